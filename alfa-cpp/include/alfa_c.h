@@ -0,0 +1,114 @@
+/*  ***************************************************************************
+*   alfa_c.h - C interface of the ALFA dataset library (alfa_c shared library).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_C_H
+#define ALFA_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Symbol export for the shared library */
+#if defined _WIN32 || defined __CYGWIN__
+#ifdef ALFA_C_BUILD
+#define ALFA_C_API __declspec(dllexport)
+#else
+#define ALFA_C_API __declspec(dllimport)
+#endif
+#else
+#define ALFA_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Version of the C interface. Only incremented on incompatible changes. */
+#define ALFA_C_ABI_VERSION 1
+
+/* Status codes returned by the functions */
+typedef enum alfa_status
+{
+    ALFA_OK = 0,                        /* Success */
+    ALFA_ERROR_INVALID_ARGUMENT = 1,    /* A NULL handle or pointer, or a negative count */
+    ALFA_ERROR_LOAD_FAILED = 2,         /* The sequence could not be loaded */
+    ALFA_ERROR_NOT_FOUND = 3,           /* The topic or the field does not exist */
+    ALFA_ERROR_OUT_OF_RANGE = 4,        /* An index is out of range */
+    ALFA_ERROR_BUFFER_TOO_SMALL = 5,    /* The caller buffer cannot hold the result */
+    ALFA_ERROR_CONVERSION = 6,          /* Some values were not numbers (they are exported as NaN or 0) */
+    ALFA_ERROR_INTERNAL = 7             /* An internal error (e.g. out of memory) */
+} alfa_status;
+
+/* Opaque handles. Topics are owned by their sequence and stay valid until the sequence is freed. */
+typedef struct alfa_sequence alfa_sequence;
+typedef struct alfa_topic alfa_topic;
+
+/* General */
+ALFA_C_API int alfa_abi_version(void);
+ALFA_C_API const char *alfa_status_string(alfa_status status);
+
+/* Sequences */
+ALFA_C_API alfa_status alfa_sequence_load(const char *sequence_dir, const char *sequence_name, alfa_sequence **out_sequence);
+ALFA_C_API void alfa_sequence_free(alfa_sequence *sequence);
+ALFA_C_API const char *alfa_sequence_name(const alfa_sequence *sequence);
+ALFA_C_API int64_t alfa_sequence_topic_count(const alfa_sequence *sequence);
+ALFA_C_API alfa_status alfa_sequence_topic(const alfa_sequence *sequence, int64_t topic_index, const alfa_topic **out_topic);
+ALFA_C_API alfa_status alfa_sequence_find_topic(const alfa_sequence *sequence, const char *topic_name, const alfa_topic **out_topic);
+ALFA_C_API int64_t alfa_sequence_find_topic_index(const alfa_sequence *sequence, const char *topic_name);
+ALFA_C_API int64_t alfa_sequence_first_fault_message(const alfa_sequence *sequence);
+
+/* Timeline (all the messages of the sequence sorted by their recorded time).
+   Any of the output buffers may be NULL; the others should hold 'count' elements. */
+ALFA_C_API int64_t alfa_sequence_message_count(const alfa_sequence *sequence);
+ALFA_C_API alfa_status alfa_sequence_timeline(const alfa_sequence *sequence, int64_t start, int64_t count,
+    int32_t *out_topic_indices, int32_t *out_message_indices, int64_t *out_times_ns, int64_t *out_written);
+
+/* Topics */
+ALFA_C_API const char *alfa_topic_name(const alfa_topic *topic);
+ALFA_C_API int alfa_topic_is_fault(const alfa_topic *topic);
+ALFA_C_API int alfa_topic_has_header(const alfa_topic *topic);
+ALFA_C_API int64_t alfa_topic_message_count(const alfa_topic *topic);
+ALFA_C_API int64_t alfa_topic_field_count(const alfa_topic *topic);
+ALFA_C_API const char *alfa_topic_field_label(const alfa_topic *topic, int64_t field_index);
+ALFA_C_API int64_t alfa_topic_find_field(const alfa_topic *topic, const char *field_label);
+
+/* Bulk column export into caller buffers holding at least 'count' elements (count < 0 for all the messages
+   after start). The number of exported messages is written to out_written (may be NULL). */
+ALFA_C_API alfa_status alfa_topic_export_times(const alfa_topic *topic, int64_t start, int64_t count,
+    int64_t *out_times_ns, int64_t *out_written);
+ALFA_C_API alfa_status alfa_topic_export_headers(const alfa_topic *topic, int64_t start, int64_t count,
+    int32_t *out_sequence_ids, int64_t *out_stamps, int64_t *out_written);
+ALFA_C_API alfa_status alfa_topic_export_double(const alfa_topic *topic, int64_t field_index, int64_t start, int64_t count,
+    double *out_values, int64_t *out_written);
+ALFA_C_API alfa_status alfa_topic_export_int64(const alfa_topic *topic, int64_t field_index, int64_t start, int64_t count,
+    int64_t *out_values, int64_t *out_written);
+
+/* Copy a single field value as a NUL-terminated string. The full length is written to out_length (may be NULL). */
+ALFA_C_API alfa_status alfa_topic_field_string(const alfa_topic *topic, int64_t field_index, int64_t message_index,
+    char *out_buffer, size_t buffer_size, size_t *out_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
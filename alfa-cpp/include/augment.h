@@ -0,0 +1,232 @@
+/*  ***************************************************************************
+*   augment.h - Header for the augmentation of the training windows.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_AUGMENT_H
+#define ALFA_AUGMENT_H
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include "commons.h"
+#include "window_index.h"
+#include "trace.h"
+
+namespace alfa
+{
+
+// This class generates augmented variants of the windows of a window index (noise injection, gain and
+// bias perturbation, time warping and window jitter). Each variant is written straight from the decoded
+// channel values into the output tensor. The random numbers come from a counter-based generator keyed by
+// (seed, window, variant), so a variant is the same regardless of the batch, the order or the thread count.
+class Augmenter
+{
+public:
+
+    // Local struct definitions
+    struct Options                  // Strength of each augmentation (zero disables it)
+    {
+        float NoiseStd = 0;         // Standard deviation of the additive noise on each value
+        float GainStd = 0;          // Standard deviation of the multiplicative gain around 1 (per channel)
+        float BiasStd = 0;          // Standard deviation of the additive bias (per channel)
+        float MaxWarp = 0;          // Maximum relative change of the playback rate (e.g. 0.1 for 0.9x to 1.1x)
+        int MaxJitter = 0;          // Maximum shift of the window start in messages
+        std::vector<float> ChannelScales;   // Scale of the noise and the bias for each channel (empty for 1)
+    };
+
+    // Constructors & Deconstructors
+    Augmenter(const WindowIndex &window_index, const Options &options);
+
+    // Member Functions
+    size_t GetTensorSize(size_t n_windows, int n_variants) const;
+    bool Generate(const std::vector<size_t> &window_ids, int n_variants, unsigned long long seed,
+        float *out_tensor, int n_threads = 0) const;
+    std::vector<int> GetLabels(const std::vector<size_t> &window_ids, int n_variants) const;
+
+private:
+    // Member Functions
+    void GenerateVariant(size_t window_id, int variant, unsigned long long seed, float *out_window) const;
+    static unsigned long long Mix(unsigned long long x);
+    static float Uniform(unsigned long long key, unsigned long long counter);
+    static float Gaussian(unsigned long long key, unsigned long long counter);
+
+    // Data Members
+    const WindowIndex &window_index;
+    Options options;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for Augmenter. The window index should stay alive while the augmenter is used.
+Augmenter::Augmenter(const WindowIndex &window_index, const Options &options)
+    : window_index(window_index), options(options)
+{
+}
+
+// Get the number of the values in the tensor of the variants of the given number of windows
+size_t Augmenter::GetTensorSize(size_t n_windows, int n_variants) const
+{
+    return window_index.GetTensorSize(n_windows) * std::max(0, n_variants);
+}
+
+// Generate n_variants augmented variants of each given window into a contiguous tensor with the shape of
+// (windows x variants x channels x WindowLength). The output should hold GetTensorSize() values.
+bool Augmenter::Generate(const std::vector<size_t> &window_ids, int n_variants, unsigned long long seed,
+    float *out_tensor, int n_threads) const
+{
+    // Print an error if the data is not loaded
+    if (!window_index.HasData())
+    {
+        std::cerr << "Augmenter Error! The data of the window index is not loaded." << std::endl;
+        return false;
+    }
+
+    // Check the inputs
+    if (n_variants <= 0 || options.MaxWarp < 0 || options.MaxWarp >= 1 || options.MaxJitter < 0 ||
+        (!options.ChannelScales.empty() && options.ChannelScales.size() != window_index.Channels.size()))
+    {
+        std::cerr << "Augmenter Error! Invalid number of variants or augmentation options." << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < window_ids.size(); ++i)
+        if (window_ids[i] >= window_index.Size())
+        {
+            std::cerr << "Augmenter Error! Window id " << window_ids[i] << " is out of range." << std::endl;
+            return false;
+        }
+
+    // Generate the variants in parallel (each task writes its own slice of the output)
+    const size_t window_size = window_index.GetTensorSize(1);
+    const int n_tasks = window_ids.size() * n_variants;
+    Commons::ParallelFor(n_tasks, n_threads, [&](int task)
+    {
+        Trace::Scope trace("augment", "variant");
+        GenerateVariant(window_ids[task / n_variants], task % n_variants, seed, out_tensor + task * window_size);
+    });
+
+    return true;
+}
+
+// Get the labels of the variants of the given windows (in the order of the generated tensor)
+std::vector<int> Augmenter::GetLabels(const std::vector<size_t> &window_ids, int n_variants) const
+{
+    std::vector<int> labels;
+    labels.reserve(window_ids.size() * std::max(0, n_variants));
+    for (size_t i = 0; i < window_ids.size(); ++i)
+        labels.insert(labels.end(), std::max(0, n_variants), window_ids[i] < window_index.Size() ? window_index.Labels[window_ids[i]] : -1);
+    return labels;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Generate a single variant of a window into its (channels x WindowLength) slice of the output
+void Augmenter::GenerateVariant(size_t window_id, int variant, unsigned long long seed, float *out_window) const
+{
+    const int length = window_index.WindowLength;
+    const unsigned long long key = Mix(Mix(seed ^ Mix(window_id)) + (unsigned long long)variant);
+
+    // Draw the parameters shared by all the channels (the warp rate and the start shift)
+    const float rate = 1 + options.MaxWarp * (2 * Uniform(key, 0) - 1);
+    const int shift = options.MaxJitter == 0 ? 0 :
+        std::min(options.MaxJitter, (int)(Uniform(key, 1) * (2 * options.MaxJitter + 1)) - options.MaxJitter);
+    const float span = (length - 1) * rate;
+
+    for (int c = 0; c < (int)window_index.Channels.size(); ++c)
+    {
+        float *out = out_window + (size_t)c * length;
+        const float *src = window_index.GetChannelData(window_index.SequenceIDs[window_id], c);
+        const int n_src = window_index.GetSequenceLength(window_index.SequenceIDs[window_id], c);
+
+        // Shift the start of the window, keeping the (warped) window inside the sequence
+        const int max_start = std::max(0, n_src - 1 - (int)std::ceil(span));
+        const int start = std::max(0, std::min(max_start, window_index.GetStartRow(window_id, c) + shift));
+        src += start;
+
+        // Copy or resample the window (linear interpolation between the neighbouring messages)
+        if (options.MaxWarp == 0)
+            std::copy(src, src + length, out);
+        else
+        {
+            const int last = n_src - 1 - start;
+            for (int l = 0; l < length; ++l)
+            {
+                float pos = std::min(l * rate, (float)last);
+                int i0 = (int)pos;
+                int i1 = std::min(i0 + 1, last);
+                float frac = pos - i0;
+                out[l] = src[i0] + frac * (src[i1] - src[i0]);
+            }
+        }
+
+        // Apply the gain, the bias and the noise in a single pass (no branches or calls, so it vectorizes)
+        const float scale = options.ChannelScales.empty() ? 1 : options.ChannelScales[c];
+        const float gain = 1 + options.GainStd * Gaussian(key, 2 + 2 * c);
+        const float bias = options.BiasStd * scale * Gaussian(key, 3 + 2 * c);
+        const float noise_std = options.NoiseStd * scale;
+        if (noise_std == 0)
+        {
+            for (int l = 0; l < length; ++l)
+                out[l] = out[l] * gain + bias;
+        }
+        else
+        {
+            const unsigned long long noise_key = Mix(key + c + 1);
+            for (int l = 0; l < length; ++l)
+                out[l] = out[l] * gain + bias + noise_std * Gaussian(noise_key, l);
+        }
+    }
+}
+
+// SplitMix64 finalizer: maps a counter to a well-mixed 64-bit value
+unsigned long long Augmenter::Mix(unsigned long long x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Get the uniform random number in [0, 1) for the given key and counter
+float Augmenter::Uniform(unsigned long long key, unsigned long long counter)
+{
+    return (Mix(key + counter * 0xD1B54A32D192ED03ULL) >> 40) * (1.0f / 16777216.0f);
+}
+
+// Get the approximately standard normal random number for the given key and counter. It is the
+// normalized sum of four 16-bit uniforms of one hash (Irwin-Hall), which only needs integer
+// arithmetic, so the loops that use it can be vectorized by the compiler.
+float Augmenter::Gaussian(unsigned long long key, unsigned long long counter)
+{
+    unsigned long long h = Mix(key + counter * 0xD1B54A32D192ED03ULL);
+    unsigned int sum = (unsigned int)(h & 0xFFFF) + (unsigned int)((h >> 16) & 0xFFFF) +
+        (unsigned int)((h >> 32) & 0xFFFF) + (unsigned int)(h >> 48);
+    return ((float)sum * (1.0f / 65536.0f) - 2.0f) * 1.7320508f;
+}
+
+}
+#endif
@@ -0,0 +1,295 @@
+/*  ***************************************************************************
+*   batch_stream.h - Header for streaming fixed-size batches of topic fields.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_BATCH_STREAM_H
+#define ALFA_BATCH_STREAM_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <iostream>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "commons.h"
+#include "diagnostics.h"
+#include "sequence.h"
+
+namespace alfa
+{
+
+// This class streams fixed-size batches of the selected fields of a topic over one or many sequences.
+// The sequences are loaded and converted by background threads, while the batches are delivered
+// in the order of the sequences with a bounded number of prefetched batches. The errors of the stream and of
+// loading the sequences are reported to the given diagnostics collector (or to its own one if not given).
+class BatchStream
+{
+public:
+
+    // Local struct definitions
+    struct Batch                        // A batch of records (rows) of the selected fields
+    {
+        int SequenceIdx = -1;           // Index of the sequence in the stream
+        std::string SequenceName;
+        int StartMessage = 0;           // Index of the first message of the batch in the topic
+        int Rows = 0;
+        int Columns = 0;
+        std::vector<double> Data;       // Row-major values (Rows x Columns), NaN if not a number
+        std::vector<long long> Times;   // Recorded times of the rows (epoch nanoseconds)
+    };
+
+    // Constructors & Deconstructors
+    BatchStream(const VecString &sequence_dirs, const VecString &sequence_names, const std::string &topic_name,
+        const VecString &field_labels, int batch_size, int n_threads = 2, int prefetch = 8, bool drop_last = false,
+        const std::shared_ptr<Diagnostics> &diagnostics = nullptr);
+    ~BatchStream();
+    BatchStream(const BatchStream &) = delete;
+    BatchStream &operator=(const BatchStream &) = delete;
+
+    // Member Functions
+    bool Next(Batch &out_batch);
+    void Stop();
+    std::shared_ptr<Diagnostics> GetDiagnostics() const;
+
+private:
+    // Member Functions
+    void Worker();
+    void ProduceBatches(int seq_idx);
+    void Push(int seq_idx, Batch &batch);
+    void FinishSequence(int seq_idx);
+    void Report(const std::string &source, const std::string &text) const;
+
+    // Data Members
+    VecString sequence_dirs, sequence_names, field_labels;
+    std::string topic_name;
+    int batch_size, prefetch;
+    bool drop_last;
+
+    // Queued batches and the completion status of each sequence
+    std::vector<std::deque<Batch> > queues;
+    std::vector<char> finished;
+    int n_queued = 0;
+    int current_seq = 0;
+
+    // Synchronization between the workers and the consumer
+    std::mutex mutex;
+    std::condition_variable cv_consumer, cv_producer;
+    std::atomic<int> next_seq;
+    std::atomic<bool> stopped;
+    std::vector<std::thread> threads;
+
+    // Collector of the errors (shared by the workers)
+    DiagnosticsLink diagnostics;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for BatchStream. Starts the background threads right away.
+BatchStream::BatchStream(const VecString &sequence_dirs, const VecString &sequence_names, const std::string &topic_name,
+    const VecString &field_labels, int batch_size, int n_threads, int prefetch, bool drop_last,
+    const std::shared_ptr<Diagnostics> &diagnostics)
+    : sequence_dirs(sequence_dirs), sequence_names(sequence_names), field_labels(field_labels), topic_name(topic_name),
+    batch_size(std::max(1, batch_size)), prefetch(std::max(1, prefetch)), drop_last(drop_last),
+    queues(sequence_dirs.size()), finished(sequence_dirs.size(), 0), next_seq(0), stopped(false), diagnostics(diagnostics)
+{
+    // Print an error if the sequence lists do not match
+    if (sequence_dirs.size() != sequence_names.size())
+    {
+        Report("BatchStream", "BatchStream Error! Number of sequence directories and names do not match.");
+        queues.clear();
+        finished.clear();
+        return;
+    }
+
+    // Start the workers
+    n_threads = std::max(1, std::min(n_threads, (int)sequence_dirs.size()));
+    for (int t = 0; t < n_threads; ++t)
+        threads.push_back(std::thread(&BatchStream::Worker, this));
+}
+
+// Destructor function for BatchStream. Stops and joins the background threads.
+BatchStream::~BatchStream()
+{
+    Stop();
+}
+
+// Get the next batch. Blocks until a batch is ready. Returns false when the stream is exhausted.
+bool BatchStream::Next(Batch &out_batch)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (current_seq < (int)queues.size())
+    {
+        // Wait for a batch from the current sequence or for the sequence to finish
+        cv_consumer.wait(lock, [this]() { return stopped || !queues[current_seq].empty() || finished[current_seq]; });
+        if (stopped) return false;
+
+        if (!queues[current_seq].empty())
+        {
+            out_batch = std::move(queues[current_seq].front());
+            queues[current_seq].pop_front();
+            n_queued--;
+            cv_producer.notify_all();
+            return true;
+        }
+
+        // Move to the next sequence (also wakes up its producer if it was waiting for space)
+        current_seq++;
+        cv_producer.notify_all();
+    }
+    return false;
+}
+
+// Stop the stream and join the background threads
+void BatchStream::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    cv_producer.notify_all();
+    cv_consumer.notify_all();
+    for (int t = 0; t < (int)threads.size(); ++t)
+        if (threads[t].joinable())
+            threads[t].join();
+    threads.clear();
+}
+
+// Get the collector of the errors of the stream and of loading its sequences
+std::shared_ptr<Diagnostics> BatchStream::GetDiagnostics() const
+{
+    return diagnostics.Get();
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Worker thread: loads the next unprocessed sequence and produces its batches
+void BatchStream::Worker()
+{
+    for (int i = next_seq++; i < (int)sequence_dirs.size() && !stopped; i = next_seq++)
+    {
+        ProduceBatches(i);
+        FinishSequence(i);
+    }
+}
+
+// Load a sequence and cut the selected fields of the topic into batches
+void BatchStream::ProduceBatches(int seq_idx)
+{
+    Sequence sequence(sequence_dirs[seq_idx], sequence_names[seq_idx], diagnostics.Get());
+    if (!sequence.IsInitialized()) return;
+
+    // Skip the sequence if it does not have the topic
+    int topic_idx = sequence.FindTopicIndex(topic_name);
+    if (topic_idx < 0)
+    {
+        Report(sequence_names[seq_idx], "BatchStream Error! '" + topic_name + "' topic not found in '" + sequence_names[seq_idx] + "'.");
+        return;
+    }
+    const Topic &topic = sequence.Topics[topic_idx];
+
+    // Find the field indices (skip the sequence if any of them is missing)
+    std::vector<int> field_indices;
+    for (int f = 0; f < (int)field_labels.size(); ++f)
+    {
+        field_indices.push_back(topic.FindLabelIndex(field_labels[f]));
+        if (field_indices.back() < 0)
+        {
+            Report(sequence_names[seq_idx], "BatchStream Error! '" + field_labels[f] + "' field not found in '" + topic_name + "'.");
+            return;
+        }
+    }
+
+    // Cut the messages into the batches
+    const int n_cols = field_indices.size();
+    const int n_msgs = topic.Messages.size();
+    for (int start = 0; start < n_msgs && !stopped; start += batch_size)
+    {
+        int n_rows = std::min(batch_size, n_msgs - start);
+        if (n_rows < batch_size && drop_last) break;
+
+        Batch batch;
+        batch.SequenceIdx = seq_idx;
+        batch.SequenceName = sequence_names[seq_idx];
+        batch.StartMessage = start;
+        batch.Rows = n_rows;
+        batch.Columns = n_cols;
+        batch.Data.resize((size_t)n_rows * n_cols);
+        batch.Times.resize(n_rows);
+        for (int r = 0; r < n_rows; ++r)
+        {
+            const Message &msg = topic.Messages[start + r];
+            batch.Times[r] = msg.DateTime.ToEpochNanoseconds();
+            for (int c = 0; c < n_cols; ++c)
+            {
+                const std::string &field = msg.Fields[field_indices[c]];
+                char *endptr;
+                double value = std::strtod(field.c_str(), &endptr);
+                batch.Data[(size_t)r * n_cols + c] = (field.empty() || *endptr != '\0') ? std::numeric_limits<double>::quiet_NaN() : value;
+            }
+        }
+
+        Push(seq_idx, batch);
+    }
+}
+
+// Queue a batch. Waits while the prefetch buffer is full. The later sequences may fill the buffer while the consumer
+// waits for the current one, so the current sequence can still queue a batch when it has none queued (the buffer
+// then holds at most prefetch + 1 batches).
+void BatchStream::Push(int seq_idx, Batch &batch)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cv_producer.wait(lock, [this, seq_idx]()
+    {
+        return stopped || n_queued < prefetch || (seq_idx == current_seq && queues[seq_idx].empty());
+    });
+    if (stopped) return;
+
+    queues[seq_idx].push_back(std::move(batch));
+    n_queued++;
+    cv_consumer.notify_all();
+}
+
+// Mark a sequence as completely produced
+void BatchStream::FinishSequence(int seq_idx)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    finished[seq_idx] = 1;
+    cv_consumer.notify_all();
+}
+
+// Report an error to the diagnostics collector
+void BatchStream::Report(const std::string &source, const std::string &text) const
+{
+    diagnostics.Get()->Add(Diagnostics::Error, source, text);
+}
+
+}
+#endif
@@ -0,0 +1,646 @@
+/*  ***************************************************************************
+*   benchmark.h - Header for running benchmarks and tracking their regressions.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_BENCHMARK_H
+#define ALFA_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cctype>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include "commons.h"
+#include "perf_counters.h"
+
+// Define different headers for Windows and Unix-based systems
+#if defined _WIN32 || defined __CYGWIN__
+#ifndef ALFA_POPEN
+#define ALFA_POPEN _popen
+#define ALFA_PCLOSE _pclose
+#endif
+#else
+#include <unistd.h>
+#ifndef ALFA_POPEN
+#define ALFA_POPEN popen
+#define ALFA_PCLOSE pclose
+#endif
+#endif
+
+namespace alfa
+{
+
+// This class runs a set of named benchmark cases repeatedly and keeps the time of each run. The results
+// are saved as JSON baselines keyed by the commit and the machine, and two sets of results are compared
+// with a confidence interval of the change of each case (Welch's t-test), so only the slowdowns that are
+// both statistically significant and larger than a threshold are flagged as regressions. The hardware counters
+// (if available) are also collected for each case, to show if it is bound by the cache or the branch misses.
+class Benchmark
+{
+public:
+
+    // Local struct definitions
+    struct Result                       // Times of the runs of a case (seconds) and their statistics
+    {
+        std::string Name;
+        std::vector<double> Samples;
+        double Mean = 0, StdDev = 0;
+        double CILow = 0, CIHigh = 0;   // 95% confidence interval of the mean
+        long long Rows = 0;             // Number of the rows (messages) processed by each run
+        PerfCounters::Values Counters;  // Hardware counters of all the timed runs together
+    };
+
+    struct Report                       // Results of all the cases on a commit and a machine
+    {
+        std::string Commit;
+        std::string Machine;            // Host name and a short hash of the fingerprint
+        std::string Fingerprint;        // CPU model, number of cores and compiler
+        std::string Label;              // Description of the input (e.g. the sequence name)
+        long long Timestamp = 0;        // Seconds since the epoch
+        int Repetitions = 0;
+        std::vector<Result> Results;
+    };
+
+    struct Comparison                   // Change of a case between a baseline and the current results
+    {
+        std::string Name;
+        double BaselineMean = 0, CurrentMean = 0;
+        double Change = 0;              // Relative change of the mean time (positive is slower)
+        double ChangeLow = 0, ChangeHigh = 0;   // 95% confidence interval of the relative change
+        bool IsRegression = false;
+        bool IsImprovement = false;
+    };
+
+    // Constructors & Deconstructors
+    Benchmark(int repetitions = 10, int warmup_runs = 1);
+
+    // Member Functions
+    void AddCase(const std::string &name, const std::function<void()> &run, const std::function<void()> &setup = nullptr,
+        long long rows_per_run = 0);
+    Report Run(const std::string &commit = "", const std::string &label = "", std::ostream *progress = nullptr) const;
+    static Result ComputeStatistics(const std::string &name, const std::vector<double> &samples);
+    static std::vector<Comparison> Compare(const Report &baseline, const Report &current, double threshold = 0.05);
+    static bool HasRegressions(const std::vector<Comparison> &comparisons);
+    static void PrintResults(const Report &report, std::ostream &os = std::cout);
+    static void PrintComparisons(const std::vector<Comparison> &comparisons, std::ostream &os = std::cout);
+    static bool SaveReport(const Report &report, const std::string &filename);
+    static bool LoadReport(const std::string &filename, Report &out_report);
+    static std::string GetReportFilename(const Report &report);
+    static std::string GetCommit();
+    static std::string GetMachineFingerprint();
+    static std::string GetMachineName();
+    static double StudentTQuantile(double degrees_of_freedom);
+
+private:
+    // Local struct definitions
+    struct Case
+    {
+        std::string Name;
+        std::function<void()> Run, Setup;
+        long long Rows;
+    };
+
+    // Data Members
+    int repetitions, warmup_runs;
+    std::vector<Case> cases;
+
+    // Member Functions
+    static bool FindJSONString(const std::string &json, size_t &pos, const std::string &key, std::string &out_value);
+    static bool ParseHex4(const std::string &json, size_t pos, unsigned int &out_code);
+    static bool FindJSONNumber(const std::string &json, size_t &pos, const std::string &key, double &out_value);
+    static std::string FormatCounters(const Result &result);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for Benchmark. Each case is run the given number of times after the warmup runs.
+Benchmark::Benchmark(int repetitions, int warmup_runs)
+    : repetitions(std::max(2, repetitions)), warmup_runs(std::max(0, warmup_runs))
+{
+}
+
+// Add a case. The setup function (if any) is called before each run and is not timed. The number of the rows
+// processed by each run (if given) is used to report the hardware events per row.
+void Benchmark::AddCase(const std::string &name, const std::function<void()> &run, const std::function<void()> &setup,
+    long long rows_per_run)
+{
+    Case c;
+    c.Name = name;
+    c.Run = run;
+    c.Setup = setup;
+    c.Rows = rows_per_run;
+    cases.push_back(c);
+}
+
+// Run all the cases and collect their times. Writes the result of each case to the progress stream (if given).
+Benchmark::Report Benchmark::Run(const std::string &commit, const std::string &label, std::ostream *progress) const
+{
+    Report report;
+    report.Commit = commit.empty() ? GetCommit() : commit;
+    report.Machine = GetMachineName();
+    report.Fingerprint = GetMachineFingerprint();
+    report.Label = label;
+    report.Timestamp = (long long)std::time(NULL);
+    report.Repetitions = repetitions;
+
+    PerfCounters perf_counters;
+    for (int c = 0; c < (int)cases.size(); ++c)
+    {
+        // Run the case, timing and counting only the run function
+        std::vector<double> samples;
+        PerfCounters::Values counters;
+        for (int r = 0; r < warmup_runs + repetitions; ++r)
+        {
+            if (cases[c].Setup) cases[c].Setup();
+            perf_counters.Start();
+            cases[c].Run();
+            PerfCounters::Values values = perf_counters.Stop();
+            if (r < warmup_runs) continue;
+            samples.push_back(values.Seconds);
+            counters += values;
+        }
+
+        report.Results.push_back(ComputeStatistics(cases[c].Name, samples));
+        report.Results.back().Rows = cases[c].Rows;
+        report.Results.back().Counters = counters;
+        if (progress)
+        {
+            const Result &result = report.Results.back();
+            *progress << std::left << std::setw(16) << result.Name << std::right << std::fixed << std::setprecision(3) <<
+                std::setw(10) << result.Mean * 1e3 << " ms +/- " << std::setw(7) << (result.CIHigh - result.Mean) * 1e3 << " ms" <<
+                FormatCounters(result) << std::endl;
+        }
+    }
+
+    return report;
+}
+
+// Compute the mean, the standard deviation and the 95% confidence interval of the mean of the samples
+Benchmark::Result Benchmark::ComputeStatistics(const std::string &name, const std::vector<double> &samples)
+{
+    Result result;
+    result.Name = name;
+    result.Samples = samples;
+    int n = samples.size();
+    if (n == 0) return result;
+
+    double sum = 0;
+    for (int i = 0; i < n; ++i)
+        sum += samples[i];
+    result.Mean = sum / n;
+
+    double sum_squares = 0;
+    for (int i = 0; i < n; ++i)
+        sum_squares += (samples[i] - result.Mean) * (samples[i] - result.Mean);
+    result.StdDev = n > 1 ? std::sqrt(sum_squares / (n - 1)) : 0;
+
+    double half_width = n > 1 ? StudentTQuantile(n - 1) * result.StdDev / std::sqrt((double)n) : 0;
+    result.CILow = result.Mean - half_width;
+    result.CIHigh = result.Mean + half_width;
+    return result;
+}
+
+// Compare the cases that are in both reports. A case is a regression if the whole confidence interval of its
+// relative change is above the threshold (and an improvement if it is below the negative threshold).
+std::vector<Benchmark::Comparison> Benchmark::Compare(const Report &baseline, const Report &current, double threshold)
+{
+    std::vector<Comparison> comparisons;
+    for (int c = 0; c < (int)current.Results.size(); ++c)
+    {
+        // Find the case in the baseline
+        const Result &cur = current.Results[c];
+        const Result *base = nullptr;
+        for (int b = 0; b < (int)baseline.Results.size() && !base; ++b)
+            if (baseline.Results[b].Name == cur.Name)
+                base = &baseline.Results[b];
+        if (!base || base->Mean <= 0 || base->Samples.empty() || cur.Samples.empty()) continue;
+
+        // Welch's confidence interval of the difference of the means
+        double var_base = base->StdDev * base->StdDev / base->Samples.size();
+        double var_cur = cur.StdDev * cur.StdDev / cur.Samples.size();
+        double std_error = std::sqrt(var_base + var_cur);
+        double dof = 1;
+        if (std_error > 0)
+        {
+            double denominator = (base->Samples.size() > 1 ? var_base * var_base / (base->Samples.size() - 1) : 0) +
+                (cur.Samples.size() > 1 ? var_cur * var_cur / (cur.Samples.size() - 1) : 0);
+            dof = denominator > 0 ? (var_base + var_cur) * (var_base + var_cur) / denominator : 1;
+        }
+        double half_width = StudentTQuantile(dof) * std_error;
+        double difference = cur.Mean - base->Mean;
+
+        Comparison comparison;
+        comparison.Name = cur.Name;
+        comparison.BaselineMean = base->Mean;
+        comparison.CurrentMean = cur.Mean;
+        comparison.Change = difference / base->Mean;
+        comparison.ChangeLow = (difference - half_width) / base->Mean;
+        comparison.ChangeHigh = (difference + half_width) / base->Mean;
+        comparison.IsRegression = comparison.ChangeLow > threshold;
+        comparison.IsImprovement = comparison.ChangeHigh < -threshold;
+        comparisons.push_back(comparison);
+    }
+    return comparisons;
+}
+
+// Returns true if any of the cases is a regression
+bool Benchmark::HasRegressions(const std::vector<Comparison> &comparisons)
+{
+    for (int i = 0; i < (int)comparisons.size(); ++i)
+        if (comparisons[i].IsRegression)
+            return true;
+    return false;
+}
+
+// Print the results of a report as a table
+void Benchmark::PrintResults(const Report &report, std::ostream &os)
+{
+    os << "Commit           : " << report.Commit << std::endl;
+    os << "Machine          : " << report.Machine << " (" << report.Fingerprint << ")" << std::endl;
+    if (!report.Label.empty())
+        os << "Input            : " << report.Label << std::endl;
+    os << "Repetitions      : " << report.Repetitions << std::endl;
+    for (int i = 0; i < (int)report.Results.size(); ++i)
+    {
+        const Result &result = report.Results[i];
+        os << std::left << std::setw(16) << result.Name << std::right << std::fixed << std::setprecision(3) <<
+            std::setw(10) << result.Mean * 1e3 << " ms  [" << result.CILow * 1e3 << ", " << result.CIHigh * 1e3 << "]" <<
+            FormatCounters(result) << std::endl;
+    }
+}
+
+// Print the comparisons as a table
+void Benchmark::PrintComparisons(const std::vector<Comparison> &comparisons, std::ostream &os)
+{
+    for (int i = 0; i < (int)comparisons.size(); ++i)
+    {
+        const Comparison &comparison = comparisons[i];
+        os << std::left << std::setw(16) << comparison.Name << std::right << std::fixed << std::setprecision(3) <<
+            std::setw(10) << comparison.BaselineMean * 1e3 << " ms -> " << std::setw(10) << comparison.CurrentMean * 1e3 << " ms  " <<
+            std::showpos << std::setprecision(1) << std::setw(7) << comparison.Change * 100 << "% [" <<
+            comparison.ChangeLow * 100 << "%, " << comparison.ChangeHigh * 100 << "%]" << std::noshowpos;
+        if (comparison.IsRegression) os << "  REGRESSION";
+        else if (comparison.IsImprovement) os << "  improvement";
+        os << std::endl;
+    }
+}
+
+// Save a report to a JSON file
+bool Benchmark::SaveReport(const Report &report, const std::string &filename)
+{
+    // Open the file
+    std::ofstream ofs(filename);
+
+    // Print an error if file did not open properly
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return false;
+    }
+
+    ofs << std::setprecision(9);
+    ofs << "{" << std::endl;
+    ofs << "  \"commit\": " << Commons::EscapeJSON(report.Commit) << "," << std::endl;
+    ofs << "  \"machine\": " << Commons::EscapeJSON(report.Machine) << "," << std::endl;
+    ofs << "  \"fingerprint\": " << Commons::EscapeJSON(report.Fingerprint) << "," << std::endl;
+    ofs << "  \"label\": " << Commons::EscapeJSON(report.Label) << "," << std::endl;
+    ofs << "  \"timestamp\": " << report.Timestamp << "," << std::endl;
+    ofs << "  \"repetitions\": " << report.Repetitions << "," << std::endl;
+    ofs << "  \"results\": [";
+    for (int i = 0; i < (int)report.Results.size(); ++i)
+    {
+        const Result &result = report.Results[i];
+        ofs << (i > 0 ? "," : "") << std::endl << "    {\"name\": " << Commons::EscapeJSON(result.Name) << ", \"mean\": " << result.Mean <<
+            ", \"stddev\": " << result.StdDev << ", \"ci_low\": " << result.CILow << ", \"ci_high\": " << result.CIHigh <<
+            ", \"rows\": " << result.Rows << ", \"counters\": {";
+        bool first_counter = true;
+        for (int e = 0; e < PerfCounters::NumEvents; ++e)
+        {
+            if (!result.Counters.Available[e]) continue;
+            ofs << (first_counter ? "" : ", ") << "\"" << PerfCounters::GetEventName((PerfCounters::Event)e) << "\": " << result.Counters.Counts[e];
+            first_counter = false;
+        }
+        ofs << "}, \"samples\": [";
+        for (int s = 0; s < (int)result.Samples.size(); ++s)
+            ofs << (s > 0 ? ", " : "") << result.Samples[s];
+        ofs << "]}";
+    }
+    ofs << std::endl << "  ]" << std::endl << "}" << std::endl;
+
+    return (bool)ofs;
+}
+
+// Load a report from a JSON file written by SaveReport. The statistics are recomputed from the samples.
+bool Benchmark::LoadReport(const std::string &filename, Report &out_report)
+{
+    out_report = Report();
+    std::string json;
+    if (!Commons::ReadFileToString(filename, json))
+    {
+        std::cerr << "Failed to open '" << filename << "' file." << std::endl;
+        return false;
+    }
+
+    // Read the description of the report
+    size_t pos = 0;
+    double timestamp = 0, repetitions = 0;
+    bool ok = FindJSONString(json, pos, "commit", out_report.Commit) && FindJSONString(json, pos, "machine", out_report.Machine) &&
+        FindJSONString(json, pos, "fingerprint", out_report.Fingerprint) && FindJSONString(json, pos, "label", out_report.Label) &&
+        FindJSONNumber(json, pos, "timestamp", timestamp) && FindJSONNumber(json, pos, "repetitions", repetitions);
+    out_report.Timestamp = (long long)timestamp;
+    out_report.Repetitions = (int)repetitions;
+
+    // Read the samples of each case
+    std::string name;
+    while (ok && FindJSONString(json, pos, "name", name))
+    {
+        size_t samples_pos = json.find("\"samples\"", pos);
+        size_t start = samples_pos == std::string::npos ? std::string::npos : json.find('[', samples_pos);
+        size_t end = start == std::string::npos ? std::string::npos : json.find(']', start);
+        if (end == std::string::npos)
+        {
+            ok = false;
+            break;
+        }
+
+        // Read the rows and the counters of the case (before its samples)
+        std::string counters = json.substr(pos, samples_pos - pos);
+        size_t counters_pos = 0;
+        double value = 0;
+        long long rows = FindJSONNumber(counters, counters_pos, "rows", value) ? (long long)value : 0;
+        PerfCounters::Values values;
+        for (int e = 0; e < PerfCounters::NumEvents; ++e)
+        {
+            counters_pos = 0;
+            values.Available[e] = FindJSONNumber(counters, counters_pos, PerfCounters::GetEventName((PerfCounters::Event)e), value);
+            values.Counts[e] = values.Available[e] ? (long long)value : 0;
+        }
+
+        std::vector<double> samples;
+        VecString tokens = Commons::Tokenize(json.substr(start + 1, end - start - 1), ',');
+        for (int i = 0; ok && i < (int)tokens.size(); ++i)
+        {
+            double value;
+            ok = Commons::StringToDouble(tokens[i], value);
+            samples.push_back(value);
+        }
+        out_report.Results.push_back(ComputeStatistics(name, samples));
+        out_report.Results.back().Rows = rows;
+        out_report.Results.back().Counters = values;
+        out_report.Results.back().Counters.Seconds = out_report.Results.back().Mean * samples.size();
+        pos = end;
+    }
+
+    // Print an error if the file is not formatted properly
+    if (!ok)
+    {
+        std::cerr << "Benchmark Error! '" << filename << "' is not a valid benchmark report." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Get the filename of a report ('<commit>_<machine>.json')
+std::string Benchmark::GetReportFilename(const Report &report)
+{
+    std::string filename = report.Commit + "_" + report.Machine + ".json";
+    for (size_t i = 0; i < filename.size(); ++i)
+        if (!std::isalnum((unsigned char)filename[i]) && filename[i] != '.' && filename[i] != '-' && filename[i] != '_')
+            filename[i] = '-';
+    return filename;
+}
+
+// Get the current git commit of the working directory (or 'unknown')
+std::string Benchmark::GetCommit()
+{
+    std::string commit;
+    FILE *pipe = ALFA_POPEN("git rev-parse --short HEAD 2>&1", "r");
+    if (pipe)
+    {
+        char buffer[128];
+        while (std::fgets(buffer, sizeof(buffer), pipe))
+            commit += buffer;
+        if (ALFA_PCLOSE(pipe) != 0) commit.clear();
+    }
+    while (!commit.empty() && std::isspace((unsigned char)commit[commit.length() - 1]))
+        commit.erase(commit.length() - 1);
+    return commit.empty() ? "unknown" : commit;
+}
+
+// Get a description of the machine that affects the timings (the CPU model, the number of cores and the compiler)
+std::string Benchmark::GetMachineFingerprint()
+{
+    // Find the CPU model
+    std::string cpu = "unknown CPU";
+    std::ifstream ifs("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(ifs, line))
+        if (line.compare(0, 10, "model name") == 0 && line.find(':') != std::string::npos)
+        {
+            cpu = line.substr(line.find(':') + 2);
+            break;
+        }
+
+    std::ostringstream oss;
+    oss << cpu << ", " << std::thread::hardware_concurrency() << " threads, ";
+#if defined __VERSION__
+    oss << "compiler " << __VERSION__;
+#elif defined _MSC_FULL_VER
+    oss << "MSVC " << _MSC_FULL_VER;
+#endif
+    return oss.str();
+}
+
+// Get the name of the machine: the host name and a short hash of the fingerprint (FNV-1a)
+std::string Benchmark::GetMachineName()
+{
+    std::string host;
+#if defined _WIN32 || defined __CYGWIN__
+    const char *name = std::getenv("COMPUTERNAME");
+    if (name) host = name;
+#else
+    char name[256] = { 0 };
+    if (gethostname(name, sizeof(name) - 1) == 0) host = name;
+#endif
+    if (host.empty()) host = "unknown";
+
+    std::string fingerprint = GetMachineFingerprint();
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < fingerprint.size(); ++i)
+        hash = (hash ^ (unsigned char)fingerprint[i]) * 16777619u;
+
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "-%08x", hash);
+    return host + suffix;
+}
+
+// Get the 97.5% quantile of the Student's t distribution (for the two-sided 95% confidence intervals),
+// using the Cornish-Fisher expansion around the normal quantile
+double Benchmark::StudentTQuantile(double degrees_of_freedom)
+{
+    // Use the exact values for the smallest degrees of freedom, where the expansion is not accurate
+    static const double small_dof[] = { 12.706, 4.303, 3.182, 2.776 };
+    if (degrees_of_freedom < 1) degrees_of_freedom = 1;
+    if (degrees_of_freedom < 5) return small_dof[(int)degrees_of_freedom - 1];
+
+    const double z = 1.959964;
+    double v = degrees_of_freedom, z3 = z * z * z, z5 = z3 * z * z, z7 = z5 * z * z;
+    return z + (z3 + z) / (4 * v) + (5 * z5 + 16 * z3 + 3 * z) / (96 * v * v) +
+        (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * v * v * v);
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Find the string value of a key after the given position and move the position after it
+bool Benchmark::FindJSONString(const std::string &json, size_t &pos, const std::string &key, std::string &out_value)
+{
+    size_t key_pos = json.find("\"" + key + "\"", pos);
+    if (key_pos == std::string::npos) return false;
+    size_t start = json.find('"', json.find(':', key_pos));
+    if (start == std::string::npos) return false;
+
+    out_value.clear();
+    for (size_t i = start + 1; i < json.size(); ++i)
+    {
+        if (json[i] == '"')
+        {
+            pos = i + 1;
+            return true;
+        }
+        if (json[i] != '\\' || i + 1 >= json.size())
+        {
+            out_value += json[i];
+            continue;
+        }
+
+        // Decode the escape sequence (as written by Commons::EscapeJSON)
+        char ch = json[++i];
+        if (ch == 'n') out_value += '\n';
+        else if (ch == 'r') out_value += '\r';
+        else if (ch == 't') out_value += '\t';
+        else if (ch == 'b') out_value += '\b';
+        else if (ch == 'f') out_value += '\f';
+        else if (ch != 'u') out_value += ch;
+        else
+        {
+            unsigned int code = 0;
+            if (!ParseHex4(json, i + 1, code)) return false;
+            i += 4;
+
+            // Join a surrogate pair and write the code point in UTF-8
+            unsigned int low = 0;
+            if (code >= 0xD800 && code < 0xDC00 && i + 6 < json.size() && json[i + 1] == '\\' && json[i + 2] == 'u' &&
+                ParseHex4(json, i + 3, low) && low >= 0xDC00 && low < 0xE000)
+            {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                i += 6;
+            }
+            if (code < 0x80) out_value += (char)code;
+            else if (code < 0x800)
+            {
+                out_value += (char)(0xC0 | (code >> 6));
+                out_value += (char)(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                out_value += (char)(0xE0 | (code >> 12));
+                out_value += (char)(0x80 | ((code >> 6) & 0x3F));
+                out_value += (char)(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                out_value += (char)(0xF0 | (code >> 18));
+                out_value += (char)(0x80 | ((code >> 12) & 0x3F));
+                out_value += (char)(0x80 | ((code >> 6) & 0x3F));
+                out_value += (char)(0x80 | (code & 0x3F));
+            }
+        }
+    }
+    return false;
+}
+
+// Parse the four hexadecimal digits of a JSON unicode escape at the given position
+bool Benchmark::ParseHex4(const std::string &json, size_t pos, unsigned int &out_code)
+{
+    if (pos + 4 > json.size()) return false;
+    out_code = 0;
+    for (size_t i = pos; i < pos + 4; ++i)
+    {
+        char ch = json[i];
+        int digit = (ch >= '0' && ch <= '9') ? ch - '0' : (ch >= 'a' && ch <= 'f') ? ch - 'a' + 10 :
+            (ch >= 'A' && ch <= 'F') ? ch - 'A' + 10 : -1;
+        if (digit < 0) return false;
+        out_code = (out_code << 4) | (unsigned int)digit;
+    }
+    return true;
+}
+
+// Format the hardware counters of a case per run (or per row if the rows are known)
+std::string Benchmark::FormatCounters(const Result &result)
+{
+    const PerfCounters::Values &counters = result.Counters;
+    if (counters.GetIPC() < 0 && !counters.Available[PerfCounters::LLCMisses] && !counters.Available[PerfCounters::BranchMisses])
+        return "";
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    if (counters.GetIPC() >= 0) oss << "  IPC " << counters.GetIPC();
+    long long total_rows = result.Rows * (long long)result.Samples.size();
+    for (int e = PerfCounters::L1DataMisses; e < PerfCounters::NumEvents; ++e)
+        if (counters.Available[e])
+        {
+            oss << "  " << PerfCounters::GetEventName((PerfCounters::Event)e) << " ";
+            if (total_rows > 0) oss << counters.GetPerRow((PerfCounters::Event)e, total_rows) << "/row";
+            else oss << (long long)(counters.Counts[e] / std::max<size_t>(1, result.Samples.size())) << "/run";
+        }
+    return oss.str();
+}
+
+// Find the number value of a key after the given position and move the position after it
+bool Benchmark::FindJSONNumber(const std::string &json, size_t &pos, const std::string &key, double &out_value)
+{
+    size_t key_pos = json.find("\"" + key + "\"", pos);
+    if (key_pos == std::string::npos) return false;
+    size_t start = json.find(':', key_pos);
+    size_t end = json.find_first_of(",}\n", start);
+    if (start == std::string::npos || end == std::string::npos) return false;
+    pos = end;
+    return Commons::StringToDouble(json.substr(start + 1, end - start - 1), out_value);
+}
+
+}
+#endif
@@ -0,0 +1,639 @@
+/*  ***************************************************************************
+*   block_store.h - Header for the time-partitioned block storage of sequences.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_BLOCK_STORE_H
+#define ALFA_BLOCK_STORE_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <climits>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include "commons.h"
+#include "message.h"
+#include "topic.h"
+#include "sequence.h"
+
+#if !(defined _WIN32 || defined __CYGWIN__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace alfa
+{
+
+// This class reads a sequence stored in a single block file ('.alfab'). Each topic is stored in blocks of a
+// fixed duration, and an index at the end of the file keeps the time range, the position and the size of
+// each block. Opening the file only reads the index, and a time window query reads (with pread) and
+// decodes in parallel only the blocks that overlap the window. The file is created from a loaded sequence
+// with Convert(). The file layout is:
+//   "ALFABLK3" | block data ... | index | index offset (8 bytes) | "ALFABLK3"
+class BlockStore
+{
+public:
+
+    // Local struct definitions
+    struct BlockInfo                    // Position and time range of a block of messages
+    {
+        long long StartTime = 0;        // Earliest and latest recorded times of the messages (epoch nanoseconds)
+        long long EndTime = 0;
+        unsigned long long Offset = 0;  // Position of the block in the file
+        unsigned long long Size = 0;    // Size of the block in bytes
+        int NMessages = 0;
+    };
+
+    struct TopicInfo                    // Description of a stored topic
+    {
+        std::string Name;
+        VecString FieldLabels;
+        bool HasHeader = false;
+        long long NMessages = 0;
+        std::vector<BlockInfo> Blocks;
+    };
+
+    struct ReadStats                    // Amount of the data read by a query
+    {
+        int BlocksRead = 0;
+        long long BytesRead = 0;
+    };
+
+    // Class Data Members
+    std::string Name;                   // Name of the stored sequence
+    std::string FileName;
+    std::vector<TopicInfo> Topics;
+
+    // Constructors & Deconstructors
+    BlockStore(const std::string &filename = "");
+    ~BlockStore();
+    BlockStore(const BlockStore &) = delete;
+    BlockStore &operator=(const BlockStore &) = delete;
+
+    // Member Functions
+    static bool Convert(const Sequence &sequence, const std::string &filename, double block_seconds = 10);
+    bool Open(const std::string &filename);
+    bool IsInitialized() const;
+    void Clear();
+    int FindTopicIndex(const std::string &topic_name) const;
+    long long GetStartTime() const;
+    long long GetEndTime() const;
+    std::vector<int> FindBlocks(int topic_idx, long long start_time, long long end_time) const;
+    bool ReadTopic(const std::string &topic_name, long long start_time, long long end_time, Topic &out_topic,
+        int n_threads = 0, ReadStats *out_stats = nullptr) const;
+    bool ReadSequence(long long start_time, long long end_time, Sequence &out_sequence, const VecString &topic_names = VecString(),
+        int n_threads = 0, ReadStats *out_stats = nullptr) const;
+
+    static const char FileMagic[9];
+
+private:
+    // Local struct definitions
+    struct BlockReader                  // Cursor over the bytes of a block
+    {
+        const char *Ptr, *End;
+        template <typename T> bool Read(T &out_value);
+        bool ReadString(std::string &out_str);
+    };
+
+    // Data Members
+    bool is_initialized = false;
+#if !(defined _WIN32 || defined __CYGWIN__)
+    int file_descriptor = -1;
+#endif
+
+    // Member Functions
+    bool ReadBytes(unsigned long long offset, unsigned long long size, std::string &out_bytes) const;
+    bool IsIndexValid(unsigned long long index_offset) const;
+    static void WriteBlocks(std::ostream &os, const std::vector<BlockInfo> &blocks);
+    static bool ReadBlocks(std::istream &is, std::vector<BlockInfo> &out_blocks);
+    static void EncodeMessage(const Message &msg, long long time, bool has_header, std::string &out_bytes);
+    static bool DecodeBlock(const std::string &bytes, const BlockInfo &block, bool has_header,
+        long long start_time, long long end_time, std::vector<Message> &out_messages);
+    template <typename T> static void Append(std::string &out_bytes, const T &value);
+    static void AppendString(std::string &out_bytes, const std::string &str);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The magic bytes at the start and the end of the block files
+const char BlockStore::FileMagic[9] = "ALFABLK3";
+
+// Constructor function for BlockStore. Opens the block file if the filename is provided.
+BlockStore::BlockStore(const std::string &filename)
+{
+    if (!filename.empty())
+        Open(filename);
+}
+
+// Deconstructor function for BlockStore. Closes the file.
+BlockStore::~BlockStore()
+{
+    Clear();
+}
+
+// Write a loaded sequence to a block file. Each topic is split into blocks of the given duration (in seconds).
+bool BlockStore::Convert(const Sequence &sequence, const std::string &filename, double block_seconds)
+{
+    // Print an error if the sequence is empty
+    if (!sequence.IsInitialized() || sequence.MessageIndexList.empty())
+    {
+        std::cerr << "BlockStore Error! The sequence is not loaded." << std::endl;
+        return false;
+    }
+
+    // Open the file
+    std::ofstream ofs(filename, std::ios::binary);
+
+    // Print an error if file did not open properly
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return false;
+    }
+
+    // Align the block boundaries of all the topics to the start of the sequence
+    const Sequence::MessageIndex &first = sequence.MessageIndexList.front();
+    long long seq_start = sequence.Topics[first.TopicIdx].Messages[first.MessageIdx].DateTime.ToEpochNanoseconds();
+    long long block_duration = std::max(1LL, (long long)std::llround(block_seconds * 1e9));
+
+    // Write the blocks of each topic
+    ofs.write(FileMagic, 8);
+    unsigned long long offset = 8;
+    std::vector<TopicInfo> topics(sequence.Topics.size());
+    std::string bytes;
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+    {
+        const Topic &topic = sequence.Topics[t];
+        TopicInfo &info = topics[t];
+        info.Name = topic.Name;
+        info.FieldLabels = topic.FieldLabels;
+        info.HasHeader = topic.HasHeaderField();
+        info.NMessages = topic.Messages.size();
+
+        // Start a new block when a message passes the end of the current block
+        long long block_end = LLONG_MIN;
+        for (int m = 0; m <= (int)topic.Messages.size(); ++m)
+        {
+            long long time = m < (int)topic.Messages.size() ? topic.Messages[m].DateTime.ToEpochNanoseconds() : LLONG_MAX;
+            if (m == (int)topic.Messages.size() || time >= block_end)
+            {
+                // Write the finished block
+                if (!info.Blocks.empty())
+                {
+                    info.Blocks.back().Size = bytes.size();
+                    ofs.write(bytes.data(), bytes.size());
+                    offset += bytes.size();
+                    bytes.clear();
+                }
+                if (m == (int)topic.Messages.size()) break;
+
+                // Start the block that contains the message
+                long long block_number = (time - seq_start) / block_duration - (time < seq_start ? 1 : 0);
+                block_end = seq_start + (block_number + 1) * block_duration;
+                BlockInfo block;
+                block.StartTime = block.EndTime = time;
+                block.Offset = offset;
+                info.Blocks.push_back(block);
+            }
+
+            // Add the message to the current block
+            BlockInfo &block = info.Blocks.back();
+            block.StartTime = std::min(block.StartTime, time);
+            block.EndTime = std::max(block.EndTime, time);
+            block.NMessages++;
+            EncodeMessage(topic.Messages[m], time, info.HasHeader, bytes);
+        }
+    }
+
+    // Write the index
+    unsigned long long index_offset = offset;
+    Commons::WriteBinaryString(ofs, sequence.Name);
+    Commons::WriteBinary(ofs, (int)topics.size());
+    for (int t = 0; t < (int)topics.size(); ++t)
+    {
+        Commons::WriteBinaryString(ofs, topics[t].Name);
+        Commons::WriteBinary(ofs, (char)topics[t].HasHeader);
+        Commons::WriteBinary(ofs, (int)topics[t].FieldLabels.size());
+        for (int f = 0; f < (int)topics[t].FieldLabels.size(); ++f)
+            Commons::WriteBinaryString(ofs, topics[t].FieldLabels[f]);
+        Commons::WriteBinary(ofs, topics[t].NMessages);
+        WriteBlocks(ofs, topics[t].Blocks);
+    }
+
+    // Write the position of the index
+    Commons::WriteBinary(ofs, index_offset);
+    ofs.write(FileMagic, 8);
+
+    return (bool)ofs;
+}
+
+// Open a block file and read its index. The blocks are only read by the queries.
+bool BlockStore::Open(const std::string &filename)
+{
+    // Clear the previous data from the object
+    Clear();
+
+    // Open the file
+    std::ifstream ifs(filename, std::ios::binary);
+
+    // Print an error if file did not open properly
+    if (!ifs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file." << std::endl;
+        return false;
+    }
+
+    // Find the index from the end of the file
+    char magic[8], end_magic[8];
+    unsigned long long index_offset = 0;
+    bool ok = ifs.read(magic, 8) && std::memcmp(magic, FileMagic, 8) == 0 && ifs.seekg(-16, std::ios::end) &&
+        Commons::ReadBinary(ifs, index_offset) && ifs.read(end_magic, 8) && std::memcmp(end_magic, FileMagic, 8) == 0 &&
+        ifs.seekg(index_offset);
+
+    // Read the index
+    int n_topics = 0;
+    ok = ok && Commons::ReadBinaryString(ifs, Name) && Commons::ReadBinary(ifs, n_topics);
+    for (int t = 0; ok && t < n_topics; ++t)
+    {
+        TopicInfo info;
+        char has_header = 0;
+        int n_labels = 0;
+        ok = Commons::ReadBinaryString(ifs, info.Name) && Commons::ReadBinary(ifs, has_header) && Commons::ReadBinary(ifs, n_labels);
+        info.HasHeader = has_header != 0;
+        long long remaining = ok ? Commons::GetRemainingSize(ifs) : -1;
+        ok = ok && n_labels >= 0 && (remaining < 0 || n_labels <= remaining / (long long)sizeof(unsigned int));
+        info.FieldLabels.resize(ok ? n_labels : 0);
+        for (int f = 0; ok && f < n_labels; ++f)
+            ok = Commons::ReadBinaryString(ifs, info.FieldLabels[f]);
+        ok = ok && Commons::ReadBinary(ifs, info.NMessages) && ReadBlocks(ifs, info.Blocks);
+        Topics.push_back(info);
+    }
+
+    // Print an error if the file is not formatted properly (or its blocks are not within the file)
+    if (!ok || !IsIndexValid(index_offset))
+    {
+        std::cerr << "BlockStore Error! '" << filename << "' is not a valid block file." << std::endl;
+        Clear();
+        return false;
+    }
+
+    // Keep the file open for the block reads
+#if !(defined _WIN32 || defined __CYGWIN__)
+    file_descriptor = open(filename.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+    {
+        std::cerr << "Failed to open '" << filename << "' file." << std::endl;
+        Clear();
+        return false;
+    }
+#endif
+
+    FileName = filename;
+    is_initialized = true;
+    return true;
+}
+
+// Returns the initialization status
+bool BlockStore::IsInitialized() const
+{
+    return is_initialized;
+}
+
+// Clear the index and close the file
+void BlockStore::Clear()
+{
+#if !(defined _WIN32 || defined __CYGWIN__)
+    if (file_descriptor >= 0)
+        close(file_descriptor);
+    file_descriptor = -1;
+#endif
+    Name.clear();
+    FileName.clear();
+    Topics.clear();
+    is_initialized = false;
+}
+
+// Find the index of a topic given its name. Returns -1 if not found.
+int BlockStore::FindTopicIndex(const std::string &topic_name) const
+{
+    for (int t = 0; t < (int)Topics.size(); ++t)
+        if (Topics[t].Name == topic_name)
+            return t;
+    return -1;
+}
+
+// Get the earliest recorded time of the stored messages (epoch nanoseconds)
+long long BlockStore::GetStartTime() const
+{
+    long long start = LLONG_MAX;
+    for (int t = 0; t < (int)Topics.size(); ++t)
+        for (int b = 0; b < (int)Topics[t].Blocks.size(); ++b)
+            start = std::min(start, Topics[t].Blocks[b].StartTime);
+    return start == LLONG_MAX ? 0 : start;
+}
+
+// Get the latest recorded time of the stored messages (epoch nanoseconds)
+long long BlockStore::GetEndTime() const
+{
+    long long end = LLONG_MIN;
+    for (int t = 0; t < (int)Topics.size(); ++t)
+        for (int b = 0; b < (int)Topics[t].Blocks.size(); ++b)
+            end = std::max(end, Topics[t].Blocks[b].EndTime);
+    return end == LLONG_MIN ? 0 : end;
+}
+
+// Find the blocks of a topic that have messages in the time window [start_time, end_time]
+std::vector<int> BlockStore::FindBlocks(int topic_idx, long long start_time, long long end_time) const
+{
+    std::vector<int> blocks;
+    if (topic_idx < 0 || topic_idx >= (int)Topics.size()) return blocks;
+
+    for (int b = 0; b < (int)Topics[topic_idx].Blocks.size(); ++b)
+    {
+        const BlockInfo &block = Topics[topic_idx].Blocks[b];
+        if (block.EndTime >= start_time && block.StartTime <= end_time)
+            blocks.push_back(b);
+    }
+    return blocks;
+}
+
+// Read the messages of a topic in the time window [start_time, end_time] (epoch nanoseconds)
+bool BlockStore::ReadTopic(const std::string &topic_name, long long start_time, long long end_time, Topic &out_topic,
+    int n_threads, ReadStats *out_stats) const
+{
+    Sequence sequence;
+    if (!ReadSequence(start_time, end_time, sequence, VecString(1, topic_name), n_threads, out_stats)) return false;
+    out_topic = std::move(sequence.Topics[0]);
+    return true;
+}
+
+// Read the messages of the given topics (or all the topics if empty) in the time window [start_time, end_time].
+// The blocks of all the topics are read and decoded in parallel.
+bool BlockStore::ReadSequence(long long start_time, long long end_time, Sequence &out_sequence, const VecString &topic_names,
+    int n_threads, ReadStats *out_stats) const
+{
+    // Print an error if the file is not open
+    if (!is_initialized)
+    {
+        std::cerr << "BlockStore Error! The block file is not open." << std::endl;
+        return false;
+    }
+
+    // Find the requested topics
+    std::vector<int> topic_indices;
+    for (int i = 0; i < (int)topic_names.size(); ++i)
+    {
+        topic_indices.push_back(FindTopicIndex(topic_names[i]));
+        if (topic_indices.back() < 0)
+        {
+            std::cerr << "BlockStore Error! '" << topic_names[i] << "' topic not found in '" << FileName << "'." << std::endl;
+            return false;
+        }
+    }
+    if (topic_names.empty())
+        for (int t = 0; t < (int)Topics.size(); ++t)
+            topic_indices.push_back(t);
+
+    // Find the blocks in the window
+    std::vector<std::pair<int, int> > tasks;        // (topic, block)
+    std::vector<int> first_task;                    // First task of each requested topic
+    for (int i = 0; i < (int)topic_indices.size(); ++i)
+    {
+        first_task.push_back(tasks.size());
+        std::vector<int> blocks = FindBlocks(topic_indices[i], start_time, end_time);
+        for (int b = 0; b < (int)blocks.size(); ++b)
+            tasks.push_back(std::make_pair(topic_indices[i], blocks[b]));
+    }
+    first_task.push_back(tasks.size());
+
+    // Read and decode the blocks in parallel
+    std::vector<std::vector<Message> > decoded(tasks.size());
+    std::vector<char> succeeded(tasks.size(), 0);
+    Commons::ParallelFor(tasks.size(), n_threads, [&](int i)
+    {
+        const TopicInfo &info = Topics[tasks[i].first];
+        const BlockInfo &block = info.Blocks[tasks[i].second];
+        std::string bytes;
+        succeeded[i] = ReadBytes(block.Offset, block.Size, bytes) &&
+            DecodeBlock(bytes, block, info.HasHeader, start_time, end_time, decoded[i]);
+    });
+
+    // Print an error if any of the blocks could not be read
+    ReadStats stats;
+    for (int i = 0; i < (int)tasks.size(); ++i)
+    {
+        if (!succeeded[i])
+        {
+            std::cerr << "BlockStore Error! Failed to read block #" << tasks[i].second << " of '" << Topics[tasks[i].first].Name <<
+                "' topic from '" << FileName << "'." << std::endl;
+            return false;
+        }
+        stats.BlocksRead++;
+        stats.BytesRead += Topics[tasks[i].first].Blocks[tasks[i].second].Size;
+    }
+    if (out_stats) *out_stats = stats;
+
+    // Create the topics from the decoded blocks and move them to the sequence (the message list is created once)
+    out_sequence.Clear();
+    out_sequence.Name = Name;
+    std::vector<Topic> topics(topic_indices.size());
+    for (int i = 0; i < (int)topic_indices.size(); ++i)
+    {
+        const TopicInfo &info = Topics[topic_indices[i]];
+        Topic &topic = topics[i];
+        topic.Create(info.Name, info.FieldLabels, info.HasHeader);
+        size_t n_messages = 0;
+        for (int k = first_task[i]; k < first_task[i + 1]; ++k)
+            n_messages += decoded[k].size();
+        topic.Messages.reserve(n_messages);
+        for (int k = first_task[i]; k < first_task[i + 1]; ++k)
+            topic.Messages.insert(topic.Messages.end(), std::make_move_iterator(decoded[k].begin()), std::make_move_iterator(decoded[k].end()));
+    }
+
+    return out_sequence.AddTopics(std::move(topics));
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Read a part of the file (safe to call from multiple threads)
+bool BlockStore::ReadBytes(unsigned long long offset, unsigned long long size, std::string &out_bytes) const
+{
+    out_bytes.resize(size);
+#if !(defined _WIN32 || defined __CYGWIN__)
+    unsigned long long done = 0;
+    while (done < size)
+    {
+        ssize_t n = pread(file_descriptor, &out_bytes[done], size - done, offset + done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += n;
+    }
+    return true;
+#else
+    std::ifstream ifs(FileName, std::ios::binary);
+    return ifs.seekg(offset) && (size == 0 || ifs.read(&out_bytes[0], size));
+#endif
+}
+
+// Check that the blocks of the index are within the block data of the file and can hold their messages
+bool BlockStore::IsIndexValid(unsigned long long index_offset) const
+{
+    // The smallest message is its time and its number of fields
+    const unsigned long long min_message_size = sizeof(long long) + sizeof(unsigned int);
+    for (int t = 0; t < (int)Topics.size(); ++t)
+    {
+        if (Topics[t].NMessages < 0) return false;
+        for (int b = 0; b < (int)Topics[t].Blocks.size(); ++b)
+        {
+            const BlockInfo &block = Topics[t].Blocks[b];
+            if (block.Offset < 8 || block.Offset > index_offset || block.Size > index_offset - block.Offset) return false;
+            if (block.NMessages < 0 || (unsigned long long)block.NMessages > block.Size / min_message_size) return false;
+        }
+    }
+    return true;
+}
+
+// Write the block descriptions of a topic field by field (so the padding of the struct is not written)
+void BlockStore::WriteBlocks(std::ostream &os, const std::vector<BlockInfo> &blocks)
+{
+    Commons::WriteBinary(os, (unsigned long long)blocks.size());
+    for (int b = 0; b < (int)blocks.size(); ++b)
+    {
+        Commons::WriteBinary(os, blocks[b].StartTime);
+        Commons::WriteBinary(os, blocks[b].EndTime);
+        Commons::WriteBinary(os, blocks[b].Offset);
+        Commons::WriteBinary(os, blocks[b].Size);
+        Commons::WriteBinary(os, blocks[b].NMessages);
+    }
+}
+
+// Read the block descriptions written by WriteBlocks. Returns false if the stream is too short.
+bool BlockStore::ReadBlocks(std::istream &is, std::vector<BlockInfo> &out_blocks)
+{
+    const long long block_size = 4 * sizeof(long long) + sizeof(int);
+    unsigned long long n_blocks = 0;
+    if (!Commons::ReadBinary(is, n_blocks)) return false;
+    long long remaining = Commons::GetRemainingSize(is);
+    if (remaining >= 0 && n_blocks > (unsigned long long)(remaining / block_size)) return false;
+
+    out_blocks.resize(n_blocks);
+    for (size_t b = 0; b < out_blocks.size(); ++b)
+    {
+        BlockInfo &block = out_blocks[b];
+        if (!(Commons::ReadBinary(is, block.StartTime) && Commons::ReadBinary(is, block.EndTime) &&
+            Commons::ReadBinary(is, block.Offset) && Commons::ReadBinary(is, block.Size) && Commons::ReadBinary(is, block.NMessages)))
+            return false;
+    }
+    return true;
+}
+
+// Encode a message at the end of the block bytes
+void BlockStore::EncodeMessage(const Message &msg, long long time, bool has_header, std::string &out_bytes)
+{
+    // Keep the epoch time only (for the window queries and to restore the recorded date-time); it is the exact
+    // UTC time of the message, so the date-time is restored to the nanosecond on any machine
+    Append(out_bytes, time);
+
+    if (has_header)
+    {
+        Append(out_bytes, msg.Header.SequenceID);
+        Append(out_bytes, msg.Header.Stamp);
+        AppendString(out_bytes, msg.Header.FrameID);
+    }
+
+    Append(out_bytes, (unsigned int)msg.Fields.size());
+    for (int f = 0; f < (int)msg.Fields.size(); ++f)
+        AppendString(out_bytes, msg.Fields[f]);
+}
+
+// Decode the messages of a block that are in the time window
+bool BlockStore::DecodeBlock(const std::string &bytes, const BlockInfo &block, bool has_header,
+    long long start_time, long long end_time, std::vector<Message> &out_messages)
+{
+    BlockReader reader = { bytes.data(), bytes.data() + bytes.size() };
+    out_messages.reserve(block.NMessages);
+    for (int m = 0; m < block.NMessages; ++m)
+    {
+        Message msg;
+        long long time = 0;
+        unsigned int n_fields = 0;
+        if (!reader.Read(time)) return false;
+        if (has_header && !(reader.Read(msg.Header.SequenceID) && reader.Read(msg.Header.Stamp) && reader.ReadString(msg.Header.FrameID)))
+            return false;
+        if (!reader.Read(n_fields) || n_fields > (unsigned int)(reader.End - reader.Ptr)) return false;
+        msg.Fields.resize(n_fields);
+        for (unsigned int f = 0; f < n_fields; ++f)
+            if (!reader.ReadString(msg.Fields[f])) return false;
+
+        // Keep only the messages in the window
+        if (time < start_time || time > end_time) continue;
+
+        // Restore the recorded date-time (exact arithmetic without locks, so the decoding threads do not wait)
+        msg.DateTime = DateTime::EpochNanosecondsToTime(time);
+        out_messages.push_back(std::move(msg));
+    }
+    return reader.Ptr == reader.End;
+}
+
+// Append a value in the native byte order
+template <typename T>
+void BlockStore::Append(std::string &out_bytes, const T &value)
+{
+    out_bytes.append((const char *)&value, sizeof(T));
+}
+
+// Append a string with its length
+void BlockStore::AppendString(std::string &out_bytes, const std::string &str)
+{
+    Append(out_bytes, (unsigned int)str.size());
+    out_bytes.append(str);
+}
+
+// Read a value and move the cursor. Returns false if the block is too short.
+template <typename T>
+bool BlockStore::BlockReader::Read(T &out_value)
+{
+    if ((size_t)(End - Ptr) < sizeof(T)) return false;
+    std::memcpy(&out_value, Ptr, sizeof(T));
+    Ptr += sizeof(T);
+    return true;
+}
+
+// Read a string with its length and move the cursor
+bool BlockStore::BlockReader::ReadString(std::string &out_str)
+{
+    unsigned int size = 0;
+    if (!Read(size) || (size_t)(End - Ptr) < size) return false;
+    out_str.assign(Ptr, size);
+    Ptr += size;
+    return true;
+}
+
+}
+#endif
@@ -0,0 +1,545 @@
+/*  ***************************************************************************
+*   catalog.h - Header for the catalog of the sequences in an ALFA dataset.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_CATALOG_H
+#define ALFA_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include "commons.h"
+#include "sequence.h"
+#include "trace.h"
+
+namespace alfa
+{
+
+// This class keeps the precomputed metadata of all the sequences in a dataset root directory,
+// so that the sequences can be filtered without loading their topic files
+class Catalog
+{
+public:
+
+    // Local struct definitions
+    struct TopicInfo            // Metadata of a single topic in a sequence
+    {
+        std::string Name;
+        int MessageCount = 0;
+        long long StartTime = 0;    // Recorded time of the first message (epoch nanoseconds)
+        long long EndTime = 0;      // Recorded time of the last message (epoch nanoseconds)
+    };
+
+    struct Entry                // Metadata of a single sequence
+    {
+        std::string Name;                   // Sequence name (also the name of its directory)
+        VecString FaultTypes;               // Fault types parsed from the sequence name (e.g. 'engine', 'rudder_left')
+        VecString FaultTopics;              // Names of the failure status topics in the sequence
+        long long StartTime = 0;            // Recorded time of the first message (epoch nanoseconds)
+        long long EndTime = 0;              // Recorded time of the last message (epoch nanoseconds)
+        long long FaultOnset = -1;          // Recorded time of the first fault message (-1 if there is no fault)
+        double TotalDuration = 0;           // Total flight duration in seconds
+        double NormalFlightDuration = 0;    // Flight duration before the fault in seconds
+        std::vector<TopicInfo> Topics;
+
+        bool HasFault() const { return FaultOnset >= 0; }
+        double FaultDuration() const { return TotalDuration - NormalFlightDuration; }
+        int FindTopicIndex(const std::string &topic_name) const;
+    };
+
+    enum FaultPresence { AnyFault, FaultOnly, NoFaultOnly };
+
+    struct Filter               // Conditions for querying the catalog (all of them should hold)
+    {
+        FaultPresence Presence = AnyFault;
+        VecString FaultTypes;               // Sequence should have one of these faults (substring match, empty for any)
+        VecString RequiredTopics;           // Sequence should have all of these topics (substring match)
+        double MinDuration = 0;             // Minimum total flight duration in seconds
+        double MaxDuration = -1;            // Maximum total flight duration in seconds (negative for no limit)
+        double MinFaultDuration = 0;        // Minimum flight duration after the fault in seconds
+    };
+
+    // Class Data Members
+    std::string RootPath;
+    std::vector<Entry> Entries;
+    static const std::string DefaultFileName;
+
+    // Constructors & Deconstructors
+    Catalog() {}
+
+    // Member Functions
+    bool Build(const std::string &root_path, int n_threads = 0);
+    bool Save(const std::string &filename = "") const;
+    bool Load(const std::string &root_path, const std::string &filename = "");
+    bool IsInitialized() const;
+    void Clear();
+    std::vector<int> Query(const Filter &filter) const;
+    int FindSequenceIndex(const std::string &sequence_name) const;
+    std::string GetSequenceDirectory(int entry_idx) const;
+    void PrintBriefInfo() const;
+    static VecString ParseFaultTypes(const std::string &sequence_name);
+    static VecString FindSequenceNames(const std::string &root_path);
+    static Entry CreateEntry(Sequence &sequence);
+
+private:
+    // Member Functions
+    std::string GetFilePath(const std::string &filename) const;
+    static bool MatchesAny(const VecString &names, const std::string &pattern);
+
+    // Data Members
+    bool is_initialized = false;
+    std::map<std::string, int> sequence_map;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The default name of the catalog file in the dataset root directory
+const std::string Catalog::DefaultFileName = "alfa-catalog.csv";
+
+// Find the index of a given topic in the entry (case sensitive)
+int Catalog::Entry::FindTopicIndex(const std::string &topic_name) const
+{
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        if (Topics[i].Name == topic_name)
+            return i;
+
+    // Return -1 if not found
+    return -1;
+}
+
+// Build the catalog by loading every sequence found under the dataset root directory once.
+// Each sub-directory containing the topic files of a sequence with the same name is cataloged.
+bool Catalog::Build(const std::string &root_path, int n_threads)
+{
+    // Clear the previous data from the object
+    Clear();
+
+    // Add the path separator to the root path
+    RootPath = root_path;
+    if (RootPath.empty() || RootPath[RootPath.length() - 1] != Commons::FilePathSeparator)
+        RootPath += Commons::FilePathSeparator;
+
+    // Find the sequence directories
+    VecString sequence_names = FindSequenceNames(RootPath);
+
+    // Print an error if no sequences are found
+    if (sequence_names.empty())
+    {
+        std::cerr << "No sequence directories found at '" << RootPath << "' directory." << std::endl;
+        return false;
+    }
+
+    // Load the sequences in parallel
+    std::vector<Entry> entries(sequence_names.size());
+    std::vector<char> loaded(sequence_names.size(), 0);
+    Commons::ParallelFor(sequence_names.size(), n_threads, [&](int i)
+    {
+        Trace::Scope trace("catalog", "sequence", sequence_names[i]);
+        Sequence sequence(RootPath + sequence_names[i] + Commons::FilePathSeparator, sequence_names[i]);
+        if (!sequence.IsInitialized()) return;
+        entries[i] = CreateEntry(sequence);
+        loaded[i] = 1;
+    });
+
+    // Keep the successfully loaded sequences
+    for (int i = 0; i < (int)entries.size(); ++i)
+        if (loaded[i])
+        {
+            sequence_map.insert(std::make_pair(entries[i].Name, (int)Entries.size()));
+            Entries.push_back(entries[i]);
+        }
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Save the catalog to a file (by default in the dataset root directory)
+bool Catalog::Save(const std::string &filename) const
+{
+    std::string file_path = GetFilePath(filename);
+
+    // Open the catalog file
+    std::ofstream ofs(file_path);
+
+    // Print an error if file did not open properly
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << file_path << "' file for writing." << std::endl;
+        return false;
+    }
+
+    const char d = Commons::CSVDelimiter;
+    ofs << "# ALFA dataset catalog v1" << std::endl;
+    for (int i = 0; i < (int)Entries.size(); ++i)
+    {
+        const Entry &entry = Entries[i];
+
+        // Join the fault lists using a secondary separator
+        std::string fault_types, fault_topics;
+        for (int j = 0; j < (int)entry.FaultTypes.size(); ++j)
+            fault_types += (j > 0 ? ";" : "") + entry.FaultTypes[j];
+        for (int j = 0; j < (int)entry.FaultTopics.size(); ++j)
+            fault_topics += (j > 0 ? ";" : "") + entry.FaultTopics[j];
+
+        // Write a line for the sequence followed by a line for each of its topics
+        ofs << "sequence" << d << entry.Name << d << entry.StartTime << d << entry.EndTime << d << entry.FaultOnset << d <<
+            std::setprecision(17) << entry.TotalDuration << d << entry.NormalFlightDuration << d <<
+            fault_types << d << fault_topics << std::endl;
+        for (int j = 0; j < (int)entry.Topics.size(); ++j)
+            ofs << "topic" << d << entry.Topics[j].Name << d << entry.Topics[j].MessageCount << d <<
+                entry.Topics[j].StartTime << d << entry.Topics[j].EndTime << std::endl;
+    }
+
+    // Print an error if the file could not be written completely
+    ofs.close();
+    if (ofs.fail())
+    {
+        std::cerr << "Catalog Error! Failed to write '" << file_path << "' file." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Load a previously built catalog file from the dataset root directory
+bool Catalog::Load(const std::string &root_path, const std::string &filename)
+{
+    // Clear the previous data from the object
+    Clear();
+
+    // Add the path separator to the root path
+    RootPath = root_path;
+    if (RootPath.empty() || RootPath[RootPath.length() - 1] != Commons::FilePathSeparator)
+        RootPath += Commons::FilePathSeparator;
+
+    std::string file_path = GetFilePath(filename);
+
+    // Open the catalog file
+    std::ifstream ifs(file_path);
+
+    // Print an error if file did not open properly
+    if (!ifs.is_open())
+    {
+        std::cerr << "Failed to open '" << file_path << "' file." << std::endl;
+        return false;
+    }
+
+    // Read the catalog line by line
+    std::string line;
+    int line_number = 0;
+    while (std::getline(ifs, line))
+    {
+        line_number++;
+
+        // Ignore the comments and the empty lines
+        if (line.empty() || line[0] == '#') continue;
+
+        VecString tokens = Commons::Tokenize(line, Commons::CSVDelimiter);
+        bool parsed = false;
+        if (tokens.size() >= 7 && tokens[0] == "sequence")
+        {
+            Entry entry;
+            entry.Name = tokens[1];
+            parsed = Commons::StringToLongLong(tokens[2], entry.StartTime) &&
+                Commons::StringToLongLong(tokens[3], entry.EndTime) &&
+                Commons::StringToLongLong(tokens[4], entry.FaultOnset) &&
+                Commons::StringToDouble(tokens[5], entry.TotalDuration) &&
+                Commons::StringToDouble(tokens[6], entry.NormalFlightDuration);
+            if (tokens.size() > 7)
+                entry.FaultTypes = Commons::Tokenize(tokens[7], ';');
+            if (tokens.size() > 8)
+                entry.FaultTopics = Commons::Tokenize(tokens[8], ';');
+            sequence_map.insert(std::make_pair(entry.Name, (int)Entries.size()));
+            Entries.push_back(entry);
+        }
+        else if (tokens.size() == 5 && tokens[0] == "topic" && !Entries.empty())
+        {
+            TopicInfo topic;
+            topic.Name = tokens[1];
+            parsed = Commons::StringToInt(tokens[2], topic.MessageCount) &&
+                Commons::StringToLongLong(tokens[3], topic.StartTime) &&
+                Commons::StringToLongLong(tokens[4], topic.EndTime);
+            Entries.back().Topics.push_back(topic);
+        }
+
+        // Print an error and stop operation if file is not formatted properly
+        if (!parsed)
+        {
+            std::cerr << "Error reading line #" << line_number << " of '" << file_path << "'." << std::endl;
+            Clear();
+            return false;
+        }
+    }
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Returns the initialization status
+bool Catalog::IsInitialized() const
+{
+    return is_initialized;
+}
+
+// Clear the entire catalog object
+void Catalog::Clear()
+{
+    RootPath = "";
+    Entries.clear();
+    sequence_map.clear();
+    is_initialized = false;
+}
+
+// Get the list of indices of the entries that satisfy all the conditions of the filter
+std::vector<int> Catalog::Query(const Filter &filter) const
+{
+    std::vector<int> result;
+    for (int i = 0; i < (int)Entries.size(); ++i)
+    {
+        const Entry &entry = Entries[i];
+
+        // Check the fault presence
+        if (filter.Presence == FaultOnly && !entry.HasFault()) continue;
+        if (filter.Presence == NoFaultOnly && entry.HasFault()) continue;
+
+        // Check the durations
+        if (entry.TotalDuration < filter.MinDuration) continue;
+        if (filter.MaxDuration >= 0 && entry.TotalDuration > filter.MaxDuration) continue;
+        if (filter.MinFaultDuration > 0 && (!entry.HasFault() || entry.FaultDuration() < filter.MinFaultDuration)) continue;
+
+        // Check if any of the desired faults happen in the sequence
+        bool fault_matched = filter.FaultTypes.empty();
+        for (int j = 0; j < (int)filter.FaultTypes.size() && !fault_matched; ++j)
+            fault_matched = MatchesAny(entry.FaultTypes, filter.FaultTypes[j]) || MatchesAny(entry.FaultTopics, filter.FaultTypes[j]);
+        if (!fault_matched) continue;
+
+        // Check if all the required topics are present
+        bool topics_matched = true;
+        for (int j = 0; j < (int)filter.RequiredTopics.size() && topics_matched; ++j)
+        {
+            topics_matched = false;
+            for (int k = 0; k < (int)entry.Topics.size() && !topics_matched; ++k)
+                topics_matched = entry.Topics[k].Name.find(filter.RequiredTopics[j]) != std::string::npos;
+        }
+        if (!topics_matched) continue;
+
+        result.push_back(i);
+    }
+    return result;
+}
+
+// Find the index of a given sequence (case sensitive)
+int Catalog::FindSequenceIndex(const std::string &sequence_name) const
+{
+    std::map<std::string, int>::const_iterator it = sequence_map.find(sequence_name);
+
+    // Return -1 if not found
+    if (it == sequence_map.end()) return -1;
+
+    return it->second;
+}
+
+// Get the directory of a sequence entry (ready to be passed to Sequence::LoadSequence)
+std::string Catalog::GetSequenceDirectory(int entry_idx) const
+{
+    if (entry_idx < 0 || entry_idx >= (int)Entries.size()) return "";
+    return RootPath + Entries[entry_idx].Name + Commons::FilePathSeparator;
+}
+
+// Print a line of brief information for each sequence in the catalog
+void Catalog::PrintBriefInfo() const
+{
+    std::cout << "Catalog of '" << RootPath << "' has " << Entries.size() << " sequences:" << std::endl;
+    for (int i = 0; i < (int)Entries.size(); ++i)
+    {
+        const Entry &entry = Entries[i];
+
+        // Print * in front of the sequences with faults
+        if (entry.HasFault()) std::cout << "*"; else std::cout << " ";
+        std::cout << std::setw(3) << i << ": " << entry.Name << " (Topics: " << entry.Topics.size() << ", Duration: " <<
+            std::fixed << std::setprecision(1) << entry.TotalDuration << " secs";
+        if (entry.HasFault())
+            std::cout << ", Fault after: " << entry.NormalFlightDuration << " secs";
+        std::cout << ")" << std::endl;
+    }
+}
+
+// Parse the fault types from the sequence name. The names are in the form of
+// 'platform_date-time[_run]_fault1__fault2_failure[_extra]' or 'platform_date-time[_run]_no_failure'.
+VecString Catalog::ParseFaultTypes(const std::string &sequence_name)
+{
+    VecString fault_types;
+
+    // Skip the platform name, the date-time and the optional run number
+    VecString tokens = Commons::Tokenize(sequence_name, '_');
+    int start = 2, run_number;
+    if ((int)tokens.size() > start && Commons::StringToInt(tokens[start], run_number)) ++start;
+
+    // Join the rest of the tokens to get the fault description
+    std::string description;
+    for (int i = start; i < (int)tokens.size(); ++i)
+        description += (i > start ? "_" : "") + tokens[i];
+
+    // Remove the failure suffix
+    std::size_t suffix_pos = description.find("failure");
+    if (suffix_pos == std::string::npos) return fault_types;
+    description = description.substr(0, suffix_pos);
+    while (!description.empty() && description[description.length() - 1] == '_')
+        description.erase(description.length() - 1);
+
+    // The sequences without any faults
+    if (description.empty() || description == "no") return fault_types;
+
+    // Break the description into the fault types (separated by double underscores)
+    std::size_t pos = 0;
+    while (pos <= description.size())
+    {
+        std::size_t next = description.find("__", pos);
+        if (next == std::string::npos) next = description.size();
+        if (next > pos)
+            fault_types.push_back(description.substr(pos, next - pos));
+        pos = next + 2;
+    }
+
+    return fault_types;
+}
+
+// Find the sorted names of the sequence directories (the ones that contain at least one CSV file) under a
+// dataset root directory, without loading them
+VecString Catalog::FindSequenceNames(const std::string &root_path)
+{
+    std::string root = root_path;
+    if (root.empty() || root[root.length() - 1] != Commons::FilePathSeparator)
+        root += Commons::FilePathSeparator;
+
+    VecString dir_list = Commons::GetFileList(root);
+    std::sort(dir_list.begin(), dir_list.end());
+    VecString sequence_names;
+    for (int i = 0; i < (int)dir_list.size(); ++i)
+    {
+        if (dir_list[i] == "." || dir_list[i] == "..") continue;
+        VecString csv_files = Commons::FilterFileList(Commons::GetFileList(root + dir_list[i]), Commons::CSVFileExtension);
+        if (!csv_files.empty())
+            sequence_names.push_back(dir_list[i]);
+    }
+    return sequence_names;
+}
+
+// Create the catalog entry of a loaded sequence
+Catalog::Entry Catalog::CreateEntry(Sequence &sequence)
+{
+    Entry entry;
+    entry.Name = sequence.Name;
+    entry.FaultTypes = ParseFaultTypes(sequence.Name);
+
+    // Find the time bounds and the fault onset over the topics (the message list may follow the header stamps)
+    const DateTime *first = nullptr;
+    const DateTime *last = nullptr;
+    for (const Topic &topic : sequence.Topics)
+    {
+        if (topic.Messages.empty())
+            continue;
+        const DateTime &front = topic.Messages.front().DateTime;
+        const DateTime &back = topic.Messages.back().DateTime;
+        if (!first || front.ToEpochNanoseconds() < first->ToEpochNanoseconds()) first = &front;
+        if (!last || back.ToEpochNanoseconds() > last->ToEpochNanoseconds()) last = &back;
+        if (topic.IsFaultTopic() && (entry.FaultOnset < 0 || front.ToEpochNanoseconds() < entry.FaultOnset))
+            entry.FaultOnset = front.ToEpochNanoseconds();
+    }
+    if (first)
+    {
+        entry.StartTime = first->ToEpochNanoseconds();
+        entry.EndTime = last->ToEpochNanoseconds();
+        entry.TotalDuration = *last - *first;
+
+        // Find the normal flight duration (until the last message before the fault onset)
+        entry.NormalFlightDuration = entry.TotalDuration;
+        if (entry.FaultOnset >= 0)
+        {
+            const DateTime *last_normal = nullptr;
+            for (const Topic &topic : sequence.Topics)
+            {
+                auto it = std::lower_bound(topic.Messages.begin(), topic.Messages.end(), entry.FaultOnset,
+                    [](const Message &msg, long long time) { return msg.DateTime.ToEpochNanoseconds() < time; });
+                if (it == topic.Messages.begin())
+                    continue;
+                const DateTime &candidate = (it - 1)->DateTime;
+                if (!last_normal || candidate.ToEpochNanoseconds() > last_normal->ToEpochNanoseconds())
+                    last_normal = &candidate;
+            }
+            entry.NormalFlightDuration = last_normal ? *last_normal - *first : 0;
+        }
+    }
+
+    // Keep the topic list with their sizes and time bounds
+    for (int i = 0; i < (int)sequence.Topics.size(); ++i)
+    {
+        const Topic &topic = sequence.Topics[i];
+        TopicInfo info;
+        info.Name = topic.Name;
+        info.MessageCount = topic.Messages.size();
+        if (!topic.Messages.empty())
+        {
+            info.StartTime = topic.Messages.front().DateTime.ToEpochNanoseconds();
+            info.EndTime = topic.Messages.back().DateTime.ToEpochNanoseconds();
+        }
+        entry.Topics.push_back(info);
+
+        if (sequence.Topics[i].IsFaultTopic())
+            entry.FaultTopics.push_back(topic.Name);
+    }
+
+    return entry;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Get the full path of the catalog file
+std::string Catalog::GetFilePath(const std::string &filename) const
+{
+    if (filename.empty()) return RootPath + DefaultFileName;
+    return filename;
+}
+
+// Check if the pattern is a substring of any of the names
+bool Catalog::MatchesAny(const VecString &names, const std::string &pattern)
+{
+    for (int i = 0; i < (int)names.size(); ++i)
+        if (names[i].find(pattern) != std::string::npos)
+            return true;
+    return false;
+}
+
+}
+#endif
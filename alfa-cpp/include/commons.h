@@ -33,14 +33,22 @@
 #include <ctime>
 #include <cstdlib>
 #include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstring>
 
 // Define different headers for Windows and Unix-based systems
 #if defined _WIN32 || defined __CYGWIN__
 #define NOMINMAX 
 #include <windows.h>
+#include <direct.h>
 #else
 #include <dirent.h>
+#include <sys/stat.h>
 #endif
+#include <cerrno>
 
 
 namespace alfa
@@ -67,9 +75,27 @@ namespace alfa
 		static bool StringToLongLong(const std::string &str, long long &out_number);
 		static bool StringToDouble(const std::string &str, double &out_number);
 		static bool StringToLongDouble(const std::string &str, long double &out_number);
+		static std::string DoubleToString(double number);
 		static VecString GetFileList(const std::string &dir_path);
 		static VecString FilterFileList(const VecString &file_list, const std::string &extension, const bool remove_extension = false);
 		static bool ExtractFilenameAndExtension(const std::string &file_path, std::string &out_filename, std::string &out_extension, std::string &out_directory);
+		static bool MakeDirectory(const std::string &dir_path);
+		static bool ReadFileToString(const std::string &filename, std::string &out_content);
+		static size_t CountCharacter(const std::string &input, const char ch);
+		static std::string EscapeJSON(const std::string &str);
+		static void AppendJSONString(std::string &out, const std::string &str);
+
+		static int GetThreadCount(int n_threads, int n_tasks);
+		static void ParallelFor(int n_tasks, int n_threads, const std::function<void(int)> &task);
+
+		// Binary serialization helpers (values are written in the native byte order)
+		template <typename T> static void WriteBinary(std::ostream &os, const T &value);
+		template <typename T> static bool ReadBinary(std::istream &is, T &out_value);
+		template <typename T> static void WriteBinaryVector(std::ostream &os, const std::vector<T> &values);
+		template <typename T> static bool ReadBinaryVector(std::istream &is, std::vector<T> &out_values);
+		static void WriteBinaryString(std::ostream &os, const std::string &str);
+		static bool ReadBinaryString(std::istream &is, std::string &out_str);
+		static long long GetRemainingSize(std::istream &is);
 	};
 
 	/******************************************************************************/
@@ -99,16 +125,19 @@ namespace alfa
 	// Break a string into smaller tokens using a delimiter
 	std::vector<std::string> Commons::Tokenize(const std::string &input, const char delim)
 	{
-		// Vector of string to save tokens 
+		// Vector of string to save tokens (allocated once)
 		std::vector<std::string> tokens;
+		tokens.reserve(std::count(input.begin(), input.end(), delim) + 1);
 
-		// Define the input string stream and the temporary string
-		std::istringstream iss(input);
-		std::string tempstr;
-
-		// Break into the tokens
-		while (std::getline(iss, tempstr, delim))
-			tokens.push_back(tempstr);
+		// Break into the tokens. Like reading with getline, an empty string or a trailing delimiter adds no token.
+		size_t start = 0;
+		while (start < input.length())
+		{
+			size_t end = input.find(delim, start);
+			if (end == std::string::npos) end = input.length();
+			tokens.emplace_back(input, start, end - start);
+			start = end + 1;
+		}
 
 		return tokens;
 	}
@@ -163,6 +192,19 @@ namespace alfa
 		return true;
 	}
 
+	// Convert a double to its text in the topic files. Uses the fewest significant digits (up to 17) that read back
+	// as the same double, so no digits of the value are lost.
+	std::string Commons::DoubleToString(double number)
+	{
+		char buffer[32];
+		for (int precision = 15; precision <= 17; ++precision)
+		{
+			snprintf(buffer, sizeof(buffer), "%.*g", precision, number);
+			if (precision == 17 || std::strtod(buffer, NULL) == number) break;
+		}
+		return buffer;
+	}
+
 	// Convert a string to a long double. Returns false if the string is not exactly a long double.
 	bool Commons::StringToLongDouble(const std::string &str, long double &out_number)
 	{
@@ -252,6 +294,81 @@ namespace alfa
 		}
 	}
 
+	// Create a directory (its parent should exist). Returns true if the directory exists afterwards.
+	bool Commons::MakeDirectory(const std::string &dir_path)
+	{
+#if defined _WIN32 || defined __CYGWIN__
+		if (_mkdir(dir_path.c_str()) == 0 || errno == EEXIST) return true;
+#else
+		if (mkdir(dir_path.c_str(), 0755) == 0 || errno == EEXIST) return true;
+#endif
+		std::cerr << "Failed to create '" << dir_path << "' directory." << std::endl;
+		return false;
+	}
+
+	// Read the whole content of a file into a string. Returns false if the file could not be read.
+	bool Commons::ReadFileToString(const std::string &filename, std::string &out_content)
+	{
+		out_content.clear();
+		std::ifstream ifs(filename, std::ios::binary);
+		if (!ifs.is_open()) return false;
+
+		// Allocate the string once using the file size
+		ifs.seekg(0, std::ios::end);
+		std::streamoff size = ifs.tellg();
+		if (size < 0) return false;
+		ifs.seekg(0, std::ios::beg);
+		out_content.resize((size_t)size);
+		if (size > 0) ifs.read(&out_content[0], size);
+
+		return ifs.gcount() == size || size == 0;
+	}
+
+	// Count the occurrences of a character in a string (memchr is vectorized in the common C libraries)
+	size_t Commons::CountCharacter(const std::string &input, const char ch)
+	{
+		size_t count = 0;
+		const char *p = input.data(), *end = input.data() + input.size();
+		while ((p = static_cast<const char *>(std::memchr(p, ch, end - p))) != NULL)
+		{
+			++count;
+			++p;
+		}
+		return count;
+	}
+
+	// Convert a string to a quoted JSON string
+	std::string Commons::EscapeJSON(const std::string &str)
+	{
+		std::string result;
+		result.reserve(str.size() + 2);
+		AppendJSONString(result, str);
+		return result;
+	}
+
+	// Append a string as a quoted JSON string (the control characters are escaped)
+	void Commons::AppendJSONString(std::string &out, const std::string &str)
+	{
+		static const char hex_digits[] = "0123456789abcdef";
+		out += '"';
+		for (size_t i = 0; i < str.size(); ++i)
+		{
+			unsigned char ch = str[i];
+			if (ch == '"' || ch == '\\') { out += '\\'; out += ch; }
+			else if (ch == '\n') out += "\\n";
+			else if (ch == '\r') out += "\\r";
+			else if (ch == '\t') out += "\\t";
+			else if (ch < 0x20)
+			{
+				out += "\\u00";
+				out += hex_digits[ch >> 4];
+				out += hex_digits[ch & 0xF];
+			}
+			else out += ch;
+		}
+		out += '"';
+	}
+
 	// Return the list of files in the input list that have the desired extension
 	VecString Commons::FilterFileList(const VecString &file_list, const std::string &extension, const bool remove_extension)
 	{
@@ -282,10 +399,107 @@ namespace alfa
 		return filtered_list;
 	}
 
+	// Get the number of threads to use for the given number of tasks (all the cores if n_threads is not positive)
+	int Commons::GetThreadCount(int n_threads, int n_tasks)
+	{
+		if (n_threads <= 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+		return std::max(1, std::min(n_threads, n_tasks));
+	}
+
+	// Run the task for the indices 0 to n_tasks - 1 on a pool of threads. Each thread takes the next unprocessed index.
+	void Commons::ParallelFor(int n_tasks, int n_threads, const std::function<void(int)> &task)
+	{
+		std::atomic<int> next_index(0);
+		auto worker = [&]()
+		{
+			for (int i = next_index++; i < n_tasks; i = next_index++)
+				task(i);
+		};
+
+		// Use the current thread as one of the workers
+		n_threads = GetThreadCount(n_threads, n_tasks);
+		std::vector<std::thread> threads;
+		for (int t = 1; t < n_threads; ++t)
+			threads.push_back(std::thread(worker));
+		worker();
+		for (int t = 0; t < (int)threads.size(); ++t)
+			threads[t].join();
+	}
+
+	// Write a plain value to a binary stream
+	template <typename T>
+	void Commons::WriteBinary(std::ostream &os, const T &value)
+	{
+		os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	// Read a plain value from a binary stream. Returns false if the stream ended.
+	template <typename T>
+	bool Commons::ReadBinary(std::istream &is, T &out_value)
+	{
+		return (bool)is.read(reinterpret_cast<char *>(&out_value), sizeof(T));
+	}
+
+	// Write a vector of plain values to a binary stream (prefixed by its size)
+	template <typename T>
+	void Commons::WriteBinaryVector(std::ostream &os, const std::vector<T> &values)
+	{
+		WriteBinary(os, (unsigned long long)values.size());
+		if (!values.empty())
+			os.write(reinterpret_cast<const char *>(&values[0]), values.size() * sizeof(T));
+	}
+
+	// Read a vector of plain values from a binary stream. Returns false if the stream ended
+	// (or if the stored size is larger than the rest of the stream, e.g. in a corrupt file).
+	template <typename T>
+	bool Commons::ReadBinaryVector(std::istream &is, std::vector<T> &out_values)
+	{
+		unsigned long long size;
+		if (!ReadBinary(is, size)) return false;
+		long long remaining = GetRemainingSize(is);
+		if (remaining >= 0 && size > (unsigned long long)remaining / sizeof(T)) return false;
+		out_values.resize(size);
+		if (size == 0) return true;
+		return (bool)is.read(reinterpret_cast<char *>(&out_values[0]), size * sizeof(T));
+	}
+
+	// Write a string to a binary stream (prefixed by its length)
+	void Commons::WriteBinaryString(std::ostream &os, const std::string &str)
+	{
+		WriteBinary(os, (unsigned int)str.size());
+		os.write(str.data(), str.size());
+	}
+
+	// Read a string from a binary stream. Returns false if the stream ended.
+	bool Commons::ReadBinaryString(std::istream &is, std::string &out_str)
+	{
+		unsigned int size;
+		if (!ReadBinary(is, size)) return false;
+		long long remaining = GetRemainingSize(is);
+		if (remaining >= 0 && size > (unsigned long long)remaining) return false;
+		out_str.resize(size);
+		if (size == 0) return true;
+		return (bool)is.read(&out_str[0], size);
+	}
+
+	// Get the number of the bytes left in a seekable binary stream. Returns -1 if the stream cannot seek.
+	long long Commons::GetRemainingSize(std::istream &is)
+	{
+		std::streampos pos = is.tellg();
+		if (pos == std::streampos(-1)) return -1;
+		is.seekg(0, std::ios::end);
+		std::streampos end = is.tellg();
+		is.seekg(pos);
+		if (end == std::streampos(-1) || !is) { is.clear(); is.seekg(pos); return -1; }
+		return (long long)(end - pos);
+	}
+
 	/******************************************************************************/
 	/********************** DateTime Class Definition *****************************/
 	/******************************************************************************/
 
+	// This class keeps a date and time in UTC. The recorded times of the messages are converted exactly in both
+	// directions, so their epoch is the same on every machine.
 	class DateTime
 	{
 	public:
@@ -299,6 +513,8 @@ namespace alfa
 		bool operator!= (const DateTime &dt) const;
 		static DateTime StringToTime(const std::string &strdatetime, const std::string &format);
 		static DateTime EpochStringToTime(const std::string &epoch);
+		static DateTime EpochNanosecondsToTime(long long epoch_ns);
+		long long ToEpochNanoseconds() const;
 		std::string ToString() const;
 		double operator-(const DateTime &dt) const;
 	};
@@ -367,20 +583,8 @@ namespace alfa
 	// Overload the - operator for DateTime to calculate the duration between two DateTimes in seconds.
 	double DateTime::operator-(const DateTime &dt) const
 	{
-		// Convert DateTime to the standard time representation
-		struct std::tm a = { this->Second, this->Minute, this->Hour, this->Day, this->Month, this->Year - 1900 };
-		struct std::tm b = { dt.Second, dt.Minute, dt.Hour, dt.Day, dt.Month, dt.Year - 1900 };
-		std::time_t x = std::mktime(&a);
-		std::time_t y = std::mktime(&b);
-
-		// Check if conversion was successful
-		if (x == (std::time_t)(-1) || y == (std::time_t)(-1))
-			return 0;
-
-		// Calculate the difference in seconds (also add the Nanoseconds)
-		double difference = std::difftime(x, y) + ((double)(this->Nanosecond - dt.Nanosecond)) / 1e9;
-
-		return difference;
+		// Subtract the exact epochs first, so the nanoseconds are not lost in a double
+		return (double)(this->ToEpochNanoseconds() - dt.ToEpochNanoseconds()) / 1e9;
 	}
 
 	// Convert a given string to a DateTime object given the specified format
@@ -398,49 +602,66 @@ namespace alfa
 	// Convert a given UNIX epoch string in nanoseconds to a DateTime object
 	DateTime DateTime::EpochStringToTime(const std::string &epoch)
 	{
-		DateTime dt;
-
-		// Get the nanoseconds substring (last 9 digits)
-		std::string nano_str;
-		if (epoch.size() < 9)
-			nano_str = epoch;
-		else
-			nano_str = epoch.substr(epoch.size() - 9, 9);
-
-		// Get the rest of the string (seconds in epoch)
-		std::string sec_str = epoch.substr(0, epoch.size() - nano_str.size());
-
-		// Read the nanoseconds
-		if (!Commons::StringToInt(nano_str, dt.Nanosecond))
+		// Read the whole epoch in nanoseconds
+		long long epoch_ns;
+		if (!Commons::StringToLongLong(epoch, epoch_ns))
 			return DateTime();
 
-		// Get the epoch seconds
-		long long secs;
-		if (!Commons::StringToLongLong(sec_str, secs))
-			return DateTime();
-
-		// Convert the seconds to time_t structure
-		std::time_t time = secs;
-
-		// Convert time_t structure to DateTime
-		std::tm *temp_tm;
+		return EpochNanosecondsToTime(epoch_ns);
+	}
 
-		//Set local dst fields of struct tm ?
-		std::time_t tvsec = std::time(NULL);
-		temp_tm = localtime(&tvsec);
+	// Convert a given UNIX epoch in nanoseconds to a DateTime object (in UTC). The conversion is exact and does
+	// not depend on the time zone of the machine, so it has no repeated hour and takes no lock of the C library.
+	DateTime DateTime::EpochNanosecondsToTime(long long epoch_ns)
+	{
+		DateTime dt;
 
-		// Perform the conversion
-		temp_tm = localtime(&time);
-		dt.Year = 1900 + temp_tm->tm_year;
-		dt.Month = temp_tm->tm_mon + 1;
-		dt.Day = temp_tm->tm_mday;
-		dt.Hour = temp_tm->tm_hour;
-		dt.Minute = temp_tm->tm_min;
-		dt.Second = temp_tm->tm_sec;
+		// Split the epoch into days, seconds of the day and nanoseconds (rounded down for the times before 1970)
+		long long seconds = epoch_ns / 1000000000LL, nanoseconds = epoch_ns % 1000000000LL;
+		if (nanoseconds < 0) { nanoseconds += 1000000000LL; --seconds; }
+		long long days = seconds / 86400, day_seconds = seconds % 86400;
+		if (day_seconds < 0) { day_seconds += 86400; --days; }
+
+		// Convert the days to the civil date (proleptic Gregorian calendar, with the years starting in March)
+		days += 719468;
+		long long era = (days >= 0 ? days : days - 146096) / 146097;
+		long long day_of_era = days - era * 146097;
+		long long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+		long long day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+		long long month_index = (5 * day_of_year + 2) / 153;
+		dt.Day = (int)(day_of_year - (153 * month_index + 2) / 5 + 1);
+		dt.Month = (int)(month_index < 10 ? month_index + 3 : month_index - 9);
+		dt.Year = (int)(year_of_era + era * 400 + (dt.Month <= 2 ? 1 : 0));
+
+		dt.Hour = (int)(day_seconds / 3600);
+		dt.Minute = (int)(day_seconds % 3600 / 60);
+		dt.Second = (int)(day_seconds % 60);
+		dt.Nanosecond = (int)nanoseconds;
 
 		return dt;
 	}
 
+	// Convert the DateTime (in UTC) back to the UNIX epoch in nanoseconds. The fields out of their ranges are
+	// carried over (e.g. month 13 is January of the next year).
+	long long DateTime::ToEpochNanoseconds() const
+	{
+		// Carry the months over to the years and start the years in March (so the leap day is the last day)
+		long long year = Year, month = Month - 1;
+		year += (month >= 0 ? month : month - 11) / 12;
+		month -= ((month >= 0 ? month : month - 11) / 12) * 12;
+		if (month < 2) --year;
+
+		// Count the days from 1970/01/01 to the first day of the month
+		long long era = (year >= 0 ? year : year - 399) / 400;
+		long long year_of_era = year - era * 400;
+		long long day_of_year = (153 * (month < 2 ? month + 10 : month - 2) + 2) / 5;
+		long long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+		long long days = era * 146097 + day_of_era - 719468 + (Day - 1);
+
+		long long seconds = days * 86400 + (long long)Hour * 3600 + (long long)Minute * 60 + Second;
+		return seconds * 1000000000LL + Nanosecond;
+	}
+
 	// Convert DateTime object to string
 	std::string DateTime::ToString() const
 	{
@@ -0,0 +1,394 @@
+/*  ***************************************************************************
+*   dataset_client.h - Header for the client of the dataset daemon.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_DATASET_CLIENT_H
+#define ALFA_DATASET_CLIENT_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cstring>
+#include "commons.h"
+#include "catalog.h"
+#include "dataset_protocol.h"
+
+namespace alfa
+{
+
+class DatasetClient;
+
+// This class is a topic of a sequence kept by the dataset daemon. Like Topic, it has the name, the field labels
+// and the number of the messages, but the values are requested from the daemon when they are read.
+class RemoteTopic
+{
+public:
+    // Data Members
+    std::string Name;
+    VecString FieldLabels;
+    long long MessageCount = 0;
+    long long StartTime = 0;        // Recorded time of the first message (epoch nanoseconds)
+    long long EndTime = 0;          // Recorded time of the last message (epoch nanoseconds)
+
+    // Member Functions
+    int FindLabelIndex(const std::string &label) const;
+    std::vector<double> GetFieldsAsDouble(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<DateTime> GetTimes(int start_msg_index = 0, int n_messages = -1) const;
+
+private:
+    // Data Members
+    DatasetClient *client = nullptr;
+    std::string sequence_name;
+    friend class DatasetClient;
+};
+
+// This class is a sequence kept by the dataset daemon, with the same lookups as Sequence
+class RemoteSequence
+{
+public:
+    // Data Members
+    std::string Name = "N/A";
+    std::vector<RemoteTopic> Topics;
+
+    // Member Functions
+    bool IsInitialized() const;
+    int FindTopicIndex(const std::string &topic_name) const;
+};
+
+// This class connects to the dataset daemon (see DatasetServer) and runs the queries on the sequences it keeps
+// loaded. The rows come as contiguous columns: the recording times and the values of each requested field. The
+// columns are read in place from the response (the shared memory mapped from the daemon for the large ones).
+// A client is a single connection, so it should not be used by several threads at the same time.
+class DatasetClient
+{
+public:
+
+    // Local struct definitions
+    struct Rows                     // Rows of some fields of a topic (a view of the response, which it keeps mapped)
+    {
+        long long FirstRow = 0;     // Index of the first row in the topic
+        long long NRows = 0;
+        int NFields = 0;
+        const long long *Times = nullptr;   // Recording times (epoch nanoseconds)
+        const double *Values = nullptr;     // Values of each field after each other (NaN if not numeric)
+
+        const double *GetColumn(int field_idx) const { return Values + field_idx * NRows; }
+
+    private:
+        std::shared_ptr<const DatasetProtocol::Response> response;
+        friend class DatasetClient;
+    };
+
+    // Constructors & Deconstructors
+    DatasetClient() {}
+    ~DatasetClient();
+    DatasetClient(const DatasetClient &) = delete;
+    DatasetClient &operator=(const DatasetClient &) = delete;
+
+    // Member Functions
+    bool Connect(const std::string &socket_path = DatasetProtocol::DefaultSocketPath);
+    void Close();
+    bool IsConnected() const;
+    const std::string &GetLastError() const;
+
+    bool Ping(unsigned int &out_version);
+    bool ListSequences(const Catalog::Filter &filter, std::vector<Catalog::Entry> &out_entries);
+    bool OpenSequence(const std::string &sequence_name, RemoteSequence &out_sequence);
+    bool GetRowSlice(const std::string &sequence_name, const std::string &topic_name, const VecString &field_labels,
+        long long start_row, long long n_rows, Rows &out_rows);
+    bool GetTimeRange(const std::string &sequence_name, const std::string &topic_name, const VecString &field_labels,
+        long long start_time, long long end_time, Rows &out_rows);
+    bool GetWindow(const std::string &sequence_name, const std::string &topic_name, const VecString &field_labels,
+        long long start_time, long long n_rows, Rows &out_rows);
+    bool GetStats(std::vector<std::pair<std::string, unsigned long long> > &out_stats);
+
+private:
+    // Member Functions
+    bool Request(DatasetProtocol::RequestType type, const std::string &payload);
+    bool RequestRows(DatasetProtocol::RequestType type, const std::string &sequence_name, const std::string &topic_name,
+        const VecString &field_labels, long long first, long long second, Rows &out_rows);
+    bool InvalidResponse();
+
+    // Data Members
+    int socket_fd = -1;
+    std::string last_error;
+    std::shared_ptr<DatasetProtocol::Response> response;     // Last response (may be kept by the rows read from it)
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Find the index of a field label (-1 if not found)
+int RemoteTopic::FindLabelIndex(const std::string &label) const
+{
+    for (int i = 0; i < (int)FieldLabels.size(); ++i)
+        if (FieldLabels[i] == label)
+            return i;
+    return -1;
+}
+
+// Get the values of a field of the messages (empty if the request fails)
+std::vector<double> RemoteTopic::GetFieldsAsDouble(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    DatasetClient::Rows rows;
+    if (!client || !client->GetRowSlice(sequence_name, Name, VecString(1, field_label), start_msg_index, n_messages, rows))
+        return std::vector<double>();
+    return std::vector<double>(rows.Values, rows.Values + rows.NRows);
+}
+
+// Get the recording times of the messages (empty if the request fails)
+std::vector<DateTime> RemoteTopic::GetTimes(int start_msg_index, int n_messages) const
+{
+    DatasetClient::Rows rows;
+    std::vector<DateTime> result;
+    if (!client || !client->GetRowSlice(sequence_name, Name, VecString(), start_msg_index, n_messages, rows)) return result;
+    result.reserve(rows.NRows);
+    for (long long i = 0; i < rows.NRows; ++i)
+        result.push_back(DateTime::EpochNanosecondsToTime(rows.Times[i]));
+    return result;
+}
+
+// Check if the sequence is received from the daemon
+bool RemoteSequence::IsInitialized() const
+{
+    return !Topics.empty();
+}
+
+// Find the index of a topic by its name (-1 if not found)
+int RemoteSequence::FindTopicIndex(const std::string &topic_name) const
+{
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        if (Topics[i].Name == topic_name)
+            return i;
+    return -1;
+}
+
+// Deconstructor function for DatasetClient
+DatasetClient::~DatasetClient()
+{
+    Close();
+}
+
+// Connect to the socket of the daemon
+bool DatasetClient::Connect(const std::string &socket_path)
+{
+    Close();
+    socket_fd = DatasetProtocol::Connect(socket_path);
+    if (socket_fd < 0)
+    {
+        last_error = "Failed to connect to the dataset daemon at '" + socket_path + "'.";
+        return false;
+    }
+    return true;
+}
+
+// Close the connection
+void DatasetClient::Close()
+{
+    response.reset();
+    if (socket_fd >= 0) close(socket_fd);
+    socket_fd = -1;
+}
+
+// Check if the client is connected
+bool DatasetClient::IsConnected() const
+{
+    return socket_fd >= 0;
+}
+
+// Get the message of the last failed request
+const std::string &DatasetClient::GetLastError() const
+{
+    return last_error;
+}
+
+// Get the version of the protocol of the daemon
+bool DatasetClient::Ping(unsigned int &out_version)
+{
+    if (!Request(DatasetProtocol::Ping, "")) return false;
+    DatasetProtocol::Reader reader(response->Meta.data(), response->Meta.size());
+    return reader.Read(out_version) || InvalidResponse();
+}
+
+// Get the catalog entries of the sequences that match the filter
+bool DatasetClient::ListSequences(const Catalog::Filter &filter, std::vector<Catalog::Entry> &out_entries)
+{
+    // Send the filter
+    DatasetProtocol::Writer writer;
+    writer.Write((unsigned char)filter.Presence);
+    writer.WriteStrings(filter.FaultTypes);
+    writer.WriteStrings(filter.RequiredTopics);
+    writer.Write(filter.MinDuration);
+    writer.Write(filter.MaxDuration);
+    writer.Write(filter.MinFaultDuration);
+    if (!Request(DatasetProtocol::ListSequences, writer.Bytes)) return false;
+
+    // Read the entries
+    DatasetProtocol::Reader reader(response->Meta.data(), response->Meta.size());
+    unsigned int n_entries;
+    if (!reader.Read(n_entries)) return InvalidResponse();
+    out_entries.assign(n_entries, Catalog::Entry());
+    for (unsigned int i = 0; i < n_entries; ++i)
+    {
+        Catalog::Entry &entry = out_entries[i];
+        unsigned int n_topics;
+        if (!reader.ReadString(entry.Name) || !reader.ReadStrings(entry.FaultTypes) || !reader.ReadStrings(entry.FaultTopics) ||
+            !reader.Read(entry.StartTime) || !reader.Read(entry.EndTime) || !reader.Read(entry.FaultOnset) ||
+            !reader.Read(entry.TotalDuration) || !reader.Read(entry.NormalFlightDuration) || !reader.Read(n_topics) ||
+            n_topics > reader.Remaining())
+            return InvalidResponse();
+        entry.Topics.resize(n_topics);
+        for (unsigned int t = 0; t < n_topics; ++t)
+            if (!reader.ReadString(entry.Topics[t].Name) || !reader.Read(entry.Topics[t].MessageCount) ||
+                !reader.Read(entry.Topics[t].StartTime) || !reader.Read(entry.Topics[t].EndTime))
+                return InvalidResponse();
+    }
+    return true;
+}
+
+// Get the topics of a sequence (the daemon loads the sequence if it is not loaded)
+bool DatasetClient::OpenSequence(const std::string &sequence_name, RemoteSequence &out_sequence)
+{
+    DatasetProtocol::Writer writer;
+    writer.WriteString(sequence_name);
+    if (!Request(DatasetProtocol::GetSequenceInfo, writer.Bytes)) return false;
+
+    DatasetProtocol::Reader reader(response->Meta.data(), response->Meta.size());
+    unsigned int n_topics;
+    if (!reader.ReadString(out_sequence.Name) || !reader.Read(n_topics) || n_topics > reader.Remaining()) return InvalidResponse();
+    out_sequence.Topics.assign(n_topics, RemoteTopic());
+    for (unsigned int t = 0; t < n_topics; ++t)
+    {
+        RemoteTopic &topic = out_sequence.Topics[t];
+        if (!reader.ReadString(topic.Name) || !reader.ReadStrings(topic.FieldLabels) || !reader.Read(topic.MessageCount) ||
+            !reader.Read(topic.StartTime) || !reader.Read(topic.EndTime))
+            return InvalidResponse();
+        topic.client = this;
+        topic.sequence_name = out_sequence.Name;
+    }
+    return true;
+}
+
+// Get the rows of the fields of a topic by their indices (all the rows after the start if the number is negative)
+bool DatasetClient::GetRowSlice(const std::string &sequence_name, const std::string &topic_name, const VecString &field_labels,
+    long long start_row, long long n_rows, Rows &out_rows)
+{
+    return RequestRows(DatasetProtocol::GetRowSlice, sequence_name, topic_name, field_labels, start_row, n_rows, out_rows);
+}
+
+// Get the rows of the fields of a topic recorded in [start_time, end_time) (epoch nanoseconds)
+bool DatasetClient::GetTimeRange(const std::string &sequence_name, const std::string &topic_name, const VecString &field_labels,
+    long long start_time, long long end_time, Rows &out_rows)
+{
+    return RequestRows(DatasetProtocol::GetTimeRange, sequence_name, topic_name, field_labels, start_time, end_time, out_rows);
+}
+
+// Get a number of rows of the fields of a topic from the first row recorded at or after the start time
+bool DatasetClient::GetWindow(const std::string &sequence_name, const std::string &topic_name, const VecString &field_labels,
+    long long start_time, long long n_rows, Rows &out_rows)
+{
+    return RequestRows(DatasetProtocol::GetWindow, sequence_name, topic_name, field_labels, start_time, n_rows, out_rows);
+}
+
+// Get the statistics of the daemon as names and values
+bool DatasetClient::GetStats(std::vector<std::pair<std::string, unsigned long long> > &out_stats)
+{
+    if (!Request(DatasetProtocol::GetStats, "")) return false;
+    DatasetProtocol::Reader reader(response->Meta.data(), response->Meta.size());
+    unsigned int n_stats;
+    if (!reader.Read(n_stats) || n_stats > reader.Remaining()) return InvalidResponse();
+    out_stats.resize(n_stats);
+    for (unsigned int i = 0; i < n_stats; ++i)
+        if (!reader.ReadString(out_stats[i].first) || !reader.Read(out_stats[i].second)) return InvalidResponse();
+    return true;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Send a request and receive its response (the error message is kept if the daemon reports an error)
+bool DatasetClient::Request(DatasetProtocol::RequestType type, const std::string &payload)
+{
+    if (socket_fd < 0)
+    {
+        last_error = "Not connected to the dataset daemon.";
+        return false;
+    }
+
+    // Receive into a new response if the rows of the last one are still read
+    if (!response || response.use_count() > 1)
+        response = std::make_shared<DatasetProtocol::Response>();
+    if (!DatasetProtocol::SendRequest(socket_fd, type, payload) || !DatasetProtocol::ReceiveResponse(socket_fd, *response))
+    {
+        last_error = "Connection to the dataset daemon is lost.";
+        Close();
+        return false;
+    }
+    if (response->ResponseStatus != DatasetProtocol::Ok)
+    {
+        last_error = response->Meta;
+        return false;
+    }
+    return true;
+}
+
+// Request the rows of the fields of a topic. The rows point into the response and keep it.
+bool DatasetClient::RequestRows(DatasetProtocol::RequestType type, const std::string &sequence_name, const std::string &topic_name,
+    const VecString &field_labels, long long first, long long second, Rows &out_rows)
+{
+    DatasetProtocol::Writer writer;
+    writer.WriteString(sequence_name);
+    writer.WriteString(topic_name);
+    writer.WriteStrings(field_labels);
+    writer.Write(first);
+    writer.Write(second);
+    if (!Request(type, writer.Bytes)) return false;
+
+    // Read the sizes and check them against the data
+    DatasetProtocol::Reader meta(response->Meta.data(), response->Meta.size());
+    unsigned int n_fields;
+    if (!meta.Read(out_rows.NRows) || !meta.Read(n_fields) || !meta.Read(out_rows.FirstRow) || out_rows.NRows < 0 ||
+        response->DataSize != (size_t)out_rows.NRows * (1 + n_fields) * sizeof(double))
+        return InvalidResponse();
+    out_rows.NFields = n_fields;
+
+    // Point to the times and the values in the data of the response (the data starts at a page of the shared memory
+    // or at the buffer of a string, so the columns are aligned for their values)
+    out_rows.response = response;
+    out_rows.Times = (const long long *)response->Data;
+    out_rows.Values = (const double *)(response->Data + out_rows.NRows * sizeof(long long));
+    return true;
+}
+
+// Keep the error of a response that could not be read
+bool DatasetClient::InvalidResponse()
+{
+    last_error = "Invalid response from the dataset daemon.";
+    return false;
+}
+
+}
+#endif
@@ -0,0 +1,456 @@
+/*  ***************************************************************************
+*   dataset_protocol.h - Header for the protocol of the dataset daemon.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_DATASET_PROTOCOL_H
+#define ALFA_DATASET_PROTOCOL_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <atomic>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "commons.h"
+
+namespace alfa
+{
+
+// This class defines the binary protocol between the dataset daemon and its clients over a Unix domain socket.
+// Each request is a frame with a type and a payload. Each response is a frame with a status, a small metadata
+// part (the sizes, the names, or the error message) and a data part (the arrays). A large data part is written
+// in place to an unlinked shared memory object, whose descriptor is passed with the response (SCM_RIGHTS), so the
+// arrays are not copied through the socket and nothing is left behind if either side exits. The receiver reads
+// the arrays from the mapped object.
+// The values are in the byte order of the machine, since both sides run on the same machine.
+class DatasetProtocol
+{
+public:
+
+    // Local enum and struct definitions
+    enum RequestType : unsigned char
+    {
+        Ping = 1,               // Returns the version of the protocol
+        ListSequences,          // Catalog filter -> catalog entries of the matching sequences
+        GetSequenceInfo,        // Sequence name -> topics with their field labels, counts and time ranges
+        GetRowSlice,            // Rows of the fields of a topic by their indices (start row, number of rows)
+        GetTimeRange,           // Rows of the fields of a topic in a time range (start time, end time)
+        GetWindow,              // Rows of the fields of a topic from a time (start time, number of rows)
+        GetStats                // Statistics of the daemon
+    };
+
+    enum Status : unsigned char { Ok = 0, Error = 1 };
+
+    struct Response
+    {
+        Status ResponseStatus = Ok;
+        std::string Meta;
+        const char *Data = nullptr;     // Points to the shared memory or to InlineData
+        size_t DataSize = 0;
+        std::string InlineData;
+
+        Response() {}
+        ~Response();
+        Response(const Response &) = delete;
+        Response &operator=(const Response &) = delete;
+        void Release();
+
+    private:
+        void *mapped = nullptr;         // Mapped shared memory (if the data came through it)
+        size_t mapped_size = 0;
+        friend class DatasetProtocol;
+    };
+
+    class ResponseData                  // Data part of a response to be written in place before it is sent
+    {
+    public:
+        ResponseData(size_t size = 0, size_t shared_memory_threshold = 0);
+        ~ResponseData();
+        ResponseData(const ResponseData &) = delete;
+        ResponseData &operator=(const ResponseData &) = delete;
+        char *GetData() { return data; }
+        size_t GetSize() const { return size; }
+        bool IsShared() const { return shm_fd >= 0; }
+
+    private:
+        char *data = nullptr;           // Points to the mapped shared memory (for the large data) or to the buffer
+        size_t size = 0;
+        int shm_fd = -1;
+        std::vector<char> buffer;
+        friend class DatasetProtocol;
+    };
+
+    class Writer                        // Appends the values to a byte string
+    {
+    public:
+        std::string Bytes;
+        template <typename T> void Write(const T &value) { Bytes.append((const char *)&value, sizeof(T)); }
+        void WriteString(const std::string &str);
+        void WriteStrings(const VecString &strs);
+    };
+
+    class Reader                        // Reads the values from a byte string (fails at the end of the string)
+    {
+    public:
+        Reader(const char *data, size_t size) : data(data), size(size) {}
+        template <typename T> bool Read(T &out_value);
+        bool ReadString(std::string &out_str);
+        bool ReadStrings(VecString &out_strs);
+        bool ReadArray(void *out_values, size_t n_bytes);
+        size_t Remaining() const { return size - pos; }
+
+    private:
+        const char *data;
+        size_t size, pos = 0;
+    };
+
+    // Data Members
+    static const unsigned int Version = 1;
+    static const size_t MaxFrameSize = (size_t)1 << 31;
+    static const std::string DefaultSocketPath;
+
+    // Member Functions
+    static bool SendRequest(int socket_fd, RequestType type, const std::string &payload);
+    static bool ReceiveRequest(int socket_fd, RequestType &out_type, std::string &out_payload);
+    static bool SendResponse(int socket_fd, Status status, const std::string &meta, const ResponseData &data = ResponseData());
+    static bool ReceiveResponse(int socket_fd, Response &out_response);
+    static int Connect(const std::string &socket_path);
+
+private:
+    // Member Functions
+    static bool SendAll(int socket_fd, const char *data, size_t size, int fd_to_pass = -1);
+    static bool ReceiveAll(int socket_fd, char *data, size_t size, int *out_passed_fd = nullptr);
+    static int CreateSharedMemory(size_t size, void *&out_mapped);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Definition of the static data members
+const unsigned int DatasetProtocol::Version;
+const size_t DatasetProtocol::MaxFrameSize;
+const std::string DatasetProtocol::DefaultSocketPath = "/tmp/alfa-dataset.sock";
+
+// Deconstructor function for Response. Unmaps the shared memory.
+DatasetProtocol::Response::~Response()
+{
+    Release();
+}
+
+// Unmap the shared memory of the data (if any) and clear the data
+void DatasetProtocol::Response::Release()
+{
+    if (mapped) munmap(mapped, mapped_size);
+    mapped = nullptr;
+    mapped_size = 0;
+    Data = nullptr;
+    DataSize = 0;
+    InlineData.clear();
+}
+
+// Constructor function for ResponseData. Maps a new shared memory object for the data of the given size if it is at
+// least the threshold (or if it fails, allocates a buffer to send the data through the socket).
+DatasetProtocol::ResponseData::ResponseData(size_t size, size_t shared_memory_threshold)
+    : size(size)
+{
+    void *mapped = nullptr;
+    if (size > 0 && size >= shared_memory_threshold && (shm_fd = CreateSharedMemory(size, mapped)) >= 0)
+        data = (char *)mapped;
+    else if (size > 0)
+    {
+        buffer.resize(size);
+        data = &buffer[0];
+    }
+}
+
+// Deconstructor function for ResponseData. Unmaps and closes the shared memory (the receiver keeps its own mapping).
+DatasetProtocol::ResponseData::~ResponseData()
+{
+    if (shm_fd < 0) return;
+    munmap(data, size);
+    close(shm_fd);
+}
+
+// Append a string with its length
+void DatasetProtocol::Writer::WriteString(const std::string &str)
+{
+    Write((unsigned int)str.size());
+    Bytes += str;
+}
+
+// Append a list of strings with its size
+void DatasetProtocol::Writer::WriteStrings(const VecString &strs)
+{
+    Write((unsigned int)strs.size());
+    for (int i = 0; i < (int)strs.size(); ++i)
+        WriteString(strs[i]);
+}
+
+// Read a value
+template <typename T>
+bool DatasetProtocol::Reader::Read(T &out_value)
+{
+    return ReadArray(&out_value, sizeof(T));
+}
+
+// Read a string with its length
+bool DatasetProtocol::Reader::ReadString(std::string &out_str)
+{
+    unsigned int length;
+    if (!Read(length) || length > Remaining()) return false;
+    out_str.assign(data + pos, length);
+    pos += length;
+    return true;
+}
+
+// Read a list of strings with its size
+bool DatasetProtocol::Reader::ReadStrings(VecString &out_strs)
+{
+    unsigned int n_strs;
+    if (!Read(n_strs) || n_strs > Remaining()) return false;
+    out_strs.resize(n_strs);
+    for (unsigned int i = 0; i < n_strs; ++i)
+        if (!ReadString(out_strs[i])) return false;
+    return true;
+}
+
+// Read an array of bytes
+bool DatasetProtocol::Reader::ReadArray(void *out_values, size_t n_bytes)
+{
+    if (n_bytes > Remaining()) return false;
+    if (n_bytes > 0) std::memcpy(out_values, data + pos, n_bytes);
+    pos += n_bytes;
+    return true;
+}
+
+// Send a request frame: [payload size][type][payload]
+bool DatasetProtocol::SendRequest(int socket_fd, RequestType type, const std::string &payload)
+{
+    std::string frame;
+    unsigned int size = payload.size();
+    frame.append((const char *)&size, sizeof(size));
+    frame += (char)type;
+    frame += payload;
+    return SendAll(socket_fd, frame.data(), frame.size());
+}
+
+// Receive a request frame. Returns false if the connection is closed or the frame is not valid.
+bool DatasetProtocol::ReceiveRequest(int socket_fd, RequestType &out_type, std::string &out_payload)
+{
+    char header[sizeof(unsigned int) + 1];
+    if (!ReceiveAll(socket_fd, header, sizeof(header))) return false;
+    unsigned int size;
+    std::memcpy(&size, header, sizeof(size));
+    if (size > MaxFrameSize) return false;
+    out_type = (RequestType)header[sizeof(size)];
+    out_payload.resize(size);
+    return size == 0 || ReceiveAll(socket_fd, &out_payload[0], size);
+}
+
+// Send a response frame: [meta size][data size][status][data in shared memory][meta][data if not shared].
+// The data in the shared memory is passed with its descriptor (it was written there in place).
+bool DatasetProtocol::SendResponse(int socket_fd, Status status, const std::string &meta, const ResponseData &data)
+{
+    std::string frame;
+    unsigned int meta_size = meta.size();
+    unsigned long long size = data.size;
+    frame.append((const char *)&meta_size, sizeof(meta_size));
+    frame.append((const char *)&size, sizeof(size));
+    frame += (char)status;
+    frame += (char)data.IsShared();
+    frame += meta;
+    if (!data.IsShared() && data.size > 0) frame.append(data.data, data.size);
+
+    return SendAll(socket_fd, frame.data(), frame.size(), data.shm_fd);
+}
+
+// Receive a response frame (maps the shared memory of the data if it was passed)
+bool DatasetProtocol::ReceiveResponse(int socket_fd, Response &out_response)
+{
+    out_response.Release();
+
+    // Read the header (the descriptor of the shared memory comes with it)
+    char header[sizeof(unsigned int) + sizeof(unsigned long long) + 2];
+    int shm_fd = -1;
+    if (!ReceiveAll(socket_fd, header, sizeof(header), &shm_fd)) return false;
+    unsigned int meta_size;
+    unsigned long long data_size;
+    std::memcpy(&meta_size, header, sizeof(meta_size));
+    std::memcpy(&data_size, header + sizeof(meta_size), sizeof(data_size));
+    out_response.ResponseStatus = (Status)header[sizeof(meta_size) + sizeof(data_size)];
+    bool in_shared_memory = header[sizeof(meta_size) + sizeof(data_size) + 1] != 0;
+
+    // Read the metadata
+    bool received = meta_size <= MaxFrameSize;
+    out_response.Meta.resize(received ? meta_size : 0);
+    if (received && meta_size > 0) received = ReceiveAll(socket_fd, &out_response.Meta[0], meta_size);
+
+    // Map the data from the shared memory or read it from the socket
+    if (received && in_shared_memory)
+    {
+        void *mapped = shm_fd >= 0 ? mmap(nullptr, data_size, PROT_READ, MAP_SHARED, shm_fd, 0) : MAP_FAILED;
+        received = mapped != MAP_FAILED;
+        if (received)
+        {
+            out_response.mapped = mapped;
+            out_response.mapped_size = data_size;
+            out_response.Data = (const char *)mapped;
+            out_response.DataSize = data_size;
+        }
+    }
+    else if (received && data_size > 0)
+    {
+        received = data_size <= MaxFrameSize;
+        if (received)
+        {
+            out_response.InlineData.resize(data_size);
+            received = ReceiveAll(socket_fd, &out_response.InlineData[0], data_size);
+            out_response.Data = out_response.InlineData.data();
+            out_response.DataSize = data_size;
+        }
+    }
+
+    if (shm_fd >= 0) close(shm_fd);
+    return received;
+}
+
+// Connect to the socket of the daemon. Returns the socket descriptor (negative if it fails).
+int DatasetProtocol::Connect(const std::string &socket_path)
+{
+    struct sockaddr_un address;
+    if (socket_path.size() >= sizeof(address.sun_path)) return -1;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    int socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket_fd < 0) return -1;
+    if (connect(socket_fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(socket_fd);
+        return -1;
+    }
+    return socket_fd;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Send all the bytes (with a descriptor passed along the first byte if given)
+bool DatasetProtocol::SendAll(int socket_fd, const char *data, size_t size, int fd_to_pass)
+{
+    size_t sent = 0;
+    while (sent < size)
+    {
+        struct iovec io = { (void *)(data + sent), size - sent };
+        struct msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = &io;
+        message.msg_iovlen = 1;
+
+        // Attach the descriptor to the first part
+        char control[CMSG_SPACE(sizeof(int))];
+        if (fd_to_pass >= 0 && sent == 0)
+        {
+            std::memset(control, 0, sizeof(control));
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(cmsg), &fd_to_pass, sizeof(int));
+        }
+
+        ssize_t n = sendmsg(socket_fd, &message, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+// Receive exactly the given number of bytes (and the descriptor passed along them, if requested)
+bool DatasetProtocol::ReceiveAll(int socket_fd, char *data, size_t size, int *out_passed_fd)
+{
+    size_t received = 0;
+    while (received < size)
+    {
+        struct iovec io = { data + received, size - received };
+        struct msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = &io;
+        message.msg_iovlen = 1;
+        char control[CMSG_SPACE(sizeof(int))];
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t n = recvmsg(socket_fd, &message, MSG_CMSG_CLOEXEC);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        received += n;
+
+        // Keep the passed descriptor (or close it if not expected)
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg))
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                int fd;
+                std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+                if (out_passed_fd && *out_passed_fd < 0) *out_passed_fd = fd;
+                else close(fd);
+            }
+    }
+    return true;
+}
+
+// Create and map an unlinked shared memory object of the given size. Returns its descriptor (negative if it fails).
+int DatasetProtocol::CreateSharedMemory(size_t size, void *&out_mapped)
+{
+    // Create the object with a unique name and unlink it at once (it lives until the last descriptor is closed)
+    static std::atomic<unsigned long long> counter(0);
+    std::string name = "/alfa-" + std::to_string((long long)getpid()) + "-" + std::to_string(counter++);
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return -1;
+    shm_unlink(name.c_str());
+
+    // Map the object for writing the data
+    void *mapped = MAP_FAILED;
+    if (ftruncate(fd, size) == 0)
+        mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        close(fd);
+        return -1;
+    }
+    out_mapped = mapped;
+    return fd;
+}
+
+}
+#endif
@@ -0,0 +1,622 @@
+/*  ***************************************************************************
+*   dataset_server.h - Header for the daemon that keeps the dataset loaded.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_DATASET_SERVER_H
+#define ALFA_DATASET_SERVER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <poll.h>
+#include "commons.h"
+#include "sequence.h"
+#include "catalog.h"
+#include "dataset_protocol.h"
+#include "metrics.h"
+
+namespace alfa
+{
+
+// This class keeps the sequences of a dataset root loaded and serves the queries of the clients (see
+// DatasetClient) over a Unix domain socket, so the short-lived scripts do not load the same sequences again.
+// The sequences are loaded on their first query (or all at the start) and the numeric columns are converted
+// on their first query, and then kept. Each connection is served by its own thread, up to a maximum number of
+// connections (the next ones wait in the backlog of the socket until a connection closes). The server keeps its
+// metrics (request and load latencies, cache hits and misses, response sizes and memory use) for GetMetrics.
+class DatasetServer
+{
+public:
+
+    // Local struct definitions
+    struct Options
+    {
+        std::string SocketPath = DatasetProtocol::DefaultSocketPath;
+        size_t SharedMemoryThreshold = 64 * 1024;   // The larger responses are passed through the shared memory
+        int MaxLoadedSequences = 0;                 // The least recently used sequences are unloaded beyond it (0 for no limit)
+        int NThreads = 0;                           // Threads for building the catalog and preloading (all the cores if not positive)
+        int MaxConnections = 64;                    // Connections served at the same time (0 for no limit)
+    };
+
+    // Constructors & Deconstructors
+    DatasetServer();
+    DatasetServer(const Options &options);
+    ~DatasetServer();
+    DatasetServer(const DatasetServer &) = delete;
+    DatasetServer &operator=(const DatasetServer &) = delete;
+
+    // Member Functions
+    bool Open(const std::string &root_path);
+    bool Preload();
+    void Run();
+    void Stop();
+    const Catalog &GetCatalog() const;
+    Metrics &GetMetrics();
+
+private:
+    // Local struct definitions
+    struct LoadedSequence               // A loaded sequence with its decoded columns
+    {
+        Sequence Data;
+        std::vector<std::vector<long long> > Times;     // Recording times of each topic
+        std::vector<std::vector<std::shared_ptr<const std::vector<double> > > > Columns;  // Decoded fields of each topic
+        std::mutex ColumnsMutex;
+        unsigned long long LastUsed = 0;
+    };
+
+    // Member Functions
+    std::shared_ptr<LoadedSequence> GetSequence(const std::string &sequence_name, std::string &out_error);
+    std::shared_ptr<const std::vector<double> > GetColumn(LoadedSequence &sequence, int topic_idx, int field_idx);
+    void ServeConnection(int socket_fd);
+    void JoinFinishedThreads();
+    bool HandleRequest(int socket_fd, DatasetProtocol::RequestType type, const std::string &payload);
+    bool HandleRows(int socket_fd, DatasetProtocol::RequestType type, DatasetProtocol::Reader &reader);
+    bool SendError(int socket_fd, const std::string &message);
+    void RegisterMetrics();
+    static void WriteEntry(DatasetProtocol::Writer &writer, const Catalog::Entry &entry);
+
+    // Data Members
+    Options options;
+    Catalog catalog;
+    int listen_fd = -1;
+    std::atomic<bool> running;
+
+    std::mutex sequences_mutex;
+    std::map<std::string, std::shared_ptr<LoadedSequence> > sequences;
+    unsigned long long use_counter = 0;
+
+    std::mutex threads_mutex;
+    std::vector<std::thread> threads;
+    std::vector<std::thread::id> finished_threads;      // Threads that served their connection (to be joined)
+    std::vector<int> connections;
+    std::condition_variable connection_closed;
+
+    // Metrics (registered by the constructors, updated without locks)
+    Metrics metrics;
+    std::vector<Metrics::Counter *> request_counters;       // By the request type (0 for the unknown types)
+    std::vector<Metrics::Histogram *> request_durations;
+    Metrics::Counter *errors, *sequence_hits, *sequence_misses, *sequence_evictions, *column_hits, *column_misses;
+    Metrics::Counter *bytes_inline, *bytes_shared;
+    Metrics::Histogram *load_duration;
+    Metrics::Gauge *active_connections;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for DatasetServer with the default options
+DatasetServer::DatasetServer()
+    : running(false)
+{
+    RegisterMetrics();
+}
+
+// Constructor function for DatasetServer with the given options
+DatasetServer::DatasetServer(const Options &options)
+    : options(options), running(false)
+{
+    RegisterMetrics();
+}
+
+// Deconstructor function for DatasetServer. Closes the socket and waits for the connections.
+DatasetServer::~DatasetServer()
+{
+    Stop();
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        for (int i = 0; i < (int)connections.size(); ++i)
+            shutdown(connections[i], SHUT_RDWR);
+    }
+    for (int i = 0; i < (int)threads.size(); ++i)
+        if (threads[i].joinable())
+            threads[i].join();
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        unlink(options.SocketPath.c_str());
+    }
+}
+
+// Read (or build) the catalog of the dataset root and start listening on the socket
+bool DatasetServer::Open(const std::string &root_path)
+{
+    // Read the catalog file if it exists, or build it by loading every sequence once
+    std::string catalog_root = root_path;
+    if (catalog_root.empty() || catalog_root[catalog_root.length() - 1] != Commons::FilePathSeparator)
+        catalog_root += Commons::FilePathSeparator;
+    bool has_catalog = std::ifstream(catalog_root + Catalog::DefaultFileName).good();
+    if (!(has_catalog ? catalog.Load(root_path) : catalog.Build(root_path, options.NThreads))) return false;
+
+    // Create the socket (replacing a stale socket file of a previous daemon)
+    struct sockaddr_un address;
+    if (options.SocketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "DatasetServer Error! The socket path '" << options.SocketPath << "' is too long." << std::endl;
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, options.SocketPath.c_str(), sizeof(address.sun_path) - 1);
+    int probe_fd = DatasetProtocol::Connect(options.SocketPath);
+    if (probe_fd >= 0)
+    {
+        close(probe_fd);
+        std::cerr << "DatasetServer Error! Another daemon is listening on '" << options.SocketPath << "'." << std::endl;
+        return false;
+    }
+    unlink(options.SocketPath.c_str());
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 || bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listen_fd, 64) != 0)
+    {
+        std::cerr << "DatasetServer Error! Failed to listen on '" << options.SocketPath << "': " << std::strerror(errno) << std::endl;
+        if (listen_fd >= 0) close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    running = true;
+    return true;
+}
+
+// Load all the sequences of the catalog in parallel (up to the limit of the loaded sequences)
+bool DatasetServer::Preload()
+{
+    int n_sequences = catalog.Entries.size();
+    if (options.MaxLoadedSequences > 0) n_sequences = std::min(n_sequences, options.MaxLoadedSequences);
+    std::vector<char> loaded(n_sequences, 0);
+    Commons::ParallelFor(n_sequences, options.NThreads, [&](int i)
+    {
+        std::string error;
+        loaded[i] = (bool)GetSequence(catalog.Entries[i].Name, error);
+    });
+    return std::find(loaded.begin(), loaded.end(), 0) == loaded.end();
+}
+
+// Accept and serve the connections until Stop is called
+void DatasetServer::Run()
+{
+    while (running)
+    {
+        // Wait for a free connection slot and then for a connection (checking the stop request regularly)
+        {
+            std::unique_lock<std::mutex> lock(threads_mutex);
+            if (!connection_closed.wait_for(lock, std::chrono::milliseconds(200), [this]()
+                { return options.MaxConnections <= 0 || (int)connections.size() < options.MaxConnections; }))
+                continue;
+        }
+        struct pollfd poll_fd = { listen_fd, POLLIN, 0 };
+        if (poll(&poll_fd, 1, 200) <= 0 || !(poll_fd.revents & POLLIN)) continue;
+        int socket_fd = accept(listen_fd, nullptr, nullptr);
+        if (socket_fd < 0) continue;
+
+        // Serve the connection in its own thread (after joining the threads of the closed connections)
+        JoinFinishedThreads();
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        connections.push_back(socket_fd);
+        threads.push_back(std::thread(&DatasetServer::ServeConnection, this, socket_fd));
+    }
+}
+
+// Stop accepting the connections (can be called from a signal handler)
+void DatasetServer::Stop()
+{
+    running = false;
+}
+
+// Get the catalog of the dataset root
+const Catalog &DatasetServer::GetCatalog() const
+{
+    return catalog;
+}
+
+// Get the metrics of the server (e.g. for a MetricsExporter)
+Metrics &DatasetServer::GetMetrics()
+{
+    return metrics;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Get a loaded sequence (loads it on its first use and unloads the least recently used ones beyond the limit)
+std::shared_ptr<DatasetServer::LoadedSequence> DatasetServer::GetSequence(const std::string &sequence_name, std::string &out_error)
+{
+    // Return the sequence if it is loaded
+    {
+        std::lock_guard<std::mutex> lock(sequences_mutex);
+        std::map<std::string, std::shared_ptr<LoadedSequence> >::iterator it = sequences.find(sequence_name);
+        if (it != sequences.end())
+        {
+            it->second->LastUsed = ++use_counter;
+            sequence_hits->Increment();
+            return it->second;
+        }
+    }
+    sequence_misses->Increment();
+
+    // Load the sequence (without holding the lock, so the other sequences are served meanwhile)
+    int entry_idx = catalog.FindSequenceIndex(sequence_name);
+    if (entry_idx < 0)
+    {
+        out_error = "Sequence '" + sequence_name + "' is not in the catalog.";
+        return nullptr;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::shared_ptr<LoadedSequence> loaded = std::make_shared<LoadedSequence>();
+    if (!loaded->Data.LoadSequence(catalog.GetSequenceDirectory(entry_idx), sequence_name))
+    {
+        out_error = "Failed to load sequence '" + sequence_name + "'.";
+        return nullptr;
+    }
+
+    // Keep the recording times of each topic for the time queries
+    loaded->Times.resize(loaded->Data.Topics.size());
+    loaded->Columns.resize(loaded->Data.Topics.size());
+    for (int t = 0; t < (int)loaded->Data.Topics.size(); ++t)
+    {
+        const Topic &topic = loaded->Data.Topics[t];
+        loaded->Times[t].resize(topic.Messages.size());
+        for (int m = 0; m < (int)topic.Messages.size(); ++m)
+            loaded->Times[t][m] = topic.Messages[m].DateTime.ToEpochNanoseconds();
+        loaded->Columns[t].resize(topic.FieldLabels.size());
+    }
+    load_duration->Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    // Add the sequence (or use the one loaded by another connection meanwhile) and unload the least recently used ones
+    std::lock_guard<std::mutex> lock(sequences_mutex);
+    std::shared_ptr<LoadedSequence> &slot = sequences[sequence_name];
+    if (!slot) slot = loaded;
+    slot->LastUsed = ++use_counter;
+    while (options.MaxLoadedSequences > 0 && (int)sequences.size() > options.MaxLoadedSequences)
+    {
+        std::map<std::string, std::shared_ptr<LoadedSequence> >::iterator oldest = sequences.begin();
+        for (std::map<std::string, std::shared_ptr<LoadedSequence> >::iterator it = sequences.begin(); it != sequences.end(); ++it)
+            if (it->second->LastUsed < oldest->second->LastUsed)
+                oldest = it;
+        sequences.erase(oldest);
+        sequence_evictions->Increment();
+    }
+    return slot;
+}
+
+// Get the numeric values of a field of a topic (converted on its first use, NaN for the non-numeric values)
+std::shared_ptr<const std::vector<double> > DatasetServer::GetColumn(LoadedSequence &sequence, int topic_idx, int field_idx)
+{
+    {
+        std::lock_guard<std::mutex> lock(sequence.ColumnsMutex);
+        if (sequence.Columns[topic_idx][field_idx])
+        {
+            column_hits->Increment();
+            return sequence.Columns[topic_idx][field_idx];
+        }
+    }
+    column_misses->Increment();
+
+    const Topic &topic = sequence.Data.Topics[topic_idx];
+    std::shared_ptr<std::vector<double> > column = std::make_shared<std::vector<double> >(topic.Messages.size());
+    for (int m = 0; m < (int)topic.Messages.size(); ++m)
+        if (field_idx >= (int)topic.Messages[m].Fields.size() || !Commons::StringToDouble(topic.Messages[m].Fields[field_idx], (*column)[m]))
+            (*column)[m] = std::numeric_limits<double>::quiet_NaN();
+
+    std::lock_guard<std::mutex> lock(sequence.ColumnsMutex);
+    sequence.Columns[topic_idx][field_idx] = column;
+    return column;
+}
+
+// Serve the requests of a connection until it is closed
+void DatasetServer::ServeConnection(int socket_fd)
+{
+    active_connections->Add(1);
+    DatasetProtocol::RequestType type;
+    std::string payload;
+    while (DatasetProtocol::ReceiveRequest(socket_fd, type, payload))
+    {
+        // Answer the request and record its latency by its type
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int type_idx = type < (int)request_counters.size() ? type : 0;
+        request_counters[type_idx]->Increment();
+        bool answered = false;
+        try
+        {
+            answered = HandleRequest(socket_fd, type, payload);
+        }
+        catch (const std::exception &e)
+        {
+            answered = SendError(socket_fd, std::string("Internal error: ") + e.what());
+        }
+        catch (...)
+        {
+            answered = SendError(socket_fd, "Internal error.");
+        }
+        request_durations[type_idx]->Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (!answered) break;
+    }
+    active_connections->Add(-1);
+
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    connections.erase(std::remove(connections.begin(), connections.end(), socket_fd), connections.end());
+    close(socket_fd);
+    finished_threads.push_back(std::this_thread::get_id());
+    connection_closed.notify_one();
+}
+
+// Join the threads that finished serving their connections, so a long-running server does not keep them
+void DatasetServer::JoinFinishedThreads()
+{
+    std::vector<std::thread> finished;
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        for (int i = 0; i < (int)finished_threads.size(); ++i)
+            for (int j = 0; j < (int)threads.size(); ++j)
+                if (threads[j].get_id() == finished_threads[i])
+                {
+                    finished.push_back(std::move(threads[j]));
+                    threads[j] = std::move(threads.back());
+                    threads.pop_back();
+                    break;
+                }
+        finished_threads.clear();
+    }
+
+    // The threads only have to return after recording that they finished
+    for (int i = 0; i < (int)finished.size(); ++i)
+        finished[i].join();
+}
+
+// Answer a request. Returns false if the response could not be sent.
+bool DatasetServer::HandleRequest(int socket_fd, DatasetProtocol::RequestType type, const std::string &payload)
+{
+    DatasetProtocol::Reader reader(payload.data(), payload.size());
+    DatasetProtocol::Writer writer;
+
+    if (type == DatasetProtocol::Ping)
+        writer.Write(DatasetProtocol::Version);
+    else if (type == DatasetProtocol::ListSequences)
+    {
+        // Read the filter and write the matching entries
+        Catalog::Filter filter;
+        unsigned char presence;
+        if (!reader.Read(presence) || !reader.ReadStrings(filter.FaultTypes) || !reader.ReadStrings(filter.RequiredTopics) ||
+            !reader.Read(filter.MinDuration) || !reader.Read(filter.MaxDuration) || !reader.Read(filter.MinFaultDuration))
+            return SendError(socket_fd, "Invalid filter.");
+        filter.Presence = (Catalog::FaultPresence)presence;
+        std::vector<int> entries = catalog.Query(filter);
+        writer.Write((unsigned int)entries.size());
+        for (int i = 0; i < (int)entries.size(); ++i)
+            WriteEntry(writer, catalog.Entries[entries[i]]);
+    }
+    else if (type == DatasetProtocol::GetSequenceInfo)
+    {
+        // Write the topics of the sequence
+        std::string name, error;
+        if (!reader.ReadString(name)) return SendError(socket_fd, "Invalid sequence name.");
+        std::shared_ptr<LoadedSequence> sequence = GetSequence(name, error);
+        if (!sequence) return SendError(socket_fd, error);
+        writer.WriteString(sequence->Data.Name);
+        writer.Write((unsigned int)sequence->Data.Topics.size());
+        for (int t = 0; t < (int)sequence->Data.Topics.size(); ++t)
+        {
+            const Topic &topic = sequence->Data.Topics[t];
+            writer.WriteString(topic.Name);
+            writer.WriteStrings(topic.FieldLabels);
+            writer.Write((long long)topic.Messages.size());
+            writer.Write(sequence->Times[t].empty() ? 0LL : sequence->Times[t].front());
+            writer.Write(sequence->Times[t].empty() ? 0LL : sequence->Times[t].back());
+        }
+    }
+    else if (type == DatasetProtocol::GetRowSlice || type == DatasetProtocol::GetTimeRange || type == DatasetProtocol::GetWindow)
+        return HandleRows(socket_fd, type, reader);
+    else if (type == DatasetProtocol::GetStats)
+    {
+        // Write the statistics as names and values
+        size_t n_loaded;
+        {
+            std::lock_guard<std::mutex> lock(sequences_mutex);
+            n_loaded = sequences.size();
+        }
+        unsigned long long n_requests = 0;
+        for (int i = 0; i < (int)request_counters.size(); ++i)
+            n_requests += request_counters[i]->Get();
+        const char *names[10] = { "requests", "errors", "sequence_loads", "loaded_sequences", "sequence_hits", "sequence_misses",
+            "column_hits", "column_misses", "bytes_inline", "bytes_shared" };
+        const unsigned long long values[10] = { n_requests, errors->Get(), load_duration->GetCount(), n_loaded, sequence_hits->Get(),
+            sequence_misses->Get(), column_hits->Get(), column_misses->Get(), bytes_inline->Get(), bytes_shared->Get() };
+        writer.Write((unsigned int)10);
+        for (int i = 0; i < 10; ++i)
+        {
+            writer.WriteString(names[i]);
+            writer.Write(values[i]);
+        }
+    }
+    else
+        return SendError(socket_fd, "Unknown request type " + std::to_string((int)type) + ".");
+
+    return DatasetProtocol::SendResponse(socket_fd, DatasetProtocol::Ok, writer.Bytes);
+}
+
+// Answer a request for the rows of the fields of a topic. The metadata is [number of rows][number of fields][first row],
+// and the data is the recording times of the rows followed by the values of each field (column by column).
+bool DatasetServer::HandleRows(int socket_fd, DatasetProtocol::RequestType type, DatasetProtocol::Reader &reader)
+{
+    // Read the request: the sequence, the topic, the fields and the two bounds of the rows
+    std::string sequence_name, topic_name, error;
+    VecString field_labels;
+    long long first, second;
+    if (!reader.ReadString(sequence_name) || !reader.ReadString(topic_name) || !reader.ReadStrings(field_labels) ||
+        !reader.Read(first) || !reader.Read(second))
+        return SendError(socket_fd, "Invalid row request.");
+
+    // Find the sequence, the topic and the fields
+    std::shared_ptr<LoadedSequence> sequence = GetSequence(sequence_name, error);
+    if (!sequence) return SendError(socket_fd, error);
+    int topic_idx = sequence->Data.FindTopicIndex(topic_name);
+    if (topic_idx < 0) return SendError(socket_fd, "Topic '" + topic_name + "' not found in '" + sequence_name + "'.");
+    std::vector<int> field_indices;
+    for (int f = 0; f < (int)field_labels.size(); ++f)
+    {
+        field_indices.push_back(sequence->Data.Topics[topic_idx].FindLabelIndex(field_labels[f]));
+        if (field_indices.back() < 0) return SendError(socket_fd, "Field '" + field_labels[f] + "' not found in '" + topic_name + "'.");
+    }
+
+    // Find the rows
+    const std::vector<long long> &times = sequence->Times[topic_idx];
+    long long n_total = times.size(), start = 0, end = 0;
+    if (type == DatasetProtocol::GetRowSlice)
+    {
+        if (first < 0 || first > n_total)
+            return SendError(socket_fd, "Row " + std::to_string(first) + " is out of the " + std::to_string(n_total) + " rows of '" +
+                topic_name + "'.");
+        start = first;
+    }
+    else
+        start = std::lower_bound(times.begin(), times.end(), first) - times.begin();
+
+    // The number of the rows is clamped to the remaining rows (so the end never overflows)
+    if (type == DatasetProtocol::GetTimeRange)
+        end = std::max(start, (long long)(std::lower_bound(times.begin(), times.end(), second) - times.begin()));
+    else
+        end = second < 0 ? n_total : start + std::min(second, n_total - start);
+    const long long n_rows = end - start;
+
+    // Write the times and the values of the rows straight into the data of the response (the shared memory if it is large)
+    DatasetProtocol::ResponseData data((n_rows * (1 + field_indices.size())) * sizeof(double), options.SharedMemoryThreshold);
+    if (n_rows > 0)
+    {
+        std::memcpy(data.GetData(), &times[start], n_rows * sizeof(long long));
+        for (int f = 0; f < (int)field_indices.size(); ++f)
+        {
+            std::shared_ptr<const std::vector<double> > column = GetColumn(*sequence, topic_idx, field_indices[f]);
+            std::memcpy(data.GetData() + (1 + f) * n_rows * sizeof(double), &(*column)[start], n_rows * sizeof(double));
+        }
+    }
+    DatasetProtocol::Writer writer;
+    writer.Write(n_rows);
+    writer.Write((unsigned int)field_indices.size());
+    writer.Write(start);
+
+    (data.IsShared() ? bytes_shared : bytes_inline)->Increment(data.GetSize());
+    return DatasetProtocol::SendResponse(socket_fd, DatasetProtocol::Ok, writer.Bytes, data);
+}
+
+// Send an error response with its message
+bool DatasetServer::SendError(int socket_fd, const std::string &message)
+{
+    errors->Increment();
+    return DatasetProtocol::SendResponse(socket_fd, DatasetProtocol::Error, message);
+}
+
+// Register the metrics of the server
+void DatasetServer::RegisterMetrics()
+{
+    // Requests by their type
+    const char *type_names[8] = { "unknown", "ping", "list_sequences", "get_sequence_info", "get_row_slice", "get_time_range",
+        "get_window", "get_stats" };
+    const std::vector<double> latency_buckets = Metrics::ExponentialBuckets(0.0001, 4, 10);
+    for (int i = 0; i < 8; ++i)
+    {
+        std::string labels = std::string("type=\"") + type_names[i] + "\"";
+        request_counters.push_back(&metrics.AddCounter("alfa_daemon_requests_total", "Requests received by the daemon.", labels));
+        request_durations.push_back(&metrics.AddHistogram("alfa_daemon_request_duration_seconds",
+            "Time of answering the requests (including sending the response).", latency_buckets, labels));
+    }
+    errors = &metrics.AddCounter("alfa_daemon_request_errors_total", "Requests answered with an error.");
+
+    // Loading and the caches of the sequences and the columns
+    load_duration = &metrics.AddHistogram("alfa_daemon_sequence_load_duration_seconds", "Time of loading a sequence.",
+        Metrics::ExponentialBuckets(0.01, 2, 12));
+    sequence_hits = &metrics.AddCounter("alfa_daemon_sequence_cache_hits_total", "Queries of the sequences that were loaded.");
+    sequence_misses = &metrics.AddCounter("alfa_daemon_sequence_cache_misses_total", "Queries of the sequences that were not loaded.");
+    sequence_evictions = &metrics.AddCounter("alfa_daemon_sequence_evictions_total", "Sequences unloaded beyond the limit.");
+    column_hits = &metrics.AddCounter("alfa_daemon_column_cache_hits_total", "Queries of the fields that were converted.");
+    column_misses = &metrics.AddCounter("alfa_daemon_column_cache_misses_total", "Queries of the fields that were not converted.");
+    metrics.AddCallback("alfa_daemon_loaded_sequences", "Sequences kept loaded.", Metrics::GaugeType, [this]()
+    {
+        std::lock_guard<std::mutex> lock(sequences_mutex);
+        return (double)sequences.size();
+    });
+
+    // Connections, responses and the process
+    active_connections = &metrics.AddGauge("alfa_daemon_connections", "Open client connections.");
+    bytes_inline = &metrics.AddCounter("alfa_daemon_response_data_bytes_total", "Array data sent to the clients.",
+        "transport=\"socket\"");
+    bytes_shared = &metrics.AddCounter("alfa_daemon_response_data_bytes_total", "Array data sent to the clients.",
+        "transport=\"shared_memory\"");
+    metrics.AddProcessMetrics();
+}
+
+// Write a catalog entry
+void DatasetServer::WriteEntry(DatasetProtocol::Writer &writer, const Catalog::Entry &entry)
+{
+    writer.WriteString(entry.Name);
+    writer.WriteStrings(entry.FaultTypes);
+    writer.WriteStrings(entry.FaultTopics);
+    writer.Write(entry.StartTime);
+    writer.Write(entry.EndTime);
+    writer.Write(entry.FaultOnset);
+    writer.Write(entry.TotalDuration);
+    writer.Write(entry.NormalFlightDuration);
+    writer.Write((unsigned int)entry.Topics.size());
+    for (int t = 0; t < (int)entry.Topics.size(); ++t)
+    {
+        writer.WriteString(entry.Topics[t].Name);
+        writer.Write(entry.Topics[t].MessageCount);
+        writer.Write(entry.Topics[t].StartTime);
+        writer.Write(entry.Topics[t].EndTime);
+    }
+}
+
+}
+#endif
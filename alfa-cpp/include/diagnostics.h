@@ -0,0 +1,370 @@
+/*  ***************************************************************************
+*   diagnostics.h - Header for collecting the errors and warnings of loading.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_DIAGNOSTICS_H
+#define ALFA_DIAGNOSTICS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <functional>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <atomic>
+
+namespace alfa
+{
+
+// This class collects the errors and warnings of loading and reading the topics. It keeps counters for
+// each source (topic) and the first few reports of each source with their line numbers. The reports
+// are also written to the standard error (or given to a user callback) at a limited rate, so a malformed
+// file does not flood the output. It is thread-safe and can be shared between the topics of a sequence.
+class Diagnostics
+{
+public:
+
+    // Local enum and struct definitions
+    enum Severity { Info = 0, Warning = 1, Error = 2 };
+
+    struct Report               // A single reported problem
+    {
+        Severity Level = Error;
+        std::string Source;     // Topic name or file name
+        int LineNumber = -1;    // Line of the file (-1 if not related to a line)
+        std::string Text;
+    };
+
+    struct Counters             // Number of the reports of a source for each severity
+    {
+        int Infos = 0, Warnings = 0, Errors = 0;
+        int Total() const { return Infos + Warnings + Errors; }
+    };
+
+    typedef std::function<void(const Report &)> Callback;
+
+    // Constructors & Deconstructors
+    Diagnostics(int max_samples_per_source = 10, int max_outputs_per_second = 20);
+
+    // Member Functions
+    void Add(Severity level, const std::string &source, const std::string &text, int line_number = -1);
+    void SetCallback(const Callback &callback);
+    void SetOutputEnabled(bool enabled);
+    void SetMinOutputSeverity(Severity level);
+    Counters GetCounters(const std::string &source) const;
+    Counters GetTotalCounters() const;
+    std::map<std::string, Counters> GetAllCounters() const;
+    std::vector<Report> GetSamples() const;
+    int GetSuppressedCount() const;
+    bool HasErrors() const;
+    void PrintSummary(std::ostream &os = std::cerr) const;
+    void Clear();
+    static std::string SeverityToString(Severity level);
+    static std::string ReportToString(const Report &report);
+
+private:
+    // Data Members
+    mutable std::mutex mutex;
+    int max_samples, max_outputs;
+    Callback callback;
+    bool output_enabled = true;
+    Severity min_output_level = Warning;
+
+    // Collected reports
+    std::map<std::string, Counters> counters;
+    std::vector<Report> samples;
+
+    // Rate limiting of the output
+    std::chrono::steady_clock::time_point window_start;
+    int window_outputs = 0;
+    int window_suppressed = 0;
+    int total_suppressed = 0;
+};
+
+// This class links an object (a topic or a sequence) to its diagnostics collector. The collector is created on its
+// first use, so the objects that never report anything do not allocate one. A copy of the object starts without a
+// collector (so its reports are not mixed with the ones of the original), a copy assignment keeps the collector of
+// the target, and a move takes the collector of the source.
+class DiagnosticsLink
+{
+public:
+    // Constructors & Deconstructors
+    DiagnosticsLink(const std::shared_ptr<Diagnostics> &diagnostics = nullptr);
+    DiagnosticsLink(const DiagnosticsLink &other);
+    DiagnosticsLink(DiagnosticsLink &&other);
+    DiagnosticsLink &operator=(const DiagnosticsLink &other);
+    DiagnosticsLink &operator=(DiagnosticsLink &&other);
+
+    // Member Functions
+    std::shared_ptr<Diagnostics> Get() const;
+    bool HasCollector() const;
+    void Set(const std::shared_ptr<Diagnostics> &diagnostics);
+
+private:
+    // Data Members
+    mutable std::shared_ptr<Diagnostics> diagnostics;    // Accessed atomically (it may be created by const readers)
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for Diagnostics. Keeps the given number of the first reports of each source
+// and outputs at most the given number of reports in each second.
+Diagnostics::Diagnostics(int max_samples_per_source, int max_outputs_per_second)
+    : max_samples(max_samples_per_source), max_outputs(max_outputs_per_second),
+    window_start(std::chrono::steady_clock::now())
+{
+}
+
+// Add a report. Updates the counters, keeps it if it is among the first reports of the source, and outputs it
+// to the callback (or the standard error) unless the output rate is exceeded.
+void Diagnostics::Add(Severity level, const std::string &source, const std::string &text, int line_number)
+{
+    Report report;
+    report.Level = level;
+    report.Source = source;
+    report.LineNumber = line_number;
+    report.Text = text;
+
+    int suppressed_before = 0;
+    Callback output_callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Update the counters and keep the first reports of the source
+        Counters &source_counters = counters[source];
+        if (source_counters.Total() < max_samples)
+            samples.push_back(report);
+        if (level == Info) source_counters.Infos++;
+        else if (level == Warning) source_counters.Warnings++;
+        else source_counters.Errors++;
+
+        if (!output_enabled || level < min_output_level) return;
+
+        // Start a new rate limiting window every second
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - window_start >= std::chrono::seconds(1))
+        {
+            suppressed_before = window_suppressed;
+            window_start = now;
+            window_outputs = 0;
+            window_suppressed = 0;
+        }
+
+        // Suppress the output if the rate is exceeded
+        if (window_outputs >= max_outputs)
+        {
+            window_suppressed++;
+            total_suppressed++;
+            return;
+        }
+        window_outputs++;
+        output_callback = callback;
+    }
+
+    // Output the report (outside the lock, so the callback can use this object)
+    if (output_callback)
+        output_callback(report);
+    else
+    {
+        if (suppressed_before > 0)
+            std::cerr << "(" << suppressed_before << " similar messages suppressed)" << std::endl;
+        std::cerr << ReportToString(report) << std::endl;
+    }
+}
+
+// Send the reports to the given callback instead of the standard error (an empty callback restores the standard error)
+void Diagnostics::SetCallback(const Callback &callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->callback = callback;
+}
+
+// Enable or disable the output of the reports (they are still counted and sampled)
+void Diagnostics::SetOutputEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    output_enabled = enabled;
+}
+
+// Set the minimum severity of the reports that are output
+void Diagnostics::SetMinOutputSeverity(Severity level)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    min_output_level = level;
+}
+
+// Get the counters of a source
+Diagnostics::Counters Diagnostics::GetCounters(const std::string &source) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, Counters>::const_iterator it = counters.find(source);
+    return it == counters.end() ? Counters() : it->second;
+}
+
+// Get the counters of all the sources together
+Diagnostics::Counters Diagnostics::GetTotalCounters() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Counters total;
+    for (std::map<std::string, Counters>::const_iterator it = counters.begin(); it != counters.end(); ++it)
+    {
+        total.Infos += it->second.Infos;
+        total.Warnings += it->second.Warnings;
+        total.Errors += it->second.Errors;
+    }
+    return total;
+}
+
+// Get the counters of all the sources
+std::map<std::string, Diagnostics::Counters> Diagnostics::GetAllCounters() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+// Get the kept reports (the first reports of each source in the order they were added)
+std::vector<Diagnostics::Report> Diagnostics::GetSamples() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return samples;
+}
+
+// Get the number of the reports that were not output because of the rate limit
+int Diagnostics::GetSuppressedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return total_suppressed;
+}
+
+// Returns true if any errors are reported
+bool Diagnostics::HasErrors() const
+{
+    return GetTotalCounters().Errors > 0;
+}
+
+// Print the counters of each source and the kept reports
+void Diagnostics::PrintSummary(std::ostream &os) const
+{
+    std::map<std::string, Counters> all_counters = GetAllCounters();
+    std::vector<Report> all_samples = GetSamples();
+
+    for (std::map<std::string, Counters>::const_iterator it = all_counters.begin(); it != all_counters.end(); ++it)
+    {
+        os << it->first << ": " << it->second.Errors << " error(s), " << it->second.Warnings << " warning(s), " <<
+            it->second.Infos << " info(s)" << std::endl;
+        for (int i = 0; i < (int)all_samples.size(); ++i)
+            if (all_samples[i].Source == it->first)
+                os << "  " << ReportToString(all_samples[i]) << std::endl;
+    }
+}
+
+// Clear all the reports and the counters
+void Diagnostics::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.clear();
+    samples.clear();
+    window_outputs = 0;
+    window_suppressed = 0;
+    total_suppressed = 0;
+}
+
+// Convert a severity to string
+std::string Diagnostics::SeverityToString(Severity level)
+{
+    if (level == Info) return "Info";
+    if (level == Warning) return "Warning";
+    return "Error";
+}
+
+// Convert a report to a single line of text
+std::string Diagnostics::ReportToString(const Report &report)
+{
+    std::string text = SeverityToString(report.Level) + " [" + report.Source + "]";
+    if (report.LineNumber >= 0)
+        text += " line #" + std::to_string(report.LineNumber);
+    return text + ": " + report.Text;
+}
+
+// Constructor function for DiagnosticsLink. Links to the given collector (or to a new one on the first use if not given).
+DiagnosticsLink::DiagnosticsLink(const std::shared_ptr<Diagnostics> &diagnostics)
+    : diagnostics(diagnostics)
+{
+}
+
+// Copy constructor function for DiagnosticsLink. The copy gets its own collector on its first use.
+DiagnosticsLink::DiagnosticsLink(const DiagnosticsLink &)
+{
+}
+
+// Move constructor function for DiagnosticsLink. Takes the collector of the source.
+DiagnosticsLink::DiagnosticsLink(DiagnosticsLink &&other)
+    : diagnostics(std::atomic_exchange(&other.diagnostics, std::shared_ptr<Diagnostics>()))
+{
+}
+
+// Copy assignment of DiagnosticsLink. Keeps the current collector.
+DiagnosticsLink &DiagnosticsLink::operator=(const DiagnosticsLink &)
+{
+    return *this;
+}
+
+// Move assignment of DiagnosticsLink. Takes the collector of the source.
+DiagnosticsLink &DiagnosticsLink::operator=(DiagnosticsLink &&other)
+{
+    if (this != &other)
+        Set(std::atomic_exchange(&other.diagnostics, std::shared_ptr<Diagnostics>()));
+    return *this;
+}
+
+// Get the collector (creates it if there is none yet)
+std::shared_ptr<Diagnostics> DiagnosticsLink::Get() const
+{
+    std::shared_ptr<Diagnostics> current = std::atomic_load(&diagnostics);
+    if (current) return current;
+
+    // Create a collector, unless another thread has just created one
+    std::shared_ptr<Diagnostics> created = std::make_shared<Diagnostics>();
+    if (std::atomic_compare_exchange_strong(&diagnostics, &current, created))
+        return created;
+    return current;
+}
+
+// Returns true if the collector is already created
+bool DiagnosticsLink::HasCollector() const
+{
+    return (bool)std::atomic_load(&diagnostics);
+}
+
+// Link to the given collector (or to a new one on the next use if not given)
+void DiagnosticsLink::Set(const std::shared_ptr<Diagnostics> &diagnostics)
+{
+    std::atomic_store(&this->diagnostics, diagnostics);
+}
+
+}
+#endif
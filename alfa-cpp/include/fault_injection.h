@@ -0,0 +1,239 @@
+/*  ***************************************************************************
+*   fault_injection.h - Header for injecting synthetic faults into sequences.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_FAULT_INJECTION_H
+#define ALFA_FAULT_INJECTION_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <climits>
+#include "commons.h"
+#include "sequence.h"
+
+namespace alfa
+{
+
+// This class creates synthetic faulty sequences from normal sequences. The fault effects are applied to
+// the selected fields of a topic from the fault onset, and a matching failure status topic is added,
+// so the result looks like a dataset sequence with a real fault.
+class FaultInjector
+{
+public:
+
+    // Local enum and struct definitions
+    enum FaultType
+    {
+        StuckSurface,           // The fields keep their last value before the onset (or Magnitude if HoldLastValue is false)
+        ThrustLoss,             // The fields are scaled by Magnitude (the remaining fraction, e.g. 0 for a complete loss)
+        SensorBias              // Magnitude is added to the fields
+    };
+
+    struct FaultSpec            // Description of a single injected fault
+    {
+        FaultType Type = SensorBias;
+        std::string FaultName;          // Fault type in the sequence name (e.g. 'engine' or 'rudder_right')
+        std::string TopicName;          // Topic with the affected fields
+        VecString FieldLabels;          // Affected fields of the topic
+        double OnsetTime = 0;           // Fault onset in seconds from the start of the sequence
+        double Duration = -1;           // Duration of the fault in seconds (negative for the rest of the sequence)
+        double Magnitude = 0;           // Strength of the fault (see FaultType)
+        bool HoldLastValue = true;      // For StuckSurface: hold the last value before the onset
+        std::string StatusTopicName;    // Failure status topic (empty for 'failure_status-' + FaultName)
+        std::string StatusValue = "1";  // Value of the 'data' field of the failure status messages
+        double StatusRate = 10;         // Rate of the failure status messages in Hz
+        std::string SequenceName;       // Name of the output sequence (empty for an automatic name)
+    };
+
+    // Member Functions
+    static bool Inject(const Sequence &normal_sequence, const FaultSpec &spec, Sequence &out_sequence);
+    static std::vector<int> InjectMany(const Sequence &normal_sequence, const std::vector<FaultSpec> &specs,
+        std::vector<Sequence> &out_sequences, int n_threads = 0);
+    static std::string CreateSequenceName(const std::string &normal_name, const FaultSpec &spec);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Create a faulty copy of a normal sequence with the given fault
+bool FaultInjector::Inject(const Sequence &normal_sequence, const FaultSpec &spec, Sequence &out_sequence)
+{
+    // Print an error if the sequence is empty
+    if (!normal_sequence.IsInitialized() || normal_sequence.MessageIndexList.empty())
+    {
+        std::cerr << "FaultInjector Error! The normal sequence is not loaded." << std::endl;
+        return false;
+    }
+
+    // Find the affected topic and fields
+    int topic_idx = normal_sequence.FindTopicIndex(spec.TopicName);
+    if (topic_idx < 0)
+    {
+        std::cerr << "FaultInjector Error! '" << spec.TopicName << "' topic not found in '" << normal_sequence.Name << "'." << std::endl;
+        return false;
+    }
+    std::vector<int> field_indices;
+    for (int f = 0; f < (int)spec.FieldLabels.size(); ++f)
+    {
+        field_indices.push_back(normal_sequence.Topics[topic_idx].FindLabelIndex(spec.FieldLabels[f]));
+        if (field_indices.back() < 0)
+        {
+            std::cerr << "FaultInjector Error! '" << spec.FieldLabels[f] << "' field not found in '" << spec.TopicName << "'." << std::endl;
+            return false;
+        }
+    }
+
+    // Print an error if the sequence already has the status topic
+    std::string status_topic = spec.StatusTopicName.empty() ? Commons::FaultTopicPrefix + "-" + spec.FaultName : spec.StatusTopicName;
+    if (normal_sequence.FindTopicIndex(status_topic) >= 0)
+    {
+        std::cerr << "FaultInjector Error! '" << normal_sequence.Name << "' already has '" << status_topic << "' topic." << std::endl;
+        return false;
+    }
+
+    // Find the fault interval (nanoseconds since epoch)
+    // (The span is taken over the topics since the message list may follow the header stamps)
+    long long seq_start = LLONG_MAX;
+    long long seq_end = LLONG_MIN;
+    for (const Topic &topic : normal_sequence.Topics)
+    {
+        if (topic.Messages.empty())
+            continue;
+        seq_start = std::min(seq_start, topic.Messages.front().DateTime.ToEpochNanoseconds());
+        seq_end = std::max(seq_end, topic.Messages.back().DateTime.ToEpochNanoseconds());
+    }
+    long long onset = seq_start + (long long)std::llround(spec.OnsetTime * 1e9);
+    long long offset = spec.Duration < 0 ? seq_end : std::min(seq_end, onset + (long long)std::llround(spec.Duration * 1e9));
+    if (onset > seq_end)
+    {
+        std::cerr << "FaultInjector Error! The fault onset is after the end of '" << normal_sequence.Name << "'." << std::endl;
+        return false;
+    }
+
+    // Copy the normal sequence
+    out_sequence.Clear();
+    out_sequence = normal_sequence;
+    out_sequence.Name = spec.SequenceName.empty() ? CreateSequenceName(normal_sequence.Name, spec) : spec.SequenceName;
+    out_sequence.DirectoryPath = "";
+
+    // Apply the fault effect to the fields of the messages in the fault interval
+    Topic &topic = out_sequence.Topics[topic_idx];
+    for (int f = 0; f < (int)field_indices.size(); ++f)
+    {
+        std::string held_value = Commons::DoubleToString(spec.Magnitude);
+        bool has_held_value = !spec.HoldLastValue;
+        for (int m = 0; m < (int)topic.Messages.size(); ++m)
+        {
+            std::string &field = topic.Messages[m].Fields[field_indices[f]];
+            long long time = topic.Messages[m].DateTime.ToEpochNanoseconds();
+            double value;
+
+            // Remember the last value before the onset for the stuck surface
+            if (time < onset)
+            {
+                if (spec.HoldLastValue && Commons::StringToDouble(field, value))
+                {
+                    held_value = field;
+                    has_held_value = true;
+                }
+                continue;
+            }
+            if (time > offset) break;
+
+            // Skip the values that are not numbers
+            if (!Commons::StringToDouble(field, value)) continue;
+
+            if (spec.Type == StuckSurface)
+            {
+                // Hold the first value after the onset if there was none before (the text is kept as it is)
+                if (!has_held_value)
+                {
+                    held_value = field;
+                    has_held_value = true;
+                }
+                field = held_value;
+            }
+            else if (spec.Type == ThrustLoss)
+                field = Commons::DoubleToString(value * spec.Magnitude);
+            else
+                field = Commons::DoubleToString(value + spec.Magnitude);
+        }
+    }
+
+    // Create the failure status topic for the fault interval
+    Topic status;
+    status.Create(status_topic, VecString(1, "data"));
+    long long period = (long long)std::llround(1e9 / std::max(spec.StatusRate, 1e-3));
+    for (long long time = onset; time <= offset; time += period)
+    {
+        Message msg;
+        msg.DateTime = DateTime::EpochNanosecondsToTime(time);
+        msg.Fields.push_back(spec.StatusValue);
+        status.AddMessage(msg);
+    }
+
+    return out_sequence.AddTopic(status);
+}
+
+// Create faulty copies of a normal sequence for all the given faults in parallel.
+// Returns the indices of the faults that were injected successfully.
+std::vector<int> FaultInjector::InjectMany(const Sequence &normal_sequence, const std::vector<FaultSpec> &specs,
+    std::vector<Sequence> &out_sequences, int n_threads)
+{
+    // Inject each fault into its own copy of the sequence
+    out_sequences.clear();
+    out_sequences.resize(specs.size());
+    std::vector<char> injected(specs.size(), 0);
+    Commons::ParallelFor(specs.size(), n_threads, [&](int i)
+    {
+        injected[i] = Inject(normal_sequence, specs[i], out_sequences[i]);
+    });
+
+    std::vector<int> result;
+    for (int i = 0; i < (int)specs.size(); ++i)
+        if (injected[i])
+            result.push_back(i);
+    return result;
+}
+
+// Create the name of the faulty sequence in the dataset naming format (e.g. 'carbonZ_2018-07-30-16-39-00_3_engine_failure_synthetic_60s').
+// The suffix after 'failure' keeps the names of the faults with different onsets unique.
+std::string FaultInjector::CreateSequenceName(const std::string &normal_name, const FaultSpec &spec)
+{
+    // Keep the platform name, the date-time and the optional run number
+    VecString tokens = Commons::Tokenize(normal_name, '_');
+    int end = std::min(2, (int)tokens.size()), run_number;
+    if ((int)tokens.size() > end && Commons::StringToInt(tokens[end], run_number)) ++end;
+
+    std::string name;
+    for (int i = 0; i < end; ++i)
+        name += tokens[i] + "_";
+
+    return name + spec.FaultName + "_failure_synthetic_" + std::to_string((long long)std::llround(spec.OnsetTime)) + "s";
+}
+
+}
+#endif
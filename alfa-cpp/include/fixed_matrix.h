@@ -0,0 +1,184 @@
+/*  ***************************************************************************
+*   fixed_matrix.h - Header for the small matrices with a fixed size.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_FIXED_MATRIX_H
+#define ALFA_FIXED_MATRIX_H
+
+#include <cmath>
+#include <algorithm>
+
+namespace alfa
+{
+
+// This class keeps a matrix with the size known at the compile time. The values are stored in the object
+// itself (row by row), so the matrices of the filters can be created and multiplied at every step without
+// allocating any memory.
+template <int R, int C>
+class FixedMatrix
+{
+public:
+
+    // Data Members
+    double Data[R * C];
+
+    // Member Functions
+    double &operator()(int row, int col) { return Data[row * C + col]; }
+    double operator()(int row, int col) const { return Data[row * C + col]; }
+    FixedMatrix operator+(const FixedMatrix &other) const;
+    FixedMatrix operator-(const FixedMatrix &other) const;
+    FixedMatrix operator*(double scale) const;
+    template <int K> FixedMatrix<R, K> operator*(const FixedMatrix<C, K> &other) const;
+    FixedMatrix<C, R> Transpose() const;
+    bool Inverse(FixedMatrix &out_inverse) const;
+    static FixedMatrix Zero();
+    static FixedMatrix Identity();
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Add two matrices
+template <int R, int C>
+FixedMatrix<R, C> FixedMatrix<R, C>::operator+(const FixedMatrix &other) const
+{
+    FixedMatrix result;
+    for (int i = 0; i < R * C; ++i)
+        result.Data[i] = Data[i] + other.Data[i];
+    return result;
+}
+
+// Subtract two matrices
+template <int R, int C>
+FixedMatrix<R, C> FixedMatrix<R, C>::operator-(const FixedMatrix &other) const
+{
+    FixedMatrix result;
+    for (int i = 0; i < R * C; ++i)
+        result.Data[i] = Data[i] - other.Data[i];
+    return result;
+}
+
+// Multiply the matrix by a number
+template <int R, int C>
+FixedMatrix<R, C> FixedMatrix<R, C>::operator*(double scale) const
+{
+    FixedMatrix result;
+    for (int i = 0; i < R * C; ++i)
+        result.Data[i] = Data[i] * scale;
+    return result;
+}
+
+// Multiply two matrices
+template <int R, int C>
+template <int K>
+FixedMatrix<R, K> FixedMatrix<R, C>::operator*(const FixedMatrix<C, K> &other) const
+{
+    FixedMatrix<R, K> result = FixedMatrix<R, K>::Zero();
+    for (int i = 0; i < R; ++i)
+        for (int k = 0; k < C; ++k)
+        {
+            double value = Data[i * C + k];
+            if (value == 0) continue;
+            for (int j = 0; j < K; ++j)
+                result.Data[i * K + j] += value * other.Data[k * K + j];
+        }
+    return result;
+}
+
+// Get the transpose of the matrix
+template <int R, int C>
+FixedMatrix<C, R> FixedMatrix<R, C>::Transpose() const
+{
+    FixedMatrix<C, R> result;
+    for (int i = 0; i < R; ++i)
+        for (int j = 0; j < C; ++j)
+            result(j, i) = Data[i * C + j];
+    return result;
+}
+
+// Invert the (square) matrix with the Gauss-Jordan elimination. Returns false if the matrix is singular.
+template <int R, int C>
+bool FixedMatrix<R, C>::Inverse(FixedMatrix &out_inverse) const
+{
+    static_assert(R == C, "Only the square matrices can be inverted.");
+    FixedMatrix work = *this;
+    out_inverse = Identity();
+
+    for (int col = 0; col < C; ++col)
+    {
+        // Use the row with the largest value in the column as the pivot
+        int pivot = col;
+        for (int row = col + 1; row < R; ++row)
+            if (std::fabs(work(row, col)) > std::fabs(work(pivot, col)))
+                pivot = row;
+        if (std::fabs(work(pivot, col)) < 1e-300) return false;
+        if (pivot != col)
+            for (int j = 0; j < C; ++j)
+            {
+                std::swap(work(pivot, j), work(col, j));
+                std::swap(out_inverse(pivot, j), out_inverse(col, j));
+            }
+
+        // Scale the pivot row and eliminate the column from the other rows
+        double scale = 1.0 / work(col, col);
+        for (int j = 0; j < C; ++j)
+        {
+            work(col, j) *= scale;
+            out_inverse(col, j) *= scale;
+        }
+        for (int row = 0; row < R; ++row)
+        {
+            double factor = work(row, col);
+            if (row == col || factor == 0) continue;
+            for (int j = 0; j < C; ++j)
+            {
+                work(row, j) -= factor * work(col, j);
+                out_inverse(row, j) -= factor * out_inverse(col, j);
+            }
+        }
+    }
+    return true;
+}
+
+// Create a matrix of zeros
+template <int R, int C>
+FixedMatrix<R, C> FixedMatrix<R, C>::Zero()
+{
+    FixedMatrix result;
+    std::fill(result.Data, result.Data + R * C, 0.0);
+    return result;
+}
+
+// Create an identity matrix
+template <int R, int C>
+FixedMatrix<R, C> FixedMatrix<R, C>::Identity()
+{
+    FixedMatrix result = Zero();
+    for (int i = 0; i < std::min(R, C); ++i)
+        result(i, i) = 1;
+    return result;
+}
+
+}
+#endif
@@ -0,0 +1,224 @@
+/*  ***************************************************************************
+*   latency.h - Header for analyzing the latency of the message stamps.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_LATENCY_H
+#define ALFA_LATENCY_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "commons.h"
+#include "sequence.h"
+
+namespace alfa
+{
+
+// This class analyzes the latency of the messages, i.e. the difference of their recording time (%time) and
+// their header stamp, which shows the transport delays and the clock problems of each topic. The times of a
+// topic are first copied to contiguous arrays, so the latencies are computed in a simple loop that the compiler
+// can vectorize. The topics of a sequence are analyzed in parallel.
+class LatencyAnalyzer
+{
+public:
+
+    // Local struct definitions
+    struct TopicLatency                 // Latency of the messages of a topic (in seconds)
+    {
+        std::string Name;
+        int NMessages = 0;
+        int NStamped = 0;               // Messages with a header stamp
+        int NNegative = 0;              // Messages stamped after their recording (clock problems)
+        int NStampReversals = 0;        // Stamps earlier than the stamp of the previous message
+        std::vector<double> Series;     // Latency of each message (NaN if not stamped)
+        double Mean = 0, StdDev = 0, Min = 0, Max = 0;
+        double Median = 0, P90 = 0, P99 = 0;
+        std::vector<int> Histogram;     // Number of the latencies in each bin of GetHistogramEdges()
+    };
+
+    // Member Functions
+    static TopicLatency Analyze(const Topic &topic, bool keep_series = true);
+    static std::vector<TopicLatency> AnalyzeSequence(const Sequence &sequence, bool keep_series = false, int n_threads = 0);
+    static void PrintReport(const std::vector<TopicLatency> &latencies, bool print_histograms = false, std::ostream &os = std::cout);
+    static const std::vector<double> &GetHistogramEdges();
+
+private:
+    // Member Functions
+    static double GetPercentile(std::vector<double> &values, double fraction);
+    static std::string FormatDuration(double seconds);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Analyze the latency of the messages of a topic (the series is not kept if not requested)
+LatencyAnalyzer::TopicLatency LatencyAnalyzer::Analyze(const Topic &topic, bool keep_series)
+{
+    TopicLatency result;
+    result.Name = topic.Name;
+    result.NMessages = topic.Messages.size();
+    result.Histogram.assign(GetHistogramEdges().size() + 1, 0);
+    if (!topic.HasHeaderField() || topic.Messages.empty()) return result;
+
+    // Copy the recording times and the stamps to contiguous arrays
+    const int n = topic.Messages.size();
+    std::vector<long long> times(n), stamps(n);
+    for (int m = 0; m < n; ++m)
+    {
+        times[m] = topic.Messages[m].DateTime.ToEpochNanoseconds();
+        stamps[m] = topic.Messages[m].Header.Stamp;
+    }
+
+    // Compute the latencies (a zero stamp means the message is not stamped)
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> series(n);
+    for (int m = 0; m < n; ++m)
+        series[m] = stamps[m] > 0 ? (times[m] - stamps[m]) * 1e-9 : nan;
+    for (int m = 1; m < n; ++m)
+        result.NStampReversals += (stamps[m] > 0 && stamps[m - 1] > 0 && stamps[m] < stamps[m - 1]);
+
+    // Compute the statistics of the stamped messages
+    std::vector<double> values;
+    values.reserve(n);
+    for (int m = 0; m < n; ++m)
+        if (!std::isnan(series[m]))
+            values.push_back(series[m]);
+    result.NStamped = values.size();
+    if (!values.empty())
+    {
+        double sum = 0, sum_squares = 0;
+        for (int i = 0; i < result.NStamped; ++i)
+        {
+            sum += values[i];
+            sum_squares += values[i] * values[i];
+            result.NNegative += values[i] < 0;
+        }
+        result.Mean = sum / result.NStamped;
+        result.StdDev = std::sqrt(std::max(0.0, sum_squares / result.NStamped - result.Mean * result.Mean));
+        result.Min = *std::min_element(values.begin(), values.end());
+        result.Max = *std::max_element(values.begin(), values.end());
+
+        // Count the latencies in the bins of the histogram
+        const std::vector<double> &edges = GetHistogramEdges();
+        for (int i = 0; i < result.NStamped; ++i)
+            result.Histogram[std::upper_bound(edges.begin(), edges.end(), values[i]) - edges.begin()]++;
+
+        // Find the percentiles (reorders the values)
+        result.Median = GetPercentile(values, 0.5);
+        result.P90 = GetPercentile(values, 0.9);
+        result.P99 = GetPercentile(values, 0.99);
+    }
+
+    if (keep_series) result.Series.swap(series);
+    return result;
+}
+
+// Analyze the latency of all the topics of a sequence in parallel
+std::vector<LatencyAnalyzer::TopicLatency> LatencyAnalyzer::AnalyzeSequence(const Sequence &sequence, bool keep_series, int n_threads)
+{
+    std::vector<TopicLatency> result(sequence.Topics.size());
+    Commons::ParallelFor(sequence.Topics.size(), n_threads, [&](int t)
+    {
+        result[t] = Analyze(sequence.Topics[t], keep_series);
+    });
+    return result;
+}
+
+// Print a table of the latency of the topics (and optionally their histograms)
+void LatencyAnalyzer::PrintReport(const std::vector<TopicLatency> &latencies, bool print_histograms, std::ostream &os)
+{
+    // Find the width of the topic names
+    size_t name_width = 5;
+    for (int t = 0; t < (int)latencies.size(); ++t)
+        name_width = std::max(name_width, latencies[t].Name.length());
+
+    os << std::left << std::setw(name_width) << "Topic" << std::right << std::setw(9) << "Stamped" << std::setw(11) << "Mean" <<
+        std::setw(11) << "StdDev" << std::setw(11) << "Min" << std::setw(11) << "Median" << std::setw(11) << "P90" <<
+        std::setw(11) << "P99" << std::setw(11) << "Max" << std::setw(10) << "Negative" << std::setw(11) << "Reversals" << std::endl;
+    for (int t = 0; t < (int)latencies.size(); ++t)
+    {
+        const TopicLatency &latency = latencies[t];
+        os << std::left << std::setw(name_width) << latency.Name << std::right << std::setw(9) << latency.NStamped;
+        if (latency.NStamped == 0)
+        {
+            os << "  (no header stamps)" << std::endl;
+            continue;
+        }
+        os << std::setw(11) << FormatDuration(latency.Mean) << std::setw(11) << FormatDuration(latency.StdDev) <<
+            std::setw(11) << FormatDuration(latency.Min) << std::setw(11) << FormatDuration(latency.Median) <<
+            std::setw(11) << FormatDuration(latency.P90) << std::setw(11) << FormatDuration(latency.P99) <<
+            std::setw(11) << FormatDuration(latency.Max) << std::setw(10) << latency.NNegative << std::setw(11) <<
+            latency.NStampReversals << std::endl;
+
+        // Print the non-empty bins of the histogram
+        if (!print_histograms) continue;
+        const std::vector<double> &edges = GetHistogramEdges();
+        for (int b = 0; b < (int)latency.Histogram.size(); ++b)
+        {
+            if (latency.Histogram[b] == 0) continue;
+            std::string range = (b == 0 ? "< " + FormatDuration(edges[0]) : b == (int)edges.size() ? ">= " + FormatDuration(edges.back()) :
+                FormatDuration(edges[b - 1]) + " - " + FormatDuration(edges[b]));
+            os << "    " << std::left << std::setw(22) << range << std::right << std::setw(9) << latency.Histogram[b] << " " <<
+                std::string((size_t)std::ceil(40.0 * latency.Histogram[b] / latency.NStamped), '#') << std::endl;
+        }
+    }
+}
+
+// Get the edges of the bins of the latency histograms (in seconds). The first bin is the negative latencies.
+const std::vector<double> &LatencyAnalyzer::GetHistogramEdges()
+{
+    static const std::vector<double> edges = { 0, 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 10 };
+    return edges;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Get a percentile of the values (partially reorders the values)
+double LatencyAnalyzer::GetPercentile(std::vector<double> &values, double fraction)
+{
+    size_t index = std::min(values.size() - 1, (size_t)(fraction * (values.size() - 1) + 0.5));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Convert a duration in seconds to a short text with a suitable unit
+std::string LatencyAnalyzer::FormatDuration(double seconds)
+{
+    std::ostringstream oss;
+    oss << std::fixed;
+    if (std::fabs(seconds) >= 1) oss << std::setprecision(2) << seconds << " s";
+    else if (std::fabs(seconds) >= 1e-3) oss << std::setprecision(2) << seconds * 1e3 << " ms";
+    else oss << std::setprecision(1) << seconds * 1e6 << " us";
+    return oss.str();
+}
+
+}
+#endif
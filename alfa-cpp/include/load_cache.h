@@ -0,0 +1,427 @@
+/*  ***************************************************************************
+*   load_cache.h - Header for the persistent cache of the parsed topic files.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_LOAD_CACHE_H
+#define ALFA_LOAD_CACHE_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "commons.h"
+#include "diagnostics.h"
+#include "topic.h"
+
+#if defined _WIN32 || defined __CYGWIN__
+#include <sys/utime.h>
+#include <process.h>
+#else
+#include <utime.h>
+#include <unistd.h>
+#endif
+
+namespace alfa
+{
+
+// This class keeps the parsed topics in a cache directory, keyed by a hash of the content of their CSV files
+// (and the format of the cache entries). Identical topic files are parsed once, no matter where they are
+// copied, and the later loads only read the binary entry. The directory can be shared between processes and
+// machines: the entries are written to temporary files and renamed, so readers never see a partial entry. The
+// total size of the entries is kept under a limit by removing the least recently used ones.
+class LoadCache
+{
+public:
+
+    // Local struct definitions
+    struct Stats                        // Number of the cache operations since the cache object was created
+    {
+        int Hits = 0;
+        int Misses = 0;
+        int Stores = 0;
+        int Evictions = 0;
+    };
+
+    // Constructors & Deconstructors
+    LoadCache(const std::string &cache_dir = "", long long max_bytes = 4LL << 30);
+
+    // Member Functions
+    bool LoadTopic(const std::string &filename, Topic &out_topic);
+    void Cleanup();
+    const std::string &GetDirectory() const;
+    long long GetMaxBytes() const;
+    Stats GetStats() const;
+    std::string GetEntryFilename(unsigned long long hash) const;
+    static unsigned long long Hash(const char *data, size_t size, unsigned long long seed = 0);
+    static std::string GetDefaultDirectory();
+
+    static const int FormatVersion;     // Changes whenever the parsing or the binary format of the topics changes
+    static const std::string EntryExtension;
+
+private:
+    // Data Members
+    std::string directory;
+    long long max_bytes;
+    std::atomic<int> hits, misses, stores, evictions;
+    std::atomic<bool> store_warned;
+    std::atomic<long long> size_estimate;       // Total size of the entries at the last cleanup plus the later stores (-1 if unknown)
+
+    // Member Functions
+    bool ReadEntry(const std::string &entry_filename, unsigned long long hash, size_t content_size, Topic &out_topic) const;
+    bool WriteEntry(const std::string &entry_filename, unsigned long long hash, size_t content_size, const Topic &topic,
+        long long &out_entry_size) const;
+    static unsigned long long ReadLittleEndian64(const char *p);
+    static unsigned int ReadLittleEndian32(const char *p);
+    static unsigned long long RotateLeft(unsigned long long x, int r);
+    static unsigned long long HashRound(unsigned long long acc, unsigned long long input);
+    static unsigned long long HashMerge(unsigned long long acc, unsigned long long value);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Version of the cache entries (part of the cache key). Version 3 keeps the exact UTC epochs of the recorded times.
+const int LoadCache::FormatVersion = 3;
+
+// The extension of the cache entry files
+const std::string LoadCache::EntryExtension = "alfac";
+
+// Constructor function for LoadCache. Uses the default directory if the directory is not given.
+LoadCache::LoadCache(const std::string &cache_dir, long long max_bytes)
+    : directory(cache_dir.empty() ? GetDefaultDirectory() : cache_dir), max_bytes(max_bytes),
+    hits(0), misses(0), stores(0), evictions(0), store_warned(false), size_estimate(-1)
+{
+    if (!directory.empty() && directory[directory.length() - 1] == Commons::FilePathSeparator)
+        directory.erase(directory.length() - 1);
+}
+
+// Load a topic CSV file through the cache. Reads the cached entry if the same content was parsed before,
+// otherwise parses the file and adds it to the cache. Keeps the name of the topic (like Topic::ReadFromFile).
+bool LoadCache::LoadTopic(const std::string &filename, Topic &out_topic)
+{
+    // Hash the content of the file (with the cache format, so the old entries are not used after a format change)
+    std::string content;
+    if (!Commons::ReadFileToString(filename, content))
+        return out_topic.ReadFromFile(filename);
+    unsigned long long hash = Hash(content.data(), content.size(), FormatVersion * 256ULL + (unsigned char)Commons::CSVDelimiter);
+    std::string entry_filename = GetEntryFilename(hash);
+
+    // Use the cached entry if there is one
+    if (ReadEntry(entry_filename, hash, content.size(), out_topic))
+    {
+        out_topic.FileName = filename;
+        hits++;
+
+        // Mark the entry as recently used
+        utime(entry_filename.c_str(), NULL);
+        return true;
+    }
+    misses++;
+
+    // Parse the content that was hashed (so the file is read once, and a change of the file after the hashing
+    // cannot be cached under the old hash). Only the topics without any errors are cached, so the errors are
+    // reported on every load.
+    std::shared_ptr<Diagnostics> diagnostics = out_topic.GetDiagnostics();
+    int errors_before = diagnostics->GetCounters(out_topic.Name).Errors;
+    if (!out_topic.ReadFromContent(content, filename)) return false;
+    if (diagnostics->GetCounters(out_topic.Name).Errors != errors_before) return true;
+
+    // Add the parsed topic to the cache (failing to do so does not fail the load). The directory is only scanned
+    // for the first store and when the stores since the last scan may have passed the size limit.
+    long long entry_size = 0;
+    if (WriteEntry(entry_filename, hash, content.size(), out_topic, entry_size))
+    {
+        stores++;
+        long long known_size = size_estimate;
+        if (known_size < 0 || (size_estimate += entry_size) > max_bytes) Cleanup();
+    }
+    else if (!store_warned.exchange(true))
+        diagnostics->Add(Diagnostics::Warning, "LoadCache", "Failed to write the cache entries to '" + directory + "' directory.");
+
+    return true;
+}
+
+// Remove the least recently used entries until the total size is under the limit. Also removes the temporary
+// files left by the interrupted writes.
+void LoadCache::Cleanup()
+{
+    struct EntryFile { std::string Filename; long long Size; std::time_t LastUsed; };
+    std::vector<EntryFile> entries;
+    long long total_size = 0;
+    std::time_t now = std::time(NULL);
+
+    // Find the size and the last use time of the entries
+    VecString files = Commons::GetFileList(directory);
+    for (int i = 0; i < (int)files.size(); ++i)
+    {
+        std::string filename = directory + Commons::FilePathSeparator + files[i];
+        struct stat info;
+        if (stat(filename.c_str(), &info) != 0) continue;
+
+        // Remove the temporary files that are older than an hour
+        if (files[i].find(".tmp.") != std::string::npos)
+        {
+            if (now - info.st_mtime > 3600) std::remove(filename.c_str());
+            continue;
+        }
+
+        std::string name, extension, dir;
+        if (!Commons::ExtractFilenameAndExtension(files[i], name, extension, dir) || extension != EntryExtension) continue;
+        EntryFile entry = { filename, (long long)info.st_size, info.st_mtime };
+        entries.push_back(entry);
+        total_size += entry.Size;
+    }
+    if (total_size <= max_bytes)
+    {
+        size_estimate = total_size;
+        return;
+    }
+
+    // Remove the oldest entries until the total size is 90% of the limit (so not every store needs a cleanup)
+    std::sort(entries.begin(), entries.end(), [](const EntryFile &e1, const EntryFile &e2) { return e1.LastUsed < e2.LastUsed; });
+    for (int i = 0; i < (int)entries.size() && total_size > max_bytes / 10 * 9; ++i)
+    {
+        if (std::remove(entries[i].Filename.c_str()) == 0)
+            evictions++;
+        total_size -= entries[i].Size;
+    }
+    size_estimate = total_size;
+}
+
+// Get the cache directory
+const std::string &LoadCache::GetDirectory() const
+{
+    return directory;
+}
+
+// Get the size limit of the cache in bytes
+long long LoadCache::GetMaxBytes() const
+{
+    return max_bytes;
+}
+
+// Get the number of the cache operations
+LoadCache::Stats LoadCache::GetStats() const
+{
+    Stats stats;
+    stats.Hits = hits;
+    stats.Misses = misses;
+    stats.Stores = stores;
+    stats.Evictions = evictions;
+    return stats;
+}
+
+// Get the filename of the cache entry of a hash
+std::string LoadCache::GetEntryFilename(unsigned long long hash) const
+{
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", hash);
+    return directory + Commons::FilePathSeparator + name + "." + EntryExtension;
+}
+
+// Compute the 64-bit xxHash (XXH64) of a buffer
+unsigned long long LoadCache::Hash(const char *data, size_t size, unsigned long long seed)
+{
+    const unsigned long long prime1 = 11400714785074694791ULL, prime2 = 14029467366897019727ULL,
+        prime3 = 1609587929392839161ULL, prime4 = 9650029242287828579ULL, prime5 = 2870177450012600261ULL;
+    const char *p = data, *end = data + size;
+    unsigned long long h;
+
+    // Process the 32-byte stripes with four accumulators
+    if (size >= 32)
+    {
+        unsigned long long v1 = seed + prime1 + prime2, v2 = seed + prime2, v3 = seed, v4 = seed - prime1;
+        for (; p + 32 <= end; p += 32)
+        {
+            v1 = HashRound(v1, ReadLittleEndian64(p));
+            v2 = HashRound(v2, ReadLittleEndian64(p + 8));
+            v3 = HashRound(v3, ReadLittleEndian64(p + 16));
+            v4 = HashRound(v4, ReadLittleEndian64(p + 24));
+        }
+        h = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        h = HashMerge(h, v1);
+        h = HashMerge(h, v2);
+        h = HashMerge(h, v3);
+        h = HashMerge(h, v4);
+    }
+    else
+        h = seed + prime5;
+    h += (unsigned long long)size;
+
+    // Process the remaining bytes
+    for (; p + 8 <= end; p += 8)
+        h = RotateLeft(h ^ HashRound(0, ReadLittleEndian64(p)), 27) * prime1 + prime4;
+    if (p + 4 <= end)
+    {
+        h = RotateLeft(h ^ (ReadLittleEndian32(p) * prime1), 23) * prime2 + prime3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+        h = RotateLeft(h ^ ((unsigned char)*p * prime5), 11) * prime1;
+
+    // Mix the final bits
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Get the default cache directory: ALFA_CACHE_DIR environment variable, or '.cache/alfa' in the home directory
+std::string LoadCache::GetDefaultDirectory()
+{
+    const char *cache_dir = std::getenv("ALFA_CACHE_DIR");
+    if (cache_dir && *cache_dir) return cache_dir;
+
+#if defined _WIN32 || defined __CYGWIN__
+    const char *home = std::getenv("LOCALAPPDATA");
+#else
+    const char *home = std::getenv("HOME");
+#endif
+    if (!home || !*home) return "alfa-cache";
+    return std::string(home) + Commons::FilePathSeparator + ".cache" + Commons::FilePathSeparator + "alfa";
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Read a cache entry. Returns false if there is no valid entry for the given content.
+bool LoadCache::ReadEntry(const std::string &entry_filename, unsigned long long hash, size_t content_size, Topic &out_topic) const
+{
+    std::string bytes;
+    if (!Commons::ReadFileToString(entry_filename, bytes)) return false;
+    std::istringstream iss(bytes);
+
+    // Check the format and the content of the entry
+    char magic[8];
+    int version = 0;
+    unsigned long long entry_hash = 0, entry_content_size = 0;
+    if (!(iss.read(magic, 8) && std::memcmp(magic, "ALFACCH1", 8) == 0 && Commons::ReadBinary(iss, version) &&
+        version == FormatVersion && Commons::ReadBinary(iss, entry_hash) && entry_hash == hash &&
+        Commons::ReadBinary(iss, entry_content_size) && entry_content_size == content_size))
+        return false;
+
+    return out_topic.ReadBinary(iss);
+}
+
+// Write a cache entry to a temporary file and rename it to the entry, so the other processes never read a partial entry
+bool LoadCache::WriteEntry(const std::string &entry_filename, unsigned long long hash, size_t content_size, const Topic &topic,
+    long long &out_entry_size) const
+{
+    // Create the cache directory (and its parents)
+    for (size_t pos = directory.find(Commons::FilePathSeparator, 1); ; pos = directory.find(Commons::FilePathSeparator, pos + 1))
+    {
+        std::string dir = directory.substr(0, pos);
+        struct stat info;
+        if (stat(dir.c_str(), &info) != 0 && !Commons::MakeDirectory(dir)) return false;
+        if (pos == std::string::npos) break;
+    }
+
+    // Write the entry to a temporary file unique to this process and thread
+#if defined _WIN32 || defined __CYGWIN__
+    long long process_id = _getpid();
+#else
+    long long process_id = getpid();
+#endif
+    std::ostringstream temp_filename;
+    temp_filename << entry_filename << ".tmp." << process_id << "." << std::hash<std::thread::id>()(std::this_thread::get_id());
+    {
+        std::ofstream ofs(temp_filename.str(), std::ios::binary);
+        if (!ofs.is_open()) return false;
+        ofs.write("ALFACCH1", 8);
+        Commons::WriteBinary(ofs, FormatVersion);
+        Commons::WriteBinary(ofs, hash);
+        Commons::WriteBinary(ofs, (unsigned long long)content_size);
+        if (!topic.WriteBinary(ofs) || !ofs.flush())
+        {
+            ofs.close();
+            std::remove(temp_filename.str().c_str());
+            return false;
+        }
+        out_entry_size = (long long)ofs.tellp();
+    }
+
+    // Move the entry to its place (replacing an identical entry written by another process at the same time)
+    if (std::rename(temp_filename.str().c_str(), entry_filename.c_str()) != 0)
+    {
+        std::remove(temp_filename.str().c_str());
+        struct stat info;
+        return stat(entry_filename.c_str(), &info) == 0;
+    }
+    return true;
+}
+
+// Read 8 bytes as a little-endian number
+unsigned long long LoadCache::ReadLittleEndian64(const char *p)
+{
+    unsigned long long value = 0;
+    for (int i = 7; i >= 0; --i)
+        value = (value << 8) | (unsigned char)p[i];
+    return value;
+}
+
+// Read 4 bytes as a little-endian number
+unsigned int LoadCache::ReadLittleEndian32(const char *p)
+{
+    unsigned int value = 0;
+    for (int i = 3; i >= 0; --i)
+        value = (value << 8) | (unsigned char)p[i];
+    return value;
+}
+
+// Rotate the bits of a number to the left
+unsigned long long LoadCache::RotateLeft(unsigned long long x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+// Mix 8 bytes of the input into an accumulator of the hash
+unsigned long long LoadCache::HashRound(unsigned long long acc, unsigned long long input)
+{
+    acc += input * 14029467366897019727ULL;
+    acc = RotateLeft(acc, 31);
+    return acc * 11400714785074694791ULL;
+}
+
+// Merge an accumulator into the hash
+unsigned long long LoadCache::HashMerge(unsigned long long acc, unsigned long long value)
+{
+    acc ^= HashRound(0, value);
+    return acc * 11400714785074694791ULL + 9650029242287828579ULL;
+}
+
+}
+#endif
@@ -29,6 +29,7 @@
 #include <vector>
 #include <iostream>
 #include <iomanip>
+#include <utility>
 #include "commons.h"
 
 namespace alfa
@@ -43,7 +44,7 @@ public:
     struct HeaderType           // Structure for the message headers
     {
         int SequenceID = -1;
-        long long int Stamp;
+        long long int Stamp = 0;
         std::string FrameID = "N/A";
     };
     
@@ -53,13 +54,14 @@ public:
     VecString Fields;           // Message Fields
 
     // Member Functions
-    std::string ToString(bool has_header = true, std::string separator = " | ") const;
-    std::string ToString(int l_seq, int l_stamp, int l_frid, std::vector<int> l_fields, bool has_header = true, std::string separator = " | ") const;
+    std::string ToString(bool has_header = true, const std::string &separator = " | ") const;
+    std::string ToString(int l_seq, int l_stamp, int l_frid, const std::vector<int> &l_fields, bool has_header = true, const std::string &separator = " | ") const;
     bool operator< (const Message &msg) const;
     bool operator> (const Message &msg) const;
     bool operator== (const Message &msg) const;
     bool operator!= (const Message &msg) const;
-    static Message TokensToMessage(const VecString &tokens, const VecString &field_labels);
+    static Message TokensToMessage(VecString tokens, const VecString &field_labels, int n_data_fields = -1);
+    static int CountDataFields(const VecString &field_labels);
     static Message TokensToMessage(const VecString &tokens, const VecString &field_labels, int &out_len_seqid,
             int &out_len_stamp, int &out_len_frameid, std::vector<int> &out_len_fields);
 };
@@ -77,14 +79,14 @@ std::ostream& operator<< (std::ostream& os, const Message& msg)
 /******************************************************************************/
 
 // Convert Message to string, using the default values for fiels sizes
-std::string Message::ToString(bool has_header, std::string separator) const
+std::string Message::ToString(bool has_header, const std::string &separator) const
 {
     return ToString(5, 10, 0, std::vector<int>(Fields.size()), has_header, separator);
 }
 
 // Convert Message to string, given the minimum spacing for each field member
 std::string Message::ToString(int l_seq, int l_stamp, int l_frid, 
-        std::vector<int> l_fields, bool has_header, std::string separator) const
+        const std::vector<int> &l_fields, bool has_header, const std::string &separator) const
 {
     // Create an output string stream
     std::ostringstream oss;
@@ -162,47 +164,71 @@ bool Message::operator!= (const Message &msg) const
     return !(msg == *this);
 }
 
-// Convert a token collection to Message object
-Message Message::TokensToMessage(const VecString &tokens, const VecString &field_labels)
+// Convert a token collection to Message object. Only parses the tokens (the field strings are moved
+// from the tokens, so pass an rvalue to avoid copying them). The number of the data fields (from CountDataFields)
+// can be given to avoid counting it for every message.
+Message Message::TokensToMessage(VecString tokens, const VecString &field_labels, int n_data_fields)
 {
-    int len_seqid = 0, len_stamp = 0, len_frameid = 0;
-    std::vector<int> len_fields;
-    return TokensToMessage(tokens, field_labels, len_seqid, len_stamp, len_frameid, len_fields);
+    // The special labels are only built once
+    static const std::string label_seqid = Commons::CSVFieldsPrefix + "header.seq";
+    static const std::string label_stamp = Commons::CSVFieldsPrefix + "header.stamp";
+    static const std::string label_frameid = Commons::CSVFieldsPrefix + "header.frame_id";
+
+    Message msg;
+
+    // Allocate the fields once (the labels also include the time and the header, which are not fields)
+    msg.Fields.reserve(n_data_fields >= 0 ? n_data_fields : CountDataFields(field_labels));
+
+    // Check the type of the current token (time, header, etc.)
+    for (int i = 0; i < (int)field_labels.size(); ++i)
+    {
+        if (field_labels[i].compare("%time") == 0)                      // If it is timestamp
+            msg.DateTime = DateTime::EpochStringToTime(tokens[i]);
+        else if (field_labels[i] == label_seqid)                        // If it is sequence id
+            Commons::StringToInt(tokens[i], msg.Header.SequenceID);
+        else if (field_labels[i] == label_stamp)                        // If it is header stamp
+            Commons::StringToLongLong(tokens[i], msg.Header.Stamp);
+        else if (field_labels[i] == label_frameid)                      // If it is frame id
+            msg.Header.FrameID = std::move(tokens[i]);
+        else                                                            // If it is any other field
+            msg.Fields.push_back(std::move(tokens[i]));
+    }
+    return msg;
+}
+
+// Count the labels of the data fields (all the labels except the time and the header)
+int Message::CountDataFields(const VecString &field_labels)
+{
+    static const std::string label_header_prefix = Commons::CSVFieldsPrefix + "header.";
+    static const std::string label_seqid = label_header_prefix + "seq";
+    static const std::string label_stamp = label_header_prefix + "stamp";
+    static const std::string label_frameid = label_header_prefix + "frame_id";
+
+    int n_data_fields = 0;
+    for (int i = 0; i < (int)field_labels.size(); ++i)
+        if (field_labels[i] != "%time" && field_labels[i] != label_seqid && field_labels[i] != label_stamp &&
+            field_labels[i] != label_frameid)
+            n_data_fields++;
+    return n_data_fields;
 }
 
 // Convert a token collection to Message object and output the string sizes of the fields
 Message Message::TokensToMessage(const VecString &tokens, const VecString &field_labels, int &out_len_seqid, 
             int &out_len_stamp, int &out_len_frameid, std::vector<int> &out_len_fields)
 {
-    Message msg;
+    Message msg = TokensToMessage(tokens, field_labels);
+
+    // Measure the string sizes of the header and the other fields
     out_len_seqid = 0; out_len_stamp = 0; out_len_frameid = 0;
     out_len_fields.clear();
-
-    // Check the type of the current token (time, header, etc.)
+    out_len_fields.reserve(msg.Fields.size());
     for (int i = 0; i < (int)field_labels.size(); ++i)
     {
-        if (field_labels[i].compare("%time") == 0)                                              // If it is timestamp
-            msg.DateTime = DateTime::EpochStringToTime(tokens[i]);
-        else if (field_labels[i].compare(Commons::CSVFieldsPrefix + "header.seq") == 0)         // If it is sequence id
-        {
-            Commons::StringToInt(tokens[i], msg.Header.SequenceID);
-            out_len_seqid = tokens[i].length();
-        }
-        else if (field_labels[i].compare(Commons::CSVFieldsPrefix + "header.stamp") == 0)       // If it is header stamp
-        {
-            Commons::StringToLongLong(tokens[i], msg.Header.Stamp);
-            out_len_stamp = tokens[i].length();
-        }
-        else if (field_labels[i].compare(Commons::CSVFieldsPrefix + "header.frame_id") == 0)     // If it is frame id
-        {
-            msg.Header.FrameID = tokens[i];
-            out_len_frameid = tokens[i].length();
-        }
-        else                                                                                      // If it is any other field
-        {
-            msg.Fields.push_back(tokens[i]);
-            out_len_fields.push_back(tokens[i].length());
-        }
+        if (field_labels[i].compare("%time") == 0) continue;
+        else if (field_labels[i].compare(Commons::CSVFieldsPrefix + "header.seq") == 0) out_len_seqid = tokens[i].length();
+        else if (field_labels[i].compare(Commons::CSVFieldsPrefix + "header.stamp") == 0) out_len_stamp = tokens[i].length();
+        else if (field_labels[i].compare(Commons::CSVFieldsPrefix + "header.frame_id") == 0) out_len_frameid = tokens[i].length();
+        else out_len_fields.push_back(tokens[i].length());
     }
     return msg;
 }
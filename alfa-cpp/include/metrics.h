@@ -0,0 +1,541 @@
+/*  ***************************************************************************
+*   metrics.h - Header for the counters, gauges and histograms of the processes.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_METRICS_H
+#define ALFA_METRICS_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include "commons.h"
+
+// The metrics are served over HTTP with the POSIX sockets
+#if !(defined _WIN32 || defined __CYGWIN__)
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+namespace alfa
+{
+
+// This class keeps the metrics of a process (counters, gauges and histograms) and writes them in the text
+// format of Prometheus. The metrics are registered once (under a lock) and the returned references are then
+// updated on the hot paths with relaxed atomic operations only, so the updates never wait for each other or
+// for the export. The metrics that are cheaper to read when exported (e.g. the memory use) are registered as
+// callbacks. Registering a name with the same labels again returns the existing metric.
+class Metrics
+{
+public:
+
+    // Local class and enum definitions
+    enum Type { CounterType, GaugeType, HistogramType };
+
+    class Counter                       // A value that only increases
+    {
+    public:
+        void Increment(unsigned long long n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+        unsigned long long Get() const { return value.load(std::memory_order_relaxed); }
+    private:
+        std::atomic<unsigned long long> value{0};
+    };
+
+    class Gauge                         // A value that goes up and down
+    {
+    public:
+        void Set(double new_value) { value.store(new_value, std::memory_order_relaxed); }
+        void Add(double delta);
+        double Get() const { return value.load(std::memory_order_relaxed); }
+    private:
+        std::atomic<double> value{0.0};
+    };
+
+    class Histogram                     // Distribution of the observed values in fixed buckets
+    {
+    public:
+        Histogram(const std::vector<double> &upper_bounds);
+        void Observe(double value);
+        const std::vector<double> &GetUpperBounds() const { return upper_bounds; }
+        unsigned long long GetBucketCount(int bucket_idx) const { return buckets[bucket_idx].load(std::memory_order_relaxed); }
+        double GetSum() const { return sum.load(std::memory_order_relaxed); }
+        unsigned long long GetCount() const;
+    private:
+        std::vector<double> upper_bounds;
+        std::unique_ptr<std::atomic<unsigned long long>[]> buckets;     // The last bucket is +Inf
+        std::atomic<double> sum{0.0};
+    };
+
+    // Constructors & Deconstructors
+    Metrics() {}
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+
+    // Member Functions
+    Counter &AddCounter(const std::string &name, const std::string &help, const std::string &labels = "");
+    Gauge &AddGauge(const std::string &name, const std::string &help, const std::string &labels = "");
+    Histogram &AddHistogram(const std::string &name, const std::string &help, const std::vector<double> &upper_bounds,
+        const std::string &labels = "");
+    void AddCallback(const std::string &name, const std::string &help, Type type, const std::function<double()> &callback,
+        const std::string &labels = "");
+    void AddProcessMetrics();
+    std::string ToText() const;
+    bool WriteToFile(const std::string &filename) const;
+    static std::vector<double> ExponentialBuckets(double start, double factor, int count);
+
+private:
+    // Local struct definitions
+    struct Series                       // A metric with a set of labels (e.g. 'type="rows"')
+    {
+        std::string Labels;
+        std::unique_ptr<Counter> CounterValue;
+        std::unique_ptr<Gauge> GaugeValue;
+        std::unique_ptr<Histogram> HistogramValue;
+        std::function<double()> Callback;
+    };
+
+    struct Family                       // All the series of a metric name
+    {
+        std::string Name, Help;
+        Type MetricType;
+        std::vector<std::unique_ptr<Series> > AllSeries;
+    };
+
+    // Member Functions
+    Series &FindOrAddSeries(const std::string &name, const std::string &help, Type type, const std::string &labels);
+    static void WriteSample(std::ostream &os, const std::string &name, const std::string &labels, double value);
+    static std::string FormatValue(double value);
+
+    // Data Members
+    mutable std::mutex registry_mutex;
+    std::vector<std::unique_ptr<Family> > families;
+};
+
+// This class exports the metrics of a process in the background: over HTTP on a local port (for Prometheus
+// to scrape '/metrics') and/or by rewriting a file periodically (e.g. for the text file collector of the
+// node exporter). The file is written once more when the exporter is stopped, so short runs are recorded too.
+class MetricsExporter
+{
+public:
+
+    // Local struct definitions
+    struct Options
+    {
+        int HttpPort = 0;                           // Port of the HTTP listener (not started if zero)
+        std::string HttpAddress = "127.0.0.1";      // Address of the HTTP listener (local only by default)
+        std::string Filename;                       // File of the periodic writes (not written if empty)
+        double FileInterval = 10;                   // Seconds between the writes of the file
+    };
+
+    // Constructors & Deconstructors
+    MetricsExporter(const Metrics &metrics, const Options &options);
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    // Member Functions
+    bool Start();
+    void Stop();
+
+private:
+    // Member Functions
+    void ServeHttp();
+    void WriteFilePeriodically();
+    void AnswerHttp(int socket_fd) const;
+
+    // Data Members
+    const Metrics &metrics;
+    Options options;
+    std::atomic<bool> running{false};
+    int listen_fd = -1;
+    std::thread http_thread, file_thread;
+    std::mutex stop_mutex;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Add a value to the gauge (without a lock)
+void Metrics::Gauge::Add(double delta)
+{
+    double current = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed));
+}
+
+// Constructor function for Histogram with the (sorted) upper bounds of its buckets
+Metrics::Histogram::Histogram(const std::vector<double> &upper_bounds)
+    : upper_bounds(upper_bounds), buckets(new std::atomic<unsigned long long>[upper_bounds.size() + 1])
+{
+    std::sort(this->upper_bounds.begin(), this->upper_bounds.end());
+    for (size_t i = 0; i <= upper_bounds.size(); ++i)
+        buckets[i].store(0, std::memory_order_relaxed);
+}
+
+// Count a value in its bucket and add it to the sum (without a lock)
+void Metrics::Histogram::Observe(double value)
+{
+    size_t bucket = std::lower_bound(upper_bounds.begin(), upper_bounds.end(), value) - upper_bounds.begin();
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    double current = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed));
+}
+
+// Get the number of the observed values
+unsigned long long Metrics::Histogram::GetCount() const
+{
+    unsigned long long count = 0;
+    for (size_t i = 0; i <= upper_bounds.size(); ++i)
+        count += buckets[i].load(std::memory_order_relaxed);
+    return count;
+}
+
+// Register a counter (or get the registered one)
+Metrics::Counter &Metrics::AddCounter(const std::string &name, const std::string &help, const std::string &labels)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Series &series = FindOrAddSeries(name, help, CounterType, labels);
+    if (!series.CounterValue) series.CounterValue.reset(new Counter());
+    return *series.CounterValue;
+}
+
+// Register a gauge (or get the registered one)
+Metrics::Gauge &Metrics::AddGauge(const std::string &name, const std::string &help, const std::string &labels)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Series &series = FindOrAddSeries(name, help, GaugeType, labels);
+    if (!series.GaugeValue) series.GaugeValue.reset(new Gauge());
+    return *series.GaugeValue;
+}
+
+// Register a histogram with the upper bounds of its buckets (or get the registered one)
+Metrics::Histogram &Metrics::AddHistogram(const std::string &name, const std::string &help, const std::vector<double> &upper_bounds,
+    const std::string &labels)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Series &series = FindOrAddSeries(name, help, HistogramType, labels);
+    if (!series.HistogramValue) series.HistogramValue.reset(new Histogram(upper_bounds));
+    return *series.HistogramValue;
+}
+
+// Register a counter or a gauge whose value is read by a function when the metrics are exported
+void Metrics::AddCallback(const std::string &name, const std::string &help, Type type, const std::function<double()> &callback,
+    const std::string &labels)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    FindOrAddSeries(name, help, type == HistogramType ? GaugeType : type, labels).Callback = callback;
+}
+
+// Register the standard metrics of the process: the CPU time and the memory use (the memory only on Linux)
+void Metrics::AddProcessMetrics()
+{
+    AddCallback("process_cpu_seconds_total", "Total user and system CPU time spent in seconds.", CounterType,
+        []() { return (double)std::clock() / CLOCKS_PER_SEC; });
+
+    const double start_time = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    AddCallback("process_start_time_seconds", "Start time of the process since unix epoch in seconds.", GaugeType,
+        [start_time]() { return start_time; });
+
+#if defined __linux__
+    // Read the sizes (in pages) from /proc/self/statm
+    auto read_statm = [](int field_idx)
+    {
+        std::ifstream ifs("/proc/self/statm");
+        double pages[2] = { 0, 0 };
+        ifs >> pages[0] >> pages[1];
+        return pages[field_idx] * sysconf(_SC_PAGESIZE);
+    };
+    AddCallback("process_virtual_memory_bytes", "Virtual memory size in bytes.", GaugeType, [read_statm]() { return read_statm(0); });
+    AddCallback("process_resident_memory_bytes", "Resident memory size in bytes.", GaugeType, [read_statm]() { return read_statm(1); });
+#endif
+}
+
+// Write all the metrics in the text format of Prometheus (version 0.0.4)
+std::string Metrics::ToText() const
+{
+    std::ostringstream oss;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (int f = 0; f < (int)families.size(); ++f)
+    {
+        const Family &family = *families[f];
+        static const char *type_names[3] = { "counter", "gauge", "histogram" };
+        oss << "# HELP " << family.Name << " " << family.Help << "\n";
+        oss << "# TYPE " << family.Name << " " << type_names[family.MetricType] << "\n";
+        for (int s = 0; s < (int)family.AllSeries.size(); ++s)
+        {
+            const Series &series = *family.AllSeries[s];
+            if (series.Callback) WriteSample(oss, family.Name, series.Labels, series.Callback());
+            else if (series.CounterValue) WriteSample(oss, family.Name, series.Labels, (double)series.CounterValue->Get());
+            else if (series.GaugeValue) WriteSample(oss, family.Name, series.Labels, series.GaugeValue->Get());
+            else if (series.HistogramValue)
+            {
+                // Write the cumulative counts of the buckets, the sum and the count
+                const Histogram &histogram = *series.HistogramValue;
+                const std::vector<double> &bounds = histogram.GetUpperBounds();
+                std::string separator = series.Labels.empty() ? "" : ",";
+                unsigned long long cumulative = 0;
+                for (int b = 0; b <= (int)bounds.size(); ++b)
+                {
+                    cumulative += histogram.GetBucketCount(b);
+                    std::string le = b < (int)bounds.size() ? FormatValue(bounds[b]) : "+Inf";
+                    WriteSample(oss, family.Name + "_bucket", series.Labels + separator + "le=\"" + le + "\"", (double)cumulative);
+                }
+                WriteSample(oss, family.Name + "_sum", series.Labels, histogram.GetSum());
+                WriteSample(oss, family.Name + "_count", series.Labels, (double)cumulative);
+            }
+        }
+    }
+    return oss.str();
+}
+
+// Write the metrics to a file. The file is replaced at once, so the readers never see a partial file
+// (or a missing one, except on Windows).
+bool Metrics::WriteToFile(const std::string &filename) const
+{
+    std::string temp_filename = filename + ".tmp";
+    {
+        std::ofstream ofs(temp_filename, std::ios::binary);
+        if (!ofs.is_open())
+        {
+            std::cerr << "Failed to open '" << temp_filename << "' file for writing." << std::endl;
+            return false;
+        }
+        ofs << ToText();
+        if (!ofs) return false;
+    }
+    // rename replaces the file atomically on POSIX, but it fails on Windows if the file exists
+#if defined _WIN32
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(temp_filename.c_str(), filename.c_str()) != 0)
+    {
+        std::cerr << "Failed to replace '" << filename << "' file." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Get the upper bounds of the buckets that grow by a factor (e.g. 0.001, 0.002, 0.004, ...)
+std::vector<double> Metrics::ExponentialBuckets(double start, double factor, int count)
+{
+    std::vector<double> bounds;
+    for (int i = 0; i < count; ++i, start *= factor)
+        bounds.push_back(start);
+    return bounds;
+}
+
+// Constructor function for MetricsExporter (the metrics should outlive the exporter)
+MetricsExporter::MetricsExporter(const Metrics &metrics, const Options &options)
+    : metrics(metrics), options(options)
+{
+}
+
+// Deconstructor function for MetricsExporter
+MetricsExporter::~MetricsExporter()
+{
+    Stop();
+}
+
+// Start the HTTP listener and the periodic writes of the file (whichever is enabled)
+bool MetricsExporter::Start()
+{
+    if (running) return true;
+
+    if (options.HttpPort > 0)
+    {
+#if !(defined _WIN32 || defined __CYGWIN__)
+        // Listen on the local port
+        struct sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options.HttpPort);
+        int reuse = 1;
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0 || inet_pton(AF_INET, options.HttpAddress.c_str(), &address.sin_addr) != 1 ||
+            setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+            bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listen_fd, 16) != 0)
+        {
+            std::cerr << "MetricsExporter Error! Failed to listen on " << options.HttpAddress << ":" << options.HttpPort << ": " <<
+                std::strerror(errno) << std::endl;
+            if (listen_fd >= 0) close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+#else
+        std::cerr << "MetricsExporter Error! The HTTP listener is not supported on this platform." << std::endl;
+        return false;
+#endif
+    }
+
+    running = true;
+    if (listen_fd >= 0) http_thread = std::thread(&MetricsExporter::ServeHttp, this);
+    if (!options.Filename.empty()) file_thread = std::thread(&MetricsExporter::WriteFilePeriodically, this);
+    return true;
+}
+
+// Stop the listener and write the file for the last time
+void MetricsExporter::Stop()
+{
+    std::lock_guard<std::mutex> lock(stop_mutex);
+    if (!running) return;
+    running = false;
+    if (http_thread.joinable()) http_thread.join();
+    if (file_thread.joinable()) file_thread.join();
+#if !(defined _WIN32 || defined __CYGWIN__)
+    if (listen_fd >= 0) close(listen_fd);
+#endif
+    listen_fd = -1;
+    if (!options.Filename.empty()) metrics.WriteToFile(options.Filename);
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Find the series of a name and labels, or add it
+Metrics::Series &Metrics::FindOrAddSeries(const std::string &name, const std::string &help, Type type, const std::string &labels)
+{
+    // Find the family of the name (or add it)
+    Family *family = nullptr;
+    for (int f = 0; f < (int)families.size() && !family; ++f)
+        if (families[f]->Name == name)
+            family = families[f].get();
+    if (!family)
+    {
+        families.push_back(std::unique_ptr<Family>(new Family()));
+        family = families.back().get();
+        family->Name = name;
+        family->Help = help;
+        family->MetricType = type;
+    }
+
+    // Find the series of the labels (or add it)
+    for (int s = 0; s < (int)family->AllSeries.size(); ++s)
+        if (family->AllSeries[s]->Labels == labels)
+            return *family->AllSeries[s];
+    family->AllSeries.push_back(std::unique_ptr<Series>(new Series()));
+    family->AllSeries.back()->Labels = labels;
+    return *family->AllSeries.back();
+}
+
+// Write a sample line: name{labels} value
+void Metrics::WriteSample(std::ostream &os, const std::string &name, const std::string &labels, double value)
+{
+    os << name;
+    if (!labels.empty()) os << "{" << labels << "}";
+    os << " " << FormatValue(value) << "\n";
+}
+
+// Format a value as a number of the text format (with +Inf, -Inf and NaN)
+std::string Metrics::FormatValue(double value)
+{
+    if (std::isnan(value)) return "NaN";
+    if (std::isinf(value)) return value > 0 ? "+Inf" : "-Inf";
+    std::ostringstream oss;
+    oss << std::setprecision(std::numeric_limits<double>::digits10) << value;
+    return oss.str();
+}
+
+// Answer the HTTP requests until the exporter is stopped
+void MetricsExporter::ServeHttp()
+{
+#if !(defined _WIN32 || defined __CYGWIN__)
+    while (running)
+    {
+        struct pollfd poll_fd = { listen_fd, POLLIN, 0 };
+        if (poll(&poll_fd, 1, 200) <= 0 || !(poll_fd.revents & POLLIN)) continue;
+        int socket_fd = accept(listen_fd, nullptr, nullptr);
+        if (socket_fd < 0) continue;
+        AnswerHttp(socket_fd);
+        close(socket_fd);
+    }
+#endif
+}
+
+// Read an HTTP request and answer it with the metrics ('GET /metrics' or 'GET /') or an error
+void MetricsExporter::AnswerHttp(int socket_fd) const
+{
+#if !(defined _WIN32 || defined __CYGWIN__)
+    // Read the request until the end of its header (waiting at most a second)
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192)
+    {
+        struct pollfd poll_fd = { socket_fd, POLLIN, 0 };
+        if (poll(&poll_fd, 1, 1000) <= 0) return;
+        ssize_t n = recv(socket_fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return;
+        request.append(buffer, n);
+    }
+
+    // Answer the request
+    std::string status = "200 OK", body;
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0) body = metrics.ToText();
+    else if (request.compare(0, 4, "GET ") == 0) { status = "404 Not Found"; body = "Not found. The metrics are at /metrics.\n"; }
+    else { status = "405 Method Not Allowed"; body = "Only GET is supported.\n"; }
+    std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n" +
+        "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    for (size_t sent = 0; sent < response.size();)
+    {
+        ssize_t n = send(socket_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        sent += n;
+    }
+#endif
+}
+
+// Write the file at the intervals until the exporter is stopped
+void MetricsExporter::WriteFilePeriodically()
+{
+    std::chrono::steady_clock::time_point next_write = std::chrono::steady_clock::now();
+    while (running)
+    {
+        if (std::chrono::steady_clock::now() >= next_write)
+        {
+            metrics.WriteToFile(options.Filename);
+            next_write += std::chrono::microseconds((long long)(options.FileInterval * 1e6));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+}
+#endif
@@ -0,0 +1,341 @@
+/*  ***************************************************************************
+*   ndjson_export.h - Header for exporting topics and sequences as JSON Lines.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_NDJSON_EXPORT_H
+#define ALFA_NDJSON_EXPORT_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "commons.h"
+#include "topic.h"
+#include "sequence.h"
+
+namespace alfa
+{
+
+// This class exports a topic, a time slice of it, or the merged (time-sorted) messages of a sequence as
+// newline-delimited JSON (one object per message). For example:
+// {"topic":"mavros-nav_info-roll","time":1531943611000000005,"commanded":0.0,"measured":-0.0398}
+// The times are integer nanoseconds since the epoch. The numeric fields are written as numbers (their
+// original text, so no precision is lost), True/False as booleans, NaN and infinity as null, and the other
+// fields as strings. The records are encoded in parallel chunks and written in their original order.
+class NDJSONExporter
+{
+public:
+
+    // Local struct definitions
+    struct Options
+    {
+        long long StartTime = LLONG_MIN;    // Only the messages in [StartTime, EndTime] (epoch nanoseconds, timeline time for the sequences)
+        long long EndTime = LLONG_MAX;
+        bool TypedValues = true;            // Write the numbers and the booleans without quotes
+        bool IncludeHeader = true;          // Write the header of the messages (if the topic has one)
+        int ChunkSize = 4096;               // Number of the records encoded by a thread at once
+        int NThreads = 0;                   // Number of the encoding threads (all the cores if not positive)
+    };
+
+    // Constructors & Deconstructors
+    NDJSONExporter();
+    NDJSONExporter(const Options &options);
+
+    // Member Functions
+    long long ExportTopic(const Topic &topic, std::ostream &os) const;
+    long long ExportTopic(const Topic &topic, const std::string &filename) const;
+    long long ExportTimeline(const Sequence &sequence, std::ostream &os) const;
+    long long ExportTimeline(const Sequence &sequence, const std::string &filename) const;
+
+    static void AppendInteger(std::string &out, long long number);
+    static void AppendValue(std::string &out, const std::string &value, bool typed);
+    static bool IsNumber(const std::string &str);
+
+private:
+    // Local struct definitions
+    struct TopicKeys            // Pre-encoded keys of a topic
+    {
+        std::string Prefix;     // '{"topic":"<name>","time":'
+        VecString Fields;       // ',"<label>":'
+        bool HasHeader = false;
+    };
+
+    // Member Functions
+    long long WriteRecords(size_t n_records, const std::function<void(size_t, std::string &)> &encode, std::ostream &os) const;
+    static TopicKeys CreateKeys(const Topic &topic);
+    void EncodeMessage(const Message &msg, const TopicKeys &keys, std::string &out) const;
+    static size_t FindFirstAtOrAfter(size_t n, long long time, const std::function<long long(size_t)> &get_time);
+
+    // Data Members
+    Options options;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Default constructor function for NDJSONExporter (exports all the messages)
+NDJSONExporter::NDJSONExporter()
+{
+}
+
+// Constructor function for NDJSONExporter
+NDJSONExporter::NDJSONExporter(const Options &options)
+    : options(options)
+{
+}
+
+// Export the messages of a topic in the time window. Returns the number of the written records (-1 if failed).
+long long NDJSONExporter::ExportTopic(const Topic &topic, std::ostream &os) const
+{
+    // Find the messages in the time window
+    auto get_time = [&topic](size_t i) { return topic.Messages[i].DateTime.ToEpochNanoseconds(); };
+    size_t start = FindFirstAtOrAfter(topic.Messages.size(), options.StartTime, get_time);
+    size_t end = options.EndTime == LLONG_MAX ? topic.Messages.size() :
+        FindFirstAtOrAfter(topic.Messages.size(), options.EndTime + 1, get_time);
+    if (end < start) end = start;
+
+    // Encode the messages
+    TopicKeys keys = CreateKeys(topic);
+    return WriteRecords(end - start, [&](size_t i, std::string &out)
+    {
+        EncodeMessage(topic.Messages[start + i], keys, out);
+    }, os);
+}
+
+// Export the messages of a topic in the time window to a file
+long long NDJSONExporter::ExportTopic(const Topic &topic, const std::string &filename) const
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return -1;
+    }
+    return ExportTopic(topic, ofs);
+}
+
+// Export all the messages of a sequence in the time window, in the order of its timeline (the recorded time, or
+// the header stamp in the HeaderStamp mode)
+long long NDJSONExporter::ExportTimeline(const Sequence &sequence, std::ostream &os) const
+{
+    // Find the messages in the time window
+    const std::vector<Sequence::MessageIndex> &timeline = sequence.MessageIndexList;
+    auto get_time = [&sequence](size_t i) { return sequence.GetTimelineTime(i); };
+    size_t start = FindFirstAtOrAfter(timeline.size(), options.StartTime, get_time);
+    size_t end = options.EndTime == LLONG_MAX ? timeline.size() : FindFirstAtOrAfter(timeline.size(), options.EndTime + 1, get_time);
+    if (end < start) end = start;
+
+    // Encode the messages with the keys of their topics
+    std::vector<TopicKeys> keys;
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+        keys.push_back(CreateKeys(sequence.Topics[t]));
+    return WriteRecords(end - start, [&](size_t i, std::string &out)
+    {
+        const Sequence::MessageIndex &index = timeline[start + i];
+        EncodeMessage(sequence.Topics[index.TopicIdx].Messages[index.MessageIdx], keys[index.TopicIdx], out);
+    }, os);
+}
+
+// Export all the messages of a sequence in the time window to a file
+long long NDJSONExporter::ExportTimeline(const Sequence &sequence, const std::string &filename) const
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return -1;
+    }
+    return ExportTimeline(sequence, ofs);
+}
+
+// Append an integer number (without going through the streams)
+void NDJSONExporter::AppendInteger(std::string &out, long long number)
+{
+    char buffer[24];
+    char *end = buffer + sizeof(buffer), *p = end;
+    unsigned long long value = number < 0 ? 0ULL - (unsigned long long)number : (unsigned long long)number;
+    do
+    {
+        *--p = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    if (number < 0) *--p = '-';
+    out.append(p, end - p);
+}
+
+// Append a field value as a JSON number, boolean or null if possible (and typed is true), or as a string
+void NDJSONExporter::AppendValue(std::string &out, const std::string &value, bool typed)
+{
+    if (typed)
+    {
+        if (IsNumber(value)) { out += value; return; }
+        if (value == "True" || value == "true") { out += "true"; return; }
+        if (value == "False" || value == "false") { out += "false"; return; }
+        if (value == "nan" || value == "NaN" || value == "inf" || value == "-inf" || value == "Inf" || value == "-Inf")
+        {
+            out += "null";
+            return;
+        }
+    }
+    Commons::AppendJSONString(out, value);
+}
+
+// Check if a string is a number in the JSON format: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+bool NDJSONExporter::IsNumber(const std::string &str)
+{
+    const char *p = str.c_str(), *end = p + str.size();
+    if (p < end && *p == '-') ++p;
+
+    // Integer part
+    if (p == end) return false;
+    if (*p == '0') ++p;
+    else if (*p >= '1' && *p <= '9') { while (p < end && *p >= '0' && *p <= '9') ++p; }
+    else return false;
+
+    // Fraction part
+    if (p < end && *p == '.')
+    {
+        ++p;
+        if (p == end || *p < '0' || *p > '9') return false;
+        while (p < end && *p >= '0' && *p <= '9') ++p;
+    }
+
+    // Exponent part
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        if (p < end && (*p == '+' || *p == '-')) ++p;
+        if (p == end || *p < '0' || *p > '9') return false;
+        while (p < end && *p >= '0' && *p <= '9') ++p;
+    }
+
+    return p == end;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Encode the records in parallel chunks and write them in order. A few chunks per thread are
+// encoded at a time, so the memory use does not depend on the number of the records.
+long long NDJSONExporter::WriteRecords(size_t n_records, const std::function<void(size_t, std::string &)> &encode, std::ostream &os) const
+{
+    const size_t chunk_size = std::max(1, options.ChunkSize);
+    const size_t n_chunks = (n_records + chunk_size - 1) / chunk_size;
+    const int n_threads = Commons::GetThreadCount(options.NThreads, n_chunks);
+    const size_t round_size = (size_t)n_threads * 4;
+
+    std::vector<std::string> buffers(round_size);
+    for (size_t round_start = 0; round_start < n_chunks; round_start += round_size)
+    {
+        // Encode the chunks of this round
+        int n_round = std::min(round_size, n_chunks - round_start);
+        Commons::ParallelFor(n_round, n_threads, [&](int c)
+        {
+            std::string &buffer = buffers[c];
+            buffer.clear();
+            size_t begin = (round_start + c) * chunk_size;
+            size_t end = std::min(n_records, begin + chunk_size);
+            for (size_t i = begin; i < end; ++i)
+                encode(i, buffer);
+        });
+
+        // Write the chunks in order
+        for (int c = 0; c < n_round; ++c)
+            os.write(buffers[c].data(), buffers[c].size());
+        if (!os)
+        {
+            std::cerr << "NDJSONExporter Error! Failed to write the records." << std::endl;
+            return -1;
+        }
+    }
+
+    os.flush();
+    return n_records;
+}
+
+// Create the encoded keys of a topic
+NDJSONExporter::TopicKeys NDJSONExporter::CreateKeys(const Topic &topic)
+{
+    TopicKeys keys;
+    keys.Prefix = "{\"topic\":";
+    Commons::AppendJSONString(keys.Prefix, topic.Name);
+    keys.Prefix += ",\"time\":";
+    for (int i = 0; i < (int)topic.FieldLabels.size(); ++i)
+    {
+        std::string key = ",";
+        Commons::AppendJSONString(key, topic.FieldLabels[i]);
+        keys.Fields.push_back(key + ":");
+    }
+    keys.HasHeader = topic.HasHeaderField();
+    return keys;
+}
+
+// Encode a message as a single line
+void NDJSONExporter::EncodeMessage(const Message &msg, const TopicKeys &keys, std::string &out) const
+{
+    out += keys.Prefix;
+    AppendInteger(out, msg.DateTime.ToEpochNanoseconds());
+
+    // Write the header
+    if (keys.HasHeader && options.IncludeHeader)
+    {
+        out += ",\"header\":{\"seq\":";
+        AppendInteger(out, msg.Header.SequenceID);
+        out += ",\"stamp\":";
+        AppendInteger(out, msg.Header.Stamp);
+        out += ",\"frame_id\":";
+        Commons::AppendJSONString(out, msg.Header.FrameID);
+        out += '}';
+    }
+
+    // Write the fields
+    for (int i = 0; i < (int)msg.Fields.size() && i < (int)keys.Fields.size(); ++i)
+    {
+        out += keys.Fields[i];
+        AppendValue(out, msg.Fields[i], options.TypedValues);
+    }
+    out += "}\n";
+}
+
+// Find the first of the n time-sorted items recorded at or after the given time
+size_t NDJSONExporter::FindFirstAtOrAfter(size_t n, long long time, const std::function<long long(size_t)> &get_time)
+{
+    if (time == LLONG_MIN) return 0;
+    size_t low = 0, high = n;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (get_time(mid) < time) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+}
+#endif
@@ -0,0 +1,244 @@
+/*  ***************************************************************************
+*   perf_counters.h - Header for reading the hardware performance counters.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_PERF_COUNTERS_H
+#define ALFA_PERF_COUNTERS_H
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+
+// The counters are read with perf_event_open, which is only available on Linux
+#if defined __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace alfa
+{
+
+// This class counts the hardware events (cycles, instructions, L1 data cache and last level cache misses
+// and branch misses) of the calling thread and the threads it creates between Start() and Stop(). The
+// counters that cannot be opened (e.g. on other systems than Linux, in the virtual machines without a PMU,
+// or when perf_event_paranoid does not allow it) are marked as unavailable, and only the time is measured.
+class PerfCounters
+{
+public:
+
+    // Local enum and struct definitions
+    enum Event { Cycles = 0, Instructions, L1DataMisses, LLCMisses, BranchMisses, NumEvents };
+
+    struct Values                           // Counts of the events in a measured interval
+    {
+        long long Counts[NumEvents] = {};
+        bool Available[NumEvents] = {};
+        double Seconds = 0;
+
+        Values &operator+=(const Values &other);
+        double GetIPC() const;              // Instructions per cycle (negative if not available)
+        double GetPerRow(Event event, long long n_rows) const;    // Events per row (negative if not available)
+        std::string ToString(long long n_rows = 0) const;
+    };
+
+    // Constructors & Deconstructors
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // Member Functions
+    bool IsAvailable() const;
+    bool IsAvailable(Event event) const;
+    void Start();
+    Values Stop();
+    static std::string GetEventName(Event event);
+
+private:
+    // Data Members
+    int file_descriptors[NumEvents];
+    std::chrono::steady_clock::time_point start_time;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for PerfCounters. Opens the counters (disabled until Start is called).
+PerfCounters::PerfCounters()
+{
+    for (int e = 0; e < NumEvents; ++e)
+        file_descriptors[e] = -1;
+
+#if defined __linux__
+    // The hardware and the cache events of each counter
+    const unsigned int types[NumEvents] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+    const unsigned long long configs[NumEvents] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+    for (int e = 0; e < NumEvents; ++e)
+    {
+        // Count only the user space of this process (also the threads created while counting)
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[e];
+        attr.config = configs[e];
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        file_descriptors[e] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+// Deconstructor function for PerfCounters. Closes the counters.
+PerfCounters::~PerfCounters()
+{
+#if defined __linux__
+    for (int e = 0; e < NumEvents; ++e)
+        if (file_descriptors[e] >= 0)
+            close(file_descriptors[e]);
+#endif
+}
+
+// Returns true if any of the counters is available
+bool PerfCounters::IsAvailable() const
+{
+    for (int e = 0; e < NumEvents; ++e)
+        if (file_descriptors[e] >= 0)
+            return true;
+    return false;
+}
+
+// Returns true if the counter of the event is available
+bool PerfCounters::IsAvailable(Event event) const
+{
+    return file_descriptors[event] >= 0;
+}
+
+// Reset and start the counters
+void PerfCounters::Start()
+{
+#if defined __linux__
+    for (int e = 0; e < NumEvents; ++e)
+        if (file_descriptors[e] >= 0)
+            ioctl(file_descriptors[e], PERF_EVENT_IOC_RESET, 0);
+    for (int e = 0; e < NumEvents; ++e)
+        if (file_descriptors[e] >= 0)
+            ioctl(file_descriptors[e], PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    start_time = std::chrono::steady_clock::now();
+}
+
+// Stop the counters and return the counts since Start
+PerfCounters::Values PerfCounters::Stop()
+{
+    Values values;
+    values.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+#if defined __linux__
+    for (int e = 0; e < NumEvents; ++e)
+        if (file_descriptors[e] >= 0)
+            ioctl(file_descriptors[e], PERF_EVENT_IOC_DISABLE, 0);
+
+    for (int e = 0; e < NumEvents; ++e)
+    {
+        // Read the count with the enabled and the running times
+        unsigned long long data[3] = { 0, 0, 0 };
+        if (file_descriptors[e] < 0 || read(file_descriptors[e], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+
+        // Scale the count if the counter was multiplexed with other counters (not available if it never ran)
+        if (data[2] == 0) continue;
+        values.Counts[e] = data[2] < data[1] ? (long long)((double)data[0] * data[1] / data[2]) : (long long)data[0];
+        values.Available[e] = true;
+    }
+#endif
+    return values;
+}
+
+// Get the name of an event
+std::string PerfCounters::GetEventName(Event event)
+{
+    static const char *names[NumEvents] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+    return names[event];
+}
+
+// Add the counts of another interval
+PerfCounters::Values &PerfCounters::Values::operator+=(const Values &other)
+{
+    for (int e = 0; e < NumEvents; ++e)
+    {
+        Counts[e] += other.Counts[e];
+        Available[e] = Available[e] || other.Available[e];
+    }
+    Seconds += other.Seconds;
+    return *this;
+}
+
+// Get the instructions per cycle
+double PerfCounters::Values::GetIPC() const
+{
+    if (!Available[Cycles] || !Available[Instructions] || Counts[Cycles] == 0) return -1;
+    return (double)Counts[Instructions] / Counts[Cycles];
+}
+
+// Get the number of the events per row
+double PerfCounters::Values::GetPerRow(Event event, long long n_rows) const
+{
+    if (!Available[event] || n_rows <= 0) return -1;
+    return (double)Counts[event] / n_rows;
+}
+
+// Convert the values to a single line of text (with the misses per row if the number of the rows is given)
+std::string PerfCounters::Values::ToString(long long n_rows) const
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << Seconds * 1e3 << " ms";
+
+    bool any_available = false;
+    for (int e = 0; e < NumEvents; ++e)
+        any_available = any_available || Available[e];
+    if (!any_available) return oss.str() + ", counters not available";
+
+    if (GetIPC() >= 0) oss << ", IPC " << std::setprecision(2) << GetIPC();
+    for (int e = L1DataMisses; e < NumEvents; ++e)
+    {
+        if (!Available[e]) continue;
+        oss << ", " << GetEventName((Event)e) << " ";
+        if (n_rows > 0) oss << std::setprecision(2) << GetPerRow((Event)e, n_rows) << "/row";
+        else oss << Counts[e];
+    }
+    return oss.str();
+}
+
+}
+#endif
@@ -0,0 +1,420 @@
+/*  ***************************************************************************
+*   rle_column.h - Header for run-length encoded low-cardinality topic columns.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_RLE_COLUMN_H
+#define ALFA_RLE_COLUMN_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include "commons.h"
+#include "topic.h"
+
+namespace alfa
+{
+
+// This class keeps a low-cardinality column of a topic (failure status, flight mode, etc.)
+// as runs of identical values, with a bitmap index over the runs for each distinct value.
+// The column can be built from a loaded topic, or read directly from the topic file (ReadFromFile) so that only
+// the runs are kept in memory instead of a message with string fields for every row.
+class RLEColumn
+{
+public:
+
+    // Local struct definitions
+    struct Run                  // A maximal run of consecutive messages with the same value
+    {
+        long long StartTime;    // Recorded time of the first message in the run (epoch nanoseconds)
+        long long EndTime;      // Recorded time of the last message in the run (epoch nanoseconds)
+        int StartIndex;         // Index of the first message of the run in the topic
+        int Length;             // Number of messages in the run
+        int ValueID;            // Index of the run value in the Values dictionary
+    };
+
+    // Class Data Members
+    std::string TopicName;
+    std::string FieldLabel;
+    VecString Values;           // Dictionary of the distinct values in the column
+    std::vector<Run> Runs;      // Runs sorted by their recorded time
+
+    // Constructors & Deconstructors
+    RLEColumn() {}
+    RLEColumn(const Topic &topic, const std::string &field_label);
+
+    // Member Functions
+    bool Build(const Topic &topic, const std::string &field_label);
+    bool Build(const Topic &topic, int field_index);
+    bool ReadFromFile(const std::string &filename, const std::string &field_label, const std::string &topic_name = "N/A");
+    bool IsInitialized() const;
+    void Clear();
+    int FindValueID(const std::string &value) const;
+    int CountMessages(const std::string &value) const;
+    std::vector<Run> GetIntervals(const std::string &value) const;
+    std::vector<Run> GetIntervals(const VecString &values) const;
+    bool GetValueAt(long long time_ns, std::string &out_value) const;
+    bool GetValueAt(const DateTime &time, std::string &out_value) const;
+    std::string GetValueAt(int msg_index) const;
+
+private:
+    // Member Functions
+    void AppendValue(long long time_ns, int msg_index, const std::string &value);
+    void BuildBitmaps();
+    std::vector<Run> CollectRuns(const std::vector<uint64_t> &bitmap) const;
+    int FindRunAtTime(long long time_ns) const;
+    static int CountTrailingZeros(uint64_t word);
+
+    // Data Members
+
+    // Table of the values vs. their indices in the dictionary
+    std::map<std::string, int> value_map;
+
+    // Bitmap of the runs for each value (bit i of bitmaps[v] is set if Runs[i] has value v)
+    std::vector<std::vector<uint64_t> > bitmaps;
+
+    // Is the column initialized or not
+    bool is_initialized = false;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for RLEColumn. Encodes the given field of a topic.
+RLEColumn::RLEColumn(const Topic &topic, const std::string &field_label)
+{
+    Build(topic, field_label);
+}
+
+// Encode a field of the topic given its label
+bool RLEColumn::Build(const Topic &topic, const std::string &field_label)
+{
+    // Find the field index
+    int field_index = topic.FindLabelIndex(field_label);
+
+    // Print error if the field name is not found
+    if (field_index < 0)
+    {
+        std::cerr << "RLEColumn Error! '" << field_label << "' field not found in '" << topic.Name << "' topic." << std::endl;
+        Clear();
+        return false;
+    }
+
+    return Build(topic, field_index);
+}
+
+// Encode a field of the topic given its index
+bool RLEColumn::Build(const Topic &topic, int field_index)
+{
+    // Clear the previous data from the object
+    Clear();
+
+    // Print error if the field index is out of range
+    if (field_index < 0 || field_index >= (int)topic.FieldLabels.size())
+    {
+        std::cerr << "RLEColumn Error! Field index is out of range." << std::endl;
+        return false;
+    }
+
+    TopicName = topic.Name;
+    FieldLabel = topic.FieldLabels[field_index];
+
+    // Break the column into maximal runs of identical values
+    const std::vector<Message> &messages = topic.Messages;
+    for (int i = 0; i < (int)messages.size(); ++i)
+        AppendValue(messages[i].DateTime.ToEpochNanoseconds(), i, messages[i].Fields[field_index]);
+
+    // Create the bitmap index of the runs
+    BuildBitmaps();
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Encode a field of a topic directly from its CSV file, without loading the messages of the topic
+bool RLEColumn::ReadFromFile(const std::string &filename, const std::string &field_label, const std::string &topic_name)
+{
+    // Clear the previous data from the object
+    Clear();
+
+    // Print an error if file did not open properly
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "RLEColumn Error! Failed to open '" << filename << "' file." << std::endl;
+        return false;
+    }
+
+    // Find the columns of the recorded time and the field in the header line
+    std::string line;
+    int n_labels = 0, time_index = -1, field_index = -1;
+    if (std::getline(file, line))
+    {
+        if (!line.empty() && line[line.length() - 1] == '\r') line.erase(line.length() - 1);
+        VecString labels = Commons::Tokenize(line, Commons::CSVDelimiter);
+        n_labels = labels.size();
+        for (int i = 0; i < n_labels; ++i)
+        {
+            if (labels[i] == "%time") time_index = i;
+            else if (labels[i] == Commons::CSVFieldsPrefix + field_label) field_index = i;
+        }
+    }
+    if (time_index < 0 || field_index < 0)
+    {
+        std::cerr << "RLEColumn Error! '" << field_label << "' field not found in '" << filename << "' file." << std::endl;
+        return false;
+    }
+
+    TopicName = topic_name;
+    FieldLabel = field_label;
+
+    // Break the column into maximal runs of identical values, one line at a time. Every line is a message
+    // (as in Topic::ReadFromFile), so the message indices match the ones of the topic loaded from the same file.
+    int msg_index = 0;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line[line.length() - 1] == '\r') line.erase(line.length() - 1);
+
+        // Break the line to tokens and add empty tokens if the line did not include all the fields
+        VecString tokens = Commons::Tokenize(line, Commons::CSVDelimiter);
+        while ((int)tokens.size() < n_labels)
+            tokens.push_back("");
+
+        // Print an error and stop reading if the line is not formatted properly
+        if ((int)tokens.size() > n_labels)
+        {
+            std::cerr << "RLEColumn Error! Error converting line #" << msg_index + 2 << " of '" << filename <<
+                "'. Skipping the rest of the file!" << std::endl;
+            break;
+        }
+
+        // Keep the exact recorded time (a missing time gets the same value as the empty time of the topic message)
+        long long time_ns;
+        if (!Commons::StringToLongLong(tokens[time_index], time_ns))
+            time_ns = DateTime().ToEpochNanoseconds();
+        AppendValue(time_ns, msg_index++, tokens[field_index]);
+    }
+
+    // Create the bitmap index of the runs
+    BuildBitmaps();
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Returns the initialization status
+bool RLEColumn::IsInitialized() const
+{
+    return is_initialized;
+}
+
+// Clear the entire column object
+void RLEColumn::Clear()
+{
+    TopicName = "";
+    FieldLabel = "";
+    Values.clear();
+    Runs.clear();
+    value_map.clear();
+    bitmaps.clear();
+    is_initialized = false;
+}
+
+// Find the index of a given value in the dictionary (case sensitive)
+int RLEColumn::FindValueID(const std::string &value) const
+{
+    std::map<std::string, int>::const_iterator it = value_map.find(value);
+
+    // Return -1 if not found
+    if (it == value_map.end()) return -1;
+
+    return it->second;
+}
+
+// Count the number of messages that have the given value
+int RLEColumn::CountMessages(const std::string &value) const
+{
+    int count = 0;
+    std::vector<Run> runs = GetIntervals(value);
+    for (int i = 0; i < (int)runs.size(); ++i)
+        count += runs[i].Length;
+    return count;
+}
+
+// Get the time intervals (runs) in which the column is equal to the given value
+std::vector<RLEColumn::Run> RLEColumn::GetIntervals(const std::string &value) const
+{
+    // Return an empty list if the value never appears in the column
+    int value_id = FindValueID(value);
+    if (value_id < 0) return std::vector<Run>();
+
+    return CollectRuns(bitmaps[value_id]);
+}
+
+// Get the time intervals (runs) in which the column is equal to any of the given values
+std::vector<RLEColumn::Run> RLEColumn::GetIntervals(const VecString &values) const
+{
+    // Combine the bitmaps of all the given values
+    std::vector<uint64_t> combined((Runs.size() + 63) / 64, 0);
+    for (int i = 0; i < (int)values.size(); ++i)
+    {
+        int value_id = FindValueID(values[i]);
+        if (value_id < 0) continue;
+        for (int w = 0; w < (int)combined.size(); ++w)
+            combined[w] |= bitmaps[value_id][w];
+    }
+
+    return CollectRuns(combined);
+}
+
+// Get the value of the column at the given time (epoch nanoseconds).
+// Returns false if the time is before the first message.
+bool RLEColumn::GetValueAt(long long time_ns, std::string &out_value) const
+{
+    int run_idx = FindRunAtTime(time_ns);
+    if (run_idx < 0) return false;
+
+    out_value = Values[Runs[run_idx].ValueID];
+    return true;
+}
+
+// Get the value of the column at the given time. Returns false if the time is before the first message.
+bool RLEColumn::GetValueAt(const DateTime &time, std::string &out_value) const
+{
+    return GetValueAt(time.ToEpochNanoseconds(), out_value);
+}
+
+// Get the value of the column for the given message index. Returns empty string if out of range.
+std::string RLEColumn::GetValueAt(int msg_index) const
+{
+    // Find the last run starting at or before the message
+    int lo = 0, hi = Runs.size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (Runs[mid].StartIndex <= msg_index) lo = mid + 1; else hi = mid;
+    }
+
+    // Check if the message is inside the found run
+    if (lo == 0 || msg_index >= Runs[lo - 1].StartIndex + Runs[lo - 1].Length) return "";
+
+    return Values[Runs[lo - 1].ValueID];
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Add the value of the next message to the runs
+void RLEColumn::AppendValue(long long time_ns, int msg_index, const std::string &value)
+{
+    // Extend the current run if the value did not change
+    if (!Runs.empty() && Values[Runs.back().ValueID] == value)
+    {
+        Runs.back().EndTime = time_ns;
+        Runs.back().Length++;
+        return;
+    }
+
+    // Find the value in the dictionary or add it
+    std::map<std::string, int>::iterator it = value_map.find(value);
+    int value_id;
+    if (it != value_map.end())
+        value_id = it->second;
+    else
+    {
+        value_id = Values.size();
+        Values.push_back(value);
+        value_map.insert(std::make_pair(value, value_id));
+    }
+
+    // Start a new run
+    Run run;
+    run.StartTime = time_ns;
+    run.EndTime = time_ns;
+    run.StartIndex = msg_index;
+    run.Length = 1;
+    run.ValueID = value_id;
+    Runs.push_back(run);
+}
+
+// Create the bitmap index of the runs for each value
+void RLEColumn::BuildBitmaps()
+{
+    int n_words = (Runs.size() + 63) / 64;
+    bitmaps.assign(Values.size(), std::vector<uint64_t>(n_words, 0));
+    for (int i = 0; i < (int)Runs.size(); ++i)
+        bitmaps[Runs[i].ValueID][i / 64] |= (uint64_t(1) << (i % 64));
+}
+
+// Collect the runs whose bits are set in the given bitmap
+std::vector<RLEColumn::Run> RLEColumn::CollectRuns(const std::vector<uint64_t> &bitmap) const
+{
+    std::vector<Run> runs;
+    for (int w = 0; w < (int)bitmap.size(); ++w)
+    {
+        // Visit only the set bits of each word
+        uint64_t word = bitmap[w];
+        while (word != 0)
+        {
+            runs.push_back(Runs[w * 64 + CountTrailingZeros(word)]);
+            word &= word - 1;
+        }
+    }
+    return runs;
+}
+
+// Find the index of the last run starting at or before the given time. Returns -1 if there is none.
+int RLEColumn::FindRunAtTime(long long time_ns) const
+{
+    int lo = 0, hi = Runs.size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (Runs[mid].StartTime <= time_ns) lo = mid + 1; else hi = mid;
+    }
+    return lo - 1;
+}
+
+// Count the number of trailing zero bits in a non-zero word
+int RLEColumn::CountTrailingZeros(uint64_t word)
+{
+#if defined __GNUC__ || defined __clang__
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    while ((word & 1) == 0) { word >>= 1; ++count; }
+    return count;
+#endif
+}
+
+}
+#endif
@@ -0,0 +1,358 @@
+/*  ***************************************************************************
+*   roc.h - Header for evaluating the anomaly scores over all the thresholds.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_ROC_H
+#define ALFA_ROC_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include "commons.h"
+#include "topic.h"
+
+namespace alfa
+{
+
+// This class evaluates the continuous anomaly scores of a detector over the timelines of the sequences for all
+// the thresholds at once, instead of running the detector again for each threshold. The samples recorded after
+// the fault onset are the positives, and all the other samples (including all the samples of the sequences
+// without a fault) are the negatives. The samples are sorted once by their scores, and a single pass over
+// them gives the ROC and the precision-recall curves with their areas. A second sorted pass over the first
+// threshold crossings of each sequence gives the trade-off between the detection delay and the false alarms.
+class ROCAnalyzer
+{
+public:
+
+    // Local struct definitions
+    struct Options
+    {
+        double MaxDelay = -1;           // Detections later than this after the onset are missed (seconds, no limit if negative)
+    };
+
+    struct SequenceScores               // Anomaly scores of a sequence over its timeline
+    {
+        std::string Name;
+        std::vector<long long> Times;   // Recorded times of the scores (epoch nanoseconds, sorted)
+        std::vector<double> Scores;     // NaN scores are ignored
+        long long FaultOnset = -1;      // Recorded time of the fault onset (-1 if there is no fault)
+    };
+
+    struct CurvePoint                   // Point of the ROC and the precision-recall curves (scores >= Threshold are alarms)
+    {
+        double Threshold = 0;
+        long long TruePositives = 0, FalsePositives = 0;
+        double TPR = 0, FPR = 0, Precision = 1;
+    };
+
+    struct DelayPoint                   // Detection of the faults and the false alarms of the sequences at a threshold
+    {
+        double Threshold = 0;
+        double FPR = 0;                 // Fraction of the negative samples with an alarm
+        int NDetected = 0;              // Faults detected (within the maximum delay)
+        double MeanDelay = 0;           // Mean delay of the detected faults (seconds)
+        int NFalseAlarms = 0;           // Sequences with an alarm before the fault (or without a fault)
+    };
+
+    struct Result
+    {
+        std::string Name;
+        int NSequences = 0, NFaults = 0;
+        long long NPositives = 0, NNegatives = 0;
+        std::vector<CurvePoint> Curve;          // From the highest threshold to the lowest
+        std::vector<DelayPoint> DelayCurve;     // From the highest threshold to the lowest
+        double ROCAUC = std::numeric_limits<double>::quiet_NaN();
+        double AveragePrecision = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    // Member Functions
+    static Result Evaluate(const std::vector<SequenceScores> &sequences, const Options &options, const std::string &name = "all");
+    static std::vector<Result> EvaluateEach(const std::vector<SequenceScores> &sequences, const Options &options, int n_threads = 0);
+    static bool ReadScores(Topic &topic, const std::string &field_label, long long fault_onset, SequenceScores &out_scores);
+    static const DelayPoint *FindOperatingPoint(const Result &result, double max_fpr);
+    static void PrintReport(const Result &result, std::ostream &os = std::cout);
+    static bool WriteCurves(const Result &result, const std::string &roc_filename, const std::string &delay_filename);
+
+private:
+    // Local struct definitions
+    struct Crossing                     // A threshold below which a sequence has an earlier alarm
+    {
+        double Score;
+        int SequenceIdx;
+        double Delay;                   // Delay of the detection (or negative for a false alarm)
+    };
+
+    // Member Functions
+    static void ComputeCurve(std::vector<std::pair<double, unsigned char> > &samples, Result &result);
+    static void ComputeDelayCurve(const std::vector<SequenceScores> &sequences, const Options &options,
+        const std::vector<std::pair<double, unsigned char> > &samples, Result &result);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Evaluate the scores of the sequences together
+ROCAnalyzer::Result ROCAnalyzer::Evaluate(const std::vector<SequenceScores> &sequences, const Options &options, const std::string &name)
+{
+    Result result;
+    result.Name = name;
+    result.NSequences = sequences.size();
+
+    // Label the samples (positive after the fault onset) in a contiguous array
+    size_t n_samples = 0;
+    for (int s = 0; s < (int)sequences.size(); ++s)
+        n_samples += sequences[s].Scores.size();
+    std::vector<std::pair<double, unsigned char> > samples;
+    samples.reserve(n_samples);
+    for (int s = 0; s < (int)sequences.size(); ++s)
+    {
+        const SequenceScores &sequence = sequences[s];
+        result.NFaults += sequence.FaultOnset >= 0;
+        for (size_t i = 0; i < sequence.Scores.size(); ++i)
+            if (!std::isnan(sequence.Scores[i]))
+                samples.push_back(std::make_pair(sequence.Scores[i], (unsigned char)(sequence.FaultOnset >= 0 && sequence.Times[i] >= sequence.FaultOnset)));
+    }
+
+    // Sort the samples by their scores (highest first) and sweep the thresholds
+    std::sort(samples.begin(), samples.end(), [](const std::pair<double, unsigned char> &a, const std::pair<double, unsigned char> &b)
+    {
+        return a.first > b.first;
+    });
+    ComputeCurve(samples, result);
+    ComputeDelayCurve(sequences, options, samples, result);
+    return result;
+}
+
+// Evaluate the scores of each sequence separately (in parallel)
+std::vector<ROCAnalyzer::Result> ROCAnalyzer::EvaluateEach(const std::vector<SequenceScores> &sequences, const Options &options, int n_threads)
+{
+    std::vector<Result> results(sequences.size());
+    Commons::ParallelFor(sequences.size(), n_threads, [&](int s)
+    {
+        results[s] = Evaluate(std::vector<SequenceScores>(1, sequences[s]), options, sequences[s].Name);
+    });
+    return results;
+}
+
+// Read the scores from a field of a topic (e.g. the output of a detector written as a topic of the sequence)
+bool ROCAnalyzer::ReadScores(Topic &topic, const std::string &field_label, long long fault_onset, SequenceScores &out_scores)
+{
+    int field_idx = field_label.empty() ? (topic.FieldLabels.empty() ? -1 : 0) : topic.FindLabelIndex(field_label);
+    if (field_idx < 0)
+    {
+        std::cerr << "ROCAnalyzer Error! Field '" << field_label << "' not found in '" << topic.Name << "'." << std::endl;
+        return false;
+    }
+
+    out_scores.Scores = topic.GetFieldsAsDouble(field_idx);
+    out_scores.Times.resize(topic.Messages.size());
+    for (int m = 0; m < (int)topic.Messages.size(); ++m)
+        out_scores.Times[m] = topic.Messages[m].DateTime.ToEpochNanoseconds();
+    out_scores.FaultOnset = fault_onset;
+    return out_scores.Scores.size() == out_scores.Times.size();
+}
+
+// Find the lowest threshold whose false positive rate is at most the given rate (null if there is none)
+const ROCAnalyzer::DelayPoint *ROCAnalyzer::FindOperatingPoint(const Result &result, double max_fpr)
+{
+    const DelayPoint *point = nullptr;
+    for (int i = 0; i < (int)result.DelayCurve.size() && result.DelayCurve[i].FPR <= max_fpr; ++i)
+        point = &result.DelayCurve[i];
+    return point;
+}
+
+// Print the areas of the curves and the detection of the faults at a few false positive rates
+void ROCAnalyzer::PrintReport(const Result &result, std::ostream &os)
+{
+    os << result.Name << ": " << result.NSequences << " sequences (" << result.NFaults << " with a fault), " << result.NPositives <<
+        " positive and " << result.NNegatives << " negative samples" << std::endl;
+    os << std::fixed << std::setprecision(4) << "  ROC AUC: " << result.ROCAUC << "  Average precision: " << result.AveragePrecision << std::endl;
+
+    const double max_fprs[4] = { 0, 0.01, 0.05, 0.1 };
+    for (int i = 0; i < 4; ++i)
+    {
+        const DelayPoint *point = FindOperatingPoint(result, max_fprs[i]);
+        os << "  FPR <= " << std::setprecision(2) << std::setw(4) << max_fprs[i] << ": ";
+        if (!point)
+        {
+            os << "no threshold" << std::endl;
+            continue;
+        }
+        os << "threshold " << std::setprecision(4) << point->Threshold << ", detected " << point->NDetected << "/" << result.NFaults;
+        if (point->NDetected > 0) os << " (mean delay " << std::setprecision(2) << point->MeanDelay << " s)";
+        os << ", false alarms in " << point->NFalseAlarms << "/" << result.NSequences << " sequences" << std::endl;
+    }
+    os.unsetf(std::ios_base::floatfield);
+    os << std::setprecision(6);
+}
+
+// Write the ROC and precision-recall curve and the detection delay curve as CSV files
+bool ROCAnalyzer::WriteCurves(const Result &result, const std::string &roc_filename, const std::string &delay_filename)
+{
+    std::ofstream roc_ofs(roc_filename), delay_ofs(delay_filename);
+    if (!roc_ofs.is_open() || !delay_ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << (roc_ofs.is_open() ? delay_filename : roc_filename) << "' file for writing." << std::endl;
+        return false;
+    }
+
+    const char d = Commons::CSVDelimiter;
+    roc_ofs << std::setprecision(std::numeric_limits<double>::digits10);
+    roc_ofs << "threshold" << d << "true_positives" << d << "false_positives" << d << "tpr" << d << "fpr" << d << "precision" << std::endl;
+    for (int i = 0; i < (int)result.Curve.size(); ++i)
+    {
+        const CurvePoint &point = result.Curve[i];
+        roc_ofs << point.Threshold << d << point.TruePositives << d << point.FalsePositives << d << point.TPR << d << point.FPR << d <<
+            point.Precision << std::endl;
+    }
+
+    delay_ofs << std::setprecision(std::numeric_limits<double>::digits10);
+    delay_ofs << "threshold" << d << "fpr" << d << "detected" << d << "mean_delay" << d << "false_alarm_sequences" << std::endl;
+    for (int i = 0; i < (int)result.DelayCurve.size(); ++i)
+    {
+        const DelayPoint &point = result.DelayCurve[i];
+        delay_ofs << point.Threshold << d << point.FPR << d << point.NDetected << d << point.MeanDelay << d << point.NFalseAlarms << std::endl;
+    }
+
+    return (bool)roc_ofs && (bool)delay_ofs;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Compute the ROC and precision-recall curves and their areas from the sorted samples (a point for each distinct score)
+void ROCAnalyzer::ComputeCurve(std::vector<std::pair<double, unsigned char> > &samples, Result &result)
+{
+    for (size_t i = 0; i < samples.size(); ++i)
+        result.NPositives += samples[i].second;
+    result.NNegatives = samples.size() - result.NPositives;
+
+    // Count the alarms from the highest threshold to the lowest
+    long long tp = 0, fp = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        tp += samples[i].second;
+        fp += !samples[i].second;
+        if (i + 1 < samples.size() && samples[i + 1].first == samples[i].first) continue;
+
+        CurvePoint point;
+        point.Threshold = samples[i].first;
+        point.TruePositives = tp;
+        point.FalsePositives = fp;
+        point.TPR = result.NPositives > 0 ? (double)tp / result.NPositives : 0;
+        point.FPR = result.NNegatives > 0 ? (double)fp / result.NNegatives : 0;
+        point.Precision = (double)tp / (tp + fp);
+        result.Curve.push_back(point);
+    }
+
+    // Integrate the ROC curve (trapezoids from the origin) and the precision over the recall (steps)
+    if (result.NPositives == 0 || result.NNegatives == 0) return;
+    double roc_auc = 0, average_precision = 0, last_tpr = 0, last_fpr = 0;
+    for (int i = 0; i < (int)result.Curve.size(); ++i)
+    {
+        const CurvePoint &point = result.Curve[i];
+        roc_auc += (point.FPR - last_fpr) * (point.TPR + last_tpr) / 2;
+        average_precision += (point.TPR - last_tpr) * point.Precision;
+        last_tpr = point.TPR;
+        last_fpr = point.FPR;
+    }
+    result.ROCAUC = roc_auc;
+    result.AveragePrecision = average_precision;
+}
+
+// Compute the detection delays and the false alarms of the sequences for all the thresholds. Lowering the threshold
+// only moves the first alarm of a sequence earlier, at the scores where the running maximum of its scores grows,
+// so only these crossings are sorted and swept (along the sorted samples for the false positive rates).
+void ROCAnalyzer::ComputeDelayCurve(const std::vector<SequenceScores> &sequences, const Options &options,
+    const std::vector<std::pair<double, unsigned char> > &samples, Result &result)
+{
+    // Find the crossings of each sequence: its highest score before the fault (a false alarm below it), and the
+    // scores after the onset where the running maximum grows (a detection with that delay below them)
+    std::vector<Crossing> crossings;
+    for (int s = 0; s < (int)sequences.size(); ++s)
+    {
+        const SequenceScores &sequence = sequences[s];
+        double max_before = -std::numeric_limits<double>::infinity(), max_after = max_before;
+        bool has_before = false;
+        for (size_t i = 0; i < sequence.Scores.size(); ++i)
+        {
+            if (std::isnan(sequence.Scores[i])) continue;
+            if (sequence.FaultOnset < 0 || sequence.Times[i] < sequence.FaultOnset)
+            {
+                max_before = std::max(max_before, sequence.Scores[i]);
+                has_before = true;
+                continue;
+            }
+            double delay = (sequence.Times[i] - sequence.FaultOnset) * 1e-9;
+            if (options.MaxDelay >= 0 && delay > options.MaxDelay) break;
+            if (sequence.Scores[i] <= max_after) continue;
+            max_after = sequence.Scores[i];
+            crossings.push_back({ max_after, s, delay });
+        }
+        if (has_before) crossings.push_back({ max_before, s, -1 });
+    }
+    std::sort(crossings.begin(), crossings.end(), [](const Crossing &a, const Crossing &b) { return a.Score > b.Score; });
+
+    // Sweep the thresholds from the highest to the lowest, updating the first alarm of the sequences
+    std::vector<double> delays(sequences.size(), -1);
+    int n_detected = 0, n_false_alarms = 0;
+    double sum_delays = 0;
+    long long fp = 0;
+    size_t sample_idx = 0;
+    for (size_t i = 0; i < crossings.size(); ++i)
+    {
+        const Crossing &crossing = crossings[i];
+        if (crossing.Delay < 0) n_false_alarms++;
+        else
+        {
+            double &delay = delays[crossing.SequenceIdx];
+            n_detected += delay < 0;
+            sum_delays += crossing.Delay - std::max(delay, 0.0);
+            delay = crossing.Delay;
+        }
+        if (i + 1 < crossings.size() && crossings[i + 1].Score == crossing.Score) continue;
+
+        // Count the negative samples at or above the threshold
+        for (; sample_idx < samples.size() && samples[sample_idx].first >= crossing.Score; ++sample_idx)
+            fp += !samples[sample_idx].second;
+
+        DelayPoint point;
+        point.Threshold = crossing.Score;
+        point.FPR = result.NNegatives > 0 ? (double)fp / result.NNegatives : 0;
+        point.NDetected = n_detected;
+        point.MeanDelay = n_detected > 0 ? sum_delays / n_detected : 0;
+        point.NFalseAlarms = n_false_alarms;
+        result.DelayCurve.push_back(point);
+    }
+}
+
+}
+#endif
@@ -30,11 +30,15 @@
 #include <iostream>
 #include <cctype>
 #include <algorithm>
-#include <queue>
 #include <functional>
 #include <map>
+#include <memory>
+#include <climits>
 #include "commons.h"
 #include "topic.h"
+#include "diagnostics.h"
+#include "load_cache.h"
+#include "trace.h"
 
 namespace alfa
 {
@@ -44,6 +48,13 @@ class Sequence
 {
 public:
 
+    // Local enum definitions
+    enum TimelineMode               // Time used to order the merged message list
+    {
+        RecordedTime,               // The recording time (%time) of the messages
+        HeaderStamp                 // The header stamp of the messages (the recording time if it has no usable stamp)
+    };
+
     // Subclasses
     class MessageIndex 
     { 
@@ -51,12 +62,6 @@ public:
         int TopicIdx; int MessageIdx; 
         MessageIndex(int topic_idx = -1, int message_idx = -1)
             : TopicIdx(topic_idx), MessageIdx(message_idx) {}
-        MessageIndex& operator=(const MessageIndex& other) {
-            if (this != &other) {
-                // 实现赋值逻辑
-            }
-            return *this;
-        }
         bool operator==(const MessageIndex& other) const {
             return TopicIdx == other.TopicIdx && MessageIdx == other.MessageIdx;
         }
@@ -69,29 +74,51 @@ public:
     std::vector<MessageIndex> MessageIndexList;
 
     // Constructors & Deconstructors
-    Sequence(const std::string &sequence_dir = "", const std::string &sequence_name = "N/A");
+    Sequence(const std::string &sequence_dir = "", const std::string &sequence_name = "N/A",
+        const std::shared_ptr<Diagnostics> &diagnostics = nullptr, const std::shared_ptr<LoadCache> &load_cache = nullptr);
+    Sequence(const Sequence &other);
+    Sequence(Sequence &&other) = default;
+    Sequence &operator=(const Sequence &other);
+    Sequence &operator=(Sequence &&other) = default;
 
     // Member Functions
     bool LoadSequence(const std::string &sequence_dir, const std::string &sequence_name);
+    bool SaveSequence(const std::string &sequence_dir, const std::string &sequence_name = "") const;
+    bool AddTopic(const Topic &topic);
+    bool AddTopics(std::vector<Topic> &&topics);
+    void RebuildMessageList();
+    void SetTimelineMode(TimelineMode mode, double max_stamp_offset = 1.0);
+    TimelineMode GetTimelineMode() const;
+    long long GetTimelineTime(size_t msg_idx) const;
     bool IsInitialized() const;
     void Clear();
-    Message GetMessage(size_t msg_idx);
+    const Message &GetMessage(size_t msg_idx) const;
     void PrintBriefInfo();
     std::vector<int> GetFaultTopics();
     double GetTotalDuration();
     double GetNormalFlightDuration();
     int FindFirstFaultMessage();
-    int FindTopicIndex(const std::string &topic_name);
+    int FindTopicIndex(const std::string &topic_name) const;
+    std::shared_ptr<Diagnostics> GetDiagnostics() const;
+    void SetLoadCache(const std::shared_ptr<LoadCache> &load_cache);
 
 private:
     // Data Members
     bool is_initialized = false;
     std::map<std::string, int> topic_map;
+    DiagnosticsLink diagnostics;                  // Shared by all the topics of the sequence
+    std::shared_ptr<LoadCache> load_cache;        // Cache of the parsed topic files (not used if null)
+    TimelineMode timeline_mode = RecordedTime;
+    long long max_stamp_offset_ns = 1000000000;   // The stamps further from the recording time are not used
 
     // Member Functions
     std::string ExtractTopicName(const std::string &topic_filename);
     bool ExtractTopicNames(VecString &out_topic_files, VecString &out_topic_names);
     void CreateMessageList();
+    void CreateStampedMessageList();
+    long long GetTimelineTime(const Message &msg, bool has_header) const;
+    bool GetTimelineBounds(long long &out_start, long long &out_end, long long end_before = LLONG_MAX) const;
+    void LinkTopicDiagnostics();
     bool CompareMessageIndices(MessageIndex msg1, MessageIndex msg2);
 };
 
@@ -100,13 +127,43 @@ private:
 /******************************************************************************/
 
 // Contructor function for Sequence. Loads all CSV files of an ALFA dataset sequence.
-Sequence::Sequence(const std::string &sequence_dir, const std::string &sequence_name)
+// The errors of all the topics are reported to the given diagnostics collector (or to a new one if not given).
+// The topic files are loaded through the given load cache (if any).
+Sequence::Sequence(const std::string &sequence_dir, const std::string &sequence_name, const std::shared_ptr<Diagnostics> &diagnostics,
+    const std::shared_ptr<LoadCache> &load_cache)
+    : diagnostics(diagnostics), load_cache(load_cache)
 {
     // Load the sequence if the path is provided
     if (!sequence_dir.empty())
         LoadSequence(sequence_dir, sequence_name);
 }
 
+// Copy constructor function for Sequence. The copy and its topics report to a new collector of their own.
+Sequence::Sequence(const Sequence &other)
+    : Name(other.Name), DirectoryPath(other.DirectoryPath), Topics(other.Topics), MessageIndexList(other.MessageIndexList),
+    is_initialized(other.is_initialized), topic_map(other.topic_map), load_cache(other.load_cache),
+    timeline_mode(other.timeline_mode), max_stamp_offset_ns(other.max_stamp_offset_ns)
+{
+    LinkTopicDiagnostics();
+}
+
+// Copy assignment of Sequence. The sequence keeps its collector, which the copied topics report to.
+Sequence &Sequence::operator=(const Sequence &other)
+{
+    if (this == &other) return *this;
+    Name = other.Name;
+    DirectoryPath = other.DirectoryPath;
+    Topics = other.Topics;
+    MessageIndexList = other.MessageIndexList;
+    is_initialized = other.is_initialized;
+    topic_map = other.topic_map;
+    load_cache = other.load_cache;
+    timeline_mode = other.timeline_mode;
+    max_stamp_offset_ns = other.max_stamp_offset_ns;
+    LinkTopicDiagnostics();
+    return *this;
+}
+
 // Load all the topic files in a sequence
 bool Sequence::LoadSequence(const std::string &sequence_dir, const std::string &sequence_name)
 {
@@ -116,18 +173,31 @@ bool Sequence::LoadSequence(const std::string &sequence_dir, const std::string &
 
     // Extract the list of all the topic names and topic filenames
     VecString topic_list, topic_file_list;
-    if (ExtractTopicNames(topic_file_list, topic_list) == false)
+    bool found = false;
+    {
+        Trace::Scope trace("load", "scan", sequence_name);
+        found = ExtractTopicNames(topic_file_list, topic_list);
+    }
+    if (found == false)
     {
         // Output error if no topics are found
-        std::cerr << "No topic files found at '" << sequence_dir << "' directory." << std::endl;
+        diagnostics.Get()->Add(Diagnostics::Error, sequence_name, "No topic files found at '" + sequence_dir + "' directory.");
         return false;
     }
 
-    // Load all the topics
+    // Load all the topics (constructed in place, so the loaded messages are never copied)
+    std::shared_ptr<Diagnostics> collector = diagnostics.Get();
+    Topics.reserve(Topics.size() + topic_list.size());
     for (int i = 0; i < (int)topic_list.size(); ++i)
     {
         std::string topic_full_filename = sequence_dir + topic_file_list[i] + "." + Commons::CSVFileExtension;
-        Topics.push_back(Topic(topic_full_filename, topic_list[i]));
+        if (load_cache)
+        {
+            Topics.emplace_back("", topic_list[i], collector);
+            load_cache->LoadTopic(topic_full_filename, Topics.back());
+        }
+        else
+            Topics.emplace_back(topic_full_filename, topic_list[i], collector);
     }
 
     // Create the sorted message list of all the topics
@@ -143,6 +213,115 @@ bool Sequence::LoadSequence(const std::string &sequence_dir, const std::string &
     return IsInitialized();
 }
 
+// Write all the topics of the sequence as CSV files in the given directory (creates the directory if needed).
+// Uses the sequence name if no name is given.
+bool Sequence::SaveSequence(const std::string &sequence_dir, const std::string &sequence_name) const
+{
+    std::string name = sequence_name.empty() ? Name : sequence_name;
+
+    // Create the directory
+    if (!Commons::MakeDirectory(sequence_dir)) return false;
+
+    // Write the topic files with the same naming as the dataset
+    std::string dir = sequence_dir;
+    if (dir.empty() || dir[dir.length() - 1] != Commons::FilePathSeparator)
+        dir += Commons::FilePathSeparator;
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        if (!Topics[i].WriteToFile(dir + name + "-" + Topics[i].Name + "." + Commons::CSVFileExtension))
+            return false;
+
+    return true;
+}
+
+// Add a topic to the sequence and update the sorted message list. Fails if a topic with the same name exists.
+bool Sequence::AddTopic(const Topic &topic)
+{
+    // Print an error if the topic already exists
+    if (FindTopicIndex(topic.Name) >= 0)
+    {
+        diagnostics.Get()->Add(Diagnostics::Error, Name, "Sequence Error! '" + topic.Name + "' topic already exists.");
+        return false;
+    }
+
+    // Add the topic and its index (its errors are reported to the sequence from now on)
+    Topics.push_back(topic);
+    Topics.back().SetDiagnostics(diagnostics.Get());
+    this->topic_map.insert(std::make_pair(topic.Name, (int)Topics.size() - 1));
+
+    // Update the sorted message list
+    RebuildMessageList();
+
+    is_initialized = true;
+    return true;
+}
+
+// Move many topics to the sequence and create the sorted message list once. Fails (and adds none of them)
+// if a topic name is repeated or already exists.
+bool Sequence::AddTopics(std::vector<Topic> &&topics)
+{
+    if (topics.empty()) return true;
+
+    // Print an error if a topic already exists
+    std::map<std::string, int> new_topic_map;
+    for (int i = 0; i < (int)topics.size(); ++i)
+    {
+        if (FindTopicIndex(topics[i].Name) >= 0 || !new_topic_map.insert(std::make_pair(topics[i].Name, (int)Topics.size() + i)).second)
+        {
+            diagnostics.Get()->Add(Diagnostics::Error, Name, "Sequence Error! '" + topics[i].Name + "' topic already exists.");
+            return false;
+        }
+    }
+
+    // Move the topics and their indices (their errors are reported to the sequence from now on)
+    std::shared_ptr<Diagnostics> collector = diagnostics.Get();
+    Topics.reserve(Topics.size() + topics.size());
+    for (int i = 0; i < (int)topics.size(); ++i)
+    {
+        Topics.push_back(std::move(topics[i]));
+        Topics.back().SetDiagnostics(collector);
+    }
+    topics.clear();
+    topic_map.insert(new_topic_map.begin(), new_topic_map.end());
+
+    // Update the sorted message list
+    RebuildMessageList();
+
+    is_initialized = true;
+    return true;
+}
+
+// Recreate the sorted message list (needed after changing the times of the messages)
+void Sequence::RebuildMessageList()
+{
+    MessageIndexList.clear();
+    CreateMessageList();
+}
+
+// Set the time that orders the merged message list and rebuild the list. In the HeaderStamp mode, the messages
+// are ordered by their header stamps, which removes the transport latency of the recording time. The recording
+// time is used for the messages without a header, with a zero stamp, or with a stamp further than the given
+// offset (in seconds) from the recording time (e.g. a stamp from an unsynchronized clock).
+void Sequence::SetTimelineMode(TimelineMode mode, double max_stamp_offset)
+{
+    timeline_mode = mode;
+    max_stamp_offset_ns = (long long)(max_stamp_offset * 1e9);
+    RebuildMessageList();
+}
+
+// Get the time that orders the merged message list
+Sequence::TimelineMode Sequence::GetTimelineMode() const
+{
+    return timeline_mode;
+}
+
+// Get the time (in epoch nanoseconds) of a message in the merged list that was used to order it
+long long Sequence::GetTimelineTime(size_t msg_idx) const
+{
+    if (msg_idx >= MessageIndexList.size()) return 0;
+    const Topic &topic = Topics[MessageIndexList[msg_idx].TopicIdx];
+    return GetTimelineTime(topic.Messages[MessageIndexList[msg_idx].MessageIdx], topic.HasHeaderField());
+}
+
 // Returns the initialization status
 bool Sequence::IsInitialized() const
 {
@@ -160,12 +339,13 @@ void Sequence::Clear()
     topic_map.clear();
 }
 
-// Get messages by index from the message collection sorted by the recording time
-Message Sequence::GetMessage(size_t msg_idx)
+// Get messages by index from the message collection sorted by the recording time (or by the header stamps, see SetTimelineMode)
+const Message &Sequence::GetMessage(size_t msg_idx) const
 {
-    // Check if the index is in range
+    // Return an empty message if the index is out of range
+    static const Message empty_message;
     if (msg_idx >= MessageIndexList.size())
-        return Message();
+        return empty_message;
     
     return Topics[MessageIndexList[msg_idx].TopicIdx].Messages[MessageIndexList[msg_idx].MessageIdx];
 }
@@ -218,13 +398,15 @@ std::vector<int> Sequence::GetFaultTopics()
     return fault_topics;
 }
 
-// Get the total flight duration in seconds
+// Get the total flight duration in seconds (in the timeline of the sequence, see SetTimelineMode)
 double Sequence::GetTotalDuration()
 {
-    return GetMessage(MessageIndexList.size() - 1).DateTime - GetMessage(0).DateTime;
+    long long start, end;
+    if (!GetTimelineBounds(start, end)) return 0;
+    return (end - start) / 1e9;
 }
 
-// Get the normal flight (pre-failure flight) duration in seconds
+// Get the normal flight (pre-failure flight) duration in seconds (in the timeline of the sequence)
 double Sequence::GetNormalFlightDuration()
 {
     // Find the first fault
@@ -233,26 +415,49 @@ double Sequence::GetNormalFlightDuration()
     // If no faults found, return the whole duration
     if (msg_ind < 0) return GetTotalDuration();
 
-    // Return the flight duration before the fault happened
-    return GetMessage(msg_ind - 1).DateTime - GetMessage(0).DateTime;
+    // Return the flight duration until the last message before the fault happened
+    long long start, end;
+    if (!GetTimelineBounds(start, end, GetTimelineTime(msg_ind))) return 0;
+    return (end - start) / 1e9;
 }
 
-// Find the index of the first fault message in the sequence message list
+// Find the index of the first fault message (the earliest one in the timeline of the sequence) in the message list
 int Sequence::FindFirstFaultMessage()
 {
-    // Iterate through all the messages to find the first fault
+    // Iterate through all the messages to find the earliest fault (the first one of the equal times)
+    int first_fault = -1;
+    long long first_time = LLONG_MAX;
     for (int i = 0; i < (int)MessageIndexList.size(); ++i)
-        if (Topics[MessageIndexList[i].TopicIdx].IsFaultTopic())
-            return i;
+    {
+        if (!Topics[MessageIndexList[i].TopicIdx].IsFaultTopic()) continue;
+        long long time = GetTimelineTime(i);
+        if (first_fault < 0 || time < first_time)
+        {
+            first_fault = i;
+            first_time = time;
+        }
+    }
 
     // If no fault topics found, return -1
-    return -1;
+    return first_fault;
+}
+
+// Get the collector of the errors and warnings of the sequence and its topics
+std::shared_ptr<Diagnostics> Sequence::GetDiagnostics() const
+{
+    return diagnostics.Get();
+}
+
+// Load the topic files of the next LoadSequence calls through the given cache (or parse them directly if null)
+void Sequence::SetLoadCache(const std::shared_ptr<LoadCache> &load_cache)
+{
+    this->load_cache = load_cache;
 }
 
 // Find the index of a given topic (case sensitive)
-int Sequence::FindTopicIndex(const std::string &topic_name)
+int Sequence::FindTopicIndex(const std::string &topic_name) const
 {
-    std::map<std::string, int>::iterator it = topic_map.find(topic_name);
+    std::map<std::string, int>::const_iterator it = topic_map.find(topic_name);
 
     // Return -1 if not found
     if (it == topic_map.end()) return -1;
@@ -264,6 +469,15 @@ int Sequence::FindTopicIndex(const std::string &topic_name)
 /*********************** Local Function Definitions ***************************/
 /******************************************************************************/
 
+// Make all the topics report to the collector of the sequence
+void Sequence::LinkTopicDiagnostics()
+{
+    if (Topics.empty()) return;
+    std::shared_ptr<Diagnostics> collector = diagnostics.Get();
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        Topics[i].SetDiagnostics(collector);
+}
+
 // Extract the topic name from its filename removing the sequence name from it.
 // Assumes that the topic file name starts with the sequence name followed by
 // a connecting character and then the topic name.
@@ -319,33 +533,134 @@ bool Sequence::ExtractTopicNames(VecString &out_topic_files, VecString &out_topi
 // Merge all the messages in all the topics into MessageIndexList sorted by their recorded time
 void Sequence::CreateMessageList()
 {
-    // Define a typedef for simplicity
-    typedef std::pair<Message, int> KeyValuePair;
+    // Order the messages by their header stamps if requested
+    if (timeline_mode == HeaderStamp)
+    {
+        CreateStampedMessageList();
+        return;
+    }
+
+    Trace::Scope trace("load", "merge", Name);
 
     // Initialize the list of the indices of current messages in the topic
     std::vector<int> curr_index(Topics.size(), 0);
 
+    // Allocate the whole list once
+    size_t n_messages = 0;
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        n_messages += Topics[i].Messages.size();
+    MessageIndexList.reserve(MessageIndexList.size() + n_messages);
+
+    // The heap keeps the topic indices ordered by their current messages (the messages are compared in place).
+    // The equal messages are ordered by their topic index.
+    auto greater = [this, &curr_index](int t1, int t2)
+    {
+        const Message &msg1 = Topics[t1].Messages[curr_index[t1]], &msg2 = Topics[t2].Messages[curr_index[t2]];
+        if (msg2 < msg1) return true;
+        if (msg1 < msg2) return false;
+        return t1 > t2;
+    };
+
     // Initialize the min heap using the first message of the topics
-    std::priority_queue<KeyValuePair, std::vector<KeyValuePair>, std::greater<KeyValuePair> > min_heap;
+    std::vector<int> min_heap;
     for (int i = 0; i < (int)Topics.size(); ++i)
         if (!Topics[i].Messages.empty())
-            min_heap.push(KeyValuePair(Topics[i].Messages[0], i));
+            min_heap.push_back(i);
+    std::make_heap(min_heap.begin(), min_heap.end(), greater);
 
     // Perform a process similar to merge sort of already sorted lists
     while (!min_heap.empty())
     {
-        // Add the smallest message to the list
-        int t_idx = min_heap.top().second;
+        // Add the smallest message to the list and remove its topic from the heap
+        std::pop_heap(min_heap.begin(), min_heap.end(), greater);
+        int t_idx = min_heap.back();
+        min_heap.pop_back();
         MessageIndexList.push_back(MessageIndex(t_idx, curr_index[t_idx]));
-        
-        // Remove the message from the heap
-        min_heap.pop();
 
-        // Add the new message from the topic
+        // Add the topic back with its next message
         ++curr_index[t_idx];
         if (curr_index[t_idx] < (int)Topics[t_idx].Messages.size())
-            min_heap.push(KeyValuePair(Topics[t_idx].Messages[curr_index[t_idx]], t_idx));
+        {
+            min_heap.push_back(t_idx);
+            std::push_heap(min_heap.begin(), min_heap.end(), greater);
+        }
+    }
+}
+
+// Create the list of all the messages of all the topics sorted by their header stamps (or their recording
+// times if not usable). The stamps of a topic may not be in the order of its messages, so the messages of each
+// topic are sorted by their times first and then merged.
+void Sequence::CreateStampedMessageList()
+{
+    Trace::Scope trace("load", "merge_stamped", Name);
+
+    // Sort the messages of each topic by their times (keeping the order of the messages with the same time)
+    std::vector<std::vector<std::pair<long long, int> > > orders(Topics.size());
+    size_t n_messages = 0;
+    for (int t = 0; t < (int)Topics.size(); ++t)
+    {
+        bool has_header = Topics[t].HasHeaderField();
+        orders[t].resize(Topics[t].Messages.size());
+        for (int m = 0; m < (int)Topics[t].Messages.size(); ++m)
+            orders[t][m] = std::make_pair(GetTimelineTime(Topics[t].Messages[m], has_header), m);
+        std::sort(orders[t].begin(), orders[t].end());
+        n_messages += orders[t].size();
+    }
+    MessageIndexList.reserve(MessageIndexList.size() + n_messages);
+
+    // Merge the sorted topics with a min heap of the topic indices (the equal times are ordered by their topic index)
+    std::vector<int> curr_index(Topics.size(), 0);
+    auto greater = [&orders, &curr_index](int t1, int t2)
+    {
+        long long time1 = orders[t1][curr_index[t1]].first, time2 = orders[t2][curr_index[t2]].first;
+        return time1 != time2 ? time1 > time2 : t1 > t2;
+    };
+    std::vector<int> min_heap;
+    for (int t = 0; t < (int)Topics.size(); ++t)
+        if (!orders[t].empty())
+            min_heap.push_back(t);
+    std::make_heap(min_heap.begin(), min_heap.end(), greater);
+    while (!min_heap.empty())
+    {
+        std::pop_heap(min_heap.begin(), min_heap.end(), greater);
+        int t_idx = min_heap.back();
+        min_heap.pop_back();
+        MessageIndexList.push_back(MessageIndex(t_idx, orders[t_idx][curr_index[t_idx]].second));
+        if (++curr_index[t_idx] < (int)orders[t_idx].size())
+        {
+            min_heap.push_back(t_idx);
+            std::push_heap(min_heap.begin(), min_heap.end(), greater);
+        }
+    }
+}
+
+// Get the time of a message in the current timeline mode (in epoch nanoseconds)
+long long Sequence::GetTimelineTime(const Message &msg, bool has_header) const
+{
+    long long time = msg.DateTime.ToEpochNanoseconds();
+    if (timeline_mode != HeaderStamp || !has_header || msg.Header.Stamp <= 0) return time;
+    long long offset = time - msg.Header.Stamp;
+    return (offset <= max_stamp_offset_ns && offset >= -max_stamp_offset_ns) ? msg.Header.Stamp : time;
+}
+
+// Find the earliest time of all the messages and the latest time of the messages before the given time (in the
+// timeline of the sequence). The times are taken over the messages of each topic, since neither the topics nor
+// the message list have to be in the order of these times. Returns false if no message is before the given time.
+bool Sequence::GetTimelineBounds(long long &out_start, long long &out_end, long long end_before) const
+{
+    out_start = LLONG_MAX;
+    out_end = LLONG_MIN;
+    for (int t = 0; t < (int)Topics.size(); ++t)
+    {
+        bool has_header = Topics[t].HasHeaderField();
+        for (int m = 0; m < (int)Topics[t].Messages.size(); ++m)
+        {
+            long long time = GetTimelineTime(Topics[t].Messages[m], has_header);
+            out_start = std::min(out_start, time);
+            if (time < end_before) out_end = std::max(out_end, time);
+        }
     }
+    return out_end != LLONG_MIN;
 }
 
 // Compare two message indices based on their actual message times, etc.
@@ -0,0 +1,388 @@
+/*  ***************************************************************************
+*   sequence_diff.h - Header for comparing two versions of a sequence.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_SEQUENCE_DIFF_H
+#define ALFA_SEQUENCE_DIFF_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include "commons.h"
+#include "topic.h"
+#include "sequence.h"
+#include "load_cache.h"
+
+namespace alfa
+{
+
+// This class compares two versions of a sequence topic by topic. For each topic it reports the schema changes
+// (added and removed fields and header), the rows added and removed (matched by their recorded time), and the
+// values changed beyond a tolerance. The matched rows are compared in blocks: the blocks are hashed in parallel
+// and only the blocks with different hashes are compared value by value, so the unchanged parts cost a hash.
+class SequenceDiff
+{
+public:
+
+    // Local enum and struct definitions
+    enum TopicStatus { Same, Changed, Added, Removed };
+
+    struct Options
+    {
+        double Tolerance = 0;               // Absolute tolerance of the numeric values
+        double RelativeTolerance = 0;       // Relative tolerance of the numeric values (to the larger one)
+        int BlockSize = 256;                // Number of the matched rows in each hashed block
+        int MaxExamples = 3;                // Number of the changed values kept as examples for each topic
+        int NThreads = 0;                   // Number of the threads (all the cores if not positive)
+    };
+
+    struct FieldChange                      // Changes of a field of a topic
+    {
+        std::string Label;
+        int NChanged = 0;                   // Number of the matched rows with a changed value
+        double MaxDifference = 0;           // Largest absolute difference of the numeric values
+    };
+
+    struct TopicDiff                        // Differences of a topic
+    {
+        std::string Name;
+        TopicStatus Status = Same;
+        VecString AddedFields, RemovedFields;
+        bool HeaderChanged = false;         // Only one of the versions has the header fields
+        int RowsA = 0, RowsB = 0;
+        int AddedRows = 0, RemovedRows = 0; // Rows whose time is only in the second (or the first) version
+        int ChangedRows = 0;                // Matched rows with at least one changed value
+        std::vector<FieldChange> FieldChanges;
+        VecString Examples;
+        int BlocksHashed = 0, BlocksCompared = 0;
+    };
+
+    struct Result
+    {
+        std::vector<TopicDiff> Topics;
+        bool IsSame() const;
+    };
+
+    // Member Functions
+    static Result Compare(const Sequence &sequence_a, const Sequence &sequence_b, const Options &options);
+    static TopicDiff CompareTopics(const Topic &topic_a, const Topic &topic_b, const Options &options);
+    static void PrintReport(const Result &result, std::ostream &os = std::cout);
+    static std::string StatusToString(TopicStatus status);
+
+private:
+    // Local struct definitions
+    struct BlockDiff                        // Differences found in a block of the matched rows
+    {
+        std::vector<FieldChange> FieldChanges;
+        int ChangedRows = 0;
+        VecString Examples;
+        bool Compared = false;
+    };
+
+    // Member Functions
+    static void MatchRows(const Topic &topic_a, const Topic &topic_b, std::vector<std::pair<int, int> > &out_matches,
+        int &out_removed, int &out_added);
+    static unsigned long long HashRows(const Topic &topic, const std::vector<std::pair<int, int> > &matches, size_t begin, size_t end,
+        bool second, const std::vector<int> &fields, bool with_header);
+    static bool AreValuesEqual(const std::string &value_a, const std::string &value_b, const Options &options, double &out_difference);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Returns true if no differences are found
+bool SequenceDiff::Result::IsSame() const
+{
+    for (int t = 0; t < (int)Topics.size(); ++t)
+        if (Topics[t].Status != Same)
+            return false;
+    return true;
+}
+
+// Compare the topics of two versions of a sequence (the topics are paired by their names)
+SequenceDiff::Result SequenceDiff::Compare(const Sequence &sequence_a, const Sequence &sequence_b, const Options &options)
+{
+    Result result;
+
+    // Compare the topics of the first version with the same topics of the second one
+    for (int t = 0; t < (int)sequence_a.Topics.size(); ++t)
+    {
+        int other_idx = sequence_b.FindTopicIndex(sequence_a.Topics[t].Name);
+        if (other_idx >= 0)
+            result.Topics.push_back(CompareTopics(sequence_a.Topics[t], sequence_b.Topics[other_idx], options));
+        else
+        {
+            TopicDiff diff;
+            diff.Name = sequence_a.Topics[t].Name;
+            diff.Status = Removed;
+            diff.RowsA = diff.RemovedRows = sequence_a.Topics[t].Messages.size();
+            result.Topics.push_back(diff);
+        }
+    }
+
+    // Add the topics that are only in the second version
+    for (int t = 0; t < (int)sequence_b.Topics.size(); ++t)
+        if (sequence_a.FindTopicIndex(sequence_b.Topics[t].Name) < 0)
+        {
+            TopicDiff diff;
+            diff.Name = sequence_b.Topics[t].Name;
+            diff.Status = Added;
+            diff.RowsB = diff.AddedRows = sequence_b.Topics[t].Messages.size();
+            result.Topics.push_back(diff);
+        }
+
+    return result;
+}
+
+// Compare two versions of a topic
+SequenceDiff::TopicDiff SequenceDiff::CompareTopics(const Topic &topic_a, const Topic &topic_b, const Options &options)
+{
+    TopicDiff diff;
+    diff.Name = topic_a.Name;
+    diff.RowsA = topic_a.Messages.size();
+    diff.RowsB = topic_b.Messages.size();
+
+    // Compare the schemas and pair the common fields
+    std::vector<int> fields_a, fields_b;
+    for (int f = 0; f < (int)topic_a.FieldLabels.size(); ++f)
+    {
+        int other_idx = topic_b.FindLabelIndex(topic_a.FieldLabels[f]);
+        if (other_idx < 0) diff.RemovedFields.push_back(topic_a.FieldLabels[f]);
+        else
+        {
+            fields_a.push_back(f);
+            fields_b.push_back(other_idx);
+        }
+    }
+    for (int f = 0; f < (int)topic_b.FieldLabels.size(); ++f)
+        if (topic_a.FindLabelIndex(topic_b.FieldLabels[f]) < 0)
+            diff.AddedFields.push_back(topic_b.FieldLabels[f]);
+    diff.HeaderChanged = topic_a.HasHeaderField() != topic_b.HasHeaderField();
+    bool with_header = topic_a.HasHeaderField() && topic_b.HasHeaderField();
+
+    // Match the rows by their recorded time
+    std::vector<std::pair<int, int> > matches;
+    MatchRows(topic_a, topic_b, matches, diff.RemovedRows, diff.AddedRows);
+
+    // Hash the blocks of the matched rows of both versions and compare the values of the blocks with different hashes
+    const size_t block_size = std::max(1, options.BlockSize);
+    const int n_blocks = (matches.size() + block_size - 1) / block_size;
+    std::vector<BlockDiff> blocks(n_blocks);
+    Commons::ParallelFor(n_blocks, options.NThreads, [&](int b)
+    {
+        size_t begin = b * block_size, end = std::min(matches.size(), begin + block_size);
+        if (HashRows(topic_a, matches, begin, end, false, fields_a, with_header) ==
+            HashRows(topic_b, matches, begin, end, true, fields_b, with_header)) return;
+
+        // Compare the values of the rows in the block
+        BlockDiff &block = blocks[b];
+        block.Compared = true;
+        block.FieldChanges.resize(fields_a.size() + 1);     // The last one is the header
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Message &msg_a = topic_a.Messages[matches[i].first];
+            const Message &msg_b = topic_b.Messages[matches[i].second];
+            bool changed = false;
+            for (int f = 0; f <= (int)fields_a.size(); ++f)
+            {
+                std::string value_a, value_b;
+                double difference = 0;
+                if (f < (int)fields_a.size())
+                {
+                    value_a = fields_a[f] < (int)msg_a.Fields.size() ? msg_a.Fields[fields_a[f]] : "";
+                    value_b = fields_b[f] < (int)msg_b.Fields.size() ? msg_b.Fields[fields_b[f]] : "";
+                    if (AreValuesEqual(value_a, value_b, options, difference)) continue;
+                }
+                else
+                {
+                    if (!with_header || (msg_a.Header.SequenceID == msg_b.Header.SequenceID &&
+                        msg_a.Header.Stamp == msg_b.Header.Stamp && msg_a.Header.FrameID == msg_b.Header.FrameID)) continue;
+                    value_a = std::to_string(msg_a.Header.SequenceID) + "/" + std::to_string(msg_a.Header.Stamp) + "/" + msg_a.Header.FrameID;
+                    value_b = std::to_string(msg_b.Header.SequenceID) + "/" + std::to_string(msg_b.Header.Stamp) + "/" + msg_b.Header.FrameID;
+                }
+
+                // Count the change and keep it as an example
+                FieldChange &change = block.FieldChanges[f];
+                change.NChanged++;
+                change.MaxDifference = std::max(change.MaxDifference, difference);
+                changed = true;
+                if ((int)block.Examples.size() < options.MaxExamples)
+                    block.Examples.push_back(msg_a.DateTime.ToString() + " " + (f < (int)fields_a.size() ?
+                        topic_a.FieldLabels[fields_a[f]] : std::string("header")) + ": " + value_a + " -> " + value_b);
+            }
+            if (changed) block.ChangedRows++;
+        }
+    });
+
+    // Merge the differences of the blocks in their order
+    std::vector<FieldChange> changes(fields_a.size() + 1);
+    for (int f = 0; f < (int)fields_a.size(); ++f)
+        changes[f].Label = topic_a.FieldLabels[fields_a[f]];
+    changes.back().Label = "header";
+    for (int b = 0; b < n_blocks; ++b)
+    {
+        diff.BlocksHashed++;
+        if (!blocks[b].Compared) continue;
+        diff.BlocksCompared++;
+        diff.ChangedRows += blocks[b].ChangedRows;
+        for (int f = 0; f < (int)changes.size(); ++f)
+        {
+            changes[f].NChanged += blocks[b].FieldChanges[f].NChanged;
+            changes[f].MaxDifference = std::max(changes[f].MaxDifference, blocks[b].FieldChanges[f].MaxDifference);
+        }
+        for (int e = 0; e < (int)blocks[b].Examples.size() && (int)diff.Examples.size() < options.MaxExamples; ++e)
+            diff.Examples.push_back(blocks[b].Examples[e]);
+    }
+    for (int f = 0; f < (int)changes.size(); ++f)
+        if (changes[f].NChanged > 0)
+            diff.FieldChanges.push_back(changes[f]);
+
+    bool changed = !diff.AddedFields.empty() || !diff.RemovedFields.empty() || diff.HeaderChanged ||
+        diff.AddedRows > 0 || diff.RemovedRows > 0 || diff.ChangedRows > 0;
+    diff.Status = changed ? Changed : Same;
+    return diff;
+}
+
+// Print a compact report of the differences (one line for each unchanged topic)
+void SequenceDiff::PrintReport(const Result &result, std::ostream &os)
+{
+    for (int t = 0; t < (int)result.Topics.size(); ++t)
+    {
+        const TopicDiff &diff = result.Topics[t];
+        os << StatusToString(diff.Status) << " " << diff.Name;
+        if (diff.Status == Added) { os << " (" << diff.RowsB << " rows)" << std::endl; continue; }
+        if (diff.Status == Removed) { os << " (" << diff.RowsA << " rows)" << std::endl; continue; }
+        os << " (" << diff.RowsA << " -> " << diff.RowsB << " rows, " << diff.BlocksCompared << "/" << diff.BlocksHashed <<
+            " blocks compared)" << std::endl;
+        if (diff.Status == Same) continue;
+
+        // Schema changes
+        for (int f = 0; f < (int)diff.AddedFields.size(); ++f)
+            os << "    + field " << diff.AddedFields[f] << std::endl;
+        for (int f = 0; f < (int)diff.RemovedFields.size(); ++f)
+            os << "    - field " << diff.RemovedFields[f] << std::endl;
+        if (diff.HeaderChanged)
+            os << "    ~ header fields added or removed" << std::endl;
+
+        // Row and value changes
+        if (diff.AddedRows > 0 || diff.RemovedRows > 0)
+            os << "    rows: +" << diff.AddedRows << " -" << diff.RemovedRows << std::endl;
+        if (diff.ChangedRows > 0)
+            os << "    changed rows: " << diff.ChangedRows << std::endl;
+        for (int f = 0; f < (int)diff.FieldChanges.size(); ++f)
+        {
+            os << "    ~ " << diff.FieldChanges[f].Label << ": " << diff.FieldChanges[f].NChanged << " values";
+            if (diff.FieldChanges[f].MaxDifference > 0)
+                os << " (max difference " << diff.FieldChanges[f].MaxDifference << ")";
+            os << std::endl;
+        }
+        for (int e = 0; e < (int)diff.Examples.size(); ++e)
+            os << "      e.g. " << diff.Examples[e] << std::endl;
+    }
+}
+
+// Convert the status of a topic to a string
+std::string SequenceDiff::StatusToString(TopicStatus status)
+{
+    if (status == Same) return "   ";
+    if (status == Changed) return "[~]";
+    if (status == Added) return "[+]";
+    return "[-]";
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Match the rows of the two versions by their recorded time (the rows with the same time are matched in their order)
+void SequenceDiff::MatchRows(const Topic &topic_a, const Topic &topic_b, std::vector<std::pair<int, int> > &out_matches,
+    int &out_removed, int &out_added)
+{
+    // Sort the rows of both versions by their time (keeping the order of the rows with the same time)
+    std::vector<std::pair<long long, int> > times_a(topic_a.Messages.size()), times_b(topic_b.Messages.size());
+    for (int i = 0; i < (int)times_a.size(); ++i)
+        times_a[i] = std::make_pair(topic_a.Messages[i].DateTime.ToEpochNanoseconds(), i);
+    for (int i = 0; i < (int)times_b.size(); ++i)
+        times_b[i] = std::make_pair(topic_b.Messages[i].DateTime.ToEpochNanoseconds(), i);
+    std::sort(times_a.begin(), times_a.end());
+    std::sort(times_b.begin(), times_b.end());
+
+    // Merge the sorted rows
+    out_matches.clear();
+    out_matches.reserve(std::min(times_a.size(), times_b.size()));
+    out_removed = out_added = 0;
+    size_t i = 0, j = 0;
+    while (i < times_a.size() && j < times_b.size())
+    {
+        if (times_a[i].first < times_b[j].first) { out_removed++; i++; }
+        else if (times_a[i].first > times_b[j].first) { out_added++; j++; }
+        else out_matches.push_back(std::make_pair(times_a[i++].second, times_b[j++].second));
+    }
+    out_removed += times_a.size() - i;
+    out_added += times_b.size() - j;
+}
+
+// Hash the given fields (and the header) of the matched rows of one of the versions. Each value is hashed in place,
+// seeded with the hash of the values before it (so the boundaries between the values are part of the hash).
+unsigned long long SequenceDiff::HashRows(const Topic &topic, const std::vector<std::pair<int, int> > &matches, size_t begin, size_t end,
+    bool second, const std::vector<int> &fields, bool with_header)
+{
+    static const std::string missing_field;
+    unsigned long long hash = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const Message &msg = topic.Messages[second ? matches[i].second : matches[i].first];
+        if (with_header)
+        {
+            hash = LoadCache::Hash((const char *)&msg.Header.SequenceID, sizeof(msg.Header.SequenceID), hash);
+            hash = LoadCache::Hash((const char *)&msg.Header.Stamp, sizeof(msg.Header.Stamp), hash);
+            hash = LoadCache::Hash(msg.Header.FrameID.data(), msg.Header.FrameID.size(), hash);
+        }
+        for (int f = 0; f < (int)fields.size(); ++f)
+        {
+            const std::string &value = fields[f] < (int)msg.Fields.size() ? msg.Fields[fields[f]] : missing_field;
+            hash = LoadCache::Hash(value.data(), value.size(), hash);
+        }
+    }
+    return hash;
+}
+
+// Check if two values are equal (the numbers are equal within the tolerance)
+bool SequenceDiff::AreValuesEqual(const std::string &value_a, const std::string &value_b, const Options &options, double &out_difference)
+{
+    out_difference = 0;
+    if (value_a == value_b) return true;
+
+    double number_a, number_b;
+    if (!Commons::StringToDouble(value_a, number_a) || !Commons::StringToDouble(value_b, number_b)) return false;
+    out_difference = std::fabs(number_a - number_b);
+    if (std::isnan(out_difference)) return std::isnan(number_a) && std::isnan(number_b);
+    return out_difference <= options.Tolerance + options.RelativeTolerance * std::max(std::fabs(number_a), std::fabs(number_b));
+}
+
+}
+#endif
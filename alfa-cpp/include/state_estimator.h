@@ -0,0 +1,600 @@
+/*  ***************************************************************************
+*   state_estimator.h - Header for the offline state estimation of sequences.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_STATE_ESTIMATOR_H
+#define ALFA_STATE_ESTIMATOR_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include "commons.h"
+#include "sequence.h"
+#include "fixed_matrix.h"
+#include "trace.h"
+#include "metrics.h"
+
+namespace alfa
+{
+
+// This class estimates the state of the aircraft (position, velocity, attitude and horizontal wind) of a sequence
+// offline by replaying its merged message list through an extended Kalman filter, optionally followed by a
+// Rauch-Tung-Striebel smoother. The IMU accelerations (and angular velocities, if recorded) drive the prediction,
+// and the GPS position, GPS velocity, airspeed and IMU orientation messages are the measurements. The frames are
+// the ones of mavros: ENU for the world (with the origin at the first GPS fix) and FLU for the body. The state
+// and the matrices have fixed sizes, so the filter does not allocate any memory at each step. The result is a
+// topic with the estimated state (and its standard deviations) at the time of each used message. If metrics are
+// given, the replay records the time of each filter step after the clock of the sequence reaches its message (the
+// lateness of the estimate if the messages arrived in real time) and the time of each sequence.
+class StateEstimator
+{
+public:
+
+    // Local enum and struct definitions
+    enum StateIndex { PositionX = 0, PositionY, PositionZ, VelocityX, VelocityY, VelocityZ, Roll, Pitch, Yaw,
+        WindX, WindY, NumStates };
+
+    typedef FixedMatrix<NumStates, 1> StateVector;
+    typedef FixedMatrix<NumStates, NumStates> StateMatrix;
+
+    struct Options
+    {
+        // Topics of the sensors (the missing ones are not used, except the IMU and the GPS position)
+        std::string IMUTopic = "mavros-imu-data";
+        std::string GPSTopic = "mavros-global_position-global";
+        std::string GPSVelocityTopic = "mavros-global_position-raw-gps_vel";
+        std::string AirspeedTopic = "mavros-nav_info-airspeed";
+        std::string AirspeedField = "measured";
+        std::string OutputTopic = "estimation-state";
+
+        bool Smooth = true;                         // Run the smoother after the filter
+        bool IncludeStandardDeviations = true;      // Add the standard deviation of each state to the output
+
+        // Model of the process (the noise densities)
+        double AccelerationNoise = 0.5;             // m/s^2 per sqrt(Hz)
+        double AngularVelocityNoise = 0.02;         // rad/s per sqrt(Hz) (the attitude random walk if not recorded)
+        double WindNoise = 0.05;                    // m/s per sqrt(s)
+
+        // Models of the measurements (the standard deviations)
+        double GPSPositionNoise = 2.5;              // m (horizontal)
+        double GPSAltitudeNoise = 5;                // m
+        double GPSVelocityNoise = 0.5;              // m/s
+        double AirspeedNoise = 1;                   // m/s
+        double AttitudeNoise = 0.05;                // rad
+        double MinAirspeed = 3;                     // The airspeed measurements below it are not used (m/s)
+
+        // Standard deviations of the initial state
+        double InitialVelocityNoise = 5;            // m/s
+        double InitialWindNoise = 5;                // m/s
+    };
+
+    // Member Functions
+    static bool Estimate(const Sequence &sequence, const Options &options, Topic &out_topic, Metrics *metrics = nullptr);
+    static std::vector<int> EstimateMany(std::vector<Sequence> &sequences, const Options &options, int n_threads = 0,
+        Metrics *metrics = nullptr);
+    static std::string GetStateLabel(StateIndex state);
+
+private:
+    // Local struct definitions
+    struct Input                        // Input of the process model (held from the last IMU message)
+    {
+        double Acceleration[3] = { 0, 0, 0 };       // Specific force in the body frame
+        double AngularVelocity[3] = { 0, 0, 0 };
+    };
+
+    struct Step                         // Estimate at the time of a used message
+    {
+        long long Time;
+        StateVector State;
+        StateMatrix Covariance;
+        Input PredictionInput;          // Input and duration of the prediction from the previous step
+        double PredictionSeconds;
+    };
+
+    struct Sources                      // Indices of the used topics and fields (-1 if not found)
+    {
+        int IMU = -1, GPS = -1, GPSVelocity = -1, Airspeed = -1;
+        int Acceleration[3], AngularVelocity[3], Orientation[4], Position[3], Velocity[3], AirspeedField = -1;
+        bool HasAngularVelocity = false, HasOrientation = false;
+    };
+
+    // Member Functions
+    static bool FindSources(const Sequence &sequence, const Options &options, Sources &out_sources);
+    static bool ReadValues(const Message &msg, const int *fields, int n_fields, double *out_values);
+    static StateVector Predict(const StateVector &state, const Input &input, double dt, bool use_angular_velocity);
+    static StateMatrix GetTransitionJacobian(const StateVector &state, const Input &input, double dt, bool use_angular_velocity);
+    static StateMatrix GetProcessNoise(const Options &options, double dt);
+    template <int M>
+    static void Update(StateVector &state, StateMatrix &covariance, const FixedMatrix<M, 1> &innovation,
+        const FixedMatrix<M, NumStates> &jacobian, const FixedMatrix<M, M> &noise);
+    static void Smooth(std::vector<Step> &steps, const Options &options, bool use_angular_velocity);
+    static void RotateToWorld(double roll, double pitch, double yaw, const double *body, double *out_world);
+    static void QuaternionToEuler(const double *quaternion, double &out_roll, double &out_pitch, double &out_yaw);
+    static double WrapAngle(double angle);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Estimate the states of a sequence and create the topic of the estimates
+bool StateEstimator::Estimate(const Sequence &sequence, const Options &options, Topic &out_topic, Metrics *metrics)
+{
+    Trace::Scope trace_scope("estimate", "sequence", sequence.Name);
+    std::chrono::steady_clock::time_point sequence_start = std::chrono::steady_clock::now();
+
+    // Register the metrics of the replay (if requested)
+    Metrics::Counter *replayed = nullptr;
+    Metrics::Histogram *lateness = nullptr, *sequence_duration = nullptr;
+    if (metrics)
+    {
+        replayed = &metrics->AddCounter("alfa_estimate_messages_total", "Messages replayed through the filter.");
+        lateness = &metrics->AddHistogram("alfa_estimate_lateness_seconds",
+            "Time of a filter step after the clock of the sequence reaches its message.", Metrics::ExponentialBuckets(0.000001, 4, 10));
+        sequence_duration = &metrics->AddHistogram("alfa_estimate_sequence_duration_seconds",
+            "Time of estimating a sequence (with the smoother).", Metrics::ExponentialBuckets(0.01, 2, 12));
+    }
+
+    // Find the topics and the fields of the sensors
+    Sources sources;
+    if (!FindSources(sequence, options, sources)) return false;
+
+    const double earth_radius = 6378137, degree = M_PI / 180;
+    std::vector<Step> steps;
+    steps.reserve(sequence.Topics[sources.IMU].Messages.size() + sequence.Topics[sources.GPS].Messages.size());
+
+    // Replay the merged message list
+    Input input;
+    bool has_input = false, has_orientation = false;
+    double orientation[3] = { 0, 0, 0 }, origin[3] = { 0, 0, 0 }, cos_latitude = 1;
+    StateVector state = StateVector::Zero();
+    StateMatrix covariance = StateMatrix::Zero();
+    for (size_t i = 0; i < sequence.MessageIndexList.size(); ++i)
+    {
+        // Skip the messages of the other topics and the ones with invalid values
+        int topic_idx = sequence.MessageIndexList[i].TopicIdx;
+        if (topic_idx != sources.IMU && topic_idx != sources.GPS && topic_idx != sources.GPSVelocity && topic_idx != sources.Airspeed) continue;
+        std::chrono::steady_clock::time_point message_start;
+        if (lateness) message_start = std::chrono::steady_clock::now();
+        const Message &msg = sequence.GetMessage(i);
+        double values[4];
+        Input new_input = input;
+        bool new_orientation = false;
+        if (topic_idx == sources.IMU)
+        {
+            if (!ReadValues(msg, sources.Acceleration, 3, new_input.Acceleration)) continue;
+            if (sources.HasAngularVelocity && !ReadValues(msg, sources.AngularVelocity, 3, new_input.AngularVelocity)) continue;
+            if (sources.HasOrientation && ReadValues(msg, sources.Orientation, 4, values))
+            {
+                QuaternionToEuler(values, orientation[0], orientation[1], orientation[2]);
+                new_orientation = true;
+            }
+        }
+        else if (topic_idx == sources.GPS && !ReadValues(msg, sources.Position, 3, values)) continue;
+        else if (topic_idx == sources.GPSVelocity && !ReadValues(msg, sources.Velocity, 3, values)) continue;
+        else if (topic_idx == sources.Airspeed && !ReadValues(msg, &sources.AirspeedField, 1, values)) continue;
+
+        // Initialize the filter at the first GPS fix after an IMU message
+        long long time = msg.DateTime.ToEpochNanoseconds();
+        if (steps.empty())
+        {
+            if (topic_idx == sources.IMU)
+            {
+                input = new_input;
+                has_input = true;
+                has_orientation = new_orientation;
+            }
+            if (topic_idx != sources.GPS || !has_input) continue;
+
+            // Start at the origin with the attitude from the orientation or from the gravity (and an unknown yaw)
+            std::copy(values, values + 3, origin);
+            cos_latitude = std::cos(origin[0] * degree);
+            const double *f = input.Acceleration;
+            state(Roll, 0) = has_orientation ? orientation[0] : std::atan2(f[1], f[2]);
+            state(Pitch, 0) = has_orientation ? orientation[1] : std::atan2(-f[0], std::sqrt(f[1] * f[1] + f[2] * f[2]));
+            state(Yaw, 0) = has_orientation ? orientation[2] : 0;
+            const double attitude_variance = has_orientation ? options.AttitudeNoise * options.AttitudeNoise : 0.1;
+            const double variances[NumStates] = { options.GPSPositionNoise * options.GPSPositionNoise,
+                options.GPSPositionNoise * options.GPSPositionNoise, options.GPSAltitudeNoise * options.GPSAltitudeNoise,
+                options.InitialVelocityNoise * options.InitialVelocityNoise, options.InitialVelocityNoise * options.InitialVelocityNoise,
+                options.InitialVelocityNoise * options.InitialVelocityNoise, attitude_variance, attitude_variance,
+                has_orientation ? attitude_variance : M_PI * M_PI, options.InitialWindNoise * options.InitialWindNoise,
+                options.InitialWindNoise * options.InitialWindNoise };
+            for (int s = 0; s < NumStates; ++s)
+                covariance(s, s) = variances[s];
+
+            Step step = { time, state, covariance, input, 0 };
+            steps.push_back(step);
+            continue;
+        }
+
+        // Predict the state at the time of the message with the input of the last IMU message
+        Step step;
+        step.Time = time;
+        step.PredictionInput = input;
+        step.PredictionSeconds = std::max(0.0, (time - steps.back().Time) * 1e-9);
+        if (step.PredictionSeconds > 0)
+        {
+            StateMatrix transition = GetTransitionJacobian(state, input, step.PredictionSeconds, sources.HasAngularVelocity);
+            state = Predict(state, input, step.PredictionSeconds, sources.HasAngularVelocity);
+            covariance = transition * covariance * transition.Transpose() + GetProcessNoise(options, step.PredictionSeconds);
+        }
+
+        // Update the state with the measurement of the message
+        if (topic_idx == sources.IMU)
+        {
+            input = new_input;
+            if (new_orientation)
+            {
+                FixedMatrix<3, 1> innovation;
+                FixedMatrix<3, NumStates> jacobian = FixedMatrix<3, NumStates>::Zero();
+                for (int a = 0; a < 3; ++a)
+                {
+                    innovation(a, 0) = WrapAngle(orientation[a] - state(Roll + a, 0));
+                    jacobian(a, Roll + a) = 1;
+                }
+                Update(state, covariance, innovation, jacobian, FixedMatrix<3, 3>::Identity() * (options.AttitudeNoise * options.AttitudeNoise));
+            }
+        }
+        else if (topic_idx == sources.GPS)
+        {
+            // Convert the position to the local ENU frame
+            FixedMatrix<3, 1> innovation;
+            innovation(0, 0) = (values[1] - origin[1]) * degree * earth_radius * cos_latitude - state(PositionX, 0);
+            innovation(1, 0) = (values[0] - origin[0]) * degree * earth_radius - state(PositionY, 0);
+            innovation(2, 0) = (values[2] - origin[2]) - state(PositionZ, 0);
+            FixedMatrix<3, NumStates> jacobian = FixedMatrix<3, NumStates>::Zero();
+            FixedMatrix<3, 3> noise = FixedMatrix<3, 3>::Zero();
+            for (int a = 0; a < 3; ++a)
+            {
+                jacobian(a, PositionX + a) = 1;
+                noise(a, a) = a < 2 ? options.GPSPositionNoise * options.GPSPositionNoise : options.GPSAltitudeNoise * options.GPSAltitudeNoise;
+            }
+            Update(state, covariance, innovation, jacobian, noise);
+        }
+        else if (topic_idx == sources.GPSVelocity)
+        {
+            FixedMatrix<3, 1> innovation;
+            FixedMatrix<3, NumStates> jacobian = FixedMatrix<3, NumStates>::Zero();
+            for (int a = 0; a < 3; ++a)
+            {
+                innovation(a, 0) = values[a] - state(VelocityX + a, 0);
+                jacobian(a, VelocityX + a) = 1;
+            }
+            Update(state, covariance, innovation, jacobian, FixedMatrix<3, 3>::Identity() * (options.GPSVelocityNoise * options.GPSVelocityNoise));
+        }
+        else if (values[0] >= options.MinAirspeed &&
+            covariance(VelocityX, VelocityX) + covariance(VelocityY, VelocityY) <= 2 * options.AirspeedNoise * options.AirspeedNoise)
+        {
+            // The airspeed is the norm of the velocity relative to the (horizontal) wind (only used after the GPS
+            // has found the velocity, since the linearization around a wrong velocity biases the wind)
+            double relative[3] = { state(VelocityX, 0) - state(WindX, 0), state(VelocityY, 0) - state(WindY, 0), state(VelocityZ, 0) };
+            double airspeed = std::sqrt(relative[0] * relative[0] + relative[1] * relative[1] + relative[2] * relative[2]);
+            if (airspeed > 1e-3)
+            {
+                FixedMatrix<1, 1> innovation, noise;
+                innovation(0, 0) = values[0] - airspeed;
+                noise(0, 0) = options.AirspeedNoise * options.AirspeedNoise;
+                FixedMatrix<1, NumStates> jacobian = FixedMatrix<1, NumStates>::Zero();
+                for (int a = 0; a < 3; ++a)
+                    jacobian(0, VelocityX + a) = relative[a] / airspeed;
+                jacobian(0, WindX) = -relative[0] / airspeed;
+                jacobian(0, WindY) = -relative[1] / airspeed;
+                Update(state, covariance, innovation, jacobian, noise);
+            }
+        }
+
+        step.State = state;
+        step.Covariance = covariance;
+        steps.push_back(step);
+        if (lateness)
+        {
+            replayed->Increment();
+            lateness->Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - message_start).count());
+        }
+    }
+
+    // Print an error if the filter never started
+    if (steps.empty())
+    {
+        std::cerr << "StateEstimator Error! No GPS fix after an IMU message in '" << sequence.Name << "'." << std::endl;
+        return false;
+    }
+
+    // Smooth the estimates with the later measurements
+    if (options.Smooth)
+        Smooth(steps, options, sources.HasAngularVelocity);
+
+    // Create the topic of the estimates
+    VecString labels;
+    for (int s = 0; s < NumStates; ++s)
+        labels.push_back(GetStateLabel((StateIndex)s));
+    if (options.IncludeStandardDeviations)
+        for (int s = 0; s < NumStates; ++s)
+            labels.push_back(GetStateLabel((StateIndex)s) + "_std");
+    out_topic.Create(options.OutputTopic, labels);
+    out_topic.Messages.reserve(steps.size());
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        Message msg;
+        msg.DateTime = DateTime::EpochNanosecondsToTime(steps[i].Time);
+        msg.Fields.reserve(labels.size());
+        for (int s = 0; s < NumStates; ++s)
+            msg.Fields.push_back(Commons::DoubleToString(steps[i].State(s, 0)));
+        if (options.IncludeStandardDeviations)
+            for (int s = 0; s < NumStates; ++s)
+                msg.Fields.push_back(Commons::DoubleToString(std::sqrt(std::max(0.0, steps[i].Covariance(s, s)))));
+        out_topic.AddMessage(msg);
+    }
+
+    if (sequence_duration)
+        sequence_duration->Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - sequence_start).count());
+    return true;
+}
+
+// Estimate the states of the sequences in parallel and add the topic of the estimates to each of them (replacing
+// the topic of a previous estimation, e.g. the one loaded from the file written by the estimate tool).
+// Returns the indices of the sequences that were estimated successfully.
+std::vector<int> StateEstimator::EstimateMany(std::vector<Sequence> &sequences, const Options &options, int n_threads,
+    Metrics *metrics)
+{
+    std::vector<char> estimated(sequences.size(), 0);
+    Commons::ParallelFor(sequences.size(), n_threads, [&](int i)
+    {
+        Topic topic;
+        if (!Estimate(sequences[i], options, topic, metrics)) return;
+
+        // Add the topic if the sequence does not have the estimates yet
+        Sequence &sequence = sequences[i];
+        int topic_idx = sequence.FindTopicIndex(options.OutputTopic);
+        if (topic_idx < 0)
+        {
+            estimated[i] = sequence.AddTopic(topic);
+            return;
+        }
+
+        // Replace the previous estimates
+        sequence.Topics[topic_idx] = std::move(topic);
+        sequence.Topics[topic_idx].SetDiagnostics(sequence.GetDiagnostics());
+        sequence.RebuildMessageList();
+        estimated[i] = 1;
+    });
+
+    std::vector<int> result;
+    for (int i = 0; i < (int)sequences.size(); ++i)
+        if (estimated[i])
+            result.push_back(i);
+    return result;
+}
+
+// Get the field label of a state in the topic of the estimates
+std::string StateEstimator::GetStateLabel(StateIndex state)
+{
+    static const char *labels[NumStates] = { "position.x", "position.y", "position.z", "velocity.x", "velocity.y",
+        "velocity.z", "roll", "pitch", "yaw", "wind.x", "wind.y" };
+    return labels[state];
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Find the topics and the fields of the sensors in the sequence
+bool StateEstimator::FindSources(const Sequence &sequence, const Options &options, Sources &out_sources)
+{
+    const char *axes[4] = { "x", "y", "z", "w" };
+    out_sources.IMU = sequence.FindTopicIndex(options.IMUTopic);
+    out_sources.GPS = sequence.FindTopicIndex(options.GPSTopic);
+    out_sources.GPSVelocity = sequence.FindTopicIndex(options.GPSVelocityTopic);
+    out_sources.Airspeed = sequence.FindTopicIndex(options.AirspeedTopic);
+
+    // Print an error if the IMU accelerations or the GPS positions are not found
+    bool found = out_sources.IMU >= 0 && out_sources.GPS >= 0;
+    for (int a = 0; found && a < 3; ++a)
+        found = (out_sources.Acceleration[a] = sequence.Topics[out_sources.IMU].FindLabelIndex(std::string("linear_acceleration.") + axes[a])) >= 0;
+    const char *position_labels[3] = { "latitude", "longitude", "altitude" };
+    for (int a = 0; found && a < 3; ++a)
+        found = (out_sources.Position[a] = sequence.Topics[out_sources.GPS].FindLabelIndex(position_labels[a])) >= 0;
+    if (!found)
+    {
+        std::cerr << "StateEstimator Error! The IMU accelerations ('" << options.IMUTopic << "') or the GPS positions ('" <<
+            options.GPSTopic << "') are not found in '" << sequence.Name << "'." << std::endl;
+        return false;
+    }
+
+    // Find the optional fields of the IMU
+    const Topic &imu = sequence.Topics[out_sources.IMU];
+    out_sources.HasAngularVelocity = out_sources.HasOrientation = true;
+    for (int a = 0; a < 3; ++a)
+        out_sources.HasAngularVelocity = (out_sources.AngularVelocity[a] = imu.FindLabelIndex(std::string("angular_velocity.") + axes[a])) >= 0 &&
+            out_sources.HasAngularVelocity;
+    for (int a = 0; a < 4; ++a)
+        out_sources.HasOrientation = (out_sources.Orientation[a] = imu.FindLabelIndex(std::string("orientation.") + axes[a])) >= 0 &&
+            out_sources.HasOrientation;
+
+    // Do not use the optional topics without their fields
+    for (int a = 0; out_sources.GPSVelocity >= 0 && a < 3; ++a)
+        if ((out_sources.Velocity[a] = sequence.Topics[out_sources.GPSVelocity].FindLabelIndex(std::string("twist.linear.") + axes[a])) < 0)
+            out_sources.GPSVelocity = -1;
+    if (out_sources.Airspeed >= 0 && (out_sources.AirspeedField = sequence.Topics[out_sources.Airspeed].FindLabelIndex(options.AirspeedField)) < 0)
+        out_sources.Airspeed = -1;
+
+    return true;
+}
+
+// Read the numeric values of the given fields of a message. Returns false if any of them is not a finite number.
+bool StateEstimator::ReadValues(const Message &msg, const int *fields, int n_fields, double *out_values)
+{
+    for (int f = 0; f < n_fields; ++f)
+        if (fields[f] >= (int)msg.Fields.size() || !Commons::StringToDouble(msg.Fields[fields[f]], out_values[f]) || !std::isfinite(out_values[f]))
+            return false;
+    return true;
+}
+
+// Predict the state after the given duration with the process model (constant input and wind)
+StateEstimator::StateVector StateEstimator::Predict(const StateVector &state, const Input &input, double dt, bool use_angular_velocity)
+{
+    StateVector result = state;
+    const double roll = state(Roll, 0), pitch = state(Pitch, 0), yaw = state(Yaw, 0);
+
+    // The acceleration in the world frame is the rotated specific force minus the gravity
+    double acceleration[3];
+    RotateToWorld(roll, pitch, yaw, input.Acceleration, acceleration);
+    acceleration[2] -= 9.80665;
+    for (int a = 0; a < 3; ++a)
+    {
+        result(PositionX + a, 0) += state(VelocityX + a, 0) * dt + 0.5 * acceleration[a] * dt * dt;
+        result(VelocityX + a, 0) += acceleration[a] * dt;
+    }
+
+    // Integrate the Euler angle rates of the body angular velocity
+    if (use_angular_velocity && std::fabs(std::cos(pitch)) > 1e-6)
+    {
+        const double *w = input.AngularVelocity;
+        const double sr = std::sin(roll), cr = std::cos(roll), tp = std::tan(pitch), cp = std::cos(pitch);
+        result(Roll, 0) = WrapAngle(roll + (w[0] + sr * tp * w[1] + cr * tp * w[2]) * dt);
+        result(Pitch, 0) = pitch + (cr * w[1] - sr * w[2]) * dt;
+        result(Yaw, 0) = WrapAngle(yaw + (sr / cp * w[1] + cr / cp * w[2]) * dt);
+    }
+    return result;
+}
+
+// Get the Jacobian of the process model with the central differences
+StateEstimator::StateMatrix StateEstimator::GetTransitionJacobian(const StateVector &state, const Input &input, double dt, bool use_angular_velocity)
+{
+    const double epsilon = 1e-6;
+    StateMatrix jacobian;
+    for (int s = 0; s < NumStates; ++s)
+    {
+        StateVector plus = state, minus = state;
+        plus(s, 0) += epsilon;
+        minus(s, 0) -= epsilon;
+        StateVector predicted_plus = Predict(plus, input, dt, use_angular_velocity), predicted_minus = Predict(minus, input, dt, use_angular_velocity);
+        for (int r = 0; r < NumStates; ++r)
+        {
+            double difference = predicted_plus(r, 0) - predicted_minus(r, 0);
+            if (r == Roll || r == Yaw) difference = WrapAngle(difference);
+            jacobian(r, s) = difference / (2 * epsilon);
+        }
+    }
+    return jacobian;
+}
+
+// Get the covariance of the process noise for the given duration
+StateEstimator::StateMatrix StateEstimator::GetProcessNoise(const Options &options, double dt)
+{
+    StateMatrix noise = StateMatrix::Zero();
+    const double acceleration = options.AccelerationNoise * options.AccelerationNoise;
+    for (int a = 0; a < 3; ++a)
+    {
+        noise(PositionX + a, PositionX + a) = acceleration * dt * dt * dt / 3;
+        noise(PositionX + a, VelocityX + a) = noise(VelocityX + a, PositionX + a) = acceleration * dt * dt / 2;
+        noise(VelocityX + a, VelocityX + a) = acceleration * dt;
+        noise(Roll + a, Roll + a) = options.AngularVelocityNoise * options.AngularVelocityNoise * dt;
+    }
+    noise(WindX, WindX) = noise(WindY, WindY) = options.WindNoise * options.WindNoise * dt;
+    return noise;
+}
+
+// Update the state and its covariance with a measurement (in the Joseph form, which keeps the covariance positive)
+template <int M>
+void StateEstimator::Update(StateVector &state, StateMatrix &covariance, const FixedMatrix<M, 1> &innovation,
+    const FixedMatrix<M, NumStates> &jacobian, const FixedMatrix<M, M> &noise)
+{
+    FixedMatrix<NumStates, M> jacobian_t = jacobian.Transpose();
+    FixedMatrix<M, M> innovation_covariance = jacobian * covariance * jacobian_t + noise, inverse;
+    if (!innovation_covariance.Inverse(inverse)) return;
+
+    FixedMatrix<NumStates, M> gain = covariance * jacobian_t * inverse;
+    state = state + gain * innovation;
+    state(Roll, 0) = WrapAngle(state(Roll, 0));
+    state(Yaw, 0) = WrapAngle(state(Yaw, 0));
+
+    StateMatrix factor = StateMatrix::Identity() - gain * jacobian;
+    covariance = factor * covariance * factor.Transpose() + gain * noise * gain.Transpose();
+}
+
+// Smooth the filtered estimates backwards (the Rauch-Tung-Striebel smoother). The predictions between the
+// steps are recomputed from their inputs, so only the filtered estimates are kept for each step.
+void StateEstimator::Smooth(std::vector<Step> &steps, const Options &options, bool use_angular_velocity)
+{
+    for (int k = (int)steps.size() - 2; k >= 0; --k)
+    {
+        const Step &next = steps[k + 1];
+        Step &step = steps[k];
+        if (next.PredictionSeconds <= 0)
+        {
+            // The steps at the same time have the same smoothed estimate
+            step.State = next.State;
+            step.Covariance = next.Covariance;
+            continue;
+        }
+
+        // Recompute the prediction of the next step from this step
+        StateMatrix transition = GetTransitionJacobian(step.State, next.PredictionInput, next.PredictionSeconds, use_angular_velocity);
+        StateVector predicted = Predict(step.State, next.PredictionInput, next.PredictionSeconds, use_angular_velocity);
+        StateMatrix predicted_covariance = transition * step.Covariance * transition.Transpose() +
+            GetProcessNoise(options, next.PredictionSeconds), inverse;
+        if (!predicted_covariance.Inverse(inverse)) continue;
+
+        // Correct this step with the difference of the smoothed next step and its prediction
+        StateMatrix gain = step.Covariance * transition.Transpose() * inverse;
+        StateVector difference = next.State - predicted;
+        difference(Roll, 0) = WrapAngle(difference(Roll, 0));
+        difference(Yaw, 0) = WrapAngle(difference(Yaw, 0));
+        step.State = step.State + gain * difference;
+        step.State(Roll, 0) = WrapAngle(step.State(Roll, 0));
+        step.State(Yaw, 0) = WrapAngle(step.State(Yaw, 0));
+        step.Covariance = step.Covariance + gain * (next.Covariance - predicted_covariance) * gain.Transpose();
+    }
+}
+
+// Rotate a vector from the body frame (FLU) to the world frame (ENU) with the roll, pitch and yaw angles
+void StateEstimator::RotateToWorld(double roll, double pitch, double yaw, const double *body, double *out_world)
+{
+    const double sr = std::sin(roll), cr = std::cos(roll), sp = std::sin(pitch), cp = std::cos(pitch);
+    const double sy = std::sin(yaw), cy = std::cos(yaw);
+    out_world[0] = cy * cp * body[0] + (cy * sp * sr - sy * cr) * body[1] + (cy * sp * cr + sy * sr) * body[2];
+    out_world[1] = sy * cp * body[0] + (sy * sp * sr + cy * cr) * body[1] + (sy * sp * cr - cy * sr) * body[2];
+    out_world[2] = -sp * body[0] + cp * sr * body[1] + cp * cr * body[2];
+}
+
+// Convert an orientation quaternion (x, y, z, w) to the roll, pitch and yaw angles
+void StateEstimator::QuaternionToEuler(const double *quaternion, double &out_roll, double &out_pitch, double &out_yaw)
+{
+    const double x = quaternion[0], y = quaternion[1], z = quaternion[2], w = quaternion[3];
+    out_roll = std::atan2(2 * (w * x + y * z), 1 - 2 * (x * x + y * y));
+    out_pitch = std::asin(std::max(-1.0, std::min(1.0, 2 * (w * y - z * x))));
+    out_yaw = std::atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z));
+}
+
+// Wrap an angle to [-pi, pi]
+double StateEstimator::WrapAngle(double angle)
+{
+    return std::atan2(std::sin(angle), std::cos(angle));
+}
+
+}
+#endif
@@ -33,8 +33,14 @@
 #include <iomanip>
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <memory>
+#include <atomic>
 #include "commons.h"
 #include "message.h"
+#include "diagnostics.h"
+#include "perf_counters.h"
+#include "trace.h"
 
 namespace alfa
 {
@@ -44,6 +50,17 @@ class Topic
 {
 public:
 
+    // Local struct definitions
+    struct LoadStats                // Statistics of loading the topic from its file
+    {
+        long long FileSize = 0;     // Size of the file in bytes
+        int EstimatedRows = 0;      // Number of the data rows estimated before parsing (used to allocate the messages)
+        int LoadedRows = 0;         // Number of the messages actually loaded
+        double LoadSeconds = 0;     // Time spent on reading and parsing the file
+        PerfCounters::Values ReadCounters;      // Hardware counters of reading the file (if enabled)
+        PerfCounters::Values ParseCounters;     // Hardware counters of parsing the messages (if enabled)
+    };
+
     // Class Data Members
     std::string Name = "N/A";
     std::string FileName;
@@ -51,25 +68,31 @@ public:
     std::vector<Message> Messages;
 
     // Constructors & Deconstructors
-    Topic(const std::string &filename = "", const std::string &topic_name = "N/A");
+    Topic(const std::string &filename = "", const std::string &topic_name = "N/A",
+        const std::shared_ptr<Diagnostics> &diagnostics = nullptr);
 
     // Member Functions
-    Topic& operator=(const Topic& other) {
-        if (this != &other) {
-            // 实现赋值逻辑
-        }
-        return *this;
-    }
     bool operator==(const Topic& other) const {
         return Name == other.Name;
     }
     bool ReadFromFile(const std::string &filename);
+    bool ReadFromContent(const std::string &content, const std::string &filename);
+    bool Create(const std::string &topic_name, const VecString &field_labels, bool has_header = false);
+    bool WriteToFile(const std::string &filename) const;
+    bool WriteBinary(std::ostream &os) const;
+    bool ReadBinary(std::istream &is);
+    void AddMessage(const Message &msg);
     int Print(int n_start = 0, int n_messages = -1, const std::string &field_separator = " | ") const;
     int PrintHeader(const std::string &field_separator = " | ") const;
     bool IsInitialized() const;
-    bool IsFaultTopic();
-    bool HasHeaderField();
-    int FindLabelIndex(const std::string &label);
+    const LoadStats &GetLoadStats() const;
+    static void SetLoadCountersEnabled(bool enabled);
+    static bool IsLoadCountersEnabled();
+    std::shared_ptr<Diagnostics> GetDiagnostics() const;
+    void SetDiagnostics(const std::shared_ptr<Diagnostics> &diagnostics);
+    bool IsFaultTopic() const;
+    bool HasHeaderField() const;
+    int FindLabelIndex(const std::string &label) const;
     void Clear();
 
     std::vector<DateTime> GetTimes(int start_msg_index = 0, int n_messages = -1);
@@ -117,9 +140,23 @@ public:
     { return GetFieldsAsLongDouble(field_index, start_msg_index, n_messages); }
 
 private:
+    // Local struct definitions
+    struct PrintWidths              // Maximum lengths of the printed header and data fields
+    {
+        int SequenceID = 0, Stamp = 0, FrameID = 0;
+        std::vector<int> Fields;
+    };
+
     // Member Functions
-    Message TokensToMessage(const VecString &tokens);
+    PrintWidths MeasurePrintWidths() const;
+    int PrintHeaderLine(const PrintWidths &widths, const std::string &field_separator) const;
+    static int GetNumberWidth(long long number);
     void ProcessHeader();
+    void DetectFaultTopic();
+    bool ParseContent(const std::string &content, PerfCounters *perf_counters, long long trace_start,
+        std::chrono::steady_clock::time_point start_time);
+    static bool GetNextLine(const std::string &content, size_t &pos, std::string &out_line);
+    void Report(Diagnostics::Severity level, const std::string &text, int line_number = -1) const;
 
     // Data Members
 
@@ -132,27 +169,44 @@ private:
     // Is the topic a fault topic
     bool is_fault_topic = false;
 
-    // Maximum length of the data fields (for better printing)
-    int len_seqid = 0, len_stamp = 0, len_frameid = 0;
-    std::vector<int> len_fields;
-
     // Pre-processed field labels from the CSV file
     VecString orig_field_labels;
 
-    // Header strings for printing
-    const std::string hdr_ind = "Index", hdr_datetime = "Date/Time Stamp";
-    const std::string hdr_seq = "SeqID", hdr_stamp = "Time Stamp", hdr_frid = "Frame";
+    // Header strings for printing (static, so the topic stays copy and move assignable)
+    static const std::string hdr_ind, hdr_datetime;
+    static const std::string hdr_seq, hdr_stamp, hdr_frid;
 
     // Keep if the topic has header field
     bool has_header = false;
+
+    // Statistics of the last load
+    LoadStats load_stats;
+
+    // Collect the hardware counters of the load stages (off by default, since opening the counters has a cost)
+    static std::atomic<bool> load_counters_enabled;
+
+    // Collector of the errors and warnings (may be shared with the other topics of the sequence)
+    DiagnosticsLink diagnostics;
 };
 
 /******************************************************************************/
 /************************** Function Definitions ******************************/
 /******************************************************************************/
 
+// Header strings for printing the topics
+const std::string Topic::hdr_ind = "Index";
+const std::string Topic::hdr_datetime = "Date/Time Stamp";
+const std::string Topic::hdr_seq = "SeqID";
+const std::string Topic::hdr_stamp = "Time Stamp";
+const std::string Topic::hdr_frid = "Frame";
+
+// The hardware counters of the loads are not collected by default
+std::atomic<bool> Topic::load_counters_enabled(false);
+
 // Contructor function for Topic. Loads a CSV file containing an ALFA dataset topic.
-Topic::Topic(const std::string &filename, const std::string &topic_name)
+// The errors are reported to the given diagnostics collector (or to its own one, created on the first report, if not given).
+Topic::Topic(const std::string &filename, const std::string &topic_name, const std::shared_ptr<Diagnostics> &diagnostics)
+    : diagnostics(diagnostics)
 {
     // Assign the given topic name
     Name = topic_name;
@@ -176,29 +230,101 @@ bool Topic::ReadFromFile(const std::string &filename)
     this->FileName = filename;
     this->Name = topic_name;
 
-    // Open the CSV file
-    std::ifstream ifs (filename);
+    // Start the hardware counters of the read stage (if enabled)
+    std::unique_ptr<PerfCounters> perf_counters;
+    if (load_counters_enabled)
+    {
+        perf_counters.reset(new PerfCounters());
+        perf_counters->Start();
+    }
+
+    // Read the whole CSV file into memory with a single read. The file is not memory-mapped: the parser copies every
+    // field out of the content anyway, and a mapped file that is truncated while it is parsed (e.g. on a network
+    // drive) would crash the process with SIGBUS instead of failing the load.
+    long long trace_start = Trace::IsEnabled() ? Trace::GetTimeNanoseconds() : -1;
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    std::string content;
 
     // Print an error if file did not open properly
-    if (!ifs.is_open())
+    if (!Commons::ReadFileToString(filename, content))
     {
-        std::cerr << "Failed to open '" << filename << "' file." << std::endl;
+        Report(Diagnostics::Error, "Failed to open '" + filename + "' file.");
         return false;
     }
 
+    // Continue with the counters and the trace of the parse stage
+    if (perf_counters)
+    {
+        load_stats.ReadCounters = perf_counters->Stop();
+        perf_counters->Start();
+    }
+    if (trace_start >= 0)
+    {
+        long long trace_now = Trace::GetTimeNanoseconds();
+        Trace::AddEvent("load", "read", Name, trace_start, trace_now);
+        trace_start = trace_now;
+    }
+
+    return ParseContent(content, perf_counters.get(), trace_start, start_time);
+}
+
+// Parse a CSV file containing an ALFA dataset topic from its content that is already in memory
+// (e.g. read to find its hash). Keeps the name of the topic like ReadFromFile.
+bool Topic::ReadFromContent(const std::string &content, const std::string &filename)
+{
+    // Keep the topic name
+    std::string topic_name = Name;
+
+    // Clear the previous data from the object
+    this->Clear();
+
+    // Save the filename and topic name
+    this->FileName = filename;
+    this->Name = topic_name;
+
+    // Start the hardware counters of the parse stage (if enabled)
+    std::unique_ptr<PerfCounters> perf_counters;
+    if (load_counters_enabled)
+    {
+        perf_counters.reset(new PerfCounters());
+        perf_counters->Start();
+    }
+
+    long long trace_start = Trace::IsEnabled() ? Trace::GetTimeNanoseconds() : -1;
+    return ParseContent(content, perf_counters.get(), trace_start, std::chrono::steady_clock::now());
+}
+
+// Parse the messages of the topic from the content of its CSV file (the counters and the trace are of the parse
+// stage, and the load time is from the given start time)
+bool Topic::ParseContent(const std::string &content, PerfCounters *perf_counters, long long trace_start,
+    std::chrono::steady_clock::time_point start_time)
+{
+    const std::string &filename = FileName;
+
+    // Estimate the number of the data rows by counting the lines (excluding the header line)
+    size_t n_lines = Commons::CountCharacter(content, '\n');
+    if (!content.empty() && content[content.length() - 1] != '\n') ++n_lines;
+    load_stats.FileSize = content.size();
+    load_stats.EstimatedRows = n_lines > 0 ? (int)n_lines - 1 : 0;
+
     // Read the header line from the CSV file
     std::string line;
-    if (std::getline(ifs, line))
+    size_t pos = 0;
+    if (GetNextLine(content, pos, line))
         this->orig_field_labels = Commons::Tokenize(line, Commons::CSVDelimiter);
     else // Print an error if the file is not formatted properly
     {
-        std::cerr << "Error reading the header from '" << filename << "' file." << std::endl;
+        Report(Diagnostics::Error, "Error reading the header from '" + filename + "' file.");
         return false;
     }
 
-    // Read the data from the CSV file
-    int line_number = 0;
-    while (std::getline(ifs, line))
+    // Allocate all the messages once (and the fields of each message once)
+    this->Messages.reserve(load_stats.EstimatedRows);
+    int n_data_fields = Message::CountDataFields(this->orig_field_labels);
+
+    // Read the data from the CSV file (the line numbers are of the file, so the header is line #1)
+    int line_number = 1;
+    while (GetNextLine(content, pos, line))
     {
         line_number++;
 
@@ -212,21 +338,59 @@ bool Topic::ReadFromFile(const std::string &filename)
         // Print an error and stop operation if file is not formatted properly
         if (tokens.size() > this->orig_field_labels.size())
         {
-            std::cerr << "Error converting line #" << line_number << " of '" << filename << "'. Skipping this topic!" << std::endl;
+            Report(Diagnostics::Error, "Error converting line #" + std::to_string(line_number) + " of '" + filename +
+                "'. Skipping the rest of this topic!", line_number);
             break;
         }
 
-        // Convert the tokens to a message and add to our collection
-        this->Messages.push_back(TokensToMessage(tokens));
+        // Convert the tokens to a message and move it to our collection
+        this->Messages.emplace_back(Message::TokensToMessage(std::move(tokens), this->orig_field_labels, n_data_fields));
+    }
+
+    // Keep the load statistics
+    load_stats.LoadedRows = this->Messages.size();
+    load_stats.LoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (perf_counters)
+        load_stats.ParseCounters = perf_counters->Stop();
+    if (trace_start >= 0)
+        Trace::AddEvent("load", "parse", Name, trace_start, Trace::GetTimeNanoseconds());
+
+    // Postprocess the header labels
+    ProcessHeader();
+
+    // Check if it is a fault topic
+    DetectFaultTopic();
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Create an empty topic in memory with the given field labels (without the 'field.' prefix).
+// The messages can then be added using AddMessage.
+bool Topic::Create(const std::string &topic_name, const VecString &field_labels, bool has_header)
+{
+    // Clear the previous data from the object
+    this->Clear();
+    this->Name = topic_name;
+
+    // Create the labels as they appear in the CSV files
+    this->orig_field_labels.push_back("%time");
+    if (has_header)
+    {
+        this->orig_field_labels.push_back(Commons::CSVFieldsPrefix + "header.seq");
+        this->orig_field_labels.push_back(Commons::CSVFieldsPrefix + "header.stamp");
+        this->orig_field_labels.push_back(Commons::CSVFieldsPrefix + "header.frame_id");
     }
+    for (int i = 0; i < (int)field_labels.size(); ++i)
+        this->orig_field_labels.push_back(Commons::CSVFieldsPrefix + field_labels[i]);
 
     // Postprocess the header labels
     ProcessHeader();
 
-    // It is not a fault topic if the topic name is shorter than the fault prefix
-    if (this->Name.length() >= Commons::FaultTopicPrefix.length()) 
-        // Check if the prefix of topic name is the fault prefix
-        is_fault_topic = (this->Name.substr(0, Commons::FaultTopicPrefix.length()) == Commons::FaultTopicPrefix);
+    // Check if it is a fault topic
+    DetectFaultTopic();
 
     // Initialization done
     is_initialized = true;
@@ -234,6 +398,143 @@ bool Topic::ReadFromFile(const std::string &filename)
     return IsInitialized();
 }
 
+// Write the topic to a CSV file in the same format as the dataset topic files
+bool Topic::WriteToFile(const std::string &filename) const
+{
+    // Open the CSV file
+    std::ofstream ofs(filename);
+
+    // Print an error if file did not open properly
+    if (!ofs.is_open())
+    {
+        Report(Diagnostics::Error, "Failed to open '" + filename + "' file for writing.");
+        return false;
+    }
+
+    // Write the header line
+    for (int i = 0; i < (int)orig_field_labels.size(); ++i)
+        ofs << (i > 0 ? std::string(1, Commons::CSVDelimiter) : "") << orig_field_labels[i];
+    ofs << std::endl;
+
+    // Write the messages, putting the time, the header and the fields in the order of the labels
+    for (int m = 0; m < (int)Messages.size(); ++m)
+    {
+        const Message &msg = Messages[m];
+        int field_idx = 0;
+        for (int i = 0; i < (int)orig_field_labels.size(); ++i)
+        {
+            if (i > 0) ofs << Commons::CSVDelimiter;
+            if (orig_field_labels[i].compare("%time") == 0)
+                ofs << msg.DateTime.ToEpochNanoseconds();
+            else if (orig_field_labels[i].compare(Commons::CSVFieldsPrefix + "header.seq") == 0)
+                ofs << msg.Header.SequenceID;
+            else if (orig_field_labels[i].compare(Commons::CSVFieldsPrefix + "header.stamp") == 0)
+                ofs << msg.Header.Stamp;
+            else if (orig_field_labels[i].compare(Commons::CSVFieldsPrefix + "header.frame_id") == 0)
+                ofs << msg.Header.FrameID;
+            else if (field_idx < (int)msg.Fields.size())
+                ofs << msg.Fields[field_idx++];
+        }
+        ofs << '\n';
+    }
+
+    return (bool)ofs;
+}
+
+// Write the parsed topic (the labels and the messages, but not the name) in a binary format for the load cache
+bool Topic::WriteBinary(std::ostream &os) const
+{
+    // Write the labels as they appear in the CSV file
+    Commons::WriteBinary(os, (int)orig_field_labels.size());
+    for (int i = 0; i < (int)orig_field_labels.size(); ++i)
+        Commons::WriteBinaryString(os, orig_field_labels[i]);
+
+    // Write the messages
+    Commons::WriteBinary(os, (int)Messages.size());
+    for (int m = 0; m < (int)Messages.size(); ++m)
+    {
+        // The time is kept as the exact epoch time (UTC), so the entry does not depend on the time zone of the machine
+        const Message &msg = Messages[m];
+        Commons::WriteBinary(os, msg.DateTime.ToEpochNanoseconds());
+        Commons::WriteBinary(os, msg.Header.SequenceID);
+        Commons::WriteBinary(os, msg.Header.Stamp);
+        Commons::WriteBinaryString(os, msg.Header.FrameID);
+        Commons::WriteBinary(os, (int)msg.Fields.size());
+        for (int f = 0; f < (int)msg.Fields.size(); ++f)
+            Commons::WriteBinaryString(os, msg.Fields[f]);
+    }
+
+    return (bool)os;
+}
+
+// Read a topic written by WriteBinary. Keeps the name of the topic.
+bool Topic::ReadBinary(std::istream &is)
+{
+    // Keep the topic name
+    std::string topic_name = Name;
+
+    // Clear the previous data from the object
+    this->Clear();
+    this->Name = topic_name;
+
+    // Read the labels (a corrupt count is bounded by the rest of the stream, with at least a length per label)
+    int n_labels = 0, n_messages = 0;
+    bool ok = Commons::ReadBinary(is, n_labels) && n_labels >= 0;
+    long long remaining = ok ? Commons::GetRemainingSize(is) : -1;
+    ok = ok && (remaining < 0 || n_labels <= remaining / (long long)sizeof(unsigned int));
+    this->orig_field_labels.resize(ok ? n_labels : 0);
+    for (int i = 0; ok && i < n_labels; ++i)
+        ok = Commons::ReadBinaryString(is, orig_field_labels[i]);
+
+    // Read the messages (each has at least its time, header and field count; its fields are bounded by the labels)
+    const long long min_message_size = sizeof(long long) + sizeof(int) + sizeof(long long) + sizeof(unsigned int) + sizeof(int);
+    ok = ok && Commons::ReadBinary(is, n_messages) && n_messages >= 0;
+    remaining = ok ? Commons::GetRemainingSize(is) : -1;
+    ok = ok && (remaining < 0 || n_messages <= remaining / min_message_size);
+    this->Messages.resize(ok ? n_messages : 0);
+    for (int m = 0; ok && m < n_messages; ++m)
+    {
+        Message &msg = Messages[m];
+        long long epoch_ns = 0;
+        int n_fields = 0;
+        ok = Commons::ReadBinary(is, epoch_ns) && Commons::ReadBinary(is, msg.Header.SequenceID) &&
+            Commons::ReadBinary(is, msg.Header.Stamp) && Commons::ReadBinaryString(is, msg.Header.FrameID) &&
+            Commons::ReadBinary(is, n_fields) && n_fields >= 0 && n_fields <= n_labels;
+        msg.DateTime = DateTime::EpochNanosecondsToTime(epoch_ns);
+        msg.Fields.resize(ok ? n_fields : 0);
+        for (int f = 0; ok && f < n_fields; ++f)
+            ok = Commons::ReadBinaryString(is, msg.Fields[f]);
+    }
+
+    // Discard the partially read data
+    if (!ok)
+    {
+        this->Clear();
+        this->Name = topic_name;
+        return false;
+    }
+
+    // Keep the load statistics
+    load_stats.EstimatedRows = load_stats.LoadedRows = this->Messages.size();
+
+    // Postprocess the header labels
+    ProcessHeader();
+
+    // Check if it is a fault topic
+    DetectFaultTopic();
+
+    // Initialization done
+    is_initialized = true;
+
+    return true;
+}
+
+// Add a message to the end of the topic (messages should be added in the order of their recorded time)
+void Topic::AddMessage(const Message &msg)
+{
+    Messages.push_back(msg);
+}
+
 // Print a specified number of messages. Also prints the header first. 
 // Returns the number of messages printed.
 int Topic::Print(int n_start, int n_messages, const std::string &field_separator) const
@@ -245,8 +546,11 @@ int Topic::Print(int n_start, int n_messages, const std::string &field_separator
     if (n_messages < 0)
         n_messages = Messages.size();
 
+    // Measure the field lengths on the current messages (they may have been edited since the last print)
+    const PrintWidths widths = MeasurePrintWidths();
+
     // Print the header first. Puts separators between each two fields.
-    int header_length = PrintHeader(field_separator);
+    int header_length = PrintHeaderLine(widths, field_separator);
 
     // Print a line to separate labels from the data
     std::cout << std::string(header_length, '-') << std::endl;
@@ -257,7 +561,7 @@ int Topic::Print(int n_start, int n_messages, const std::string &field_separator
     for (int i = n_start; (i < n_start + n_messages) && (i < (int)Messages.size()); ++i)
     {
         std::cout << field_separator << std::setw(hdr_ind.length()) << i << field_separator << 
-            Messages[i].ToString(len_seqid, len_stamp, len_frameid, len_fields, has_header, field_separator) 
+            Messages[i].ToString(widths.SequenceID, widths.Stamp, widths.FrameID, widths.Fields, has_header, field_separator) 
             << field_separator << std::endl;
         printed_messages++;
     }
@@ -269,6 +573,13 @@ int Topic::Print(int n_start, int n_messages, const std::string &field_separator
 // Print the topic header (message field labels).
 // Returns the length of the header line printed.
 int Topic::PrintHeader(const std::string &field_separator) const
+{
+    return PrintHeaderLine(MeasurePrintWidths(), field_separator);
+}
+
+// Print the topic header with the given field lengths.
+// Returns the length of the header line printed.
+int Topic::PrintHeaderLine(const PrintWidths &widths, const std::string &field_separator) const
 {
     // Ignore if there are no messages in the topic
     if (Messages.size() == 0) return 0;
@@ -278,9 +589,9 @@ int Topic::PrintHeader(const std::string &field_separator) const
 
     // Measure the total line length
     int total_len = hdr_ind.length() + len_datetime;
-    if (has_header) total_len += len_seqid + len_stamp + len_frameid;
+    if (has_header) total_len += widths.SequenceID + widths.Stamp + widths.FrameID;
     for (int i = 0; i < (int)FieldLabels.size(); ++i)
-        total_len += len_fields[i];
+        total_len += widths.Fields[i];
     total_len += (3 + FieldLabels.size()) * field_separator.length();
     if (has_header)
         total_len += 3 * field_separator.length();
@@ -288,12 +599,12 @@ int Topic::PrintHeader(const std::string &field_separator) const
     // Print the index, time and the Header object (if it has one)
     std::cout << field_separator << hdr_ind << field_separator << std::setw(len_datetime) << hdr_datetime;
     if (has_header)
-        std::cout << field_separator << std::setw(len_seqid) << hdr_seq << field_separator <<
-            std::setw(len_stamp) << hdr_stamp << field_separator << std::setw(len_frameid) << hdr_frid;
+        std::cout << field_separator << std::setw(widths.SequenceID) << hdr_seq << field_separator <<
+            std::setw(widths.Stamp) << hdr_stamp << field_separator << std::setw(widths.FrameID) << hdr_frid;
 
     // Print the rest of the field labels
     for (int i = 0; i < (int)FieldLabels.size(); ++i)
-        std::cout << field_separator << std::setw(len_fields[i]) << FieldLabels[i];
+        std::cout << field_separator << std::setw(widths.Fields[i]) << FieldLabels[i];
 
     // Finish the line
     std::cout << field_separator << std::endl;
@@ -308,13 +619,44 @@ bool Topic::IsInitialized() const
     return is_initialized;
 }
 
+// Get the statistics of loading the topic from its file
+const Topic::LoadStats &Topic::GetLoadStats() const
+{
+    return load_stats;
+}
+
+// Enable or disable collecting the hardware counters of the read and the parse stages of the next loads (for all the topics)
+void Topic::SetLoadCountersEnabled(bool enabled)
+{
+    load_counters_enabled = enabled;
+}
+
+// Returns true if the hardware counters of the loads are collected
+bool Topic::IsLoadCountersEnabled()
+{
+    return load_counters_enabled;
+}
+
+// Get the collector of the errors and warnings of the topic. A copy of a topic has its own collector.
+std::shared_ptr<Diagnostics> Topic::GetDiagnostics() const
+{
+    return diagnostics.Get();
+}
+
+// Set the collector of the errors and warnings of the topic (or use its own one if not given)
+void Topic::SetDiagnostics(const std::shared_ptr<Diagnostics> &diagnostics)
+{
+    this->diagnostics.Set(diagnostics);
+}
+
 // Returns true if the current topic is a fault topic
-bool Topic::IsFaultTopic()
+bool Topic::IsFaultTopic() const
 {
     return is_fault_topic;
 }
 
-bool Topic::HasHeaderField()
+// Returns true if the messages of the topic have the header fields
+bool Topic::HasHeaderField() const
 {
     return has_header;
 }
@@ -328,19 +670,16 @@ void Topic::Clear()
     Messages.clear();
     is_initialized = false;
     is_fault_topic = false;
-    len_seqid = 0; 
-    len_stamp = 0;
-    len_frameid = 0;
-    len_fields.clear();
     orig_field_labels.clear();
     has_header = false;
     labels_map.clear();
+    load_stats = LoadStats();
 }
 
 // Find the index of a given field label (case sensitive)
-int Topic::FindLabelIndex(const std::string &label)
+int Topic::FindLabelIndex(const std::string &label) const
 {
-    std::map<std::string, int>::iterator it = labels_map.find(label);
+    std::map<std::string, int>::const_iterator it = labels_map.find(label);
 
     // Return -1 if not found
     if (it == labels_map.end()) return -1;
@@ -360,6 +699,7 @@ std::vector<DateTime> Topic::GetTimes(int start_msg_index, int n_messages)
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
+    vec_output.reserve(std::max(0, std::min(n_messages, (int)Messages.size() - start_msg_index)));
 
     // Add the datetimes to the output vector
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
@@ -380,6 +720,7 @@ std::vector<Message::HeaderType> Topic::GetHeaders(int start_msg_index, int n_me
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
+    vec_output.reserve(std::max(0, std::min(n_messages, (int)Messages.size() - start_msg_index)));
 
     // Add the headers to the output vector
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
@@ -397,20 +738,21 @@ std::vector<std::string> Topic::GetFieldsAsString(int field_index, int start_msg
     // Print error if the field index is negative
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsString Error! Field index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsString Error! Field index is negative.");
         return vec_output;
     }
 
     // Print error if the start index is negative
     if (start_msg_index < 0)
     {
-        std::cerr << "GetFieldsAsString Error! Starting index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsString Error! Starting index is negative.");
         return vec_output;
     }
 
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
+    vec_output.reserve(std::max(0, std::min(n_messages, (int)Messages.size() - start_msg_index)));
 
     // Add the fields to the output vector
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
@@ -428,7 +770,7 @@ std::vector<std::string> Topic::GetFieldsAsString(const std::string &field_label
     // Print error if the field name is not found
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsString Error! '" << field_label << "' field not found." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsString Error! '" + field_label + "' field not found.");
         return std::vector<std::string>();
     }
 
@@ -445,29 +787,36 @@ std::vector<int> Topic::GetFieldsAsInt(int field_index, int start_msg_index, int
     // Print error if the field index is negative
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsInt Error! Field index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsInt Error! Field index is negative.");
         return vec_output;
     }
 
     // Print error if the start index is negative
     if (start_msg_index < 0)
     {
-        std::cerr << "GetFieldsAsInt Error! Starting index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsInt Error! Starting index is negative.");
         return vec_output;
     }
 
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
+    vec_output.reserve(std::max(0, std::min(n_messages, (int)Messages.size() - start_msg_index)));
 
-    // Add the fields to the output vector
+    // Add the fields to the output vector (the values that are not numbers are added as zero)
+    int n_failed = 0;
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
     {
         int temp = 0;
-        Commons::StringToInt(Messages[i].Fields[field_index], temp);
+        if (!Commons::StringToInt(Messages[i].Fields[field_index], temp)) n_failed++;
         vec_output.push_back(temp);
     }
 
+    // Report the failed conversions once for the whole column
+    if (n_failed > 0)
+        Report(Diagnostics::Warning, "GetFieldsAsInt Warning! " + std::to_string(n_failed) + " value(s) of '" +
+            FieldLabels[field_index] + "' field could not be converted.");
+
     return vec_output;
 }
 
@@ -480,7 +829,7 @@ std::vector<int> Topic::GetFieldsAsInt(const std::string &field_label, int start
     // Print error if the field name is not found
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsInt Error! '" << field_label << "' field not found." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsInt Error! '" + field_label + "' field not found.");
         return std::vector<int>();
     }
 
@@ -497,29 +846,36 @@ std::vector<long long> Topic::GetFieldsAsLongLong(int field_index, int start_msg
     // Print error if the field index is negative
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsLongLong Error! Field index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsLongLong Error! Field index is negative.");
         return vec_output;
     }
 
     // Print error if the start index is negative
     if (start_msg_index < 0)
     {
-        std::cerr << "GetFieldsAsLongLong Error! Starting index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsLongLong Error! Starting index is negative.");
         return vec_output;
     }
 
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
+    vec_output.reserve(std::max(0, std::min(n_messages, (int)Messages.size() - start_msg_index)));
 
-    // Add the fields to the output vector
+    // Add the fields to the output vector (the values that are not numbers are added as zero)
+    int n_failed = 0;
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
     {
         long long temp = 0;
-        Commons::StringToLongLong(Messages[i].Fields[field_index], temp);
+        if (!Commons::StringToLongLong(Messages[i].Fields[field_index], temp)) n_failed++;
         vec_output.push_back(temp);
     }
 
+    // Report the failed conversions once for the whole column
+    if (n_failed > 0)
+        Report(Diagnostics::Warning, "GetFieldsAsLongLong Warning! " + std::to_string(n_failed) + " value(s) of '" +
+            FieldLabels[field_index] + "' field could not be converted.");
+
     return vec_output;
 }
 
@@ -532,7 +888,7 @@ std::vector<long long> Topic::GetFieldsAsLongLong(const std::string &field_label
     // Print error if the field name is not found
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsLongLong Error! '" << field_label << "' field not found." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsLongLong Error! '" + field_label + "' field not found.");
         return std::vector<long long>();
     }
 
@@ -549,29 +905,36 @@ std::vector<double> Topic::GetFieldsAsDouble(int field_index, int start_msg_inde
     // Print error if the field index is negative
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsDouble Error! Field index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsDouble Error! Field index is negative.");
         return vec_output;
     }
 
     // Print error if the start index is negative
     if (start_msg_index < 0)
     {
-        std::cerr << "GetFieldsAsDouble Error! Starting index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsDouble Error! Starting index is negative.");
         return vec_output;
     }
 
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
+    vec_output.reserve(std::max(0, std::min(n_messages, (int)Messages.size() - start_msg_index)));
 
-    // Add the fields to the output vector
+    // Add the fields to the output vector (the values that are not numbers are added as zero)
+    int n_failed = 0;
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
     {
         double temp = 0;
-        Commons::StringToDouble(Messages[i].Fields[field_index], temp);
+        if (!Commons::StringToDouble(Messages[i].Fields[field_index], temp)) n_failed++;
         vec_output.push_back(temp);
     }
 
+    // Report the failed conversions once for the whole column
+    if (n_failed > 0)
+        Report(Diagnostics::Warning, "GetFieldsAsDouble Warning! " + std::to_string(n_failed) + " value(s) of '" +
+            FieldLabels[field_index] + "' field could not be converted.");
+
     return vec_output;
 }
 
@@ -584,7 +947,7 @@ std::vector<double> Topic::GetFieldsAsDouble(const std::string &field_label, int
     // Print error if the field name is not found
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsLongDouble Error! '" << field_label << "' field not found." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsDouble Error! '" + field_label + "' field not found.");
         return std::vector<double>();
     }
 
@@ -601,29 +964,36 @@ std::vector<long double> Topic::GetFieldsAsLongDouble(int field_index, int start
     // Print error if the field index is negative
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsLongDouble Error! Field index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsLongDouble Error! Field index is negative.");
         return vec_output;
     }
 
     // Print error if the start index is negative
     if (start_msg_index < 0)
     {
-        std::cerr << "GetFieldsAsLongDouble Error! Starting index is negative." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsLongDouble Error! Starting index is negative.");
         return vec_output;
     }
 
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
+    vec_output.reserve(std::max(0, std::min(n_messages, (int)Messages.size() - start_msg_index)));
 
-    // Add the fields to the output vector
+    // Add the fields to the output vector (the values that are not numbers are added as zero)
+    int n_failed = 0;
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
     {
         long double temp = 0;
-        Commons::StringToLongDouble(Messages[i].Fields[field_index], temp);
+        if (!Commons::StringToLongDouble(Messages[i].Fields[field_index], temp)) n_failed++;
         vec_output.push_back(temp);
     }
 
+    // Report the failed conversions once for the whole column
+    if (n_failed > 0)
+        Report(Diagnostics::Warning, "GetFieldsAsLongDouble Warning! " + std::to_string(n_failed) + " value(s) of '" +
+            FieldLabels[field_index] + "' field could not be converted.");
+
     return vec_output;
 }
 
@@ -636,7 +1006,7 @@ std::vector<long double> Topic::GetFieldsAsLongDouble(const std::string &field_l
     // Print error if the field name is not found
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsLongDouble Error! '" << field_label << "' field not found." << std::endl;
+        Report(Diagnostics::Error, "GetFieldsAsLongDouble Error! '" + field_label + "' field not found.");
         return std::vector<long double>();
     }
 
@@ -648,30 +1018,82 @@ std::vector<long double> Topic::GetFieldsAsLongDouble(const std::string &field_l
 /*********************** Local Function Definitions ***************************/
 /******************************************************************************/
 
-// Convert a vector of tokens to a message
-Message Topic::TokensToMessage(const VecString &tokens)
+// Get the maximum length of the header and data fields for printing. Measured on every print, since the
+// messages are public and may be edited in place (only the lengths of the strings are read, so it is cheap).
+Topic::PrintWidths Topic::MeasurePrintWidths() const
 {
-    // Define temporary variables for header field lengths
-    int l_seq = 0, l_stamp = 0, l_frid = 0;
-    std::vector<int> l_fields;
+    // Start from the lengths of the labels
+    PrintWidths widths;
+    widths.SequenceID = hdr_seq.length();
+    widths.Stamp = hdr_stamp.length();
+    widths.FrameID = hdr_frid.length();
+    widths.Fields.resize(FieldLabels.size());
+    for (int i = 0; i < (int)FieldLabels.size(); ++i)
+        widths.Fields[i] = FieldLabels[i].length();
 
-    // Convert the tokens to a message
-    Message msg = Message::TokensToMessage(tokens, orig_field_labels, l_seq, l_stamp, l_frid, l_fields);
+    // One pass over the messages (only the lengths of the strings are read)
+    for (size_t m = 0; m < Messages.size(); ++m)
+    {
+        const Message &msg = Messages[m];
+        if (has_header)
+        {
+            widths.SequenceID = std::max(widths.SequenceID, GetNumberWidth(msg.Header.SequenceID));
+            widths.Stamp = std::max(widths.Stamp, GetNumberWidth(msg.Header.Stamp));
+            widths.FrameID = std::max(widths.FrameID, (int)msg.Header.FrameID.length());
+        }
+        const int n_fields = std::min(msg.Fields.size(), widths.Fields.size());
+        for (int i = 0; i < n_fields; ++i)
+            widths.Fields[i] = std::max(widths.Fields[i], (int)msg.Fields[i].length());
+    }
 
-    // Update the field lengths in the messages
-    len_seqid = std::max(len_seqid, l_seq);
-    len_stamp = std::max(len_stamp, l_stamp);
-    len_frameid = std::max(len_frameid, l_frid);
-    for (int i = 0; i < (int)l_fields.size(); ++i)
+    return widths;
+}
+
+// Get the number of characters needed to print an integer number
+int Topic::GetNumberWidth(long long number)
+{
+    int width = number < 0 ? 2 : 1;
+    unsigned long long value = number < 0 ? 0ULL - (unsigned long long)number : (unsigned long long)number;
+    while (value >= 10)
     {
-        if (i == (int)len_fields.size())
-            len_fields.push_back(l_fields[i]);
-        else
-            len_fields[i] = std::max(len_fields[i], l_fields[i]);
+        value /= 10;
+        ++width;
     }
+    return width;
+}
 
-    // Return the new message
-    return msg;
+// Report an error or a warning of the topic to its diagnostics collector
+void Topic::Report(Diagnostics::Severity level, const std::string &text, int line_number) const
+{
+    diagnostics.Get()->Add(level, Name, text, line_number);
+}
+
+// Get the line starting from the given position in the file content and move the position to the next line.
+// Returns false at the end of the content.
+bool Topic::GetNextLine(const std::string &content, size_t &pos, std::string &out_line)
+{
+    if (pos >= content.size()) return false;
+
+    // Find the end of the line
+    size_t end = content.find('\n', pos);
+    if (end == std::string::npos) end = content.size();
+    out_line.assign(content, pos, end - pos);
+    pos = end + 1;
+
+    // Remove the carriage return of the Windows line endings
+    if (!out_line.empty() && out_line[out_line.length() - 1] == '\r')
+        out_line.erase(out_line.length() - 1);
+
+    return true;
+}
+
+// Check if the topic is a fault topic using its name
+void Topic::DetectFaultTopic()
+{
+    // It is not a fault topic if the topic name is shorter than the fault prefix
+    if (this->Name.length() >= Commons::FaultTopicPrefix.length()) 
+        // Check if the prefix of topic name is the fault prefix
+        is_fault_topic = (this->Name.substr(0, Commons::FaultTopicPrefix.length()) == Commons::FaultTopicPrefix);
 }
 
 // Postprocess the header of the CSV file (remove time, etc. from labels).
@@ -702,16 +1124,6 @@ void Topic::ProcessHeader()
         FieldLabels.push_back(new_field_label);
         this->labels_map.insert(std::make_pair(new_field_label, FieldLabels.size() - 1));
     }
-
-    // Update the minimum spaces needed for printing each field
-    len_seqid = std::max(len_seqid, (int)hdr_seq.length());
-    len_stamp = std::max(len_stamp, (int)hdr_stamp.length());
-    len_frameid = std::max(len_frameid, (int)hdr_frid.length());
-    for (int i = 0; i < (int)FieldLabels.size(); ++i)
-    {
-        if ((int)len_fields.size() < (i + 1)) break;
-        len_fields[i] = std::max(len_fields[i], (int)FieldLabels[i].length());
-    }
 }
 
 }
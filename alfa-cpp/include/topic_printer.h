@@ -0,0 +1,347 @@
+/*  ***************************************************************************
+*   topic_printer.h - Header for the paged printing of large topics.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_TOPIC_PRINTER_H
+#define ALFA_TOPIC_PRINTER_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include "commons.h"
+#include "topic.h"
+
+// Define different headers for Windows and Unix-based systems
+#if defined _WIN32 || defined __CYGWIN__
+#define ALFA_POPEN _popen
+#define ALFA_PCLOSE _pclose
+#else
+#include <csignal>
+#define ALFA_POPEN popen
+#define ALFA_PCLOSE pclose
+#endif
+
+namespace alfa
+{
+
+// This class prints the messages of a topic page by page. Only the rows of the current page are formatted
+// and buffered, and the column widths are measured from the printed rows (they only grow, and the header is
+// printed again whenever they change). Any row or time window, the head, the tail or a sample of the topic
+// can be printed, or the whole topic can be browsed in a pager.
+class TopicPrinter
+{
+public:
+
+    // Class Data Members
+    int PageSize = 100;                     // Number of the rows formatted and written at once
+    std::string FieldSeparator = " | ";
+
+    // Constructors & Deconstructors
+    TopicPrinter(const Topic &topic, std::ostream &os = std::cout);
+
+    // Member Functions
+    int PrintRows(int start_row, int n_rows = -1);
+    int PrintTimeRange(long long start_time, long long end_time);
+    int PrintTimeRange(const DateTime &start_time, const DateTime &end_time);
+    int PrintHead(int n_rows = 10);
+    int PrintTail(int n_rows = 10);
+    int PrintSample(int n_rows = 10, unsigned long long seed = 0);
+    int Page(int start_row = 0, const std::string &pager_command = "");
+
+private:
+    // Member Functions
+    int PrintRowList(const std::vector<int> &rows);
+    int PrintRange(int start_row, int end_row, bool (*write)(const std::string &, void *), void *target);
+    bool FormatPage(const int *rows, int n_rows, std::string &out_text);
+    static bool WriteToStream(const std::string &text, void *os);
+    static bool WriteToFile(const std::string &text, void *file);
+    int FindFirstRowAtOrAfter(long long time) const;
+
+    // Data Members
+    const Topic &topic;
+    std::ostream &os;
+
+    // Current column widths (reset at the start of each print)
+    int len_index = 0, len_datetime = 0, len_seqid = 0, len_stamp = 0, len_frameid = 0;
+    std::vector<int> len_fields;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for TopicPrinter. The topic should stay alive while the printer is used.
+TopicPrinter::TopicPrinter(const Topic &topic, std::ostream &os)
+    : topic(topic), os(os)
+{
+}
+
+// Print a number of rows starting from the given row (all the rest if n_rows is negative).
+// Returns the number of rows printed.
+int TopicPrinter::PrintRows(int start_row, int n_rows)
+{
+    if (start_row < 0) return 0;
+    int n_messages = topic.Messages.size();
+    int end_row = (n_rows < 0) ? n_messages : std::min(n_messages, start_row + n_rows);
+    return PrintRange(start_row, end_row, &WriteToStream, &os);
+}
+
+// Print the rows recorded in the given time window (epoch nanoseconds, inclusive)
+int TopicPrinter::PrintTimeRange(long long start_time, long long end_time)
+{
+    int start_row = FindFirstRowAtOrAfter(start_time);
+    int end_row = (end_time == LLONG_MAX) ? topic.Messages.size() : FindFirstRowAtOrAfter(end_time + 1);
+    return PrintRange(start_row, end_row, &WriteToStream, &os);
+}
+
+// Print the rows recorded in the given time window (inclusive)
+int TopicPrinter::PrintTimeRange(const DateTime &start_time, const DateTime &end_time)
+{
+    return PrintTimeRange(start_time.ToEpochNanoseconds(), end_time.ToEpochNanoseconds());
+}
+
+// Print the first rows of the topic
+int TopicPrinter::PrintHead(int n_rows)
+{
+    return PrintRows(0, std::max(0, n_rows));
+}
+
+// Print the last rows of the topic
+int TopicPrinter::PrintTail(int n_rows)
+{
+    int start_row = std::max(0, (int)topic.Messages.size() - std::max(0, n_rows));
+    return PrintRows(start_row, std::max(0, n_rows));
+}
+
+// Print a random sample of the rows (in the order of the rows). The sample is the same for the same seed.
+int TopicPrinter::PrintSample(int n_rows, unsigned long long seed)
+{
+    int n_messages = topic.Messages.size();
+    if (n_rows >= n_messages) return PrintRows(0);
+
+    // Select distinct rows (Floyd's algorithm) and sort them
+    std::mt19937_64 rng(seed);
+    std::vector<int> rows;
+    std::vector<char> selected(n_messages, 0);
+    for (int j = n_messages - std::max(0, n_rows); j < n_messages; ++j)
+    {
+        int r = (int)(rng() % (unsigned long long)(j + 1));
+        if (selected[r]) r = j;
+        selected[r] = 1;
+        rows.push_back(r);
+    }
+    std::sort(rows.begin(), rows.end());
+
+    return PrintRowList(rows);
+}
+
+// Browse the topic from the given row in a pager (the PAGER environment variable or 'less -S' if no command is given).
+// The pages are written as the pager reads them and the printing stops when the pager is closed.
+// Prints to the output stream if the pager cannot be started. Returns the number of rows written.
+int TopicPrinter::Page(int start_row, const std::string &pager_command)
+{
+    // Find the pager command
+    std::string command = pager_command;
+    if (command.empty())
+    {
+        const char *env_pager = std::getenv("PAGER");
+#if defined _WIN32 || defined __CYGWIN__
+        command = (env_pager != NULL && env_pager[0] != '\0') ? env_pager : "more";
+#else
+        command = (env_pager != NULL && env_pager[0] != '\0') ? env_pager : "less -S";
+#endif
+    }
+
+    // Start the pager (print directly if it fails)
+    FILE *pager = ALFA_POPEN(command.c_str(), "w");
+    if (pager == NULL)
+        return PrintRows(start_row);
+
+    // Ignore the broken pipe signal while writing, so closing the pager only stops the printing
+#if !(defined _WIN32 || defined __CYGWIN__)
+    void (*old_handler)(int) = std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    int printed = PrintRange(std::max(0, start_row), topic.Messages.size(), &WriteToFile, pager);
+    ALFA_PCLOSE(pager);
+
+#if !(defined _WIN32 || defined __CYGWIN__)
+    std::signal(SIGPIPE, old_handler);
+#endif
+
+    return printed;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Print the given rows page by page
+int TopicPrinter::PrintRowList(const std::vector<int> &rows)
+{
+    len_index = 0;
+    int printed = 0;
+    std::string text;
+    const int page_size = std::max(1, PageSize);
+    for (int start = 0; start < (int)rows.size(); start += page_size)
+    {
+        int n_rows = std::min(page_size, (int)rows.size() - start);
+        FormatPage(&rows[start], n_rows, text);
+        if (!WriteToStream(text, &os)) break;
+        printed += n_rows;
+    }
+    return printed;
+}
+
+// Print the rows in [start_row, end_row) page by page using the given writer
+int TopicPrinter::PrintRange(int start_row, int end_row, bool (*write)(const std::string &, void *), void *target)
+{
+    len_index = 0;
+    int printed = 0;
+    std::string text;
+    std::vector<int> rows;
+    const int page_size = std::max(1, PageSize);
+    for (int start = start_row; start < end_row; start += page_size)
+    {
+        // Format and write one page at a time
+        int n_rows = std::min(page_size, end_row - start);
+        rows.resize(n_rows);
+        for (int i = 0; i < n_rows; ++i)
+            rows[i] = start + i;
+        FormatPage(&rows[0], n_rows, text);
+        if (!write(text, target)) break;
+        printed += n_rows;
+    }
+    return printed;
+}
+
+// Format the given rows into a page of text. Grows the column widths to fit the rows and starts the
+// page with the header if it is the first page or the widths changed. Returns true if the header was added.
+bool TopicPrinter::FormatPage(const int *rows, int n_rows, std::string &out_text)
+{
+    const bool has_header = topic.HasHeaderField();
+    const VecString &labels = topic.FieldLabels;
+    bool changed = (len_index == 0);
+
+    // Start from the lengths of the labels on the first page
+    if (len_index == 0)
+    {
+        len_index = 5;
+        len_datetime = 15;
+        len_seqid = 5;
+        len_stamp = 10;
+        len_frameid = 5;
+        len_fields.assign(labels.size(), 0);
+        for (int i = 0; i < (int)labels.size(); ++i)
+            len_fields[i] = labels[i].length();
+    }
+
+    // Grow the widths to fit the rows of this page
+    for (int r = 0; r < n_rows; ++r)
+    {
+        const Message &msg = topic.Messages[rows[r]];
+        int l_index = std::to_string(rows[r]).length();
+        int l_datetime = msg.DateTime.ToString().length();
+        if (l_index > len_index) { len_index = l_index; changed = true; }
+        if (l_datetime > len_datetime) { len_datetime = l_datetime; changed = true; }
+        if (has_header)
+        {
+            int l_seq = std::to_string(msg.Header.SequenceID).length();
+            int l_stamp = std::to_string(msg.Header.Stamp).length();
+            int l_frid = msg.Header.FrameID.length();
+            if (l_seq > len_seqid) { len_seqid = l_seq; changed = true; }
+            if (l_stamp > len_stamp) { len_stamp = l_stamp; changed = true; }
+            if (l_frid > len_frameid) { len_frameid = l_frid; changed = true; }
+        }
+        for (int i = 0; i < (int)msg.Fields.size() && i < (int)len_fields.size(); ++i)
+            if ((int)msg.Fields[i].length() > len_fields[i])
+            {
+                len_fields[i] = msg.Fields[i].length();
+                changed = true;
+            }
+    }
+
+    std::ostringstream oss;
+    const std::string &sep = FieldSeparator;
+
+    // Write the header (and a line to separate the labels from the data) if needed
+    if (changed)
+    {
+        std::ostringstream header;
+        header << sep << std::setw(len_index) << "Index" << sep << std::setw(len_datetime) << "Date/Time Stamp";
+        if (has_header)
+            header << sep << std::setw(len_seqid) << "SeqID" << sep << std::setw(len_stamp) << "Time Stamp" <<
+                sep << std::setw(len_frameid) << "Frame";
+        for (int i = 0; i < (int)labels.size(); ++i)
+            header << sep << std::setw(len_fields[i]) << labels[i];
+        header << sep;
+        oss << header.str() << '\n' << std::string(header.str().length(), '-') << '\n';
+    }
+
+    // Write the rows
+    for (int r = 0; r < n_rows; ++r)
+        oss << sep << std::setw(len_index) << rows[r] << sep <<
+            topic.Messages[rows[r]].ToString(len_seqid, len_stamp, len_frameid, len_fields, has_header, sep) << sep << '\n';
+
+    out_text = oss.str();
+    return changed;
+}
+
+// Write a page to an output stream
+bool TopicPrinter::WriteToStream(const std::string &text, void *os)
+{
+    std::ostream &out = *static_cast<std::ostream *>(os);
+    out << text;
+    out.flush();
+    return (bool)out;
+}
+
+// Write a page to a C file (the pager). Returns false if the pager was closed.
+bool TopicPrinter::WriteToFile(const std::string &text, void *file)
+{
+    FILE *out = static_cast<FILE *>(file);
+    return std::fwrite(text.data(), 1, text.size(), out) == text.size() && std::fflush(out) == 0;
+}
+
+// Find the first row recorded at or after the given time (epoch nanoseconds)
+int TopicPrinter::FindFirstRowAtOrAfter(long long time) const
+{
+    int low = 0, high = topic.Messages.size();
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        if (topic.Messages[mid].DateTime.ToEpochNanoseconds() < time) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+}
+#endif
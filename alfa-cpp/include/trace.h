@@ -0,0 +1,286 @@
+/*  ***************************************************************************
+*   trace.h - Header for recording the trace events of the loading pipelines.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_TRACE_H
+#define ALFA_TRACE_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include "commons.h"
+
+namespace alfa
+{
+
+// This class records the time intervals of the stages of loading and processing (scanning the directories,
+// reading and parsing the topics, merging the messages, cutting and augmenting the windows) and writes them
+// as a Chrome trace event file, which can be viewed in chrome://tracing or https://ui.perfetto.dev to see
+// how busy each thread is. Each thread records to its own buffer, and when the tracing is not started the
+// instrumented stages only check a flag.
+class Trace
+{
+public:
+
+    // Subclasses
+    class Scope                 // Records the interval from its construction to its destruction
+    {
+    public:
+        Scope(const char *category, const char *name);
+        Scope(const char *category, const char *name, const std::string &detail);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *category, *name;
+        std::string detail;
+        long long start_ns;     // Negative if the tracing was not started at the construction
+    };
+
+    // Member Functions
+    static void Start();
+    static void Stop();
+    static bool IsEnabled();
+    static bool Save(const std::string &filename);
+    static void Clear();
+    static void SetThreadName(const std::string &name);
+    static void AddEvent(const char *category, const char *name, const std::string &detail, long long start_ns, long long end_ns);
+    static long long GetTimeNanoseconds();
+
+private:
+    // Local struct definitions
+    struct Event
+    {
+        const char *Category, *Name;
+        std::string Detail;
+        long long StartNs, EndNs;
+    };
+
+    struct ThreadBuffer         // Events of a single thread (kept after the thread exits until they are cleared; saving keeps them)
+    {
+        int ThreadID;
+        std::string ThreadName;
+        std::mutex Mutex;       // Only contended while saving
+        std::vector<Event> Events;
+        bool Exited = false;    // The thread has exited, so the buffer is removed once it has no events
+    };
+
+    struct ThreadBufferOwner    // Marks the buffer of a thread when the thread exits
+    {
+        std::shared_ptr<ThreadBuffer> Buffer;
+        ~ThreadBufferOwner();
+    };
+
+    // Data Members
+    static std::atomic<bool> enabled;
+    static std::mutex buffers_mutex;
+    static std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+    static int last_thread_id;
+
+    // Member Functions
+    static ThreadBuffer &GetThreadBuffer();
+    static void RemoveExitedBuffers();
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The tracing is not started by default
+std::atomic<bool> Trace::enabled(false);
+
+// The buffers of all the threads that recorded an event
+std::mutex Trace::buffers_mutex;
+std::vector<std::shared_ptr<Trace::ThreadBuffer> > Trace::buffers;
+int Trace::last_thread_id = 0;
+
+// Constructor function for Scope. Starts the interval if the tracing is started.
+Trace::Scope::Scope(const char *category, const char *name)
+    : category(category), name(name), start_ns(enabled.load(std::memory_order_relaxed) ? GetTimeNanoseconds() : -1)
+{
+}
+
+// Constructor function for Scope with a detail shown with the event (e.g. the name of the topic)
+Trace::Scope::Scope(const char *category, const char *name, const std::string &detail)
+    : category(category), name(name), start_ns(-1)
+{
+    if (!enabled.load(std::memory_order_relaxed)) return;
+    this->detail = detail;
+    start_ns = GetTimeNanoseconds();
+}
+
+// Deconstructor function for Scope. Records the interval.
+Trace::Scope::~Scope()
+{
+    if (start_ns >= 0)
+        AddEvent(category, name, detail, start_ns, GetTimeNanoseconds());
+}
+
+// Start recording the events
+void Trace::Start()
+{
+    enabled = true;
+}
+
+// Stop recording the events (the recorded events are kept until saved or cleared)
+void Trace::Stop()
+{
+    enabled = false;
+}
+
+// Returns true if the events are being recorded
+bool Trace::IsEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+// Save the recorded events of all the threads to a Chrome trace event (JSON) file
+bool Trace::Save(const std::string &filename)
+{
+    // Open the file
+    std::ofstream ofs(filename);
+
+    // Print an error if file did not open properly
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (int b = 0; b < (int)buffers.size(); ++b)
+    {
+        ThreadBuffer &buffer = *buffers[b];
+        std::lock_guard<std::mutex> buffer_lock(buffer.Mutex);
+
+        // Name the thread
+        ofs << (first ? "" : ",") << "\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.ThreadID <<
+            ",\"name\":\"thread_name\",\"args\":{\"name\":" << Commons::EscapeJSON(buffer.ThreadName) << "}}";
+        first = false;
+
+        // Write the events as complete events (the times are in microseconds)
+        for (int e = 0; e < (int)buffer.Events.size(); ++e)
+        {
+            const Event &event = buffer.Events[e];
+            ofs << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.ThreadID << ",\"cat\":" << Commons::EscapeJSON(event.Category) <<
+                ",\"name\":" << Commons::EscapeJSON(event.Name) << ",\"ts\":" << event.StartNs / 1000 << "." << (event.StartNs % 1000) / 100 <<
+                ",\"dur\":" << (event.EndNs - event.StartNs) / 1000 << "." << ((event.EndNs - event.StartNs) % 1000) / 100;
+            if (!event.Detail.empty())
+                ofs << ",\"args\":{\"detail\":" << Commons::EscapeJSON(event.Detail) << "}";
+            ofs << "}";
+        }
+    }
+    ofs << "\n]}" << std::endl;
+
+    // Forget the exited threads that have no events (e.g. the short-lived workers of the parallel loops)
+    RemoveExitedBuffers();
+
+    return (bool)ofs;
+}
+
+// Remove all the recorded events (and the buffers of the exited threads)
+void Trace::Clear()
+{
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    for (int b = 0; b < (int)buffers.size(); ++b)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffers[b]->Mutex);
+        buffers[b]->Events.clear();
+    }
+    RemoveExitedBuffers();
+}
+
+// Set the name of the calling thread in the trace (the threads are numbered by default)
+void Trace::SetThreadName(const std::string &name)
+{
+    ThreadBuffer &buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.Mutex);
+    buffer.ThreadName = name;
+}
+
+// Record an event of the calling thread (the times are from GetTimeNanoseconds)
+void Trace::AddEvent(const char *category, const char *name, const std::string &detail, long long start_ns, long long end_ns)
+{
+    ThreadBuffer &buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.Mutex);
+    Event event = { category, name, detail, start_ns, end_ns };
+    buffer.Events.push_back(event);
+}
+
+// Get the time of the events in nanoseconds (from a monotonic clock)
+long long Trace::GetTimeNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Deconstructor function for ThreadBufferOwner. Marks the buffer of the exiting thread.
+Trace::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    if (!Buffer) return;
+    std::lock_guard<std::mutex> lock(Buffer->Mutex);
+    Buffer->Exited = true;
+}
+
+// Get the buffer of the calling thread (created on its first event)
+Trace::ThreadBuffer &Trace::GetThreadBuffer()
+{
+    static thread_local ThreadBufferOwner owner;
+    if (!owner.Buffer)
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        owner.Buffer = std::make_shared<ThreadBuffer>();
+        owner.Buffer->ThreadID = ++last_thread_id;
+        owner.Buffer->ThreadName = "thread " + std::to_string(owner.Buffer->ThreadID);
+        buffers.push_back(owner.Buffer);
+    }
+    return *owner.Buffer;
+}
+
+// Remove the buffers of the exited threads that have no events left (buffers_mutex must be locked)
+void Trace::RemoveExitedBuffers()
+{
+    size_t n_kept = 0;
+    for (size_t b = 0; b < buffers.size(); ++b)
+    {
+        std::unique_lock<std::mutex> buffer_lock(buffers[b]->Mutex);
+        bool remove = buffers[b]->Exited && buffers[b]->Events.empty();
+        buffer_lock.unlock();
+        if (!remove) buffers[n_kept++] = buffers[b];
+    }
+    buffers.resize(n_kept);
+}
+
+}
+#endif
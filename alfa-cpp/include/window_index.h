@@ -0,0 +1,672 @@
+/*  ***************************************************************************
+*   window_index.h - Header for the random-access index of training windows.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_WINDOW_INDEX_H
+#define ALFA_WINDOW_INDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include "commons.h"
+#include "sequence.h"
+#include "catalog.h"
+#include "diagnostics.h"
+#include "trace.h"
+
+namespace alfa
+{
+
+// This class keeps a compact table of fixed-length windows over a set of sequences for shuffled training.
+// Each window is one row of the table: its sequence id, its label, and its start message for each topic.
+// The windows are cut from the first topic of the channels (the reference topic) using the given stride,
+// and the other topics start at their first message recorded at or after the start of the window.
+// Every channel contributes WindowLength consecutive messages of its topic to the window.
+class WindowIndex
+{
+public:
+
+    // Local struct definitions
+    struct Channel              // A field of a topic that is included in the windows
+    {
+        std::string TopicName;
+        std::string FieldLabel;
+        Channel(const std::string &topic_name = "", const std::string &field_label = "")
+            : TopicName(topic_name), FieldLabel(field_label) {}
+    };
+
+    // Class Data Members
+    std::vector<Channel> Channels;
+    int WindowLength = 0;
+    int Stride = 0;
+    VecString SequenceDirs;
+    VecString SequenceNames;
+    VecString TopicNames;           // Distinct topics of the channels (the first one is the reference topic)
+    VecString ClassNames;           // Label names ('normal' and the fault types of the sequences)
+    std::vector<int> SequenceIDs;   // Sequence of each window
+    std::vector<int> Labels;        // Label of each window (0 if the fault has not happened until the end of the window)
+    std::vector<int> StartRows;     // Start message of each window for each topic (Size() x TopicNames.size())
+
+    // Constructors & Deconstructors
+    WindowIndex() {}
+
+    // Member Functions
+    bool Build(const VecString &sequence_dirs, const VecString &sequence_names, const std::vector<Channel> &channels,
+        int window_length, int stride, bool load_data = true, int n_threads = 0);
+    bool Build(const Catalog &catalog, const std::vector<int> &entries, const std::vector<Channel> &channels,
+        int window_length, int stride, bool load_data = true, int n_threads = 0);
+    bool Save(const std::string &filename) const;
+    bool Load(const std::string &filename, bool load_data = true, int n_threads = 0);
+    bool LoadData(int n_threads = 0);
+    bool IsInitialized() const;
+    bool HasData() const;
+    void Clear();
+    size_t Size() const;
+    int GetStartRow(size_t window_id, int channel_idx) const;
+    int GetSequenceLength(int sequence_id, int channel_idx) const;
+    const float *GetChannelData(int sequence_id, int channel_idx) const;
+    size_t GetTensorSize(size_t n_windows) const;
+    bool Fetch(const std::vector<size_t> &window_ids, float *out_tensor, int n_threads = 0) const;
+    std::vector<size_t> Shuffle(unsigned long long seed) const;
+    std::vector<size_t> StratifiedShuffle(unsigned long long seed) const;
+    std::shared_ptr<Diagnostics> GetDiagnostics() const;
+    void SetDiagnostics(const std::shared_ptr<Diagnostics> &diagnostics);
+
+private:
+    // Local struct definitions
+    struct SequenceWindows      // Windows and data of a single sequence (used while building)
+    {
+        bool Loaded = false;
+        std::string ClassName;
+        std::vector<int> Labels;
+        std::vector<int> StartRows;
+        std::vector<std::vector<float> > Columns;
+    };
+
+    // Member Functions
+    bool LoadSequenceWindows(int seq_idx, bool cut_windows, SequenceWindows &out_windows) const;
+    bool IsTableValid() const;
+    static void ShuffleIndices(std::vector<size_t> &indices, std::mt19937_64 &rng);
+    void Report(const std::string &source, const std::string &text) const;
+
+    // Data Members
+    bool is_initialized = false;
+
+    // Topic index (in TopicNames) of each channel
+    std::vector<int> channel_topics;
+
+    // Decoded channel values of each sequence ([sequence][channel][message])
+    std::vector<std::vector<std::vector<float> > > columns;
+    bool has_data = false;
+
+    // Collector of the errors (also of loading the sequences)
+    DiagnosticsLink diagnostics;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Build the window table for the given sequences. Also keeps the decoded channel values if load_data is true.
+bool WindowIndex::Build(const VecString &sequence_dirs, const VecString &sequence_names, const std::vector<Channel> &channels,
+    int window_length, int stride, bool load_data, int n_threads)
+{
+    // Clear the previous data from the object
+    Clear();
+
+    // Print an error if the inputs are not valid
+    if (sequence_dirs.size() != sequence_names.size() || channels.empty() || window_length <= 0 || stride <= 0)
+    {
+        Report("WindowIndex", "WindowIndex Error! Invalid sequences, channels, window length or stride.");
+        return false;
+    }
+
+    SequenceDirs = sequence_dirs;
+    SequenceNames = sequence_names;
+    Channels = channels;
+    WindowLength = window_length;
+    Stride = stride;
+
+    // Find the distinct topics of the channels
+    for (int c = 0; c < (int)Channels.size(); ++c)
+    {
+        int topic_idx = std::find(TopicNames.begin(), TopicNames.end(), Channels[c].TopicName) - TopicNames.begin();
+        if (topic_idx == (int)TopicNames.size())
+            TopicNames.push_back(Channels[c].TopicName);
+        channel_topics.push_back(topic_idx);
+    }
+
+    // Cut the windows of all the sequences in parallel
+    std::vector<SequenceWindows> seq_windows(SequenceNames.size());
+    Commons::ParallelFor(SequenceNames.size(), n_threads, [&](int i)
+    {
+        seq_windows[i].Loaded = LoadSequenceWindows(i, true, seq_windows[i]);
+    });
+
+    // Merge the windows in the order of the sequences (so the window ids do not depend on the scheduling)
+    ClassNames.push_back("normal");
+    columns.resize(SequenceNames.size());
+    for (int i = 0; i < (int)seq_windows.size(); ++i)
+    {
+        SequenceWindows &windows = seq_windows[i];
+        if (!windows.Loaded) continue;
+
+        // Find the label of the sequence fault or add it
+        int class_id = std::find(ClassNames.begin(), ClassNames.end(), windows.ClassName) - ClassNames.begin();
+        if (class_id == (int)ClassNames.size() && !windows.ClassName.empty())
+            ClassNames.push_back(windows.ClassName);
+
+        for (int w = 0; w < (int)windows.Labels.size(); ++w)
+        {
+            SequenceIDs.push_back(i);
+            Labels.push_back(windows.Labels[w] ? class_id : 0);
+        }
+        StartRows.insert(StartRows.end(), windows.StartRows.begin(), windows.StartRows.end());
+        if (load_data)
+            columns[i].swap(windows.Columns);
+    }
+    has_data = load_data;
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Build the window table for the given entries of a catalog
+bool WindowIndex::Build(const Catalog &catalog, const std::vector<int> &entries, const std::vector<Channel> &channels,
+    int window_length, int stride, bool load_data, int n_threads)
+{
+    VecString sequence_dirs, sequence_names;
+    for (int i = 0; i < (int)entries.size(); ++i)
+    {
+        sequence_dirs.push_back(catalog.GetSequenceDirectory(entries[i]));
+        sequence_names.push_back(catalog.Entries[entries[i]].Name);
+    }
+    return Build(sequence_dirs, sequence_names, channels, window_length, stride, load_data, n_threads);
+}
+
+// Save the window table to a binary file (the decoded data is not saved)
+bool WindowIndex::Save(const std::string &filename) const
+{
+    // Open the file
+    std::ofstream ofs(filename, std::ios::binary);
+
+    // Print an error if file did not open properly
+    if (!ofs.is_open())
+    {
+        Report(filename, "Failed to open '" + filename + "' file for writing.");
+        return false;
+    }
+
+    // Write the definition of the windows
+    ofs.write("ALFAWIN1", 8);
+    Commons::WriteBinary(ofs, WindowLength);
+    Commons::WriteBinary(ofs, Stride);
+    Commons::WriteBinary(ofs, (int)Channels.size());
+    for (int c = 0; c < (int)Channels.size(); ++c)
+    {
+        Commons::WriteBinaryString(ofs, Channels[c].TopicName);
+        Commons::WriteBinaryString(ofs, Channels[c].FieldLabel);
+    }
+
+    // Write the sequences and the labels
+    Commons::WriteBinary(ofs, (int)SequenceNames.size());
+    for (int i = 0; i < (int)SequenceNames.size(); ++i)
+    {
+        Commons::WriteBinaryString(ofs, SequenceDirs[i]);
+        Commons::WriteBinaryString(ofs, SequenceNames[i]);
+    }
+    Commons::WriteBinary(ofs, (int)ClassNames.size());
+    for (int i = 0; i < (int)ClassNames.size(); ++i)
+        Commons::WriteBinaryString(ofs, ClassNames[i]);
+
+    // Write the window table
+    Commons::WriteBinaryVector(ofs, SequenceIDs);
+    Commons::WriteBinaryVector(ofs, Labels);
+    Commons::WriteBinaryVector(ofs, StartRows);
+
+    return (bool)ofs;
+}
+
+// Load a window table from a binary file. Also loads the decoded channel values if load_data is true.
+bool WindowIndex::Load(const std::string &filename, bool load_data, int n_threads)
+{
+    // Clear the previous data from the object
+    Clear();
+
+    // Open the file
+    std::ifstream ifs(filename, std::ios::binary);
+
+    // Print an error if file did not open properly
+    if (!ifs.is_open())
+    {
+        Report(filename, "Failed to open '" + filename + "' file.");
+        return false;
+    }
+
+    // Read the definition of the windows
+    char magic[8];
+    int n_channels = 0, n_sequences = 0, n_classes = 0;
+    bool ok = ifs.read(magic, 8) && std::memcmp(magic, "ALFAWIN1", 8) == 0 &&
+        Commons::ReadBinary(ifs, WindowLength) && Commons::ReadBinary(ifs, Stride) && Commons::ReadBinary(ifs, n_channels);
+    for (int c = 0; ok && c < n_channels; ++c)
+    {
+        Channel channel;
+        ok = Commons::ReadBinaryString(ifs, channel.TopicName) && Commons::ReadBinaryString(ifs, channel.FieldLabel);
+        Channels.push_back(channel);
+    }
+
+    // Read the sequences and the labels
+    ok = ok && Commons::ReadBinary(ifs, n_sequences);
+    for (int i = 0; ok && i < n_sequences; ++i)
+    {
+        std::string dir, name;
+        ok = Commons::ReadBinaryString(ifs, dir) && Commons::ReadBinaryString(ifs, name);
+        SequenceDirs.push_back(dir);
+        SequenceNames.push_back(name);
+    }
+    ok = ok && Commons::ReadBinary(ifs, n_classes);
+    for (int i = 0; ok && i < n_classes; ++i)
+    {
+        std::string name;
+        ok = Commons::ReadBinaryString(ifs, name);
+        ClassNames.push_back(name);
+    }
+
+    // Read the window table
+    ok = ok && Commons::ReadBinaryVector(ifs, SequenceIDs) && Commons::ReadBinaryVector(ifs, Labels) &&
+        Commons::ReadBinaryVector(ifs, StartRows);
+
+    // Print an error if the file is not formatted properly
+    if (!ok)
+    {
+        Report(filename, "Error reading the window index from '" + filename + "' file.");
+        Clear();
+        return false;
+    }
+
+    // Find the distinct topics of the channels
+    for (int c = 0; c < (int)Channels.size(); ++c)
+    {
+        int topic_idx = std::find(TopicNames.begin(), TopicNames.end(), Channels[c].TopicName) - TopicNames.begin();
+        if (topic_idx == (int)TopicNames.size())
+            TopicNames.push_back(Channels[c].TopicName);
+        channel_topics.push_back(topic_idx);
+    }
+
+    // Print an error if the window table does not match the definition (e.g. a stale or corrupt file)
+    if (!IsTableValid())
+    {
+        Report(filename, "WindowIndex Error! The window table in '" + filename + "' file is not valid.");
+        Clear();
+        return false;
+    }
+
+    // Initialization done
+    is_initialized = true;
+
+    if (load_data)
+        return LoadData(n_threads);
+
+    return IsInitialized();
+}
+
+// Load and decode the channel values of all the sequences (needed for fetching the windows)
+bool WindowIndex::LoadData(int n_threads)
+{
+    if (!IsInitialized()) return false;
+
+    // Load the sequences in parallel
+    std::vector<SequenceWindows> seq_windows(SequenceNames.size());
+    Commons::ParallelFor(SequenceNames.size(), n_threads, [&](int i)
+    {
+        seq_windows[i].Loaded = LoadSequenceWindows(i, false, seq_windows[i]);
+    });
+
+    // Keep the decoded values
+    columns.assign(SequenceNames.size(), std::vector<std::vector<float> >());
+    for (int i = 0; i < (int)seq_windows.size(); ++i)
+        columns[i].swap(seq_windows[i].Columns);
+
+    // Check that every sequence with windows is loaded and has all the messages of its windows
+    for (int w = 0; w < (int)SequenceIDs.size(); ++w)
+    {
+        if (!seq_windows[SequenceIDs[w]].Loaded)
+        {
+            Report(SequenceNames[SequenceIDs[w]], "WindowIndex Error! Failed to load the data of '" + SequenceNames[SequenceIDs[w]] + "'.");
+            columns.clear();
+            return false;
+        }
+        for (int c = 0; c < (int)Channels.size(); ++c)
+            if ((long long)GetStartRow(w, c) + WindowLength > (long long)columns[SequenceIDs[w]][c].size())
+            {
+                Report(SequenceNames[SequenceIDs[w]], "WindowIndex Error! Window " + std::to_string(w) + " is beyond the messages of '" +
+                    SequenceNames[SequenceIDs[w]] + "' (the sequence has changed since the index was built).");
+                columns.clear();
+                return false;
+            }
+    }
+
+    has_data = true;
+    return true;
+}
+
+// Returns the initialization status
+bool WindowIndex::IsInitialized() const
+{
+    return is_initialized;
+}
+
+// Returns true if the decoded channel values are loaded (windows can be fetched)
+bool WindowIndex::HasData() const
+{
+    return has_data;
+}
+
+// Clear the entire window index object
+void WindowIndex::Clear()
+{
+    Channels.clear();
+    WindowLength = 0;
+    Stride = 0;
+    SequenceDirs.clear();
+    SequenceNames.clear();
+    TopicNames.clear();
+    ClassNames.clear();
+    SequenceIDs.clear();
+    Labels.clear();
+    StartRows.clear();
+    channel_topics.clear();
+    columns.clear();
+    has_data = false;
+    is_initialized = false;
+}
+
+// Get the number of the windows
+size_t WindowIndex::Size() const
+{
+    return SequenceIDs.size();
+}
+
+// Get the start message of a window for the topic of the given channel
+int WindowIndex::GetStartRow(size_t window_id, int channel_idx) const
+{
+    return StartRows[window_id * TopicNames.size() + channel_topics[channel_idx]];
+}
+
+// Get the number of the decoded values of a channel in a sequence
+int WindowIndex::GetSequenceLength(int sequence_id, int channel_idx) const
+{
+    if (!has_data || columns[sequence_id].empty()) return 0;
+    return columns[sequence_id][channel_idx].size();
+}
+
+// Get the decoded values of a channel in a sequence (NULL if not loaded)
+const float *WindowIndex::GetChannelData(int sequence_id, int channel_idx) const
+{
+    if (!has_data || columns[sequence_id].empty() || columns[sequence_id][channel_idx].empty()) return NULL;
+    return &columns[sequence_id][channel_idx][0];
+}
+
+// Get the number of the values in the tensor of the given number of windows
+size_t WindowIndex::GetTensorSize(size_t n_windows) const
+{
+    return n_windows * Channels.size() * WindowLength;
+}
+
+// Gather the given windows into a contiguous tensor with the shape of (windows x channels x WindowLength).
+// The output should hold GetTensorSize(window_ids.size()) values.
+bool WindowIndex::Fetch(const std::vector<size_t> &window_ids, float *out_tensor, int n_threads) const
+{
+    // Print an error if the data is not loaded
+    if (!has_data)
+    {
+        Report("WindowIndex", "WindowIndex Error! The data is not loaded for fetching the windows.");
+        return false;
+    }
+
+    // Check the window ids
+    for (size_t i = 0; i < window_ids.size(); ++i)
+        if (window_ids[i] >= Size())
+        {
+            Report("WindowIndex", "WindowIndex Error! Window id " + std::to_string(window_ids[i]) + " is out of range.");
+            return false;
+        }
+
+    // Split the windows into contiguous chunks for the threads
+    const int n_channels = Channels.size();
+    const size_t window_size = (size_t)n_channels * WindowLength;
+    const int n_chunks = Commons::GetThreadCount(n_threads, (window_ids.size() + 63) / 64);
+    const size_t chunk_size = (window_ids.size() + n_chunks - 1) / n_chunks;
+
+    // Copy the channel values of each window
+    Commons::ParallelFor(n_chunks, n_chunks, [&](int chunk)
+    {
+        Trace::Scope trace("windows", "fetch");
+        size_t end = std::min(window_ids.size(), (chunk + 1) * chunk_size);
+        for (size_t i = chunk * chunk_size; i < end; ++i)
+        {
+            size_t w = window_ids[i];
+            const std::vector<std::vector<float> > &seq_columns = columns[SequenceIDs[w]];
+            for (int c = 0; c < n_channels; ++c)
+                std::memcpy(out_tensor + i * window_size + (size_t)c * WindowLength,
+                    &seq_columns[c][GetStartRow(w, c)], WindowLength * sizeof(float));
+        }
+    });
+
+    return true;
+}
+
+// Get a deterministic random permutation of the window ids for the given seed
+std::vector<size_t> WindowIndex::Shuffle(unsigned long long seed) const
+{
+    std::vector<size_t> indices(Size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = i;
+
+    std::mt19937_64 rng(seed);
+    ShuffleIndices(indices, rng);
+    return indices;
+}
+
+// Get a deterministic random permutation of the window ids for the given seed, in which
+// the labels are spread evenly (every prefix keeps the proportions of the labels)
+std::vector<size_t> WindowIndex::StratifiedShuffle(unsigned long long seed) const
+{
+    // Shuffle the windows of each label separately
+    std::mt19937_64 rng(seed);
+    std::vector<std::vector<size_t> > strata(ClassNames.size());
+    for (size_t i = 0; i < Size(); ++i)
+        strata[Labels[i]].push_back(i);
+    for (int k = 0; k < (int)strata.size(); ++k)
+        ShuffleIndices(strata[k], rng);
+
+    // Interleave the labels, taking the next window from the label that is most behind its share
+    std::vector<size_t> indices;
+    std::vector<size_t> taken(strata.size(), 0);
+    const double total = Size();
+    for (size_t pos = 0; pos < Size(); ++pos)
+    {
+        int best = -1;
+        double best_deficit = -std::numeric_limits<double>::infinity();
+        for (int k = 0; k < (int)strata.size(); ++k)
+        {
+            if (taken[k] == strata[k].size()) continue;
+            double deficit = strata[k].size() * (pos + 1) / total - taken[k];
+            if (deficit > best_deficit) { best_deficit = deficit; best = k; }
+        }
+        indices.push_back(strata[best][taken[best]++]);
+    }
+    return indices;
+}
+
+// Get the collector of the errors of the window index and of loading its sequences
+std::shared_ptr<Diagnostics> WindowIndex::GetDiagnostics() const
+{
+    return diagnostics.Get();
+}
+
+// Set the collector of the errors of the window index (or use its own one if not given)
+void WindowIndex::SetDiagnostics(const std::shared_ptr<Diagnostics> &diagnostics)
+{
+    this->diagnostics.Set(diagnostics);
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Load a sequence, decode its channel values and (optionally) cut its windows
+bool WindowIndex::LoadSequenceWindows(int seq_idx, bool cut_windows, SequenceWindows &out_windows) const
+{
+    Trace::Scope trace("windows", cut_windows ? "cut" : "decode", SequenceNames[seq_idx]);
+    Sequence sequence(SequenceDirs[seq_idx], SequenceNames[seq_idx], diagnostics.Get());
+    if (!sequence.IsInitialized()) return false;
+
+    // Find the topics (skip the sequence if any of them is missing)
+    std::vector<int> topic_indices;
+    for (int t = 0; t < (int)TopicNames.size(); ++t)
+    {
+        topic_indices.push_back(sequence.FindTopicIndex(TopicNames[t]));
+        if (topic_indices.back() < 0)
+        {
+            Report(SequenceNames[seq_idx], "WindowIndex Error! '" + TopicNames[t] + "' topic not found in '" + SequenceNames[seq_idx] + "'.");
+            return false;
+        }
+    }
+
+    // Decode the values of the channels
+    out_windows.Columns.resize(Channels.size());
+    for (int c = 0; c < (int)Channels.size(); ++c)
+    {
+        const Topic &topic = sequence.Topics[topic_indices[channel_topics[c]]];
+        int field_idx = topic.FindLabelIndex(Channels[c].FieldLabel);
+        if (field_idx < 0)
+        {
+            Report(SequenceNames[seq_idx], "WindowIndex Error! '" + Channels[c].FieldLabel + "' field not found in '" + topic.Name + "'.");
+            return false;
+        }
+
+        std::vector<float> &column = out_windows.Columns[c];
+        column.resize(topic.Messages.size());
+        for (int m = 0; m < (int)topic.Messages.size(); ++m)
+        {
+            const std::string &field = topic.Messages[m].Fields[field_idx];
+            char *endptr;
+            double value = std::strtod(field.c_str(), &endptr);
+            column[m] = (field.empty() || *endptr != '\0') ? std::numeric_limits<float>::quiet_NaN() : (float)value;
+        }
+    }
+
+    if (!cut_windows) return true;
+
+    // Find the fault onset and the fault name of the sequence
+    long long fault_onset = -1;
+    int fault_msg_idx = sequence.FindFirstFaultMessage();
+    if (fault_msg_idx >= 0)
+    {
+        fault_onset = sequence.GetMessage(fault_msg_idx).DateTime.ToEpochNanoseconds();
+        VecString fault_types = Catalog::ParseFaultTypes(SequenceNames[seq_idx]);
+        for (int f = 0; f < (int)fault_types.size(); ++f)
+            out_windows.ClassName += (f > 0 ? "+" : "") + fault_types[f];
+        if (out_windows.ClassName.empty())
+            out_windows.ClassName = sequence.Topics[sequence.MessageIndexList[fault_msg_idx].TopicIdx].Name;
+    }
+
+    // Get the recorded times of all the topics
+    std::vector<std::vector<long long> > times(TopicNames.size());
+    for (int t = 0; t < (int)TopicNames.size(); ++t)
+    {
+        const Topic &topic = sequence.Topics[topic_indices[t]];
+        times[t].resize(topic.Messages.size());
+        for (int m = 0; m < (int)topic.Messages.size(); ++m)
+            times[t][m] = topic.Messages[m].DateTime.ToEpochNanoseconds();
+    }
+
+    // Cut the windows from the reference topic and align the other topics to them
+    const std::vector<long long> &ref_times = times[0];
+    std::vector<int> start_rows(TopicNames.size());
+    for (int start = 0; start + WindowLength <= (int)ref_times.size(); start += Stride)
+    {
+        // Find the first message of each topic recorded at or after the start of the window
+        bool complete = true;
+        start_rows[0] = start;
+        for (int t = 1; t < (int)TopicNames.size() && complete; ++t)
+        {
+            start_rows[t] = std::lower_bound(times[t].begin(), times[t].end(), ref_times[start]) - times[t].begin();
+            complete = start_rows[t] + WindowLength <= (int)times[t].size();
+        }
+
+        // Stop when any of the topics runs out of messages
+        if (!complete) break;
+
+        out_windows.StartRows.insert(out_windows.StartRows.end(), start_rows.begin(), start_rows.end());
+        out_windows.Labels.push_back(fault_onset >= 0 && ref_times[start + WindowLength - 1] >= fault_onset);
+    }
+
+    return true;
+}
+
+// Check that the sizes and the values of the window table match the definition of the windows
+bool WindowIndex::IsTableValid() const
+{
+    if (WindowLength <= 0 || Stride <= 0 || Channels.empty()) return false;
+    if (SequenceDirs.size() != SequenceNames.size() || Labels.size() != SequenceIDs.size()) return false;
+    if (StartRows.size() != SequenceIDs.size() * TopicNames.size()) return false;
+    for (size_t w = 0; w < SequenceIDs.size(); ++w)
+    {
+        if (SequenceIDs[w] < 0 || SequenceIDs[w] >= (int)SequenceNames.size()) return false;
+        if (Labels[w] < 0 || Labels[w] >= (int)ClassNames.size()) return false;
+    }
+    for (size_t i = 0; i < StartRows.size(); ++i)
+        if (StartRows[i] < 0) return false;
+    return true;
+}
+
+// Shuffle the indices in place (Fisher-Yates with the fully specified mt19937_64 engine, so the
+// result is the same on all platforms and standard libraries)
+void WindowIndex::ShuffleIndices(std::vector<size_t> &indices, std::mt19937_64 &rng)
+{
+    for (size_t i = indices.size(); i > 1; --i)
+    {
+        size_t j = (size_t)(rng() % i);
+        std::swap(indices[i - 1], indices[j]);
+    }
+}
+
+// Report an error to the diagnostics collector
+void WindowIndex::Report(const std::string &source, const std::string &text) const
+{
+    diagnostics.Get()->Add(Diagnostics::Error, source, text);
+}
+
+}
+#endif
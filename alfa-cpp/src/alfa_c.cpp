@@ -0,0 +1,450 @@
+/*  ***************************************************************************
+*   alfa_c.cpp - Implementation of the C interface of the ALFA dataset library.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include "alfa_c.h"
+#include "sequence.h"
+
+// The topic handle: a loaded topic and its recorded times (computed once at load time)
+struct alfa_topic
+{
+    const alfa::Topic *Topic;
+    std::vector<int64_t> Times;
+};
+
+// The sequence handle: a loaded sequence and the handles of its topics
+struct alfa_sequence
+{
+    alfa::Sequence Sequence;
+    std::vector<alfa_topic> Topics;
+    int64_t FirstFaultMessage;
+};
+
+namespace
+{
+
+// Clamp the requested message range to the available messages. Returns false if the start is out of range.
+bool ClampRange(int64_t n_available, int64_t start, int64_t &count)
+{
+    if (start < 0 || start > n_available) return false;
+    if (count < 0 || count > n_available - start)
+        count = n_available - start;
+    return true;
+}
+
+// Check the common arguments of the field export functions
+alfa_status CheckFieldArguments(const alfa_topic *topic, int64_t field_index, int64_t start, int64_t &count, const void *out_values)
+{
+    if (topic == NULL || out_values == NULL) return ALFA_ERROR_INVALID_ARGUMENT;
+    if (field_index < 0 || field_index >= (int64_t)topic->Topic->FieldLabels.size()) return ALFA_ERROR_OUT_OF_RANGE;
+    if (!ClampRange(topic->Topic->Messages.size(), start, count)) return ALFA_ERROR_OUT_OF_RANGE;
+    return ALFA_OK;
+}
+
+}
+
+// The C++ exceptions must not reach the C callers, so every function that can throw (allocations, strings and
+// loading) catches them and returns ALFA_ERROR_INTERNAL (or -1 for the index lookups). The simple accessors
+// cannot throw.
+
+/******************************************************************************/
+/************************** General Functions *********************************/
+/******************************************************************************/
+
+// Get the version of the C interface the library is built with
+int alfa_abi_version(void)
+{
+    return ALFA_C_ABI_VERSION;
+}
+
+// Get a human-readable description of a status code
+const char *alfa_status_string(alfa_status status)
+{
+    switch (status)
+    {
+    case ALFA_OK: return "Success";
+    case ALFA_ERROR_INVALID_ARGUMENT: return "Invalid argument";
+    case ALFA_ERROR_LOAD_FAILED: return "Failed to load the sequence";
+    case ALFA_ERROR_NOT_FOUND: return "Topic or field not found";
+    case ALFA_ERROR_OUT_OF_RANGE: return "Index out of range";
+    case ALFA_ERROR_BUFFER_TOO_SMALL: return "Buffer too small";
+    case ALFA_ERROR_CONVERSION: return "Some values could not be converted";
+    case ALFA_ERROR_INTERNAL: return "Internal error";
+    }
+    return "Unknown status";
+}
+
+/******************************************************************************/
+/************************** Sequence Functions ********************************/
+/******************************************************************************/
+
+// Load all the topic files of a sequence. The handle should be released with alfa_sequence_free.
+alfa_status alfa_sequence_load(const char *sequence_dir, const char *sequence_name, alfa_sequence **out_sequence)
+{
+    try
+    {
+        if (sequence_dir == NULL || sequence_name == NULL || out_sequence == NULL) return ALFA_ERROR_INVALID_ARGUMENT;
+        *out_sequence = NULL;
+
+        // Add the path separator to the directory
+        std::string dir(sequence_dir);
+        if (dir.empty() || dir[dir.length() - 1] != alfa::Commons::FilePathSeparator)
+            dir += alfa::Commons::FilePathSeparator;
+
+        // Load the sequence
+        std::unique_ptr<alfa_sequence> sequence(new alfa_sequence);
+        if (!sequence->Sequence.LoadSequence(dir, sequence_name)) return ALFA_ERROR_LOAD_FAILED;
+
+        // Create the topic handles with their recorded times, so the exports do not need any conversion
+        sequence->Topics.resize(sequence->Sequence.Topics.size());
+        for (size_t i = 0; i < sequence->Topics.size(); ++i)
+        {
+            const alfa::Topic &topic = sequence->Sequence.Topics[i];
+            sequence->Topics[i].Topic = &topic;
+            sequence->Topics[i].Times.resize(topic.Messages.size());
+            for (size_t j = 0; j < topic.Messages.size(); ++j)
+                sequence->Topics[i].Times[j] = topic.Messages[j].DateTime.ToEpochNanoseconds();
+        }
+        sequence->FirstFaultMessage = sequence->Sequence.FindFirstFaultMessage();
+
+        *out_sequence = sequence.release();
+        return ALFA_OK;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+// Release a sequence and all its topic handles
+void alfa_sequence_free(alfa_sequence *sequence)
+{
+    delete sequence;
+}
+
+// Get the name of the sequence
+const char *alfa_sequence_name(const alfa_sequence *sequence)
+{
+    if (sequence == NULL) return "";
+    return sequence->Sequence.Name.c_str();
+}
+
+// Get the number of the topics in the sequence
+int64_t alfa_sequence_topic_count(const alfa_sequence *sequence)
+{
+    if (sequence == NULL) return 0;
+    return sequence->Topics.size();
+}
+
+// Get a topic by its index
+alfa_status alfa_sequence_topic(const alfa_sequence *sequence, int64_t topic_index, const alfa_topic **out_topic)
+{
+    try
+    {
+        if (sequence == NULL || out_topic == NULL) return ALFA_ERROR_INVALID_ARGUMENT;
+        if (topic_index < 0 || topic_index >= (int64_t)sequence->Topics.size()) return ALFA_ERROR_OUT_OF_RANGE;
+        *out_topic = &sequence->Topics[topic_index];
+        return ALFA_OK;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+// Get a topic by its name (case sensitive)
+alfa_status alfa_sequence_find_topic(const alfa_sequence *sequence, const char *topic_name, const alfa_topic **out_topic)
+{
+    try
+    {
+        if (sequence == NULL || topic_name == NULL || out_topic == NULL) return ALFA_ERROR_INVALID_ARGUMENT;
+        int64_t topic_index = alfa_sequence_find_topic_index(sequence, topic_name);
+        if (topic_index < 0) return ALFA_ERROR_NOT_FOUND;
+        *out_topic = &sequence->Topics[topic_index];
+        return ALFA_OK;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+// Find the index of a topic by its name. Returns -1 if not found.
+int64_t alfa_sequence_find_topic_index(const alfa_sequence *sequence, const char *topic_name)
+{
+    try
+    {
+        if (sequence == NULL || topic_name == NULL) return -1;
+        return sequence->Sequence.FindTopicIndex(topic_name);
+    }
+    catch (...)
+    {
+        return -1;
+    }
+}
+
+// Get the timeline index of the first fault message. Returns -1 if there are no faults.
+int64_t alfa_sequence_first_fault_message(const alfa_sequence *sequence)
+{
+    if (sequence == NULL) return -1;
+    return sequence->FirstFaultMessage;
+}
+
+// Get the total number of the messages in the sequence timeline
+int64_t alfa_sequence_message_count(const alfa_sequence *sequence)
+{
+    if (sequence == NULL) return 0;
+    return sequence->Sequence.MessageIndexList.size();
+}
+
+// Export a range of the sequence timeline (topic index, message index and recorded time of each message)
+alfa_status alfa_sequence_timeline(const alfa_sequence *sequence, int64_t start, int64_t count,
+    int32_t *out_topic_indices, int32_t *out_message_indices, int64_t *out_times_ns, int64_t *out_written)
+{
+    try
+    {
+        if (sequence == NULL) return ALFA_ERROR_INVALID_ARGUMENT;
+        const std::vector<alfa::Sequence::MessageIndex> &timeline = sequence->Sequence.MessageIndexList;
+        if (!ClampRange(timeline.size(), start, count)) return ALFA_ERROR_OUT_OF_RANGE;
+
+        for (int64_t i = 0; i < count; ++i)
+        {
+            const alfa::Sequence::MessageIndex &index = timeline[start + i];
+            if (out_topic_indices != NULL) out_topic_indices[i] = index.TopicIdx;
+            if (out_message_indices != NULL) out_message_indices[i] = index.MessageIdx;
+            if (out_times_ns != NULL) out_times_ns[i] = sequence->Topics[index.TopicIdx].Times[index.MessageIdx];
+        }
+
+        if (out_written != NULL) *out_written = count;
+        return ALFA_OK;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+/******************************************************************************/
+/**************************** Topic Functions *********************************/
+/******************************************************************************/
+
+// Get the name of the topic
+const char *alfa_topic_name(const alfa_topic *topic)
+{
+    if (topic == NULL) return "";
+    return topic->Topic->Name.c_str();
+}
+
+// Returns 1 if the topic is a fault (ground truth) topic
+int alfa_topic_is_fault(const alfa_topic *topic)
+{
+    if (topic == NULL) return 0;
+    return topic->Topic->IsFaultTopic() ? 1 : 0;
+}
+
+// Returns 1 if the messages of the topic have the header fields
+int alfa_topic_has_header(const alfa_topic *topic)
+{
+    if (topic == NULL) return 0;
+    return topic->Topic->HasHeaderField() ? 1 : 0;
+}
+
+// Get the number of the messages in the topic
+int64_t alfa_topic_message_count(const alfa_topic *topic)
+{
+    if (topic == NULL) return 0;
+    return topic->Topic->Messages.size();
+}
+
+// Get the number of the data fields (excluding the time and the header)
+int64_t alfa_topic_field_count(const alfa_topic *topic)
+{
+    if (topic == NULL) return 0;
+    return topic->Topic->FieldLabels.size();
+}
+
+// Get the label of a data field. Returns NULL if the index is out of range.
+const char *alfa_topic_field_label(const alfa_topic *topic, int64_t field_index)
+{
+    if (topic == NULL || field_index < 0 || field_index >= (int64_t)topic->Topic->FieldLabels.size()) return NULL;
+    return topic->Topic->FieldLabels[field_index].c_str();
+}
+
+// Find the index of a data field by its label. Returns -1 if not found.
+int64_t alfa_topic_find_field(const alfa_topic *topic, const char *field_label)
+{
+    try
+    {
+        if (topic == NULL || field_label == NULL) return -1;
+        return topic->Topic->FindLabelIndex(field_label);
+    }
+    catch (...)
+    {
+        return -1;
+    }
+}
+
+// Export the recorded times (epoch nanoseconds) of a range of messages
+alfa_status alfa_topic_export_times(const alfa_topic *topic, int64_t start, int64_t count,
+    int64_t *out_times_ns, int64_t *out_written)
+{
+    try
+    {
+        if (topic == NULL || out_times_ns == NULL) return ALFA_ERROR_INVALID_ARGUMENT;
+        if (!ClampRange(topic->Times.size(), start, count)) return ALFA_ERROR_OUT_OF_RANGE;
+
+        if (count > 0)
+            std::memcpy(out_times_ns, &topic->Times[start], count * sizeof(int64_t));
+
+        if (out_written != NULL) *out_written = count;
+        return ALFA_OK;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+// Export the header sequence ids and stamps of a range of messages (any of the buffers may be NULL)
+alfa_status alfa_topic_export_headers(const alfa_topic *topic, int64_t start, int64_t count,
+    int32_t *out_sequence_ids, int64_t *out_stamps, int64_t *out_written)
+{
+    try
+    {
+        if (topic == NULL) return ALFA_ERROR_INVALID_ARGUMENT;
+        const std::vector<alfa::Message> &messages = topic->Topic->Messages;
+        if (!ClampRange(messages.size(), start, count)) return ALFA_ERROR_OUT_OF_RANGE;
+
+        for (int64_t i = 0; i < count; ++i)
+        {
+            if (out_sequence_ids != NULL) out_sequence_ids[i] = messages[start + i].Header.SequenceID;
+            if (out_stamps != NULL) out_stamps[i] = messages[start + i].Header.Stamp;
+        }
+
+        if (out_written != NULL) *out_written = count;
+        return ALFA_OK;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+// Export a field of a range of messages as doubles. The values that are not numbers are exported as NaN.
+alfa_status alfa_topic_export_double(const alfa_topic *topic, int64_t field_index, int64_t start, int64_t count,
+    double *out_values, int64_t *out_written)
+{
+    try
+    {
+        alfa_status status = CheckFieldArguments(topic, field_index, start, count, out_values);
+        if (status != ALFA_OK) return status;
+
+        const std::vector<alfa::Message> &messages = topic->Topic->Messages;
+        for (int64_t i = 0; i < count; ++i)
+        {
+            // Convert directly from the stored string (no temporary objects)
+            const std::string &field = messages[start + i].Fields[field_index];
+            char *endptr;
+            out_values[i] = std::strtod(field.c_str(), &endptr);
+            if (field.empty() || *endptr != '\0')
+            {
+                out_values[i] = std::numeric_limits<double>::quiet_NaN();
+                status = ALFA_ERROR_CONVERSION;
+            }
+        }
+
+        if (out_written != NULL) *out_written = count;
+        return status;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+// Export a field of a range of messages as 64-bit integers. The values that are not integers are exported as 0.
+alfa_status alfa_topic_export_int64(const alfa_topic *topic, int64_t field_index, int64_t start, int64_t count,
+    int64_t *out_values, int64_t *out_written)
+{
+    try
+    {
+        alfa_status status = CheckFieldArguments(topic, field_index, start, count, out_values);
+        if (status != ALFA_OK) return status;
+
+        const std::vector<alfa::Message> &messages = topic->Topic->Messages;
+        for (int64_t i = 0; i < count; ++i)
+        {
+            // Convert directly from the stored string (no temporary objects)
+            const std::string &field = messages[start + i].Fields[field_index];
+            char *endptr;
+            out_values[i] = std::strtoll(field.c_str(), &endptr, 10);
+            if (field.empty() || *endptr != '\0')
+            {
+                out_values[i] = 0;
+                status = ALFA_ERROR_CONVERSION;
+            }
+        }
+
+        if (out_written != NULL) *out_written = count;
+        return status;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
+
+// Copy a single field value as a NUL-terminated string. Truncates and returns ALFA_ERROR_BUFFER_TOO_SMALL
+// if the buffer cannot hold the whole value.
+alfa_status alfa_topic_field_string(const alfa_topic *topic, int64_t field_index, int64_t message_index,
+    char *out_buffer, size_t buffer_size, size_t *out_length)
+{
+    try
+    {
+        if (topic == NULL || (out_buffer == NULL && buffer_size > 0)) return ALFA_ERROR_INVALID_ARGUMENT;
+        const std::vector<alfa::Message> &messages = topic->Topic->Messages;
+        if (field_index < 0 || field_index >= (int64_t)topic->Topic->FieldLabels.size()) return ALFA_ERROR_OUT_OF_RANGE;
+        if (message_index < 0 || message_index >= (int64_t)messages.size()) return ALFA_ERROR_OUT_OF_RANGE;
+
+        const std::string &field = messages[message_index].Fields[field_index];
+        if (out_length != NULL) *out_length = field.size();
+        if (buffer_size == 0) return ALFA_ERROR_BUFFER_TOO_SMALL;
+
+        // Copy as much as fits in the buffer
+        size_t n_copy = std::min(field.size(), buffer_size - 1);
+        std::memcpy(out_buffer, field.data(), n_copy);
+        out_buffer[n_copy] = '\0';
+
+        return (n_copy < field.size()) ? ALFA_ERROR_BUFFER_TOO_SMALL : ALFA_OK;
+    }
+    catch (...)
+    {
+        return ALFA_ERROR_INTERNAL;
+    }
+}
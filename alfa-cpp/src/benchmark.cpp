@@ -0,0 +1,211 @@
+/*  ***************************************************************************
+*   benchmark.cpp - Benchmarks the hot paths and compares them with baselines.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include "benchmark.h"
+#include "sequence.h"
+#include "commons.h"
+
+int RunBenchmarks(int argc, char** argv);
+int CompareReports(int argc, char** argv);
+void PrintHelpMessage();
+
+// Prevents the compiler from removing the benchmarked work
+volatile size_t benchmark_sink = 0;
+
+int main(int argc, char** argv)
+{
+    // Run the requested command
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "run") return RunBenchmarks(argc, argv);
+    if (command == "compare") return CompareReports(argc, argv);
+
+    PrintHelpMessage();
+    return 0;
+}
+
+// Run the benchmarks of the hot paths on a sequence and save the results as a baseline
+int RunBenchmarks(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Extract the path and the sequence name from the bag file path
+    std::string sequence_dir, sequence_name, extension;
+    bool extracted = alfa::Commons::ExtractFilenameAndExtension(argv[2], sequence_name, extension, sequence_dir);
+    if (!extracted || (extension != "bag"))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    if (sequence_dir.empty() || sequence_dir[sequence_dir.length() - 1] != alfa::Commons::FilePathSeparator)
+        sequence_dir += alfa::Commons::FilePathSeparator;
+
+    // Parse the options
+    int repetitions = 10, warmup_runs = 1;
+    std::string commit, output_dir = ".";
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (i + 1 >= argc)
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--repetitions") parsed = alfa::Commons::StringToInt(value, repetitions);
+        else if (option == "--warmup") parsed = alfa::Commons::StringToInt(value, warmup_runs);
+        else if (option == "--commit") commit = value;
+        else if (option == "--output-dir") output_dir = value;
+        else parsed = false;
+
+        if (!parsed)
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+
+    // Load the sequence once for the cases that do not measure the loading (without printing the errors at every run)
+    std::shared_ptr<alfa::Diagnostics> diagnostics = std::make_shared<alfa::Diagnostics>();
+    diagnostics->SetOutputEnabled(false);
+    alfa::Sequence sequence(sequence_dir, sequence_name, diagnostics);
+    if (!sequence.IsInitialized()) return 1;
+
+    alfa::Benchmark benchmark(repetitions, warmup_runs);
+    long long n_messages = sequence.MessageIndexList.size(), n_values = 0;
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+        n_values += (long long)sequence.Topics[t].Messages.size() * sequence.Topics[t].FieldLabels.size();
+
+    // Loading all the topic files of the sequence
+    benchmark.AddCase("load", [&]()
+    {
+        alfa::Sequence loaded(sequence_dir, sequence_name, diagnostics);
+        benchmark_sink = benchmark_sink + loaded.MessageIndexList.size();
+    }, nullptr, n_messages);
+
+    // Merging the topics into the time-sorted message list
+    benchmark.AddCase("merge", [&]()
+    {
+        sequence.RebuildMessageList();
+        benchmark_sink = benchmark_sink + sequence.MessageIndexList.size();
+    }, nullptr, n_messages);
+
+    // Converting all the fields of all the topics to numbers
+    benchmark.AddCase("accessors", [&]()
+    {
+        for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+            for (int f = 0; f < (int)sequence.Topics[t].FieldLabels.size(); ++f)
+                benchmark_sink = benchmark_sink + sequence.Topics[t].GetFieldsAsDouble(f).size();
+    }, nullptr, n_values);
+
+    // Replaying all the messages of the sequence in the order of their time
+    benchmark.AddCase("replay", [&]()
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < sequence.MessageIndexList.size(); ++i)
+        {
+            const alfa::Message &msg = sequence.GetMessage(i);
+            total += msg.Fields.size() + msg.DateTime.Nanosecond;
+        }
+        benchmark_sink = benchmark_sink + total;
+    }, nullptr, n_messages);
+
+    // Run the cases and save the results
+    alfa::Benchmark::Report report = benchmark.Run(commit, sequence_name, &std::cout);
+
+    // Load the sequence once more with the counters of the load stages of the topics
+    alfa::Topic::SetLoadCountersEnabled(true);
+    alfa::Sequence counted(sequence_dir, sequence_name, diagnostics);
+    alfa::Topic::SetLoadCountersEnabled(false);
+    alfa::PerfCounters::Values read_counters, parse_counters;
+    for (int t = 0; t < (int)counted.Topics.size(); ++t)
+    {
+        read_counters += counted.Topics[t].GetLoadStats().ReadCounters;
+        parse_counters += counted.Topics[t].GetLoadStats().ParseCounters;
+    }
+    std::cout << "Load stages of all the topics (" << n_messages << " rows):" << std::endl;
+    std::cout << "  read           " << read_counters.ToString(n_messages) << std::endl;
+    std::cout << "  parse          " << parse_counters.ToString(n_messages) << std::endl;
+    if (!output_dir.empty() && output_dir[output_dir.length() - 1] != alfa::Commons::FilePathSeparator)
+        output_dir += alfa::Commons::FilePathSeparator;
+    std::string filename = output_dir + alfa::Benchmark::GetReportFilename(report);
+    if (!alfa::Benchmark::SaveReport(report, filename)) return 1;
+
+    std::cout << "Results saved to '" << filename << "'." << std::endl;
+    return 0;
+}
+
+// Compare the current results with a baseline. Returns 1 if there are any regressions.
+int CompareReports(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the threshold of the regressions
+    double threshold = 0.05;
+    if (argc >= 6 && std::string(argv[4]) == "--threshold" && !alfa::Commons::StringToDouble(argv[5], threshold))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the reports
+    alfa::Benchmark::Report baseline, current;
+    if (!alfa::Benchmark::LoadReport(argv[2], baseline) || !alfa::Benchmark::LoadReport(argv[3], current)) return 2;
+
+    // Warn if the results are from different machines, since the times are not comparable
+    if (baseline.Machine != current.Machine)
+        std::cerr << "Warning! The reports are from different machines ('" << baseline.Machine << "' and '" << current.Machine << "')." << std::endl;
+
+    std::cout << "Baseline: " << baseline.Commit << "    Current: " << current.Commit << std::endl;
+    std::vector<alfa::Benchmark::Comparison> comparisons = alfa::Benchmark::Compare(baseline, current, threshold);
+    alfa::Benchmark::PrintComparisons(comparisons);
+
+    return alfa::Benchmark::HasRegressions(comparisons) ? 1 : 0;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./benchmark run path/to/sequence/bagfile.bag [options]" << std::endl;
+    std::cout << "./benchmark compare baseline.json current.json [--threshold <fraction>]" << std::endl;
+    std::cout << "Run options:" << std::endl;
+    std::cout << "  --repetitions <n>    Number of the timed runs of each case (default: 10)" << std::endl;
+    std::cout << "  --warmup <n>         Number of the untimed runs before them (default: 1)" << std::endl;
+    std::cout << "  --commit <id>        Commit of the results (default: the current git commit)" << std::endl;
+    std::cout << "  --output-dir <dir>   Directory of the '<commit>_<machine>.json' result file (default: .)" << std::endl;
+    std::cout << "Compare flags a case as a regression if its whole 95% confidence interval is slower than" << std::endl;
+    std::cout << "the threshold (default: 0.05, i.e. 5%), and returns 1 if there are any regressions." << std::endl;
+}
@@ -0,0 +1,155 @@
+/*  ***************************************************************************
+*   blockstore.cpp - Converts sequences to block files and reads time windows.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <climits>
+#include <cmath>
+#include "block_store.h"
+#include "sequence.h"
+#include "commons.h"
+
+int ConvertSequence(int argc, char** argv);
+int ReadWindow(int argc, char** argv);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Run the requested command
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "convert") return ConvertSequence(argc, argv);
+    if (command == "read") return ReadWindow(argc, argv);
+
+    PrintHelpMessage();
+    return 0;
+}
+
+// Convert a sequence (in CSV files) to a block file
+int ConvertSequence(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Extract the path and the sequence name from the bag file path
+    std::string sequence_dir, sequence_name, extension;
+    bool extracted = alfa::Commons::ExtractFilenameAndExtension(argv[2], sequence_name, extension, sequence_dir);
+    if (!extracted || (extension != "bag"))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    if (sequence_dir.empty() || sequence_dir[sequence_dir.length() - 1] != alfa::Commons::FilePathSeparator)
+        sequence_dir += alfa::Commons::FilePathSeparator;
+
+    // Read the block duration
+    double block_seconds = 10;
+    if (argc >= 6 && std::string(argv[4]) == "--block" && !alfa::Commons::StringToDouble(argv[5], block_seconds))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the sequence and write it to the block file
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized()) return 1;
+    if (!alfa::BlockStore::Convert(sequence, argv[3], block_seconds)) return 1;
+
+    std::cout << "'" << sequence.Name << "' written to '" << argv[3] << "'." << std::endl;
+    return 0;
+}
+
+// Read a time window of a block file and print the number of the messages of each topic
+int ReadWindow(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Parse the options
+    alfa::VecString topic_names;
+    double start = -1, end = -1;
+    int n_threads = 0;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (i + 1 >= argc)
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--topic") topic_names.push_back(value);
+        else if (option == "--start") parsed = alfa::Commons::StringToDouble(value, start) && start >= 0;
+        else if (option == "--end") parsed = alfa::Commons::StringToDouble(value, end) && end >= 0;
+        else if (option == "--threads") parsed = alfa::Commons::StringToInt(value, n_threads);
+        else parsed = false;
+
+        if (!parsed)
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+
+    // Open the block file (only its index is read)
+    alfa::BlockStore store(argv[2]);
+    if (!store.IsInitialized()) return 1;
+
+    // Convert the time window from seconds after the start of the sequence to epoch nanoseconds
+    long long seq_start = store.GetStartTime();
+    long long start_time = start >= 0 ? seq_start + (long long)std::llround(start * 1e9) : LLONG_MIN;
+    long long end_time = end >= 0 ? seq_start + (long long)std::llround(end * 1e9) : LLONG_MAX;
+
+    // Read the window
+    alfa::Sequence sequence;
+    alfa::BlockStore::ReadStats stats;
+    if (!store.ReadSequence(start_time, end_time, sequence, topic_names, n_threads, &stats)) return 1;
+
+    std::cout << "Sequence Name    : " << sequence.Name << std::endl;
+    std::cout << "Total Messages   : " << sequence.MessageIndexList.size() << std::endl;
+    std::cout << "Blocks Read      : " << stats.BlocksRead << " (" << stats.BytesRead << " bytes)" << std::endl;
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+        std::cout << "  " << sequence.Topics[t].Name << ": " << sequence.Topics[t].Messages.size() << " messages" << std::endl;
+    return 0;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./blockstore convert path/to/sequence/bagfile.bag path/to/output.alfab [--block <secs>]" << std::endl;
+    std::cout << "./blockstore read path/to/file.alfab [options]" << std::endl;
+    std::cout << "Read options:" << std::endl;
+    std::cout << "  --topic <name>       Read only this topic (can be repeated; default: all the topics)" << std::endl;
+    std::cout << "  --start <secs>       Start of the time window from the start of the sequence" << std::endl;
+    std::cout << "  --end <secs>         End of the time window from the start of the sequence" << std::endl;
+    std::cout << "  --threads <n>        Number of the decoding threads (default: all the cores)" << std::endl;
+}
@@ -0,0 +1,131 @@
+/*  ***************************************************************************
+*   catalog.cpp - Builds and queries the catalog of an ALFA dataset.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include "catalog.h"
+#include "commons.h"
+#include "trace.h"
+
+bool ParseQuery(int argc, char** argv, alfa::Catalog::Filter &out_filter);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Check the command and the dataset root path
+    if (argc < 3)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    std::string command(argv[1]), root_path(argv[2]);
+
+    // Build the catalog by loading all the sequences once and save it in the dataset root
+    if (command == "build")
+    {
+        // Record the trace of the loading if requested
+        std::string trace_file;
+        if (argc >= 5 && std::string(argv[3]) == "--trace") trace_file = argv[4];
+        if (!trace_file.empty())
+        {
+            alfa::Trace::SetThreadName("main");
+            alfa::Trace::Start();
+        }
+
+        alfa::Catalog catalog;
+        if (!catalog.Build(root_path) || !catalog.Save()) return 1;
+        catalog.PrintBriefInfo();
+
+        if (!trace_file.empty())
+        {
+            alfa::Trace::Stop();
+            if (!alfa::Trace::Save(trace_file)) return 1;
+        }
+        return 0;
+    }
+
+    // Answer a query using only the catalog file
+    if (command == "query")
+    {
+        alfa::Catalog::Filter filter;
+        if (!ParseQuery(argc, argv, filter))
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+
+        alfa::Catalog catalog;
+        if (!catalog.Load(root_path)) return 1;
+
+        std::vector<int> result = catalog.Query(filter);
+        for (int i = 0; i < (int)result.size(); ++i)
+            std::cout << catalog.GetSequenceDirectory(result[i]) << std::endl;
+        return 0;
+    }
+
+    PrintHelpMessage();
+    return 0;
+}
+
+// Parse the query options from the command-line arguments
+bool ParseQuery(int argc, char** argv, alfa::Catalog::Filter &out_filter)
+{
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+
+        // Options without values
+        if (option == "--faulty") { out_filter.Presence = alfa::Catalog::FaultOnly; continue; }
+        if (option == "--normal") { out_filter.Presence = alfa::Catalog::NoFaultOnly; continue; }
+
+        // All the other options need a value
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+        bool parsed = true;
+        if (option == "--fault") out_filter.FaultTypes.push_back(value);
+        else if (option == "--topic") out_filter.RequiredTopics.push_back(value);
+        else if (option == "--min-duration") parsed = alfa::Commons::StringToDouble(value, out_filter.MinDuration);
+        else if (option == "--max-duration") parsed = alfa::Commons::StringToDouble(value, out_filter.MaxDuration);
+        else if (option == "--min-fault-duration") parsed = alfa::Commons::StringToDouble(value, out_filter.MinFaultDuration);
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+    return true;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./catalog build path/to/dataset/root [--trace trace.json]" << std::endl;
+    std::cout << "./catalog query path/to/dataset/root [options]" << std::endl;
+    std::cout << "Query options:" << std::endl;
+    std::cout << "  --faulty | --normal          Only the sequences with (or without) faults" << std::endl;
+    std::cout << "  --fault <type>               Sequence has a fault matching the type (e.g. rudder)" << std::endl;
+    std::cout << "  --topic <name>               Sequence has a topic matching the name (e.g. global_position)" << std::endl;
+    std::cout << "  --min-duration <secs>        Minimum total flight duration" << std::endl;
+    std::cout << "  --max-duration <secs>        Maximum total flight duration" << std::endl;
+    std::cout << "  --min-fault-duration <secs>  Minimum flight duration after the fault" << std::endl;
+}
@@ -0,0 +1,132 @@
+/*  ***************************************************************************
+*   daemon.cpp - Keeps the sequences of a dataset loaded and serves queries.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <csignal>
+#include <atomic>
+#include "dataset_server.h"
+#include "metrics.h"
+#include "commons.h"
+
+bool ParseCommandLine(int argc, char** argv, std::string &out_root_path, alfa::DatasetServer::Options &out_options, bool &out_preload,
+    alfa::MetricsExporter::Options &out_metrics_options);
+void HandleSignal(int);
+void PrintHelpMessage();
+
+// The running server (lock-free, so the signal handler can read it)
+std::atomic<alfa::DatasetServer *> server(nullptr);
+
+int main(int argc, char** argv)
+{
+    // Read the dataset root and the options from the command-line arguments
+    std::string root_path;
+    alfa::DatasetServer::Options options;
+    alfa::MetricsExporter::Options metrics_options;
+    bool preload = false;
+    if (!ParseCommandLine(argc, argv, root_path, options, preload, metrics_options))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the catalog and start listening
+    alfa::DatasetServer dataset_server(options);
+    if (!dataset_server.Open(root_path)) return 1;
+
+    // Export the metrics (if requested) while the daemon runs
+    alfa::MetricsExporter exporter(dataset_server.GetMetrics(), metrics_options);
+    if (!exporter.Start()) return 1;
+    if (preload && !dataset_server.Preload()) std::cerr << "Some of the sequences failed to load." << std::endl;
+
+    // Serve the queries until the daemon is interrupted
+    server = &dataset_server;
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    std::cout << "Serving " << dataset_server.GetCatalog().Entries.size() << " sequences on '" << options.SocketPath << "'." << std::endl;
+    dataset_server.Run();
+    server = nullptr;
+    exporter.Stop();
+    std::cout << "Stopped." << std::endl;
+    return 0;
+}
+
+// Parse command-line arguments
+bool ParseCommandLine(int argc, char** argv, std::string &out_root_path, alfa::DatasetServer::Options &out_options, bool &out_preload,
+    alfa::MetricsExporter::Options &out_metrics_options)
+{
+    if (argc < 2) return false;
+    out_root_path = argv[1];
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "--preload") { out_preload = true; continue; }
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        int shm_threshold = out_options.SharedMemoryThreshold;
+        if (option == "--socket") out_options.SocketPath = value;
+        else if (option == "--max-sequences") parsed = alfa::Commons::StringToInt(value, out_options.MaxLoadedSequences);
+        else if (option == "--threads") parsed = alfa::Commons::StringToInt(value, out_options.NThreads);
+        else if (option == "--max-connections") parsed = alfa::Commons::StringToInt(value, out_options.MaxConnections) &&
+            out_options.MaxConnections >= 0;
+        else if (option == "--shm-threshold") parsed = alfa::Commons::StringToInt(value, shm_threshold) && shm_threshold >= 0;
+        else if (option == "--metrics-port") parsed = alfa::Commons::StringToInt(value, out_metrics_options.HttpPort);
+        else if (option == "--metrics-file") out_metrics_options.Filename = value;
+        else if (option == "--metrics-interval") parsed = alfa::Commons::StringToDouble(value, out_metrics_options.FileInterval) &&
+            out_metrics_options.FileInterval > 0;
+        else parsed = false;
+
+        if (!parsed) return false;
+        out_options.SharedMemoryThreshold = shm_threshold;
+    }
+    return true;
+}
+
+// Stop the daemon on SIGINT and SIGTERM
+void HandleSignal(int)
+{
+    alfa::DatasetServer *running_server = server;
+    if (running_server) running_server->Stop();
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./daemon path/to/dataset/root [options]" << std::endl;
+    std::cout << "Keeps the sequences loaded and answers the queries of './query' and DatasetClient." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --socket <path>           Path of the Unix domain socket (default: /tmp/alfa-dataset.sock)" << std::endl;
+    std::cout << "  --preload                 Load all the sequences at the start (otherwise on their first query)" << std::endl;
+    std::cout << "  --max-sequences <n>       Unload the least recently used sequences beyond n (default: no limit)" << std::endl;
+    std::cout << "  --shm-threshold <bytes>   Pass the larger responses through the shared memory (default: 65536)" << std::endl;
+    std::cout << "  --threads <n>             Threads for building the catalog and preloading (default: all the cores)" << std::endl;
+    std::cout << "  --max-connections <n>     Serve at most n connections at the same time (default: 64, 0 for no limit)" << std::endl;
+    std::cout << "  --metrics-port <port>     Serve the metrics for Prometheus on http://127.0.0.1:<port>/metrics" << std::endl;
+    std::cout << "  --metrics-file <file>     Write the metrics (Prometheus text format) to the file periodically" << std::endl;
+    std::cout << "  --metrics-interval <s>    Seconds between the writes of the metrics file (default: 10)" << std::endl;
+}
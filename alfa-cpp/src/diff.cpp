@@ -0,0 +1,184 @@
+/*  ***************************************************************************
+*   diff.cpp - Compares two versions of a sequence or of the dataset.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include "sequence_diff.h"
+#include "sequence.h"
+#include "catalog.h"
+#include "commons.h"
+
+bool ParseCommandLine(int argc, char** argv, std::string &out_path_a, std::string &out_path_b, alfa::SequenceDiff::Options &out_options);
+int CompareSequences(const std::string &bag_a, const std::string &bag_b, const alfa::SequenceDiff::Options &options);
+int CompareDatasets(std::string root_a, std::string root_b, const alfa::SequenceDiff::Options &options);
+bool SplitBagPath(const std::string &bag_path, std::string &out_sequence_dir, std::string &out_sequence_name);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Parse the command line
+    std::string path_a, path_b;
+    alfa::SequenceDiff::Options options;
+    if (!ParseCommandLine(argc, argv, path_a, path_b, options))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Compare two sequences (given by their bag files) or two dataset roots
+    std::string name, extension, dir;
+    if (alfa::Commons::ExtractFilenameAndExtension(path_a, name, extension, dir) && extension == "bag")
+        return CompareSequences(path_a, path_b, options);
+    return CompareDatasets(path_a, path_b, options);
+}
+
+// Parse the command line. Returns false if it is not valid.
+bool ParseCommandLine(int argc, char** argv, std::string &out_path_a, std::string &out_path_b, alfa::SequenceDiff::Options &out_options)
+{
+    if (argc < 3) return false;
+    out_path_a = argv[1];
+    out_path_b = argv[2];
+
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--tolerance") parsed = alfa::Commons::StringToDouble(value, out_options.Tolerance);
+        else if (option == "--relative-tolerance") parsed = alfa::Commons::StringToDouble(value, out_options.RelativeTolerance);
+        else if (option == "--block") parsed = alfa::Commons::StringToInt(value, out_options.BlockSize) && out_options.BlockSize > 0;
+        else if (option == "--examples") parsed = alfa::Commons::StringToInt(value, out_options.MaxExamples);
+        else if (option == "--threads") parsed = alfa::Commons::StringToInt(value, out_options.NThreads);
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+    return true;
+}
+
+// Compare two sequences. Returns 1 if they are different.
+int CompareSequences(const std::string &bag_a, const std::string &bag_b, const alfa::SequenceDiff::Options &options)
+{
+    std::string dir_a, name_a, dir_b, name_b;
+    if (!SplitBagPath(bag_a, dir_a, name_a) || !SplitBagPath(bag_b, dir_b, name_b))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Load both versions
+    alfa::Sequence sequence_a(dir_a, name_a), sequence_b(dir_b, name_b);
+    if (!sequence_a.IsInitialized() || !sequence_b.IsInitialized()) return 2;
+
+    alfa::SequenceDiff::Result result = alfa::SequenceDiff::Compare(sequence_a, sequence_b, options);
+    alfa::SequenceDiff::PrintReport(result);
+    std::cout << (result.IsSame() ? "The sequences are the same." : "The sequences are different.") << std::endl;
+    return result.IsSame() ? 0 : 1;
+}
+
+// Compare the sequences with the same names under two dataset roots. Returns 1 if there are any differences.
+int CompareDatasets(std::string root_a, std::string root_b, const alfa::SequenceDiff::Options &options)
+{
+    // Add the path separator to the roots
+    if (root_a.empty() || root_a[root_a.length() - 1] != alfa::Commons::FilePathSeparator)
+        root_a += alfa::Commons::FilePathSeparator;
+    if (root_b.empty() || root_b[root_b.length() - 1] != alfa::Commons::FilePathSeparator)
+        root_b += alfa::Commons::FilePathSeparator;
+
+    // Find the sequences of both versions
+    alfa::VecString names_a = alfa::Catalog::FindSequenceNames(root_a), names_b = alfa::Catalog::FindSequenceNames(root_b);
+    if (names_a.empty() && names_b.empty())
+    {
+        std::cerr << "Diff Error! No sequences found in '" << root_a << "' and '" << root_b << "'." << std::endl;
+        return 2;
+    }
+
+    // Report the sequences that are only in one of the versions
+    int n_different = 0;
+    for (int i = 0; i < (int)names_a.size(); ++i)
+        if (!std::binary_search(names_b.begin(), names_b.end(), names_a[i]))
+        {
+            std::cout << "[-] sequence " << names_a[i] << std::endl;
+            n_different++;
+        }
+    for (int i = 0; i < (int)names_b.size(); ++i)
+        if (!std::binary_search(names_a.begin(), names_a.end(), names_b[i]))
+        {
+            std::cout << "[+] sequence " << names_b[i] << std::endl;
+            n_different++;
+        }
+
+    // Compare the sequences that are in both versions (only the changed ones are reported in detail)
+    int n_common = 0;
+    for (int i = 0; i < (int)names_a.size(); ++i)
+    {
+        if (!std::binary_search(names_b.begin(), names_b.end(), names_a[i])) continue;
+        n_common++;
+        std::string sequence_dir = names_a[i] + alfa::Commons::FilePathSeparator;
+        alfa::Sequence sequence_a(root_a + sequence_dir, names_a[i]), sequence_b(root_b + sequence_dir, names_a[i]);
+        if (!sequence_a.IsInitialized() || !sequence_b.IsInitialized())
+        {
+            std::cout << "[!] sequence " << names_a[i] << " could not be loaded" << std::endl;
+            n_different++;
+            continue;
+        }
+        alfa::SequenceDiff::Result result = alfa::SequenceDiff::Compare(sequence_a, sequence_b, options);
+        if (result.IsSame()) continue;
+        std::cout << "[~] sequence " << names_a[i] << std::endl;
+        alfa::SequenceDiff::PrintReport(result);
+        n_different++;
+    }
+
+    std::cout << n_common << " sequences compared, " << n_different << " different." << std::endl;
+    return n_different == 0 ? 0 : 1;
+}
+
+// Extract the directory and the sequence name from the bag file path
+bool SplitBagPath(const std::string &bag_path, std::string &out_sequence_dir, std::string &out_sequence_name)
+{
+    std::string extension;
+    bool extracted = alfa::Commons::ExtractFilenameAndExtension(bag_path, out_sequence_name, extension, out_sequence_dir);
+    if (!extracted || (extension != "bag")) return false;
+    if (out_sequence_dir.empty() || out_sequence_dir[out_sequence_dir.length() - 1] != alfa::Commons::FilePathSeparator)
+        out_sequence_dir += alfa::Commons::FilePathSeparator;
+    return true;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./diff path/to/first/bagfile.bag path/to/second/bagfile.bag [options]" << std::endl;
+    std::cout << "./diff path/to/first/dataset path/to/second/dataset [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --tolerance <x>            Absolute tolerance of the numeric values (default: 0)" << std::endl;
+    std::cout << "  --relative-tolerance <x>   Relative tolerance of the numeric values (default: 0)" << std::endl;
+    std::cout << "  --block <n>                Number of the rows in each hashed block (default: 256)" << std::endl;
+    std::cout << "  --examples <n>             Number of the changed values shown for each topic (default: 3)" << std::endl;
+    std::cout << "  --threads <n>              Number of the threads (default: all the cores)" << std::endl;
+    std::cout << "Returns 1 if there are any differences." << std::endl;
+}
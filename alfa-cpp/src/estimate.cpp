@@ -0,0 +1,149 @@
+/*  ***************************************************************************
+*   estimate.cpp - Estimates the states of the sequences offline.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "state_estimator.h"
+#include "sequence.h"
+#include "commons.h"
+#include "metrics.h"
+
+bool ParseCommandLine(int argc, char** argv, alfa::VecString &out_sequence_dirs, alfa::VecString &out_sequence_names,
+    std::string &out_output_dir, alfa::StateEstimator::Options &out_options, int &out_n_threads,
+    alfa::MetricsExporter::Options &out_metrics_options);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequences and the options from the command-line arguments
+    alfa::VecString sequence_dirs, sequence_names;
+    std::string output_dir;
+    alfa::StateEstimator::Options options;
+    int n_threads = 0;
+    alfa::MetricsExporter::Options metrics_options;
+    if (!ParseCommandLine(argc, argv, sequence_dirs, sequence_names, output_dir, options, n_threads, metrics_options))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the sequences
+    std::vector<alfa::Sequence> sequences(sequence_names.size());
+    for (int i = 0; i < (int)sequences.size(); ++i)
+        if (!sequences[i].LoadSequence(sequence_dirs[i], sequence_names[i])) return 1;
+
+    // Export the metrics of the replay (if requested) while estimating
+    alfa::Metrics metrics;
+    metrics.AddProcessMetrics();
+    alfa::MetricsExporter exporter(metrics, metrics_options);
+    if (!exporter.Start()) return 1;
+
+    // Estimate the states of all the sequences in parallel
+    std::vector<int> estimated = alfa::StateEstimator::EstimateMany(sequences, options, n_threads, &metrics);
+    exporter.Stop();
+
+    // Write the topic of the estimates next to the other topics of each sequence (or to the output directory)
+    for (int i = 0; i < (int)estimated.size(); ++i)
+    {
+        const alfa::Sequence &sequence = sequences[estimated[i]];
+        const alfa::Topic &topic = sequence.Topics[sequence.FindTopicIndex(options.OutputTopic)];
+        std::string filename = (output_dir.empty() ? sequence_dirs[estimated[i]] : output_dir) + sequence.Name + "-" +
+            topic.Name + "." + alfa::Commons::CSVFileExtension;
+        if (!topic.WriteToFile(filename)) return 1;
+        std::cout << filename << " (" << topic.Messages.size() << " estimates)" << std::endl;
+    }
+
+    return estimated.size() == sequences.size() ? 0 : 1;
+}
+
+// Parse command-line arguments. All the arguments before the options are the bag files of the sequences.
+bool ParseCommandLine(int argc, char** argv, alfa::VecString &out_sequence_dirs, alfa::VecString &out_sequence_names,
+    std::string &out_output_dir, alfa::StateEstimator::Options &out_options, int &out_n_threads,
+    alfa::MetricsExporter::Options &out_metrics_options)
+{
+    int i = 1;
+    for (; i < argc && std::string(argv[i]).compare(0, 2, "--") != 0; ++i)
+    {
+        // Extract the path and the sequence name from the bag file path
+        std::string sequence_dir, sequence_name, extension;
+        bool extracted = alfa::Commons::ExtractFilenameAndExtension(argv[i], sequence_name, extension, sequence_dir);
+        if (!extracted || (extension != "bag")) return false;
+        if (sequence_dir.empty() || sequence_dir[sequence_dir.length() - 1] != alfa::Commons::FilePathSeparator)
+            sequence_dir += alfa::Commons::FilePathSeparator;
+        out_sequence_dirs.push_back(sequence_dir);
+        out_sequence_names.push_back(sequence_name);
+    }
+    if (out_sequence_names.empty()) return false;
+
+    for (; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "--no-smoothing") { out_options.Smooth = false; continue; }
+        if (option == "--no-std") { out_options.IncludeStandardDeviations = false; continue; }
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--output-dir") out_output_dir = value;
+        else if (option == "--topic") out_options.OutputTopic = value;
+        else if (option == "--threads") parsed = alfa::Commons::StringToInt(value, out_n_threads);
+        else if (option == "--acceleration-noise") parsed = alfa::Commons::StringToDouble(value, out_options.AccelerationNoise);
+        else if (option == "--gps-noise") parsed = alfa::Commons::StringToDouble(value, out_options.GPSPositionNoise);
+        else if (option == "--airspeed-noise") parsed = alfa::Commons::StringToDouble(value, out_options.AirspeedNoise);
+        else if (option == "--wind-noise") parsed = alfa::Commons::StringToDouble(value, out_options.WindNoise);
+        else if (option == "--metrics-port") parsed = alfa::Commons::StringToInt(value, out_metrics_options.HttpPort);
+        else if (option == "--metrics-file") out_metrics_options.Filename = value;
+        else if (option == "--metrics-interval") parsed = alfa::Commons::StringToDouble(value, out_metrics_options.FileInterval) &&
+            out_metrics_options.FileInterval > 0;
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+
+    if (!out_output_dir.empty() && out_output_dir[out_output_dir.length() - 1] != alfa::Commons::FilePathSeparator)
+        out_output_dir += alfa::Commons::FilePathSeparator;
+    return true;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./estimate path/to/sequence1.bag [path/to/sequence2.bag ...] [options]" << std::endl;
+    std::cout << "Writes the estimated states of each sequence as a topic file ('<sequence>-estimation-state.csv', replacing the file of a previous run)." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --output-dir <dir>          Directory of the topic files (default: the directory of each sequence)" << std::endl;
+    std::cout << "  --topic <name>              Name of the topic of the estimates (default: estimation-state)" << std::endl;
+    std::cout << "  --no-smoothing              Only run the filter (without the backward smoother)" << std::endl;
+    std::cout << "  --no-std                    Do not write the standard deviations of the states" << std::endl;
+    std::cout << "  --threads <n>               Number of the sequences estimated in parallel (default: all the cores)" << std::endl;
+    std::cout << "  --acceleration-noise <x>    Noise density of the accelerations (default: 0.5 m/s^2/sqrt(Hz))" << std::endl;
+    std::cout << "  --gps-noise <x>             Standard deviation of the horizontal GPS positions (default: 2.5 m)" << std::endl;
+    std::cout << "  --airspeed-noise <x>        Standard deviation of the airspeeds (default: 1 m/s)" << std::endl;
+    std::cout << "  --wind-noise <x>            Random walk of the wind (default: 0.05 m/s/sqrt(s))" << std::endl;
+    std::cout << "  --metrics-port <port>       Serve the metrics of the replay for Prometheus on http://127.0.0.1:<port>/metrics" << std::endl;
+    std::cout << "  --metrics-file <file>       Write the metrics of the replay (Prometheus text format) to the file periodically" << std::endl;
+    std::cout << "  --metrics-interval <s>      Seconds between the writes of the metrics file (default: 10)" << std::endl;
+}
@@ -0,0 +1,142 @@
+/*  ***************************************************************************
+*   inject.cpp - Creates synthetic faulty sequences from a normal sequence.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include "fault_injection.h"
+#include "sequence.h"
+#include "commons.h"
+
+bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_path, std::string &out_sequence_name,
+    std::string &out_output_root, std::vector<alfa::FaultInjector::FaultSpec> &out_specs);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence, the output directory and the faults from the command-line arguments
+    std::string sequence_dir, sequence_name, output_root;
+    std::vector<alfa::FaultInjector::FaultSpec> specs;
+    if (!ParseCommandLine(argc, argv, sequence_dir, sequence_name, output_root, specs))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the normal sequence
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized()) return 1;
+
+    // Inject the faults in parallel
+    std::vector<alfa::Sequence> faulty_sequences;
+    std::vector<int> injected = alfa::FaultInjector::InjectMany(sequence, specs, faulty_sequences);
+
+    // Write each faulty sequence in its own directory under the output root
+    if (!output_root.empty() && output_root[output_root.length() - 1] != alfa::Commons::FilePathSeparator)
+        output_root += alfa::Commons::FilePathSeparator;
+    for (int i = 0; i < (int)injected.size(); ++i)
+    {
+        const alfa::Sequence &faulty = faulty_sequences[injected[i]];
+        if (!faulty.SaveSequence(output_root + faulty.Name)) return 1;
+        std::cout << output_root << faulty.Name << std::endl;
+    }
+
+    return injected.size() == specs.size() ? 0 : 1;
+}
+
+// Parse command-line arguments. Creates one fault for each given onset time.
+bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_path, std::string &out_sequence_name,
+    std::string &out_output_root, std::vector<alfa::FaultInjector::FaultSpec> &out_specs)
+{
+    if (argc < 3) return false;
+
+    // Extract the path and the sequence name from the bag file path
+    std::string extension;
+    bool extracted = alfa::Commons::ExtractFilenameAndExtension(argv[1], out_sequence_name, extension, out_sequence_path);
+    if (!extracted || (extension != "bag")) return false;
+    if (out_sequence_path.empty() || out_sequence_path[out_sequence_path.length() - 1] != alfa::Commons::FilePathSeparator)
+        out_sequence_path += alfa::Commons::FilePathSeparator;
+    out_output_root = argv[2];
+
+    // Parse the fault options (all of them need a value)
+    alfa::FaultInjector::FaultSpec spec;
+    alfa::VecString onsets;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--type")
+        {
+            if (value == "stuck") spec.Type = alfa::FaultInjector::StuckSurface;
+            else if (value == "thrust") spec.Type = alfa::FaultInjector::ThrustLoss;
+            else if (value == "bias") spec.Type = alfa::FaultInjector::SensorBias;
+            else parsed = false;
+        }
+        else if (option == "--fault") spec.FaultName = value;
+        else if (option == "--topic") spec.TopicName = value;
+        else if (option == "--field") spec.FieldLabels.push_back(value);
+        else if (option == "--onset") onsets = alfa::Commons::Tokenize(value, ',');
+        else if (option == "--duration") parsed = alfa::Commons::StringToDouble(value, spec.Duration);
+        else if (option == "--magnitude") parsed = alfa::Commons::StringToDouble(value, spec.Magnitude);
+        else if (option == "--status-topic") spec.StatusTopicName = value;
+        else if (option == "--stuck-value")
+        {
+            parsed = alfa::Commons::StringToDouble(value, spec.Magnitude);
+            spec.HoldLastValue = false;
+        }
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+
+    // Check the required options
+    if (spec.FaultName.empty() || spec.TopicName.empty() || spec.FieldLabels.empty() || onsets.empty()) return false;
+
+    // Create a fault for each onset
+    for (int i = 0; i < (int)onsets.size(); ++i)
+    {
+        if (!alfa::Commons::StringToDouble(onsets[i], spec.OnsetTime)) return false;
+        out_specs.push_back(spec);
+    }
+    return true;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./inject path/to/normal/sequence/bagfile.bag path/to/output/root [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --type <stuck|thrust|bias>   Fault effect (default: bias)" << std::endl;
+    std::cout << "  --fault <name>               Fault type in the sequence name (e.g. engine, rudder_right)" << std::endl;
+    std::cout << "  --topic <name>               Topic with the affected fields" << std::endl;
+    std::cout << "  --field <label>              Affected field (can be repeated)" << std::endl;
+    std::cout << "  --onset <secs>[,<secs>...]   Fault onset(s) from the start; one sequence per onset" << std::endl;
+    std::cout << "  --duration <secs>            Fault duration (default: until the end)" << std::endl;
+    std::cout << "  --magnitude <value>          Remaining thrust fraction or sensor bias" << std::endl;
+    std::cout << "  --stuck-value <value>        Stuck surface value (default: the last value before the onset)" << std::endl;
+    std::cout << "  --status-topic <name>        Failure status topic (default: failure_status-<fault>)" << std::endl;
+}
@@ -0,0 +1,151 @@
+/*  ***************************************************************************
+*   latency.cpp - Reports the latency of the message stamps of a sequence.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cmath>
+#include "latency.h"
+#include "sequence.h"
+#include "commons.h"
+
+bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_dir, std::string &out_sequence_name,
+    bool &out_histograms, std::string &out_series_topic, std::string &out_series_filename, double &out_max_offset);
+bool WriteSeries(const alfa::Topic &topic, const alfa::LatencyAnalyzer::TopicLatency &latency, const std::string &filename);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence and the options from the command-line arguments
+    std::string sequence_dir, sequence_name, series_topic, series_filename;
+    bool histograms = false;
+    double max_offset = 1.0;
+    if (!ParseCommandLine(argc, argv, sequence_dir, sequence_name, histograms, series_topic, series_filename, max_offset))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the sequence
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized()) return 1;
+
+    // Report the latency of all the topics
+    std::vector<alfa::LatencyAnalyzer::TopicLatency> latencies = alfa::LatencyAnalyzer::AnalyzeSequence(sequence);
+    alfa::LatencyAnalyzer::PrintReport(latencies, histograms);
+
+    // Report how much the merged message list changes when it is ordered by the header stamps
+    std::vector<alfa::Sequence::MessageIndex> recorded = sequence.MessageIndexList;
+    sequence.SetTimelineMode(alfa::Sequence::HeaderStamp, max_offset);
+    int n_moved = 0, n_fallback = 0;
+    for (size_t i = 0; i < recorded.size(); ++i)
+    {
+        n_moved += !(recorded[i] == sequence.MessageIndexList[i]);
+        n_fallback += sequence.Topics[sequence.MessageIndexList[i].TopicIdx].HasHeaderField() &&
+            sequence.GetTimelineTime(i) != sequence.GetMessage(i).Header.Stamp;
+    }
+    std::cout << "Ordered by the header stamps: " << n_moved << " of " << recorded.size() << " messages change their position, " <<
+        n_fallback << " stamped messages use their recording time (stamp missing or more than " << max_offset << " s away)." << std::endl;
+
+    // Write the latency series of the requested topic
+    if (series_topic.empty()) return 0;
+    int topic_idx = sequence.FindTopicIndex(series_topic);
+    if (topic_idx < 0)
+    {
+        std::cerr << "Latency Error! '" << series_topic << "' topic not found." << std::endl;
+        return 1;
+    }
+    if (!WriteSeries(sequence.Topics[topic_idx], alfa::LatencyAnalyzer::Analyze(sequence.Topics[topic_idx]), series_filename)) return 1;
+    std::cout << "Latency series of '" << series_topic << "' written to '" << series_filename << "'." << std::endl;
+    return 0;
+}
+
+// Parse command-line arguments
+bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_dir, std::string &out_sequence_name,
+    bool &out_histograms, std::string &out_series_topic, std::string &out_series_filename, double &out_max_offset)
+{
+    if (argc < 2) return false;
+
+    // Extract the path and the sequence name from the bag file path
+    std::string extension;
+    bool extracted = alfa::Commons::ExtractFilenameAndExtension(argv[1], out_sequence_name, extension, out_sequence_dir);
+    if (!extracted || (extension != "bag")) return false;
+    if (out_sequence_dir.empty() || out_sequence_dir[out_sequence_dir.length() - 1] != alfa::Commons::FilePathSeparator)
+        out_sequence_dir += alfa::Commons::FilePathSeparator;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "--histogram") { out_histograms = true; continue; }
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--series") out_series_topic = value;
+        else if (option == "-o") out_series_filename = value;
+        else if (option == "--max-offset") parsed = alfa::Commons::StringToDouble(value, out_max_offset);
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+
+    // The series needs an output file
+    return out_series_topic.empty() == out_series_filename.empty();
+}
+
+// Write the recording time, the stamp and the latency of each message of a topic as a CSV file
+bool WriteSeries(const alfa::Topic &topic, const alfa::LatencyAnalyzer::TopicLatency &latency, const std::string &filename)
+{
+    // Open the file
+    std::ofstream ofs(filename);
+
+    // Print an error if file did not open properly
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return false;
+    }
+
+    ofs << "%time,stamp,latency" << std::endl;
+    for (int m = 0; m < (int)latency.Series.size(); ++m)
+    {
+        ofs << topic.Messages[m].DateTime.ToEpochNanoseconds() << alfa::Commons::CSVDelimiter << topic.Messages[m].Header.Stamp <<
+            alfa::Commons::CSVDelimiter;
+        if (!std::isnan(latency.Series[m])) ofs << latency.Series[m];
+        ofs << std::endl;
+    }
+
+    return (bool)ofs;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./latency path/to/sequence/bagfile.bag [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --histogram                       Print the histogram of the latencies of each topic" << std::endl;
+    std::cout << "  --series <topic> -o <file.csv>    Write the latency of each message of the topic" << std::endl;
+    std::cout << "  --max-offset <seconds>            Largest latency of the stamps used for ordering the messages (default: 1)" << std::endl;
+}
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <string>
 #include "sequence.h"
+#include "rle_column.h"
 #include "commons.h"
 
 bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_path, std::string &out_sequence_name);
@@ -84,6 +85,18 @@ int main(int argc, char** argv)
     sequence.Topics[fault_topic_idx].Print(0, 1);
     std::cout << std::endl;
 
+    // Print the intervals in which the first fault topic reports a failure
+    alfa::RLEColumn fault_column(sequence.Topics[fault_topic_idx], "data");
+    for (int i = 0; i < (int)fault_column.Values.size(); ++i)
+    {
+        auto intervals = fault_column.GetIntervals(fault_column.Values[i]);
+        std::cout << "Value '" << fault_column.Values[i] << "' is reported in " << intervals.size() << " interval(s):" << std::endl;
+        for (int j = 0; j < (int)intervals.size(); ++j)
+            std::cout << "  " << alfa::DateTime::EpochNanosecondsToTime(intervals[j].StartTime) << " to " <<
+                alfa::DateTime::EpochNanosecondsToTime(intervals[j].EndTime) << " (" << intervals[j].Length << " messages)" << std::endl;
+    }
+    std::cout << std::endl;
+
     // Retrieve the commanded rolls and its times from 'mavros-nav_info-roll' topic (15 first messages)
     int rolltopic_idx = sequence.FindTopicIndex("mavros-nav_info-roll");
     auto rolls = sequence.Topics[rolltopic_idx].GetFieldsAsDouble("commanded", 0, 15);
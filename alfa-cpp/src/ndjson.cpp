@@ -0,0 +1,141 @@
+/*  ***************************************************************************
+*   ndjson.cpp - Exports a sequence or one of its topics as JSON Lines.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "ndjson_export.h"
+#include "sequence.h"
+#include "commons.h"
+
+bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_path, std::string &out_sequence_name,
+    std::string &out_topic_name, double &out_start, double &out_end, std::string &out_output_file,
+    alfa::NDJSONExporter::Options &out_options);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence, the topic, the time window and the output file from the command-line arguments
+    std::string sequence_dir, sequence_name, topic_name, output_file;
+    double start = -1, end = -1;
+    alfa::NDJSONExporter::Options options;
+    if (!ParseCommandLine(argc, argv, sequence_dir, sequence_name, topic_name, start, end, output_file, options))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the sequence
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized() || sequence.MessageIndexList.empty()) return 1;
+
+    // Convert the time window from seconds after the start of the sequence to epoch nanoseconds
+    const alfa::Sequence::MessageIndex &first = sequence.MessageIndexList.front();
+    long long seq_start = sequence.Topics[first.TopicIdx].Messages[first.MessageIdx].DateTime.ToEpochNanoseconds();
+    if (start >= 0) options.StartTime = seq_start + (long long)std::llround(start * 1e9);
+    if (end >= 0) options.EndTime = seq_start + (long long)std::llround(end * 1e9);
+
+    // Export the topic or the whole sequence
+    alfa::NDJSONExporter exporter(options);
+    long long n_records;
+    if (!topic_name.empty())
+    {
+        int topic_idx = sequence.FindTopicIndex(topic_name);
+        if (topic_idx < 0)
+        {
+            std::cerr << "'" << topic_name << "' topic not found in '" << sequence.Name << "'." << std::endl;
+            return 1;
+        }
+        const alfa::Topic &topic = sequence.Topics[topic_idx];
+        n_records = output_file.empty() ? exporter.ExportTopic(topic, std::cout) : exporter.ExportTopic(topic, output_file);
+    }
+    else
+        n_records = output_file.empty() ? exporter.ExportTimeline(sequence, std::cout) : exporter.ExportTimeline(sequence, output_file);
+
+    if (n_records < 0) return 1;
+    if (!output_file.empty())
+        std::cerr << n_records << " records written to '" << output_file << "'." << std::endl;
+    return 0;
+}
+
+// Parse command-line arguments
+bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_path, std::string &out_sequence_name,
+    std::string &out_topic_name, double &out_start, double &out_end, std::string &out_output_file,
+    alfa::NDJSONExporter::Options &out_options)
+{
+    if (argc < 2) return false;
+
+    // Extract the path and the sequence name from the bag file path
+    std::string extension;
+    bool extracted = alfa::Commons::ExtractFilenameAndExtension(argv[1], out_sequence_name, extension, out_sequence_path);
+    if (!extracted || (extension != "bag")) return false;
+    if (out_sequence_path.empty() || out_sequence_path[out_sequence_path.length() - 1] != alfa::Commons::FilePathSeparator)
+        out_sequence_path += alfa::Commons::FilePathSeparator;
+
+    // Parse the options
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "--strings")
+        {
+            out_options.TypedValues = false;
+            continue;
+        }
+        if (option == "--no-header")
+        {
+            out_options.IncludeHeader = false;
+            continue;
+        }
+
+        // The rest of the options need a value
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--topic") out_topic_name = value;
+        else if (option == "--start") parsed = alfa::Commons::StringToDouble(value, out_start) && out_start >= 0;
+        else if (option == "--end") parsed = alfa::Commons::StringToDouble(value, out_end) && out_end >= 0;
+        else if (option == "-o" || option == "--output") out_output_file = value;
+        else if (option == "--threads") parsed = alfa::Commons::StringToInt(value, out_options.NThreads);
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+    return true;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./ndjson path/to/sequence/bagfile.bag [options]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --topic <name>       Export only this topic (default: all the topics, sorted by time)" << std::endl;
+    std::cout << "  --start <secs>       Start of the time window from the start of the sequence" << std::endl;
+    std::cout << "  --end <secs>         End of the time window from the start of the sequence" << std::endl;
+    std::cout << "  -o <file>            Output file (default: the standard output)" << std::endl;
+    std::cout << "  --threads <n>        Number of the encoding threads (default: all the cores)" << std::endl;
+    std::cout << "  --strings            Write all the field values as strings" << std::endl;
+    std::cout << "  --no-header          Do not write the message headers" << std::endl;
+}
@@ -0,0 +1,244 @@
+/*  ***************************************************************************
+*   query.cpp - Queries the sequences kept loaded by the dataset daemon.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include "dataset_client.h"
+#include "catalog.h"
+#include "commons.h"
+
+bool ParseFilter(int argc, char** argv, int start, alfa::Catalog::Filter &out_filter);
+bool ParseRows(int argc, char** argv, int start, alfa::DatasetProtocol::RequestType &out_type, long long &out_first, long long &out_second);
+void PrintRows(const alfa::DatasetClient::Rows &rows, const alfa::VecString &field_labels);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the socket path and the command
+    std::string socket_path = alfa::DatasetProtocol::DefaultSocketPath;
+    int arg = 1;
+    if (argc > 2 && std::string(argv[1]) == "--socket")
+    {
+        socket_path = argv[2];
+        arg = 3;
+    }
+    if (arg >= argc)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    std::string command(argv[arg++]);
+
+    // Connect to the daemon
+    alfa::DatasetClient client;
+    if (!client.Connect(socket_path))
+    {
+        std::cerr << client.GetLastError() << std::endl;
+        return 1;
+    }
+
+    // List the sequences that match the catalog filter
+    if (command == "list")
+    {
+        alfa::Catalog::Filter filter;
+        std::vector<alfa::Catalog::Entry> entries;
+        if (!ParseFilter(argc, argv, arg, filter))
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+        if (!client.ListSequences(filter, entries))
+        {
+            std::cerr << client.GetLastError() << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < (int)entries.size(); ++i)
+            std::cout << entries[i].Name << " (" << entries[i].TotalDuration << " s, " << entries[i].Topics.size() << " topics)" << std::endl;
+        return 0;
+    }
+
+    // Print the topics of a sequence
+    if (command == "info" && arg + 1 == argc)
+    {
+        alfa::RemoteSequence sequence;
+        if (!client.OpenSequence(argv[arg], sequence))
+        {
+            std::cerr << client.GetLastError() << std::endl;
+            return 1;
+        }
+        for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+        {
+            const alfa::RemoteTopic &topic = sequence.Topics[t];
+            std::cout << topic.Name << " (" << topic.MessageCount << " messages, " << (topic.EndTime - topic.StartTime) * 1e-9 << " s):";
+            for (int f = 0; f < (int)topic.FieldLabels.size(); ++f)
+                std::cout << " " << topic.FieldLabels[f];
+            std::cout << std::endl;
+        }
+        return 0;
+    }
+
+    // Print the rows of some fields of a topic
+    if (command == "rows" && arg + 3 <= argc)
+    {
+        std::string sequence_name(argv[arg]), topic_name(argv[arg + 1]);
+        alfa::VecString field_labels = alfa::Commons::Tokenize(argv[arg + 2], ',');
+        alfa::DatasetProtocol::RequestType type;
+        long long first, second;
+        if (!ParseRows(argc, argv, arg + 3, type, first, second))
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+
+        alfa::DatasetClient::Rows rows;
+        bool received = type == alfa::DatasetProtocol::GetRowSlice ? client.GetRowSlice(sequence_name, topic_name, field_labels, first, second, rows) :
+            type == alfa::DatasetProtocol::GetTimeRange ? client.GetTimeRange(sequence_name, topic_name, field_labels, first, second, rows) :
+            client.GetWindow(sequence_name, topic_name, field_labels, first, second, rows);
+        if (!received)
+        {
+            std::cerr << client.GetLastError() << std::endl;
+            return 1;
+        }
+        PrintRows(rows, field_labels);
+        return 0;
+    }
+
+    // Print the statistics of the daemon
+    if (command == "stats")
+    {
+        std::vector<std::pair<std::string, unsigned long long> > stats;
+        if (!client.GetStats(stats))
+        {
+            std::cerr << client.GetLastError() << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < (int)stats.size(); ++i)
+            std::cout << stats[i].first << ": " << stats[i].second << std::endl;
+        return 0;
+    }
+
+    PrintHelpMessage();
+    return 0;
+}
+
+// Parse the catalog filter options from the command-line arguments
+bool ParseFilter(int argc, char** argv, int start, alfa::Catalog::Filter &out_filter)
+{
+    for (int i = start; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+
+        // Options without values
+        if (option == "--faulty") { out_filter.Presence = alfa::Catalog::FaultOnly; continue; }
+        if (option == "--normal") { out_filter.Presence = alfa::Catalog::NoFaultOnly; continue; }
+
+        // All the other options need a value
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+        bool parsed = true;
+        if (option == "--fault") out_filter.FaultTypes.push_back(value);
+        else if (option == "--topic") out_filter.RequiredTopics.push_back(value);
+        else if (option == "--min-duration") parsed = alfa::Commons::StringToDouble(value, out_filter.MinDuration);
+        else if (option == "--max-duration") parsed = alfa::Commons::StringToDouble(value, out_filter.MaxDuration);
+        else if (option == "--min-fault-duration") parsed = alfa::Commons::StringToDouble(value, out_filter.MinFaultDuration);
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+    return true;
+}
+
+// Parse the selection of the rows (all the rows if not given)
+bool ParseRows(int argc, char** argv, int start, alfa::DatasetProtocol::RequestType &out_type, long long &out_first, long long &out_second)
+{
+    out_type = alfa::DatasetProtocol::GetRowSlice;
+    out_first = 0;
+    out_second = -1;
+    if (start == argc) return true;
+    if (start + 3 != argc) return false;
+
+    std::string option(argv[start]);
+    if (option == "--rows") out_type = alfa::DatasetProtocol::GetRowSlice;
+    else if (option == "--time-range") out_type = alfa::DatasetProtocol::GetTimeRange;
+    else if (option == "--window") out_type = alfa::DatasetProtocol::GetWindow;
+    else return false;
+
+    // The times are given in epoch nanoseconds
+    try
+    {
+        size_t first_end, second_end;
+        out_first = std::stoll(argv[start + 1], &first_end);
+        out_second = std::stoll(argv[start + 2], &second_end);
+        return argv[start + 1][first_end] == '\0' && argv[start + 2][second_end] == '\0';
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+// Print the rows as CSV lines with their row index and recording time
+void PrintRows(const alfa::DatasetClient::Rows &rows, const alfa::VecString &field_labels)
+{
+    std::cout << "row,%time";
+    for (int f = 0; f < (int)field_labels.size(); ++f)
+        std::cout << alfa::Commons::CSVDelimiter << field_labels[f];
+    std::cout << std::endl;
+
+    std::cout.precision(std::numeric_limits<double>::digits10);
+    for (long long r = 0; r < rows.NRows; ++r)
+    {
+        std::cout << rows.FirstRow + r << alfa::Commons::CSVDelimiter << rows.Times[r];
+        for (int f = 0; f < rows.NFields; ++f)
+        {
+            std::cout << alfa::Commons::CSVDelimiter;
+            if (!std::isnan(rows.GetColumn(f)[r])) std::cout << rows.GetColumn(f)[r];
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./query [--socket path] list [catalog filter options]" << std::endl;
+    std::cout << "./query [--socket path] info <sequence>" << std::endl;
+    std::cout << "./query [--socket path] rows <sequence> <topic> <field1,field2,...> [selection]" << std::endl;
+    std::cout << "./query [--socket path] stats" << std::endl;
+    std::cout << "Catalog filter options (as in './catalog query'):" << std::endl;
+    std::cout << "  --faulty | --normal          Only the sequences with (or without) faults" << std::endl;
+    std::cout << "  --fault <type>               Sequence has a fault matching the type (e.g. rudder)" << std::endl;
+    std::cout << "  --topic <name>               Sequence has a topic matching the name (e.g. global_position)" << std::endl;
+    std::cout << "  --min-duration <secs>        Minimum total flight duration" << std::endl;
+    std::cout << "  --max-duration <secs>        Maximum total flight duration" << std::endl;
+    std::cout << "  --min-fault-duration <secs>  Minimum flight duration after the fault" << std::endl;
+    std::cout << "Row selection (all the rows if not given, times in epoch nanoseconds):" << std::endl;
+    std::cout << "  --rows <start> <count>       Rows by their index (negative count for all the rest)" << std::endl;
+    std::cout << "  --time-range <start> <end>   Rows recorded in [start, end)" << std::endl;
+    std::cout << "  --window <start> <count>     Rows from the first one recorded at or after the start" << std::endl;
+}
@@ -0,0 +1,140 @@
+/*  ***************************************************************************
+*   roc.cpp - Evaluates the anomaly scores of a detector over all thresholds.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "roc.h"
+#include "catalog.h"
+#include "topic.h"
+#include "commons.h"
+
+bool ParseCommandLine(int argc, char** argv, std::string &out_root_path, std::string &out_topic_name, std::string &out_field_label,
+    std::string &out_output_prefix, bool &out_per_sequence, alfa::ROCAnalyzer::Options &out_options, int &out_n_threads);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the dataset root, the topic of the scores and the options from the command-line arguments
+    std::string root_path, topic_name, field_label, output_prefix;
+    bool per_sequence = false;
+    alfa::ROCAnalyzer::Options options;
+    int n_threads = 0;
+    if (!ParseCommandLine(argc, argv, root_path, topic_name, field_label, output_prefix, per_sequence, options, n_threads))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the catalog (for the fault onsets) or build it if the dataset root does not have one
+    alfa::Catalog catalog;
+    bool has_catalog = std::ifstream(root_path + alfa::Catalog::DefaultFileName).good();
+    if (!(has_catalog ? catalog.Load(root_path) : catalog.Build(root_path, n_threads))) return 1;
+
+    // Read the scores topic of each sequence (the sequences without the topic are skipped)
+    std::vector<alfa::ROCAnalyzer::SequenceScores> sequences(catalog.Entries.size());
+    std::vector<char> loaded(sequences.size(), 0);
+    alfa::Commons::ParallelFor(sequences.size(), n_threads, [&](int i)
+    {
+        const alfa::Catalog::Entry &entry = catalog.Entries[i];
+        std::string filename = catalog.GetSequenceDirectory(i) + entry.Name + "-" + topic_name + "." + alfa::Commons::CSVFileExtension;
+        if (!std::ifstream(filename).good()) return;
+        alfa::Topic topic(filename, topic_name);
+        sequences[i].Name = entry.Name;
+        loaded[i] = topic.IsInitialized() && alfa::ROCAnalyzer::ReadScores(topic, field_label, entry.FaultOnset, sequences[i]);
+    });
+    std::vector<alfa::ROCAnalyzer::SequenceScores> scored;
+    for (int i = 0; i < (int)sequences.size(); ++i)
+    {
+        if (loaded[i]) scored.push_back(sequences[i]);
+        else std::cerr << "Skipped '" << catalog.Entries[i].Name << "' (no readable '" << topic_name << "' topic)." << std::endl;
+    }
+    if (scored.empty())
+    {
+        std::cerr << "No sequence has the '" << topic_name << "' topic." << std::endl;
+        return 1;
+    }
+
+    // Evaluate each sequence and all the sequences together
+    if (per_sequence)
+    {
+        std::vector<alfa::ROCAnalyzer::Result> results = alfa::ROCAnalyzer::EvaluateEach(scored, options, n_threads);
+        for (int i = 0; i < (int)results.size(); ++i)
+            alfa::ROCAnalyzer::PrintReport(results[i]);
+    }
+    alfa::ROCAnalyzer::Result result = alfa::ROCAnalyzer::Evaluate(scored, options);
+    alfa::ROCAnalyzer::PrintReport(result);
+
+    // Write the curves of all the sequences
+    if (output_prefix.empty()) return 0;
+    if (!alfa::ROCAnalyzer::WriteCurves(result, output_prefix + "-roc.csv", output_prefix + "-delay.csv")) return 1;
+    std::cout << "Curves written to '" << output_prefix << "-roc.csv' and '" << output_prefix << "-delay.csv'." << std::endl;
+    return 0;
+}
+
+// Parse command-line arguments
+bool ParseCommandLine(int argc, char** argv, std::string &out_root_path, std::string &out_topic_name, std::string &out_field_label,
+    std::string &out_output_prefix, bool &out_per_sequence, alfa::ROCAnalyzer::Options &out_options, int &out_n_threads)
+{
+    if (argc < 2) return false;
+    out_root_path = argv[1];
+    if (out_root_path[out_root_path.length() - 1] != alfa::Commons::FilePathSeparator)
+        out_root_path += alfa::Commons::FilePathSeparator;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "--per-sequence") { out_per_sequence = true; continue; }
+        if (i + 1 >= argc) return false;
+        std::string value(argv[++i]);
+
+        bool parsed = true;
+        if (option == "--topic") out_topic_name = value;
+        else if (option == "--field") out_field_label = value;
+        else if (option == "-o") out_output_prefix = value;
+        else if (option == "--max-delay") parsed = alfa::Commons::StringToDouble(value, out_options.MaxDelay);
+        else if (option == "--threads") parsed = alfa::Commons::StringToInt(value, out_n_threads);
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+
+    // The scores topic is required
+    return !out_topic_name.empty();
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./roc path/to/dataset/root --topic <name> [options]" << std::endl;
+    std::cout << "Evaluates the anomaly scores written by a detector as a topic of each sequence ('<sequence>-<name>.csv')." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --field <label>       Field of the scores (default: the first field of the topic)" << std::endl;
+    std::cout << "  --max-delay <secs>    Detections later than this after the fault onset are missed (default: no limit)" << std::endl;
+    std::cout << "  --per-sequence        Also report each sequence separately" << std::endl;
+    std::cout << "  -o <prefix>           Write the curves to '<prefix>-roc.csv' and '<prefix>-delay.csv'" << std::endl;
+    std::cout << "  --threads <n>         Number of the sequences read in parallel (default: all the cores)" << std::endl;
+}
@@ -0,0 +1,99 @@
+/*  ***************************************************************************
+*   block_store_times.cpp - Checks that a sequence converted to a block file
+*   reads back with the exact recorded times and the same fields.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <climits>
+#include "sequence.h"
+#include "block_store.h"
+
+int main(int argc, char** argv)
+{
+    // Read the fixture sequence from the command-line arguments
+    if (argc < 3)
+    {
+        std::cout << "Usage: ./test_block_store_times path/to/sequence/directory/ sequence_name" << std::endl;
+        return 1;
+    }
+    std::string sequence_dir(argv[1]), sequence_name(argv[2]);
+
+    // The results must not depend on the time zone of the machine
+#if !(defined _WIN32 || defined __CYGWIN__)
+    setenv("TZ", "America/New_York", 1);
+    tzset();
+#endif
+
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized() || sequence.Topics.empty())
+    {
+        std::cout << "FAILED: the fixture sequence did not load." << std::endl;
+        return 1;
+    }
+
+    // Convert the sequence and open the block file (in the working directory)
+    const std::string filename = sequence_name + ".alfab";
+    alfa::BlockStore store;
+    if (!alfa::BlockStore::Convert(sequence, filename, 1) || !store.Open(filename))
+    {
+        std::cout << "FAILED: the block file could not be written or opened." << std::endl;
+        return 1;
+    }
+
+    // Every topic reads back with the same epoch times (to the nanosecond), date-time fields and data fields
+    int n_failures = 0;
+    long long n_messages = 0;
+    for (const alfa::Topic &topic : sequence.Topics)
+    {
+        alfa::Topic read_topic;
+        if (!store.ReadTopic(topic.Name, LLONG_MIN, LLONG_MAX, read_topic, 2) || read_topic.Messages.size() != topic.Messages.size())
+        {
+            std::cout << "FAILED: '" << topic.Name << "' did not read back with " << topic.Messages.size() << " messages." << std::endl;
+            n_failures++;
+            continue;
+        }
+        for (size_t m = 0; m < topic.Messages.size(); ++m)
+        {
+            const alfa::Message &original = topic.Messages[m], &read = read_topic.Messages[m];
+            if (read.DateTime.ToEpochNanoseconds() != original.DateTime.ToEpochNanoseconds() ||
+                read.DateTime.ToString() != original.DateTime.ToString() || read.Fields != original.Fields)
+            {
+                std::cout << "FAILED: message " << m << " of '" << topic.Name << "' read back as " << read.DateTime <<
+                    " (recorded " << original.DateTime << ")." << std::endl;
+                n_failures++;
+                break;
+            }
+        }
+        n_messages += topic.Messages.size();
+    }
+    std::remove(filename.c_str());
+
+    std::cout << "Topics: " << sequence.Topics.size() << ", messages: " << n_messages << std::endl;
+    if (n_failures > 0) return 1;
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+/*  ***************************************************************************
+*   epoch_times.cpp - Checks that the recorded times of the messages keep
+*   their exact epoch, also in the repeated hour of a daylight saving change.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <ctime>
+#include "commons.h"
+
+int n_failures = 0;
+
+// Check that an epoch is converted to the expected date-time and back to the same epoch
+void CheckEpoch(long long epoch_ns, const std::string &expected)
+{
+    alfa::DateTime dt = alfa::DateTime::EpochNanosecondsToTime(epoch_ns);
+    if (dt.ToString() != expected || dt.ToEpochNanoseconds() != epoch_ns)
+    {
+        std::cout << "FAILED: " << epoch_ns << " -> " << dt << " -> " << dt.ToEpochNanoseconds() << " (expected " << expected << ")" << std::endl;
+        n_failures++;
+    }
+}
+
+int main()
+{
+    // The results must not depend on the time zone of the machine (this one repeats 01:00-02:00 on 2018/11/04)
+#if !(defined _WIN32 || defined __CYGWIN__)
+    setenv("TZ", "America/New_York", 1);
+    tzset();
+#endif
+
+    // The two times 30 minutes after 01:00 in New York on 2018/11/04 (before and after the clock goes back)
+    const long long first_ns = 1541309400LL * 1000000000LL + 123456789;
+    const long long second_ns = first_ns + 3600LL * 1000000000LL;
+    CheckEpoch(first_ns, "2018/11/04 05:30:00.123456789");
+    CheckEpoch(second_ns, "2018/11/04 06:30:00.123456789");
+    alfa::DateTime first = alfa::DateTime::EpochNanosecondsToTime(first_ns);
+    alfa::DateTime second = alfa::DateTime::EpochNanosecondsToTime(second_ns);
+    if (!(first < second) || second - first != 3600)
+    {
+        std::cout << "FAILED: the two times are not 3600 seconds apart in order." << std::endl;
+        n_failures++;
+    }
+
+    // The epoch itself, a leap day, the end of a year and a time before 1970
+    CheckEpoch(0, "1970/01/01 00:00:00.000000000");
+    CheckEpoch(951782400LL * 1000000000LL, "2000/02/29 00:00:00.000000000");
+    CheckEpoch(1546300799LL * 1000000000LL + 999999999, "2018/12/31 23:59:59.999999999");
+    CheckEpoch(-1, "1969/12/31 23:59:59.999999999");
+
+    // The fields out of their ranges are carried over
+    alfa::DateTime carried;
+    carried.Year = 2018; carried.Month = 13; carried.Day = 1;
+    if (carried.ToEpochNanoseconds() != 1546300800LL * 1000000000LL)
+    {
+        std::cout << "FAILED: month 13 of 2018 is not January of 2019." << std::endl;
+        n_failures++;
+    }
+
+    if (n_failures > 0) return 1;
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
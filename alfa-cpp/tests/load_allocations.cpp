@@ -0,0 +1,90 @@
+/*  ***************************************************************************
+*   load_allocations.cpp - Checks that loading a sequence does not copy the
+*   parsed topics and messages, by counting the heap allocations.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "sequence.h"
+
+// Counters of the heap allocations (all the threads)
+std::atomic<long long> n_allocations(0);
+std::atomic<long long> n_live_blocks(0);
+
+// Replace the global allocation functions with the counting ones
+void *operator new(std::size_t size)
+{
+    void *ptr = std::malloc(size ? size : 1);
+    if (ptr == NULL) throw std::bad_alloc();
+    n_allocations++;
+    n_live_blocks++;
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (ptr == NULL) return;
+    n_live_blocks--;
+    std::free(ptr);
+}
+
+int main(int argc, char** argv)
+{
+    // Read the fixture sequence from the command-line arguments
+    if (argc < 3)
+    {
+        std::cout << "Usage: ./test_load_allocations path/to/sequence/directory/ sequence_name" << std::endl;
+        return 1;
+    }
+    std::string sequence_dir(argv[1]), sequence_name(argv[2]);
+
+    // Count the allocations of loading the sequence and the blocks that it still holds afterwards
+    alfa::Sequence sequence;
+    long long allocations_before = n_allocations, live_before = n_live_blocks;
+    bool loaded = sequence.LoadSequence(sequence_dir, sequence_name);
+    long long n_load_allocations = n_allocations - allocations_before;
+    long long n_kept_blocks = n_live_blocks - live_before;
+    if (!loaded || sequence.Topics.empty())
+    {
+        std::cout << "FAILED: the fixture sequence did not load." << std::endl;
+        return 1;
+    }
+
+    // Every kept block (message fields, long strings, etc.) is allocated once for the result and at most once more for
+    // the tokens it is parsed from; the rest is a small fixed cost per topic (file content, labels, maps, etc.).
+    // Copying the topics or the messages would allocate all their blocks again and exceed the bound.
+    long long bound = 2 * n_kept_blocks + 64 * (long long)sequence.Topics.size() + 256;
+    std::cout << "Messages: " << sequence.MessageIndexList.size() << ", allocations: " << n_load_allocations <<
+        ", kept blocks: " << n_kept_blocks << ", bound: " << bound << std::endl;
+    if (n_load_allocations > bound)
+    {
+        std::cout << "FAILED: loading the sequence allocated more than the bound (the loaded data is copied)." << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*  ***************************************************************************
+*   state_estimator.cpp - Checks the fixed-size matrices and the state
+*   estimator against hand-computed values: the inverse of a matrix, the
+*   covariance of a GPS update and a constant-velocity trajectory.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "commons.h"
+#include "sequence.h"
+#include "fixed_matrix.h"
+#include "state_estimator.h"
+
+int n_failures = 0;
+
+// Check that a value is within the tolerance of the expected one
+void CheckValue(const std::string &name, double value, double expected, double tolerance)
+{
+    if (!(std::fabs(value - expected) <= tolerance))
+    {
+        std::cout << "FAILED: " << name << " is " << value << " (expected " << expected << " +- " << tolerance << ")" << std::endl;
+        n_failures++;
+    }
+}
+
+// Read a field of the estimates topic as a number
+double GetEstimate(const alfa::Topic &topic, int msg_idx, const std::string &label)
+{
+    double value = NAN;
+    int field_idx = topic.FindLabelIndex(label);
+    if (field_idx >= 0) alfa::Commons::StringToDouble(topic.Messages[msg_idx].Fields[field_idx], value);
+    return value;
+}
+
+// Add a message with the given time (in seconds) and fields to a topic
+void AddMessage(alfa::Topic &topic, double seconds, const std::vector<double> &values)
+{
+    alfa::Message msg;
+    msg.DateTime = alfa::DateTime::EpochNanosecondsToTime(1531943617LL * 1000000000LL + (long long)std::llround(seconds * 1e9));
+    for (size_t i = 0; i < values.size(); ++i)
+        msg.Fields.push_back(alfa::Commons::DoubleToString(values[i]));
+    topic.AddMessage(msg);
+}
+
+// Create a sequence of a level aircraft flying east at a constant velocity (on the equator, so one degree of
+// longitude is the same length as one of latitude). The IMU reports only the gravity (no acceleration), and its
+// first message is before the first GPS fix (which starts the filter).
+alfa::Sequence CreateConstantVelocitySequence(double velocity, double duration, double gps_period)
+{
+    const double earth_radius = 6378137, degree = M_PI / 180, gravity = 9.80665, altitude = 100;
+    alfa::Topic imu, gps, gps_velocity;
+    imu.Create("mavros-imu-data", { "linear_acceleration.x", "linear_acceleration.y", "linear_acceleration.z" });
+    gps.Create("mavros-global_position-global", { "latitude", "longitude", "altitude" });
+    gps_velocity.Create("mavros-global_position-raw-gps_vel", { "twist.linear.x", "twist.linear.y", "twist.linear.z" });
+    for (int i = 0; i * 0.02 <= duration; ++i)
+        AddMessage(imu, i * 0.02 - 0.01, { 0, 0, gravity });
+    for (int i = 0; i * gps_period <= duration; ++i)
+    {
+        AddMessage(gps, i * gps_period, { 0, velocity * i * gps_period / earth_radius / degree, altitude });
+        AddMessage(gps_velocity, i * gps_period, { velocity, 0, 0 });
+    }
+
+    alfa::Sequence sequence;
+    sequence.Name = "constant_velocity";
+    sequence.AddTopic(imu);
+    sequence.AddTopic(gps);
+    sequence.AddTopic(gps_velocity);
+    return sequence;
+}
+
+int main()
+{
+    // Inverse of [4 7; 2 6] (the determinant is 10) is [0.6 -0.7; -0.2 0.4], and their product is the identity
+    alfa::FixedMatrix<2, 2> matrix, inverse;
+    matrix(0, 0) = 4; matrix(0, 1) = 7; matrix(1, 0) = 2; matrix(1, 1) = 6;
+    if (!matrix.Inverse(inverse))
+    {
+        std::cout << "FAILED: [4 7; 2 6] was not inverted." << std::endl;
+        n_failures++;
+    }
+    CheckValue("inverse(0, 0)", inverse(0, 0), 0.6, 1e-12);
+    CheckValue("inverse(0, 1)", inverse(0, 1), -0.7, 1e-12);
+    CheckValue("inverse(1, 0)", inverse(1, 0), -0.2, 1e-12);
+    CheckValue("inverse(1, 1)", inverse(1, 1), 0.4, 1e-12);
+    alfa::FixedMatrix<2, 2> product = matrix * inverse;
+    for (int i = 0; i < 4; ++i)
+        CheckValue("(matrix * inverse)" + std::to_string(i), product.Data[i], i % 3 == 0 ? 1 : 0, 1e-12);
+    alfa::FixedMatrix<2, 2> singular = matrix;
+    singular(1, 0) = 8; singular(1, 1) = 14;
+    if (singular.Inverse(inverse))
+    {
+        std::cout << "FAILED: [4 7; 8 14] was inverted." << std::endl;
+        n_failures++;
+    }
+
+    // A second GPS fix at the time of the first one (so there is no prediction) 2 m east and 4 m up. The variances
+    // of the position are the ones of the fix, so the gain is 1/2: the position moves half way to the fix and the
+    // variances are halved (the Joseph form gives (1 - 1/2)^2 s^2 + (1/2)^2 s^2 = s^2 / 2).
+    {
+        alfa::StateEstimator::Options options;
+        options.Smooth = false;
+        const double earth_radius = 6378137, degree = M_PI / 180;
+        alfa::Topic imu, gps;
+        imu.Create("mavros-imu-data", { "linear_acceleration.x", "linear_acceleration.y", "linear_acceleration.z" });
+        gps.Create("mavros-global_position-global", { "latitude", "longitude", "altitude" });
+        AddMessage(imu, -0.01, { 0, 0, 9.80665 });
+        AddMessage(gps, 0, { 0, 0, 100 });
+        AddMessage(gps, 0, { 0, 2 / earth_radius / degree, 104 });
+        alfa::Sequence sequence;
+        sequence.Name = "gps_update";
+        sequence.AddTopic(imu);
+        sequence.AddTopic(gps);
+
+        alfa::Topic estimates;
+        if (!alfa::StateEstimator::Estimate(sequence, options, estimates) || estimates.Messages.size() != 2)
+        {
+            std::cout << "FAILED: the GPS update sequence was not estimated with 2 steps." << std::endl;
+            return 1;
+        }
+        CheckValue("updated position.x", GetEstimate(estimates, 1, "position.x"), 1, 1e-9);
+        CheckValue("updated position.y", GetEstimate(estimates, 1, "position.y"), 0, 1e-9);
+        CheckValue("updated position.z", GetEstimate(estimates, 1, "position.z"), 2, 1e-9);
+        CheckValue("initial position.x_std", GetEstimate(estimates, 0, "position.x_std"), options.GPSPositionNoise, 1e-9);
+        CheckValue("updated position.x_std", GetEstimate(estimates, 1, "position.x_std"), options.GPSPositionNoise / std::sqrt(2.0), 1e-9);
+        CheckValue("updated position.y_std", GetEstimate(estimates, 1, "position.y_std"), options.GPSPositionNoise / std::sqrt(2.0), 1e-9);
+        CheckValue("updated position.z_std", GetEstimate(estimates, 1, "position.z_std"), options.GPSAltitudeNoise / std::sqrt(2.0), 1e-9);
+        CheckValue("updated velocity.x_std", GetEstimate(estimates, 1, "velocity.x_std"), options.InitialVelocityNoise, 1e-9);
+    }
+
+    // A constant velocity of 15 m/s east for a minute with a GPS fix (and velocity) every 0.2 seconds. The estimates
+    // follow the trajectory (x = 15 t, level and at a constant altitude) within the noise of the filter.
+    {
+        const double velocity = 15, duration = 60;
+        alfa::Sequence sequence = CreateConstantVelocitySequence(velocity, duration, 0.2);
+        for (int smooth = 0; smooth < 2; ++smooth)
+        {
+            alfa::StateEstimator::Options options;
+            options.Smooth = smooth == 1;
+            alfa::Topic estimates;
+            if (!alfa::StateEstimator::Estimate(sequence, options, estimates) || estimates.Messages.empty())
+            {
+                std::cout << "FAILED: the constant-velocity sequence was not estimated." << std::endl;
+                return 1;
+            }
+            const std::string mode = options.Smooth ? " (smoothed)" : " (filtered)";
+            const int last = estimates.Messages.size() - 1;
+            for (int m = last / 2; m <= last; m += last / 4)
+            {
+                double t = (estimates.Messages[m].DateTime - estimates.Messages[0].DateTime);
+                CheckValue("position.x at " + std::to_string(t) + mode, GetEstimate(estimates, m, "position.x"), velocity * t, 0.5);
+                CheckValue("position.y at " + std::to_string(t) + mode, GetEstimate(estimates, m, "position.y"), 0, 0.5);
+                CheckValue("position.z at " + std::to_string(t) + mode, GetEstimate(estimates, m, "position.z"), 0, 0.5);
+                CheckValue("velocity.x at " + std::to_string(t) + mode, GetEstimate(estimates, m, "velocity.x"), velocity, 0.05);
+                CheckValue("velocity.y at " + std::to_string(t) + mode, GetEstimate(estimates, m, "velocity.y"), 0, 0.05);
+                CheckValue("velocity.z at " + std::to_string(t) + mode, GetEstimate(estimates, m, "velocity.z"), 0, 0.05);
+                CheckValue("roll at " + std::to_string(t) + mode, GetEstimate(estimates, m, "roll"), 0, 1e-3);
+                CheckValue("pitch at " + std::to_string(t) + mode, GetEstimate(estimates, m, "pitch"), 0, 1e-3);
+            }
+        }
+    }
+
+    if (n_failures > 0) return 1;
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*  ***************************************************************************
+*   timeline_durations.cpp - Checks the durations and the first fault of a
+*   sequence in both timeline modes, with header stamps that reorder the
+*   messages against their recording times.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "sequence.h"
+
+int n_failures = 0;
+
+// Check that a duration is the expected one (to the nanosecond)
+void CheckDuration(const std::string &name, double duration, double expected)
+{
+    if (std::fabs(duration - expected) > 1e-9)
+    {
+        std::cout << "FAILED: " << name << " is " << duration << " secs (expected " << expected << ")" << std::endl;
+        n_failures++;
+    }
+}
+
+// Add a message recorded at the given time (in seconds) with the given header stamp (in seconds, 0 for none)
+void AddMessage(alfa::Topic &topic, double recorded, double stamp)
+{
+    const long long base = 1531943617LL * 1000000000LL;
+    alfa::Message msg;
+    msg.DateTime = alfa::DateTime::EpochNanosecondsToTime(base + (long long)std::llround(recorded * 1e9));
+    if (stamp > 0) msg.Header.Stamp = base + (long long)std::llround(stamp * 1e9);
+    msg.Fields.push_back("0");
+    topic.AddMessage(msg);
+}
+
+int main()
+{
+    // The stamps of the IMU are 0.6-0.8 seconds before the recording, so in the header stamp timeline the sequence
+    // starts with the IMU and its last message is the last one before the fault:
+    //   recorded time: IMU 1.0, 2.0, 3.0   roll 0.5, 1.5   fault 2.5, 3.5
+    //   header stamp:  IMU 0.2, 1.2, 2.4   roll 0.5, 1.5   fault 2.5, 3.5
+    alfa::Topic imu, roll, fault;
+    imu.Create("mavros-imu-data", { "data" }, true);
+    roll.Create("mavros-nav_info-roll", { "data" });
+    fault.Create("failure_status-engines", { "data" });
+    AddMessage(imu, 1.0, 0.2);
+    AddMessage(imu, 2.0, 1.2);
+    AddMessage(imu, 3.0, 2.4);
+    AddMessage(roll, 0.5, 0);
+    AddMessage(roll, 1.5, 0);
+    AddMessage(fault, 2.5, 0);
+    AddMessage(fault, 3.5, 0);
+    alfa::Sequence sequence;
+    sequence.Name = "header_stamps";
+    sequence.AddTopic(imu);
+    sequence.AddTopic(roll);
+    sequence.AddTopic(fault);
+
+    // Recorded times: from 0.5 to 3.5, and the last message before the fault at 2.5 is the IMU at 2.0
+    CheckDuration("total duration (recorded time)", sequence.GetTotalDuration(), 3.0);
+    CheckDuration("normal flight duration (recorded time)", sequence.GetNormalFlightDuration(), 1.5);
+    int fault_idx = sequence.FindFirstFaultMessage();
+    if (fault_idx < 0 || sequence.GetTimelineTime(fault_idx) != sequence.Topics[2].Messages[0].DateTime.ToEpochNanoseconds())
+    {
+        std::cout << "FAILED: the first fault message (recorded time) is " << fault_idx << std::endl;
+        n_failures++;
+    }
+
+    // Header stamps: from 0.2 to 3.5, and the last message before the fault at 2.5 is the IMU stamped at 2.4
+    sequence.SetTimelineMode(alfa::Sequence::HeaderStamp);
+    CheckDuration("total duration (header stamp)", sequence.GetTotalDuration(), 3.3);
+    CheckDuration("normal flight duration (header stamp)", sequence.GetNormalFlightDuration(), 2.2);
+    fault_idx = sequence.FindFirstFaultMessage();
+    if (fault_idx < 0 || sequence.MessageIndexList[fault_idx].TopicIdx != 2 || sequence.MessageIndexList[fault_idx].MessageIdx != 0)
+    {
+        std::cout << "FAILED: the first fault message (header stamp) is " << fault_idx << std::endl;
+        n_failures++;
+    }
+
+    if (n_failures > 0) return 1;
+    std::cout << "PASSED" << std::endl;
+    return 0;
+}
@@ -0,0 +1,212 @@
+/*  ***************************************************************************
+*   evaluator.h - Header for evaluating the detections against the faults.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_EVAL_EVALUATOR_H
+#define ALFA_EVAL_EVALUATOR_H
+
+#include <algorithm>
+#include <cmath>
+
+namespace alfa
+{
+
+// This class decides the result of the evaluation from the ground truth faults and the detections. It does not
+// read any clock: every call gets the current time (in nanoseconds) from its caller, which is the ROS time in the
+// evaluation node or the recorded time of the messages in the simulated replay. All the times are integers, so
+// the same calls give the same results on any machine.
+// With the original rules (the ones of the evaluation node), every ground truth message restarts the fault and the
+// detections are decided on the next update: a detection with a fault is a detected fault (the delay is from the last
+// ground truth message), a detection without a fault is a false positive, and a fault is missed when the whole
+// seconds from it are more than the timeout.
+// With the fault episode rules, a fault starts at its first ground truth message (the later messages of the same
+// fault are ignored). It is detected by the first detection after its start, or missed if there is no detection
+// within the timeout. A detection while there is no fault is a false positive, and the detections after the fault is
+// decided are ignored until the fault ends. A fault ends when its ground truth messages stop for longer than the
+// timeout, and the next ground truth message then starts a new fault.
+class Evaluator
+{
+public:
+
+    // Local enum definitions
+    enum Rules
+    {
+        OriginalRules,                  // The rules of the original evaluation node
+        FaultEpisodeRules               // A fault is decided once from its first ground truth message
+    };
+
+    // Local struct definitions
+    struct Result                       // Same fields as the evaluation message
+    {
+        long long Time = 0;             // Time of deciding the result (nanoseconds)
+        bool FaultDetected = false;
+        long long DetectionDelay = 0;   // Nanoseconds from the fault to its detection (0 if not detected)
+        bool FalsePositive = false;
+    };
+
+    // Constructors & Deconstructors
+    Evaluator(double timeout = 5, Rules rules = OriginalRules);
+
+    // Member Functions
+    void OnFault(long long time);
+    bool OnDetection(long long time, Result &out_result);
+    bool Update(long long now, Result &out_result);
+    long long GetNextDeadline() const;
+    void Reset();
+
+private:
+    // Data Members
+    double timeout;
+    long long timeout_ns;
+    Rules rules;
+    long long fault_time = -1;          // Start of the pending fault (-1 if there is none)
+    long long detection_time = -1;      // Time of the last undecided detection of the original rules (-1 if there is none)
+    long long last_fault_time = -1;     // Time of the last ground truth message (-1 if there is none)
+    bool fault_decided = false;         // The fault is detected or missed
+
+    // Member Functions
+    void EndFinishedFault(long long now);
+    bool UpdateOriginal(long long now, Result &out_result);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for Evaluator with the timeout of the detections (seconds) and the evaluation rules
+Evaluator::Evaluator(double timeout, Rules rules)
+    : timeout(timeout), timeout_ns((long long)(timeout * 1e9 + 0.5)), rules(rules)
+{
+}
+
+// Record a ground truth fault message
+void Evaluator::OnFault(long long time)
+{
+    if (rules == OriginalRules)
+    {
+        fault_time = time;
+        return;
+    }
+
+    EndFinishedFault(time);
+    if (fault_time < 0 && !fault_decided) fault_time = time;
+    last_fault_time = time;
+}
+
+// Record a detection. Returns true if it decides a result (a detected fault or a false positive).
+// With the original rules, the detection is decided on the next update.
+bool Evaluator::OnDetection(long long time, Result &out_result)
+{
+    if (rules == OriginalRules)
+    {
+        detection_time = time;
+        return false;
+    }
+
+    EndFinishedFault(time);
+    if (fault_decided) return false;
+    out_result = Result();
+    out_result.Time = time;
+    if (fault_time >= 0)
+    {
+        out_result.FaultDetected = true;
+        out_result.DetectionDelay = time - fault_time;
+        fault_time = -1;
+        fault_decided = true;
+    }
+    else
+        out_result.FalsePositive = true;
+    return true;
+}
+
+// Advance the time. Returns true if the pending fault is missed (no detection within the timeout),
+// or with the original rules, if it decides a result.
+bool Evaluator::Update(long long now, Result &out_result)
+{
+    if (rules == OriginalRules) return UpdateOriginal(now, out_result);
+
+    if (fault_time < 0 || now - fault_time <= timeout_ns) return false;
+    out_result = Result();
+    out_result.Time = fault_time + timeout_ns;
+    fault_time = -1;
+    fault_decided = true;
+    return true;
+}
+
+// Get the time after which the next update decides a result (-1 if there is nothing to decide)
+long long Evaluator::GetNextDeadline() const
+{
+    if (rules == OriginalRules)
+    {
+        if (detection_time >= 0) return std::max(detection_time, fault_time);
+        if (fault_time < 0) return -1;
+        return ((long long)std::floor(fault_time / 1000000000LL + timeout) + 1) * 1000000000LL - 1;
+    }
+    return fault_time < 0 ? -1 : fault_time + timeout_ns;
+}
+
+// Forget the faults (e.g. before a new sequence)
+void Evaluator::Reset()
+{
+    fault_time = -1;
+    detection_time = -1;
+    last_fault_time = -1;
+    fault_decided = false;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Forget the decided fault if its ground truth messages stopped for longer than the timeout
+void Evaluator::EndFinishedFault(long long now)
+{
+    if (fault_decided && now - last_fault_time > timeout_ns) fault_decided = false;
+}
+
+// Decide a result with the original rules (a detection, a false positive or a fault missed in whole seconds)
+bool Evaluator::UpdateOriginal(long long now, Result &out_result)
+{
+    out_result = Result();
+    out_result.Time = now;
+    if (fault_time >= 0 && detection_time >= 0)
+    {
+        out_result.FaultDetected = true;
+        out_result.DetectionDelay = detection_time - fault_time;
+    }
+    else if (fault_time >= 0)
+    {
+        if (now / 1000000000LL - fault_time / 1000000000LL <= timeout) return false;
+    }
+    else if (detection_time >= 0)
+        out_result.FalsePositive = true;
+    else
+        return false;
+
+    fault_time = -1;
+    detection_time = -1;
+    return true;
+}
+
+}
+#endif
@@ -0,0 +1,325 @@
+/*  ***************************************************************************
+*   simulated_replay.h - Header for the deterministic replay of the sequences
+*   to the detectors and the evaluator on the recorded clock.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_EVAL_SIMULATED_REPLAY_H
+#define ALFA_EVAL_SIMULATED_REPLAY_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include "evaluator.h"
+#include "sequence.h"
+#include "catalog.h"
+#include "commons.h"
+#include "metrics.h"
+
+namespace alfa
+{
+
+// This class is the interface of the detectors under the test. The replay gives it every message of a sequence in
+// the recorded order with the recorded time of the message as the current time, and the detector returns true for
+// the messages on which it reports a fault. The detector must not read any other clock.
+class Detector
+{
+public:
+    virtual ~Detector() {}
+
+    // Member Functions
+    virtual void Reset() {}
+    virtual bool OnMessage(const Topic &topic, const Message &msg, long long now) = 0;
+};
+
+// This class is a simple example detector. It reports a fault when a field of a topic (or its difference from a
+// reference field) stays beyond a threshold for a number of consecutive messages, e.g. when the measured roll does
+// not follow the commanded roll.
+class ThresholdDetector : public Detector
+{
+public:
+
+    // Local struct definitions
+    struct Options
+    {
+        std::string TopicName = "mavros-nav_info-roll";
+        std::string FieldLabel = "measured";
+        std::string ReferenceLabel = "commanded";   // The field is compared to this field (not used if empty)
+        double Threshold = 10;                      // Largest normal absolute value (of the difference)
+        int Persistence = 5;                        // Consecutive messages beyond the threshold for a detection
+    };
+
+    // Constructors & Deconstructors
+    ThresholdDetector(const Options &options);
+
+    // Member Functions
+    void Reset() override;
+    bool OnMessage(const Topic &topic, const Message &msg, long long now) override;
+
+private:
+    // Data Members
+    Options options;
+    int n_beyond = 0;                   // Consecutive messages beyond the threshold
+    const Topic *label_topic = nullptr; // Topic of the field indices below (found on its first message)
+    int field_idx = -1, ref_idx = -1;
+};
+
+// This class replays the sequences to a detector and the evaluator on a simulated clock. The clock jumps from each
+// event (a message or the timeout of a fault) to the next one, so a sequence is evaluated as fast as it can be
+// processed, and the results only depend on the recorded data: the clock is the exact UTC epoch time of the
+// messages (converted without the time zone of the machine), so the results are the same in every run on every machine.
+// The faults are given to the evaluator from the ground truth (fault) topics of the sequence. If metrics are given,
+// the replay records the time of handling each message after the simulated clock reaches it (the lateness of the
+// detector if the messages arrived in real time), the time of each sequence and the time of loading it.
+class SimulatedReplay
+{
+public:
+
+    // Local struct definitions
+    struct Options
+    {
+        double Timeout = 5;             // Seconds after a fault to detect it
+        Evaluator::Rules Rules = Evaluator::FaultEpisodeRules;
+    };
+
+    struct Result                       // Evaluation of a sequence
+    {
+        std::string SequenceName;
+        long long StartTime = 0;        // Time of the first message (nanoseconds)
+        long long FaultTime = -1;       // Time of the first fault message (-1 if the sequence has no fault)
+        int NMessages = 0;
+        std::vector<Evaluator::Result> Evaluations;
+    };
+
+    typedef std::function<std::unique_ptr<Detector>()> DetectorFactory;
+
+    // Member Functions
+    static bool Run(const Sequence &sequence, Detector &detector, const Options &options, Result &out_result,
+        Metrics *metrics = nullptr);
+    static std::vector<Result> RunEach(const Catalog &catalog, const DetectorFactory &create_detector, const Options &options,
+        int n_threads = 0, Metrics *metrics = nullptr);
+    static void PrintResult(const Result &result, std::ostream &os = std::cout);
+    static void PrintSummary(const std::vector<Result> &results, std::ostream &os = std::cout);
+
+private:
+    // Member Functions
+    static std::vector<size_t> GetEventOrder(const Sequence &sequence, std::vector<long long> &out_times);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for ThresholdDetector
+ThresholdDetector::ThresholdDetector(const Options &options)
+    : options(options)
+{
+}
+
+// Forget the previous messages (e.g. before a new sequence)
+void ThresholdDetector::Reset()
+{
+    n_beyond = 0;
+    label_topic = nullptr;
+}
+
+// Process a message. Reports a fault once when the field has been beyond the threshold long enough.
+bool ThresholdDetector::OnMessage(const Topic &topic, const Message &msg, long long /*now*/)
+{
+    if (topic.Name != options.TopicName) return false;
+
+    // Find the indices of the fields once for the topic
+    if (label_topic != &topic)
+    {
+        field_idx = topic.FindLabelIndex(options.FieldLabel);
+        ref_idx = options.ReferenceLabel.empty() ? -1 : topic.FindLabelIndex(options.ReferenceLabel);
+        label_topic = &topic;
+    }
+
+    // Read the field (and the reference field) of the message
+    double value = 0, reference = 0;
+    if (field_idx < 0 || field_idx >= (int)msg.Fields.size() || !Commons::StringToDouble(msg.Fields[field_idx], value)) return false;
+    if (ref_idx >= 0 && (ref_idx >= (int)msg.Fields.size() || !Commons::StringToDouble(msg.Fields[ref_idx], reference))) return false;
+
+    // Count the consecutive messages beyond the threshold
+    if (std::abs(value - reference) > options.Threshold) ++n_beyond;
+    else n_beyond = 0;
+    return n_beyond == options.Persistence;
+}
+
+// Replay a sequence to the detector and the evaluator
+bool SimulatedReplay::Run(const Sequence &sequence, Detector &detector, const Options &options, Result &out_result,
+    Metrics *metrics)
+{
+    std::chrono::steady_clock::time_point sequence_start = std::chrono::steady_clock::now();
+    out_result = Result();
+    out_result.SequenceName = sequence.Name;
+    if (!sequence.IsInitialized() || sequence.MessageIndexList.empty())
+    {
+        std::cerr << "SimulatedReplay Error! The sequence '" << sequence.Name << "' has no messages." << std::endl;
+        return false;
+    }
+
+    // Put the messages in a deterministic order
+    std::vector<long long> times;
+    std::vector<size_t> order = GetEventOrder(sequence, times);
+    out_result.StartTime = times[order[0]];
+    out_result.NMessages = (int)order.size();
+
+    // Register the metrics of the replay (if requested)
+    Metrics::Counter *replayed = nullptr;
+    Metrics::Histogram *lateness = nullptr, *sequence_duration = nullptr;
+    if (metrics)
+    {
+        replayed = &metrics->AddCounter("alfa_replay_messages_total", "Messages replayed to the detectors.");
+        lateness = &metrics->AddHistogram("alfa_replay_lateness_seconds",
+            "Time of handling a message after the simulated clock reaches it.", Metrics::ExponentialBuckets(0.00001, 4, 10));
+        sequence_duration = &metrics->AddHistogram("alfa_replay_sequence_duration_seconds", "Time of replaying a sequence.",
+            Metrics::ExponentialBuckets(0.01, 2, 12));
+    }
+
+    Evaluator evaluator(options.Timeout, options.Rules);
+    Evaluator::Result evaluation;
+    detector.Reset();
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        // Advance the clock to the message (deciding the faults that time out before it)
+        long long now = times[order[i]];
+        std::chrono::steady_clock::time_point message_start;
+        if (lateness) message_start = std::chrono::steady_clock::now();
+        if (evaluator.Update(now, evaluation)) out_result.Evaluations.push_back(evaluation);
+
+        // Give the message to the evaluator (if it is a fault) and to the detector
+        const Sequence::MessageIndex &index = sequence.MessageIndexList[order[i]];
+        const Topic &topic = sequence.Topics[index.TopicIdx];
+        const Message &msg = topic.Messages[index.MessageIdx];
+        if (topic.IsFaultTopic())
+        {
+            if (out_result.FaultTime < 0) out_result.FaultTime = now;
+            evaluator.OnFault(now);
+        }
+        if (detector.OnMessage(topic, msg, now) && evaluator.OnDetection(now, evaluation))
+            out_result.Evaluations.push_back(evaluation);
+        if (lateness)
+        {
+            replayed->Increment();
+            lateness->Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - message_start).count());
+        }
+    }
+
+    // Advance the clock to decide what is still pending at the end of the sequence (e.g. the timeout of a fault)
+    long long deadline;
+    while ((deadline = evaluator.GetNextDeadline()) >= 0 && evaluator.Update(deadline + 1, evaluation))
+        out_result.Evaluations.push_back(evaluation);
+    if (sequence_duration)
+        sequence_duration->Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - sequence_start).count());
+    return true;
+}
+
+// Replay each sequence of the catalog to a new detector (in parallel). The results are in the order of the catalog.
+std::vector<SimulatedReplay::Result> SimulatedReplay::RunEach(const Catalog &catalog, const DetectorFactory &create_detector,
+    const Options &options, int n_threads, Metrics *metrics)
+{
+    Metrics::Histogram *load_duration = nullptr;
+    if (metrics)
+        load_duration = &metrics->AddHistogram("alfa_replay_sequence_load_duration_seconds", "Time of loading a sequence.",
+            Metrics::ExponentialBuckets(0.01, 2, 12));
+    std::vector<Result> results(catalog.Entries.size());
+    Commons::ParallelFor(results.size(), n_threads, [&](int i)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Sequence sequence(catalog.GetSequenceDirectory(i), catalog.Entries[i].Name);
+        if (load_duration) load_duration->Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        std::unique_ptr<Detector> detector = create_detector();
+        if (!Run(sequence, *detector, options, results[i], metrics)) results[i].SequenceName = catalog.Entries[i].Name;
+    });
+    return results;
+}
+
+// Print the evaluations of a sequence (the same fields as the evaluation node)
+void SimulatedReplay::PrintResult(const Result &result, std::ostream &os)
+{
+    os << result.SequenceName << " (" << result.NMessages << " messages";
+    if (result.FaultTime >= 0) os << ", fault at " << (result.FaultTime - result.StartTime) / 1000000 << " ms";
+    os << "):" << std::endl;
+    for (size_t i = 0; i < result.Evaluations.size(); ++i)
+    {
+        const Evaluator::Result &eval = result.Evaluations[i];
+        os << "  t = " << (eval.Time - result.StartTime) / 1000000 << " ms: fault_detected = " << eval.FaultDetected
+           << ", detection_delay.sec = " << eval.DetectionDelay / 1000000000 << ", detection_delay.nsec = "
+           << eval.DetectionDelay % 1000000000 << ", false_positive = " << eval.FalsePositive << std::endl;
+    }
+}
+
+// Print the totals of the evaluations of all the sequences
+void SimulatedReplay::PrintSummary(const std::vector<Result> &results, std::ostream &os)
+{
+    int n_faults = 0, n_detected = 0, n_false_positives = 0;
+    long long total_delay = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (results[i].FaultTime >= 0) ++n_faults;
+        for (size_t j = 0; j < results[i].Evaluations.size(); ++j)
+        {
+            const Evaluator::Result &eval = results[i].Evaluations[j];
+            if (eval.FaultDetected) { ++n_detected; total_delay += eval.DetectionDelay; }
+            if (eval.FalsePositive) ++n_false_positives;
+        }
+    }
+    os << "Sequences       : " << results.size() << std::endl;
+    os << "Faults          : " << n_faults << std::endl;
+    os << "Detected        : " << n_detected << std::endl;
+    os << "False positives : " << n_false_positives << std::endl;
+    if (n_detected > 0) os << "Mean delay      : " << total_delay / n_detected / 1000000 << " ms" << std::endl;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Get the order of the messages by their timeline time, breaking the ties by the topic names. The merged message
+// list breaks the ties by the topic indices, which also depend on the topics added after loading the sequence.
+std::vector<size_t> SimulatedReplay::GetEventOrder(const Sequence &sequence, std::vector<long long> &out_times)
+{
+    size_t n_messages = sequence.MessageIndexList.size();
+    out_times.resize(n_messages);
+    std::vector<size_t> order(n_messages);
+    for (size_t i = 0; i < n_messages; ++i)
+    {
+        out_times[i] = sequence.GetTimelineTime(i);
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        if (out_times[a] != out_times[b]) return out_times[a] < out_times[b];
+        return sequence.Topics[sequence.MessageIndexList[a].TopicIdx].Name < sequence.Topics[sequence.MessageIndexList[b].TopicIdx].Name;
+    });
+    return order;
+}
+
+}
+#endif
@@ -14,7 +14,7 @@
 *   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
 *   Contact: keipour@cmu.edu
 *
-*   Last Modified: May 19, 2019
+*   Last Modified: October 18, 2026
 *
 *   Copyright (c) 2019 Carnegie Mellon University,
 *   Azarakhsh Keipour <keipour@cmu.edu>
@@ -27,55 +27,53 @@
 #include "eval_msg/evaluate.h"
 #include "std_msgs/Bool.h"
 #include "std_msgs/Int8.h"
+#include "evaluator.h"
 #include <sstream>
 
+// All the times come from ros::Time::now(), which follows the /clock topic when the 'use_sim_time' parameter is
+// set (e.g. with 'rosbag play --clock'), so the evaluation then runs on the recorded time of the sequence.
 double timeout = 5;
-ros::Time gt_time;
-ros::Time detection_time;
-ros::Time detection_delay;
-bool gt_trig = false;
-bool detection_trig = false;
-bool fault_detected = false;
+bool fault_episodes = false;
+alfa::Evaluator *evaluator = nullptr;
+ros::Publisher evalPub;
+
+void publishEvaluation(const alfa::Evaluator::Result& result)
+{
+  eval_msg::evaluate eval;
+  eval.header.stamp.fromNSec(result.Time);
+  eval.fault_detected = result.FaultDetected;
+  eval.detection_delay.fromNSec(result.DetectionDelay);
+  eval.false_positive = result.FalsePositive;
+  evalPub.publish(eval);
+  ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
+}
+
+void faultHandler()
+{
+  evaluator->OnFault(ros::Time::now().toNSec());
+}
 
 void engineFailHandler(const std_msgs::Bool::ConstPtr& data)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  if(data) faultHandler();
 }
 void aileronFailHandler(const std_msgs::Int8::ConstPtr& data)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  if(data) faultHandler();
 }
 void rudderFailHandler(const std_msgs::Int8::ConstPtr& data)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  if(data) faultHandler();
 }
 void elevatorFailHandler(const std_msgs::Int8::ConstPtr& data)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  if(data) faultHandler();
 }
 void detectionHandler(const std_msgs::Int8::ConstPtr& data)
 {
-  if(data)
-  {
-    detection_time = ros::Time::now();
-    detection_trig = true;
-  }
+  alfa::Evaluator::Result result;
+  if(data && evaluator->OnDetection(ros::Time::now().toNSec(), result))
+    publishEvaluation(result);
 }
 
 int main(int argc, char **argv)
@@ -84,7 +82,13 @@ int main(int argc, char **argv)
   ros::NodeHandle n;
   ros::NodeHandle nhPrivate = ros::NodeHandle("~");
 
-  ros::Publisher evalPub = n.advertise<eval_msg::evaluate>("/evaluation", 1);
+  // The original rules are the default, so the results can be compared to the earlier evaluations
+  nhPrivate.getParam("timeout", timeout);
+  nhPrivate.getParam("fault_episodes", fault_episodes);
+  alfa::Evaluator eval_state(timeout, fault_episodes ? alfa::Evaluator::FaultEpisodeRules : alfa::Evaluator::OriginalRules);
+  evaluator = &eval_state;
+
+  evalPub = n.advertise<eval_msg::evaluate>("/evaluation", 1);
   
   ros::Subscriber enginesSub = n.subscribe("/failure_status/engines", 1, engineFailHandler);
   ros::Subscriber aileronSub = n.subscribe("/failure_status/aileron", 1, aileronFailHandler);
@@ -95,65 +99,12 @@ int main(int argc, char **argv)
 
   ros::Rate loop_rate(10);
 
-  nhPrivate.getParam("timeout", timeout);
-
-  eval_msg::evaluate eval;
-
-  int count = 0;
   while (ros::ok())
   {
-    
-    if(gt_trig)
-    {
-      if(detection_trig)
-      {
-        fault_detected = true;
-        detection_delay.sec = detection_time.sec - gt_time.sec;
-        detection_delay.nsec = detection_time.nsec - gt_time.nsec;
-        if(detection_delay.nsec < 0)
-        {
-          detection_delay.sec -= 1;
-          detection_delay.nsec = 1000000000 + detection_delay.nsec;
-        }
-        eval.fault_detected = fault_detected;
-        eval.detection_delay = detection_delay;
-        eval.false_positive = false;
-        evalPub.publish(eval);
-        ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
-        gt_trig = false;
-        detection_trig = false;
-      }
-      else
-      {
-        eval.fault_detected = false;
-        eval.false_positive = false;
-        detection_delay.sec = 0;
-        detection_delay.nsec = 0;
-        eval.detection_delay = detection_delay;
-        if( (ros::Time::now().sec - gt_time.sec) > timeout )
-        {
-          fault_detected = false;
-          detection_trig = false;
-          gt_trig = false;
-          evalPub.publish(eval);
-          ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
-        }
-      }
-    }
-    else
-    {
-      if(detection_trig)
-      {
-        eval.false_positive = true;
-        eval.fault_detected = false;
-        detection_delay.sec = 0;
-        detection_delay.nsec = 0;
-        eval.detection_delay = detection_delay;
-        evalPub.publish(eval);
-        ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
-        detection_trig = false;
-      }
-    }
+    // Decide the detections (original rules) and the faults that are not detected within the timeout
+    alfa::Evaluator::Result result;
+    if(evaluator->Update(ros::Time::now().toNSec(), result))
+      publishEvaluation(result);
     
     ros::spinOnce();
     loop_rate.sleep();
@@ -0,0 +1,136 @@
+/*  ***************************************************************************
+*   alfa-evaluate_replay.cpp - Evaluates a detector on the sequences of the
+*   dataset on the recorded clock (deterministic and faster than real time).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 18, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include "simulated_replay.h"
+#include "catalog.h"
+#include "commons.h"
+#include "metrics.h"
+
+bool ParseCommandLine(int argc, char** argv, std::string &out_root_path, alfa::SimulatedReplay::Options &out_options,
+    alfa::ThresholdDetector::Options &out_detector_options, int &out_n_threads, alfa::MetricsExporter::Options &out_metrics_options);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the dataset root and the options from the command-line arguments
+    std::string root_path;
+    alfa::SimulatedReplay::Options options;
+    alfa::ThresholdDetector::Options detector_options;
+    int n_threads = 0;
+    alfa::MetricsExporter::Options metrics_options;
+    if (!ParseCommandLine(argc, argv, root_path, options, detector_options, n_threads, metrics_options))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the catalog or build it if the dataset root does not have one
+    alfa::Catalog catalog;
+    bool has_catalog = std::ifstream(root_path + alfa::Catalog::DefaultFileName).good();
+    if (!(has_catalog ? catalog.Load(root_path) : catalog.Build(root_path, n_threads))) return 1;
+
+    // Export the metrics of the replay (if requested) while replaying
+    alfa::Metrics metrics;
+    metrics.AddProcessMetrics();
+    alfa::MetricsExporter exporter(metrics, metrics_options);
+    if (!exporter.Start()) return 1;
+
+    // Replay each sequence to its own detector and print the evaluations in the order of the catalog
+    std::vector<alfa::SimulatedReplay::Result> results = alfa::SimulatedReplay::RunEach(catalog, [&]()
+    {
+        return std::unique_ptr<alfa::Detector>(new alfa::ThresholdDetector(detector_options));
+    }, options, n_threads, &metrics);
+    exporter.Stop();
+    for (size_t i = 0; i < results.size(); ++i)
+        alfa::SimulatedReplay::PrintResult(results[i]);
+    alfa::SimulatedReplay::PrintSummary(results);
+    return 0;
+}
+
+// Parse command-line arguments
+bool ParseCommandLine(int argc, char** argv, std::string &out_root_path, alfa::SimulatedReplay::Options &out_options,
+    alfa::ThresholdDetector::Options &out_detector_options, int &out_n_threads, alfa::MetricsExporter::Options &out_metrics_options)
+{
+    if (argc < 2) return false;
+    out_root_path = argv[1];
+    if (out_root_path[out_root_path.length() - 1] != alfa::Commons::FilePathSeparator)
+        out_root_path += alfa::Commons::FilePathSeparator;
+
+    for (int i = 2; i < argc; i += 2)
+    {
+        if (i + 1 >= argc) return false;
+        std::string option(argv[i]);
+        std::string value(argv[i + 1]);
+
+        bool parsed = true;
+        if (option == "--timeout") parsed = alfa::Commons::StringToDouble(value, out_options.Timeout) && out_options.Timeout >= 0;
+        else if (option == "--rules")
+        {
+            if (value == "original") out_options.Rules = alfa::Evaluator::OriginalRules;
+            else if (value == "episodes") out_options.Rules = alfa::Evaluator::FaultEpisodeRules;
+            else parsed = false;
+        }
+        else if (option == "--topic") out_detector_options.TopicName = value;
+        else if (option == "--field") out_detector_options.FieldLabel = value;
+        else if (option == "--reference") out_detector_options.ReferenceLabel = (value == "none" ? "" : value);
+        else if (option == "--threshold") parsed = alfa::Commons::StringToDouble(value, out_detector_options.Threshold);
+        else if (option == "--persistence") parsed = alfa::Commons::StringToInt(value, out_detector_options.Persistence) &&
+            out_detector_options.Persistence > 0;
+        else if (option == "--threads") parsed = alfa::Commons::StringToInt(value, out_n_threads);
+        else if (option == "--metrics-port") parsed = alfa::Commons::StringToInt(value, out_metrics_options.HttpPort);
+        else if (option == "--metrics-file") out_metrics_options.Filename = value;
+        else if (option == "--metrics-interval") parsed = alfa::Commons::StringToDouble(value, out_metrics_options.FileInterval) &&
+            out_metrics_options.FileInterval > 0;
+        else parsed = false;
+
+        if (!parsed) return false;
+    }
+    return true;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "./alfa-evaluate_replay path/to/dataset/root [options]" << std::endl;
+    std::cout << "Evaluates a threshold detector on each sequence using the recorded time of the messages as the clock." << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --timeout <secs>      Seconds after a fault to detect it (default: 5)" << std::endl;
+    std::cout << "  --rules <rules>       'original' (rules of the evaluation node) or 'episodes' (default: episodes)" << std::endl;
+    std::cout << "  --topic <name>        Topic of the detector (default: mavros-nav_info-roll)" << std::endl;
+    std::cout << "  --field <label>       Field of the detector (default: measured)" << std::endl;
+    std::cout << "  --reference <label>   Field subtracted from the field, or 'none' (default: commanded)" << std::endl;
+    std::cout << "  --threshold <value>   Largest normal absolute value of the difference (default: 10)" << std::endl;
+    std::cout << "  --persistence <n>     Consecutive messages beyond the threshold for a detection (default: 5)" << std::endl;
+    std::cout << "  --threads <n>         Number of the sequences replayed in parallel (default: all the cores)" << std::endl;
+    std::cout << "  --metrics-port <port> Serve the metrics of the replay for Prometheus on http://127.0.0.1:<port>/metrics" << std::endl;
+    std::cout << "  --metrics-file <file> Write the metrics of the replay (Prometheus text format) to the file periodically" << std::endl;
+    std::cout << "  --metrics-interval <s> Seconds between the writes of the metrics file (default: 10)" << std::endl;
+}
@@ -30,6 +30,7 @@
 #include "commons.h"
 #include "topic.h"
 #include "message.h"
+#include "batch_stream.h"
 
 
 using namespace boost::python;
@@ -44,10 +45,88 @@ bool operator==(const alfa::Sequence::MessageIndex& left, const alfa::Sequence::
     return left.TopicIdx == right.TopicIdx && left.MessageIdx == right.MessageIdx;
 }
 
+namespace np = boost::python::numpy;
+
+// Converts a python list of strings to a vector of strings
+alfa::VecString ListToVecString(const list &input)
+{
+    return alfa::VecString(stl_input_iterator<std::string>(input), stl_input_iterator<std::string>());
+}
+
+// Releases the GIL in the current scope (the background threads keep producing the batches meanwhile)
+class ScopedGILRelease
+{
+public:
+    ScopedGILRelease() { state = PyEval_SaveThread(); }
+    ~ScopedGILRelease() { PyEval_RestoreThread(state); }
+private:
+    PyThreadState *state;
+};
+
+// Python iterator over the batches of alfa::BatchStream. Each item is a tuple of
+// (data, times, sequence_name) where data is a (rows x fields) float64 NumPy array
+// and times is an int64 NumPy array of the recorded times in nanoseconds.
+class BatchIterator
+{
+public:
+    BatchIterator(const list &sequence_dirs, const list &sequence_names, const std::string &topic_name,
+            const list &field_labels, int batch_size, int n_threads = 2, int prefetch = 8, bool drop_last = false)
+        : stream(new alfa::BatchStream(ListToVecString(sequence_dirs), ListToVecString(sequence_names), topic_name,
+            ListToVecString(field_labels), batch_size, n_threads, prefetch, drop_last)) {}
+
+    tuple Next()
+    {
+        // Wait for the next batch without holding the GIL
+        alfa::BatchStream::Batch batch;
+        bool has_batch;
+        {
+            ScopedGILRelease release;
+            has_batch = stream->Next(batch);
+        }
+
+        // Raise StopIteration at the end of the stream
+        if (!has_batch)
+        {
+            PyErr_SetNone(PyExc_StopIteration);
+            throw_error_already_set();
+        }
+
+        // Copy the batch into NumPy arrays
+        np::ndarray data = np::empty(boost::python::make_tuple(batch.Rows, batch.Columns), np::dtype::get_builtin<double>());
+        np::ndarray times = np::empty(boost::python::make_tuple(batch.Rows), np::dtype::get_builtin<long long>());
+        std::copy(batch.Data.begin(), batch.Data.end(), reinterpret_cast<double *>(data.get_data()));
+        std::copy(batch.Times.begin(), batch.Times.end(), reinterpret_cast<long long *>(times.get_data()));
+        return boost::python::make_tuple(data, times, batch.SequenceName);
+    }
+
+    void Stop()
+    {
+        ScopedGILRelease release;
+        stream->Stop();
+    }
+
+private:
+    boost::shared_ptr<alfa::BatchStream> stream;
+};
+
+// Returns the iterator itself (for the python iterator protocol)
+object PassThrough(const object &obj)
+{
+    return obj;
+}
+
 // Defines a python module which will be named "alfa-python"
 BOOST_PYTHON_MODULE(alfa_python)
 {
-    
+    np::initialize();
+
+    class_<BatchIterator, boost::noncopyable>("BatchIterator",
+            init<list, list, std::string, list, int, optional<int, int, bool> >())
+        .def("__iter__", &PassThrough)
+        .def("__next__", &BatchIterator::Next)
+        .def("Stop", &BatchIterator::Stop)
+        ;
+
     class_<alfa::Topic>("Topic", init<std::string, std::string>())
 		// Class Data Members
 		.def_readwrite("Name", &alfa::Topic::Name)
@@ -87,7 +166,7 @@ BOOST_PYTHON_MODULE(alfa_python)
 		.def("LoadSequence", &alfa::Sequence::LoadSequence)
 	  .def("IsInitialized", &alfa::Sequence::IsInitialized)
 	  .def("Clear", &alfa::Sequence::Clear)
-	  .def("GetMessage", &alfa::Sequence::GetMessage)
+	  .def("GetMessage", &alfa::Sequence::GetMessage, return_value_policy<copy_const_reference>())
 	  .def("PrintBriefInfo", &alfa::Sequence::PrintBriefInfo)
 	  .def("GetFaultTopics", &alfa::Sequence::GetFaultTopics)
 	  .def("GetTotalDuration", &alfa::Sequence::GetTotalDuration)